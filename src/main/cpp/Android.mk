@@ -35,6 +35,7 @@ drivers/opensl_io.c \
 utilities/utils.cpp \
 audioengine.cpp \
 audiobuffer.cpp \
+audiobus.cpp \
 audiochannel.cpp \
 instruments/baseinstrument.cpp \
 instruments/druminstrument.cpp \
@@ -50,6 +51,7 @@ events/synthevent.cpp \
 events/sampleevent.cpp \
 processors/baseprocessor.cpp \
 processors/bitcrusher.cpp \
+processors/convolutionreverb.cpp \
 processors/dcoffsetfilter.cpp \
 processors/decimator.cpp \
 processors/delay.cpp \
@@ -59,6 +61,7 @@ processors/fm.cpp \
 processors/formantfilter.cpp \
 processors/glitcher.cpp \
 processors/limiter.cpp \
+processors/lookaheadlimiter.cpp \
 processors/lowpassfilter.cpp \
 processors/lpfhpfilter.cpp \
 processors/phaser.cpp \
@@ -71,13 +74,29 @@ generators/envelopegenerator.cpp \
 generators/wavegenerator.cpp \
 generators/synthesizer.cpp \
 utilities/bufferutility.cpp \
+utilities/levelmeter.cpp \
 utilities/levelutility.cpp \
 utilities/bulkcacher.cpp \
 utilities/diskwriter.cpp \
+utilities/audiorenderer.cpp \
+utilities/freezer.cpp \
+utilities/tempomap.cpp \
+utilities/fft.cpp \
+utilities/timestretcher.cpp \
+utilities/stretchcache.cpp \
+utilities/biquadcascade.cpp \
+utilities/partitionedconvolver.cpp \
+utilities/inputcapture.cpp \
+utilities/lockfreeringbuffer.cpp \
+utilities/recordingstream.cpp \
 processingchain.cpp \
 ringbuffer.cpp \
+routinggraph.cpp \
 utilities/debug.cpp \
 utilities/samplemanager.cpp \
+utilities/samplestream.cpp \
+utilities/worksignal.cpp \
+utilities/resampler.cpp \
 utilities/bufferpool.cpp \
 utilities/tablepool.cpp \
 sequencer.cpp \
@@ -86,6 +105,7 @@ wavetable.cpp \
 utilities/fastmath.cpp \
 utilities/wavereader.cpp \
 utilities/wavewriter.cpp \
+utilities/waveencoder.cpp \
 messaging/notifier.cpp \
 messaging/observer.cpp \
 modules/adsr.cpp \
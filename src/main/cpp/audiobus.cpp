@@ -0,0 +1,110 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "audiobus.h"
+#include "audioengine.h"
+#include "routinggraph.h"
+#include <utilities/volumeutil.h>
+
+namespace MWEngine {
+
+/* constructor / destructor */
+
+AudioBus::AudioBus( float aVolume )
+{
+    processingChain = new ProcessingChain();
+    _outputBus      = nullptr;
+    _outputBuffer   = nullptr;
+
+    setVolume( aVolume );
+}
+
+AudioBus::~AudioBus()
+{
+    // unregisters the bus and reroutes all sources outputting into this bus (upon
+    // return the render thread no longer references this bus)
+    AudioEngine::routing->removeBus( this );
+
+    delete processingChain;
+    processingChain = nullptr;
+}
+
+/* public methods */
+
+float AudioBus::getVolume()
+{
+    return VolumeUtil::toLinear( _volume );
+}
+
+float AudioBus::getVolumeLogarithmic()
+{
+    return _volume;
+}
+
+void AudioBus::setVolume( float value )
+{
+    _volume = VolumeUtil::toLog( value );
+}
+
+bool AudioBus::setOutputBus( AudioBus* bus )
+{
+    for ( AudioBus* output = bus; output != nullptr; output = output->getOutputBus())
+    {
+        if ( output == this )
+            return false;
+    }
+    _outputBus = bus;
+
+    AudioEngine::routing->rebuild();
+
+    return true;
+}
+
+AudioBus* AudioBus::getOutputBus()
+{
+    return _outputBus;
+}
+
+AudioBuffer* AudioBus::getOutputBuffer()
+{
+    return _outputBuffer.load();
+}
+
+void AudioBus::setOutputBuffer( AudioBuffer* buffer )
+{
+    _outputBuffer.store( buffer );
+}
+
+void AudioBus::process( bool isMonoSource )
+{
+    std::vector<BaseProcessor*> processors = processingChain->getActiveProcessors();
+
+    for ( size_t k = 0; k < processors.size(); ++k )
+        processors[ k ]->process( _outputBuffer.load(), isMonoSource );
+}
+
+void AudioBus::mixBuffer( AudioBuffer* bufferToMixInto )
+{
+    bufferToMixInto->mergeBuffers( _outputBuffer.load(), 0, 0, _volume );
+}
+
+} // E.O namespace MWEngine
@@ -0,0 +1,95 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__AUDIOBUS_H_INCLUDED__
+#define __MWENGINE__AUDIOBUS_H_INCLUDED__
+
+#include "audiobuffer.h"
+#include "processingchain.h"
+#include <atomic>
+
+namespace MWEngine {
+
+/**
+ * AudioBus accumulates the output of multiple sources, applies its ProcessingChain
+ * once onto the accumulated signal and mixes the result into its output bus
+ *
+ * a bus can serve as a group bus: AudioChannels (see AudioChannel::setOutputBus()) and
+ * other buses output into the bus instead of into the master bus (e.g. all drums share
+ * a compressor). A bus can also serve as an auxiliary (send / return) bus: AudioChannels
+ * send a portion of their output into the bus (see AudioChannel::setSendLevel()), so a
+ * single effect (e.g. a reverb) serves many channels
+ *
+ * buses are processed by the AudioEngine once registered in its routing graph
+ * (see RoutingGraph), which also provides the output buffer of the bus
+ */
+class AudioBus
+{
+    public:
+
+        AudioBus( float aVolume );
+        ~AudioBus();
+
+        ProcessingChain* processingChain;
+
+        /**
+         * volume (of the bus output) is given in a percentile (0 - 1) range
+         * this will internally be scaled against a logarithmic
+         * scale for more natural sounding results
+         */
+        float getVolume();
+        float getVolumeLogarithmic();
+        void setVolume( float value );
+
+        /**
+         * routes the output of this bus into given bus (buses can nest), nullptr routes the
+         * output into the master bus. Returns false (leaving the routing unchanged) when
+         * given bus is (or outputs into) this bus, as this would create a cycle
+         */
+        bool setOutputBus( AudioBus* bus );
+        AudioBus* getOutputBus();
+
+        /**
+         * the buffer into which all sources of this bus are accumulated upon each iteration
+         * of the AudioEngine's render cycle. This is provided by the routing graph once the
+         * bus has been registered (nullptr otherwise)
+         */
+        AudioBuffer* getOutputBuffer();
+        void setOutputBuffer( AudioBuffer* buffer );
+
+        // applies the processing chain onto the accumulated sources
+
+        void process( bool isMonoSource );
+
+        // merges the contents of the output buffer into given bufferToMixInto (at the bus volume)
+
+        void mixBuffer( AudioBuffer* bufferToMixInto );
+
+    protected:
+
+        float _volume;
+        AudioBus* _outputBus;
+        std::atomic<AudioBuffer*> _outputBuffer; // read by the render thread
+};
+} // E.O namespace MWEngine
+
+#endif
@@ -22,10 +22,13 @@
  */
 #include "audiochannel.h"
 #include <utilities/volumeutil.h>
+#include <algorithm>
+#include <thread>
 
 namespace MWEngine {
 
 unsigned int AudioChannel::INSTANCE_COUNT = 0;
+const int AudioChannel::MAX_SENDS;
 
 /* constructor / destructor */
 
@@ -47,6 +50,8 @@ AudioChannel::~AudioChannel()
     reset();
     --INSTANCE_COUNT;
 
+    unfreeze();
+
     delete _outputBuffer;
     delete _cachedBuffer;
     delete processingChain;
@@ -141,23 +146,27 @@ AudioBuffer* AudioChannel::getOutputBuffer()
 }
 
 void AudioChannel::mixBuffer( AudioBuffer* bufferToMixInto, float mixVolume ) {
+    mixBuffer( _outputBuffer, bufferToMixInto, 0, mixVolume );
+}
+
+void AudioChannel::mixBuffer( AudioBuffer* sourceBuffer, AudioBuffer* bufferToMixInto, int writeOffset, float mixVolume ) {
 
     // if channels panning is set to center, use AudioBuffer mix method
 
     if ( _pan == 0 ) {
-        bufferToMixInto->mergeBuffers( _outputBuffer, 0, 0, mixVolume );
+        bufferToMixInto->mergeBuffers( sourceBuffer, 0, writeOffset, mixVolume );
     }
     else {
 
-        int buffersToWrite = std::min( bufferToMixInto->bufferSize, _outputBuffer->bufferSize );
+        int buffersToWrite = std::min( bufferToMixInto->bufferSize - writeOffset, sourceBuffer->bufferSize );
 
         // TODO: currently stereo only
         // assumption that buffers have equal amount of channels
 
-        SAMPLE_TYPE* leftSrcBuffer     = _outputBuffer->getBufferForChannel( 0 );
-        SAMPLE_TYPE* rightSrcBuffer    = _outputBuffer->getBufferForChannel( 1 );
-        SAMPLE_TYPE* leftTargetBuffer  = bufferToMixInto->getBufferForChannel( 0 );
-        SAMPLE_TYPE* rightTargetBuffer = bufferToMixInto->getBufferForChannel( 1 );
+        SAMPLE_TYPE* leftSrcBuffer     = sourceBuffer->getBufferForChannel( 0 );
+        SAMPLE_TYPE* rightSrcBuffer    = sourceBuffer->getBufferForChannel( 1 );
+        SAMPLE_TYPE* leftTargetBuffer  = bufferToMixInto->getBufferForChannel( 0 ) + writeOffset;
+        SAMPLE_TYPE* rightTargetBuffer = bufferToMixInto->getBufferForChannel( 1 ) + writeOffset;
 
         // apply pan to output volume
         float leftVolume  = mixVolume * _leftVolume;
@@ -178,6 +187,117 @@ void AudioChannel::mixBuffer( AudioBuffer* bufferToMixInto, float mixVolume ) {
     }
 }
 
+void AudioChannel::freeze( AudioBuffer* buffer, int rangeStart, int rangeEnd, int amountOfProcessors )
+{
+    unfreeze();
+
+    _frozenStart      = rangeStart;
+    _frozenEnd        = rangeEnd;
+    _frozenProcessors = amountOfProcessors;
+
+    // publish the buffer after its properties have been set
+
+    _frozenBuffer.store( buffer );
+}
+
+void AudioChannel::unfreeze()
+{
+    AudioBuffer* buffer = _frozenBuffer.exchange( nullptr );
+
+    if ( buffer == nullptr )
+        return;
+
+    // wait for the rendering thread to finish reading before deleting
+
+    while ( _frozenReaders > 0 )
+        std::this_thread::yield();
+
+    delete buffer;
+}
+
+bool AudioChannel::isFreezing()
+{
+    return _freezing;
+}
+
+void AudioChannel::setFreezing( bool value )
+{
+    _freezing = value;
+
+    if ( !value )
+        return;
+
+    while ( _renderers > 0 )
+        std::this_thread::yield();
+}
+
+bool AudioChannel::beginRender()
+{
+    // register as renderer prior to reading the freezing state (see setFreezing())
+
+    ++_renderers;
+
+    if ( _freezing ) {
+        --_renderers;
+        return false;
+    }
+    return true;
+}
+
+void AudioChannel::endRender()
+{
+    --_renderers;
+}
+
+bool AudioChannel::isFrozen()
+{
+    return _frozenBuffer.load() != nullptr;
+}
+
+int AudioChannel::getFrozenProcessorAmount()
+{
+    return _frozenProcessors;
+}
+
+bool AudioChannel::readFrozenBuffer( AudioBuffer* aOutputBuffer, int aReadOffset )
+{
+    // register as reader prior to reading the buffer pointer so
+    // unfreeze() can't delete the buffer while it is being read
+
+    ++_frozenReaders;
+
+    AudioBuffer* buffer = _frozenBuffer.load();
+
+    if ( buffer == nullptr ) {
+        --_frozenReaders;
+        return false;
+    }
+
+    int rangeLength    = _frozenEnd - _frozenStart + 1;
+    int outputChannels = aOutputBuffer->amountOfChannels;
+
+    for ( int i = 0, l = aOutputBuffer->bufferSize; i < l; ++i )
+    {
+        // positions exceeding the range continue from its start (e.g. sequencer loop)
+
+        int readPointer = aReadOffset + i - _frozenStart;
+
+        if ( readPointer >= rangeLength )
+            readPointer %= rangeLength;
+
+        if ( readPointer < 0 || readPointer >= buffer->bufferSize )
+            continue;
+
+        for ( int c = 0; c < outputChannels; ++c ) {
+            aOutputBuffer->getBufferForChannel( c )[ i ] +=
+                buffer->getBufferForChannel( std::min( c, buffer->amountOfChannels - 1 ))[ readPointer ];
+        }
+    }
+    --_frozenReaders;
+
+    return true;
+}
+
 /**
  * write the current contents of the buffer
  * into the cached buffer
@@ -228,6 +348,94 @@ void AudioChannel::setPan( float value )
     _rightVolume = ( _pan > 0 ) ? 1 : _pan + 1;
 }
 
+bool AudioChannel::setSendLevel( AudioBus* bus, float level )
+{
+    std::lock_guard<std::mutex> guard( _sendLock );
+
+    int freeSlot = -1;
+
+    for ( int i = 0; i < MAX_SENDS; ++i )
+    {
+        AudioBus* sendBus = _sendBuses[ i ].load();
+
+        if ( sendBus == nullptr && freeSlot < 0 )
+            freeSlot = i;
+
+        if ( sendBus != bus )
+            continue;
+
+        if ( level > 0.f )
+            _sendLevels[ i ].store( level );
+        else
+            _sendBuses[ i ].store( nullptr );
+
+        return true;
+    }
+
+    if ( level <= 0.f )
+        return true;
+
+    if ( freeSlot < 0 )
+        return false;
+
+    // store the level before publishing the bus, so the render thread never reads a stale level
+
+    _sendLevels[ freeSlot ].store( level );
+    _sendBuses [ freeSlot ].store( bus );
+
+    return true;
+}
+
+float AudioChannel::getSendLevel( AudioBus* bus )
+{
+    for ( int i = 0; i < MAX_SENDS; ++i )
+    {
+        if ( _sendBuses[ i ].load() == bus )
+            return _sendLevels[ i ].load();
+    }
+    return 0.f;
+}
+
+bool AudioChannel::hasSends()
+{
+    for ( int i = 0; i < MAX_SENDS; ++i )
+    {
+        if ( _sendBuses[ i ].load() != nullptr )
+            return true;
+    }
+    return false;
+}
+
+void AudioChannel::mixSends( float mixVolume )
+{
+    if ( mixVolume == 0.f )
+        return;
+
+    for ( int i = 0; i < MAX_SENDS; ++i )
+    {
+        AudioBus* bus = _sendBuses[ i ].load();
+
+        if ( bus == nullptr )
+            continue;
+
+        AudioBuffer* busBuffer = bus->getOutputBuffer();
+
+        // bus not registered in the engine routing ? omit the send
+        if ( busBuffer != nullptr )
+            mixBuffer( busBuffer, mixVolume * _sendLevels[ i ].load());
+    }
+}
+
+void AudioChannel::setOutputBus( AudioBus* bus )
+{
+    _outputBus.store( bus );
+}
+
+AudioBus* AudioChannel::getOutputBus()
+{
+    return _outputBus.load();
+}
+
 /* protected methods */
 
 void AudioChannel::init()
@@ -239,15 +447,28 @@ void AudioChannel::init()
     instanceId         = ++INSTANCE_COUNT;
     _canCache          = false;
     _outputBuffer      = nullptr;
+    _outputBus         = nullptr;
     _cachedBuffer      = nullptr;
     _cacheReadPointer  = 0;
     _cacheWritePointer = 0;
     _cacheStartOffset  = 0;
     _cacheEndOffset    = 0;
+    _frozenBuffer      = nullptr;
+    _frozenReaders     = 0;
+    _frozenStart       = 0;
+    _frozenEnd         = 0;
+    _frozenProcessors  = 0;
+    _freezing          = false;
+    _renderers         = 0;
     _volume            = VolumeUtil::toLog( 1.0 );
     maxBufferPosition  = 0;
     processingChain    = new ProcessingChain();
 
+    for ( int i = 0; i < MAX_SENDS; ++i ) {
+        _sendBuses [ i ].store( nullptr );
+        _sendLevels[ i ].store( 0.f );
+    }
+
     setPan( 0 );
     createOutputBuffer();
 }
@@ -24,8 +24,11 @@
 #define __MWENGINE__AUDIOCHANNEL_H_INCLUDED__
 
 #include "audiobuffer.h"
+#include "audiobus.h"
 #include "processingchain.h"
 #include <events/baseaudioevent.h>
+#include <atomic>
+#include <mutex>
 #include <vector>
 
 namespace MWEngine {
@@ -104,6 +107,35 @@ class AudioChannel
         float getPan();
         void setPan( float value ); // -1 (fully left) 0 (center) +1 (fully right)
 
+        /**
+         * an AudioChannel can send (post fader) a portion of its output into up to MAX_SENDS
+         * auxiliary buses (e.g. a single reverb shared by multiple channels). The send level is
+         * given in a percentile (0 - 1) range, setting it to 0 removes the send. Returns false
+         * when the send could not be added as all MAX_SENDS slots are in use.
+         *
+         * sends can be changed while the render thread is mixing them (slots are updated
+         * atomically), deleting a bus removes all sends to it before it is freed
+         */
+        static const int MAX_SENDS = 8;
+
+        bool setSendLevel( AudioBus* bus, float level );
+        float getSendLevel( AudioBus* bus );
+        bool hasSends();
+
+        /**
+         * merges the contents of the AudioChannels output buffer into the output
+         * buffers of the buses it sends to, at given mixVolume multiplied by the
+         * send level. This is queried by AudioEngine during render cycle
+         */
+        void mixSends( float mixVolume );
+
+        /**
+         * routes the output of this channel into given (group) bus instead of
+         * into the master bus. nullptr routes the output into the master bus
+         */
+        void setOutputBus( AudioBus* bus );
+        AudioBus* getOutputBus();
+
         /**
          * AudioChannel has its own output buffer which will contain
          * the channels contents upon each iteration of the AudioEngine's render cycle
@@ -121,6 +153,13 @@ class AudioChannel
          */
         void mixBuffer( AudioBuffer* bufferToMixInto, float mixVolume );
 
+        /**
+         * merges the contents of given sourceBuffer (e.g. audio rendered for this
+         * channel outside of the render cycle, see AudioRenderer) into given bufferToMixInto
+         * at given writeOffset, applying this channels stereo panning
+         */
+        void mixBuffer( AudioBuffer* sourceBuffer, AudioBuffer* bufferToMixInto, int writeOffset, float mixVolume );
+
         /**
          * AudioChannel can also have a large cache buffer that holds pre-rendered
          * contents. Use this sparingly (for instance on compositions that are only a few
@@ -136,6 +175,38 @@ class AudioChannel
 
         // to spare CPU resources an AudioChannel can cache its contents
 
+        /**
+         * a "frozen" AudioChannel plays back a pre-rendered buffer holding the output of its
+         * sequenced events (with the first amountOfProcessors of its processing chain applied)
+         * rather than rendering these in real time. See Freezer for creating frozen buffers.
+         *
+         * given buffer spans the range from rangeStart to rangeEnd (after which playback loops)
+         * and is owned by this AudioChannel. Freezing and unfreezing can be done from any
+         * thread (but not during rendering), a previously frozen buffer is deleted once it has
+         * been read by the rendering thread
+         */
+        void freeze( AudioBuffer* buffer, int rangeStart, int rangeEnd, int amountOfProcessors );
+        void unfreeze();
+        bool isFrozen();
+        int getFrozenProcessorAmount();
+
+        // invoked by the rendering thread to mix the frozen buffer at given
+        // sequencer position, returns false when the channel isn't frozen
+
+        bool readFrozenBuffer( AudioBuffer* aOutputBuffer, int aReadOffset );
+
+        // whether the frozen buffer is being rendered, during which the rendering
+        // thread omits this channel (as the render shares its events and processors)
+
+        bool isFreezing();
+        void setFreezing( bool value ); // when true, waits for the rendering thread to finish rendering this channel
+
+        // invoked by the rendering thread around rendering this channel, beginRender()
+        // returns false when the channel is not to be rendered (e.g. while freezing)
+
+        bool beginRender();
+        void endRender();
+
     protected:
 
         static unsigned int INSTANCE_COUNT;
@@ -157,6 +228,23 @@ class AudioChannel
         // the sequencer must read from the cache
         int _cacheStartOffset;
         int _cacheEndOffset;
+
+        std::atomic<bool> _freezing;
+        std::atomic<int> _renderers;
+        std::atomic<AudioBuffer*> _frozenBuffer;
+        std::atomic<int> _frozenReaders;
+        int _frozenStart;
+        int _frozenEnd;
+        int _frozenProcessors;
+
+        // the auxiliary buses this channel sends to and their send levels (an empty slot
+        // has no bus), only mutated under _sendLock as the render thread reads these lock-free
+
+        std::atomic<AudioBus*> _sendBuses [ MAX_SENDS ];
+        std::atomic<float>     _sendLevels[ MAX_SENDS ];
+        std::mutex _sendLock;
+
+        std::atomic<AudioBus*> _outputBus; // read by the render thread
 };
 } // E.O namespace MWEngine
 
@@ -31,6 +31,11 @@
 #include <events/baseaudioevent.h>
 #include <utilities/bufferutility.h>
 #include <utilities/debug.h>
+#include <utilities/freezer.h>
+#include <utilities/inputcapture.h>
+#include <utilities/levelmeter.h>
+#include <chrono>
+#include <thread>
 #include <vector>
 
 #ifdef RECORD_TO_DISK
@@ -80,6 +85,12 @@ namespace MWEngine {
     int   AudioEngine::time_sig_beat_unit         = 4;
     int   AudioEngine::queuedTime_sig_beat_amount = time_sig_beat_amount;
     int   AudioEngine::queuedTime_sig_beat_unit   = time_sig_beat_unit;
+    TempoMap* AudioEngine::tempoMap               = nullptr;
+    TempoMap* AudioEngine::queuedTempoMap         = nullptr;
+    unsigned int AudioEngine::tempoMapVersion       = 0;
+    unsigned int AudioEngine::queuedTempoMapVersion = 0;
+    int   AudioEngine::tempoMapNextChange         = -1;
+    int   AudioEngine::tempoMapNextStep           = -1;
 
     /* buffer read/write pointers */
 
@@ -92,6 +103,7 @@ namespace MWEngine {
 
     float            AudioEngine::volume    = 1.0f;
     ProcessingChain* AudioEngine::masterBus = new ProcessingChain();
+    RoutingGraph*    AudioEngine::routing   = new RoutingGraph();
 
     /* private properties */
 
@@ -107,6 +119,10 @@ namespace MWEngine {
 
     int AudioEngine::thread = 0;
 
+    std::atomic<unsigned long> AudioEngine::renderCyclesStarted( 0 );
+    std::atomic<unsigned long> AudioEngine::renderCyclesCompleted( 0 );
+    std::atomic<std::thread::id> AudioEngine::renderThreadId;
+
     /* public methods */
 
     void AudioEngine::setup( int bufferSize, int sampleRate, int amountOfChannels )
@@ -166,6 +182,8 @@ namespace MWEngine {
         for ( int i = 0; i < instruments.size(); ++i )
             instruments.at( i )->audioChannel->createOutputBuffer();
 
+        routing->createOutputBuffers();
+
         // start thread and request first render (gets render loop going)
 
         thread = 1;
@@ -223,6 +241,21 @@ namespace MWEngine {
         recordOutputToDisk = false;
         recordInputToDisk  = false;
         bouncing           = false;
+
+        LevelMeter::reset();
+    }
+
+    void AudioEngine::waitForRenderCycle()
+    {
+        unsigned long started = renderCyclesStarted.load();
+
+        while ( renderCyclesCompleted.load() < started )
+            std::this_thread::sleep_for( std::chrono::milliseconds( 1 ));
+    }
+
+    bool AudioEngine::isRenderThread()
+    {
+        return renderThreadId.load( std::memory_order_relaxed ) == std::this_thread::get_id();
     }
 
     AudioChannel* AudioEngine::getInputChannel()
@@ -239,12 +272,23 @@ namespace MWEngine {
         if ( thread == 0 )
             return false;
 
+        ++renderCyclesStarted;
+        renderThreadId.store( std::this_thread::get_id(), std::memory_order_relaxed );
+
         int i, c, ci;
         float sample;
 
         // erase previous buffer contents
         inBuffer->silenceBuffers();
 
+        routing->prepare();
+
+        // tempo map applied ? sync the tempo and time signature to the current position
+        // (note this is also done at sample accuracy when reaching a change during the write loop below)
+
+        if ( tempoMap != nullptr )
+            syncTempoMap( bufferPosition );
+
         // gather the audio events by the buffer range currently being processed
         loopStarted = Sequencer::getAudioEvents( channels, bufferPosition, amountOfSamples, true, true );
 
@@ -258,7 +302,7 @@ namespace MWEngine {
 
 #ifdef RECORD_DEVICE_INPUT
         // record audio from Android device ?
-        if (( recordDeviceInput || recordInputToDisk ) && AudioEngineProps::INPUT_CHANNELS > 0 )
+        if (( recordDeviceInput || recordInputToDisk || InputCapture::isCalibrating() ) && AudioEngineProps::INPUT_CHANNELS > 0 )
         {
             int recSamps                  = DriverAdapter::getInput( recbufferIn );
             SAMPLE_TYPE* recBufferChannel = inputChannel->getOutputBuffer()->getBufferForChannel( 0 );
@@ -277,18 +321,32 @@ namespace MWEngine {
             if ( inputChannel->getVolume() > 0.f ) {
                 inputChannel->mixBuffer( inBuffer, inputChannel->getVolume() );
             }
+
+            // record input (compensated for latency) when requested, note recording is
+            // only done when RECORD_TO_DISK is defined and the DiskWriter has been prepared
+
+            InputCapture::processInput( inputChannel->getOutputBuffer(), recSamps, recordInputToDisk );
         }
 #endif
         // channel loop
         int j = 0;
         int channelAmount = channels->size();
+        bool metering     = LevelMeter::isEnabled();
+        int meterSlot     = 1; // slot 0 is reserved for the master bus
+
+#ifdef RECORD_TO_DISK
+        // whether to record the output of each channel into a separate file
+        bool recordStems = Sequencer::playing && recordOutputToDisk && DiskWriter::hasStems();
+#endif
 
         for ( ; j < channelAmount; ++j )
         {
             AudioChannel* channel = channels->at( j );
+            bool isFrozen         = channel->isFrozen();              // whether this channel plays back a frozen buffer (see Freezer)
             bool isCached         = channel->hasCache;                // whether this channel has a fully cached buffer
-            bool mustCache        = AudioEngineProps::CHANNEL_CACHING && channel->canCache() && !isCached; // whether to cache this channels output
+            bool mustCache        = AudioEngineProps::CHANNEL_CACHING && channel->canCache() && !isCached && !isFrozen; // whether to cache this channels output
             int cacheReadPos      = 0;  // the offset we start ready from the channel buffer (when writing to cache)
+            int firstProcessor    = 0;  // index of the first processor to apply (frozen channels have the preceding ones applied)
 
             std::vector<BaseAudioEvent*> audioEvents = channel->audioEvents;
             int amount = audioEvents.size();
@@ -299,7 +357,9 @@ namespace MWEngine {
             // get channel output buffer and clear previous contents
             AudioBuffer* channelBuffer = channel->getOutputBuffer();
 
-            if ( channelBuffer == nullptr ) continue;
+            // channels that are being frozen are omitted until freezing completes
+
+            if ( channelBuffer == nullptr || !channel->beginRender()) continue;
 
             channelBuffer->silenceBuffers();
 
@@ -317,7 +377,12 @@ namespace MWEngine {
             // only render sequenced events when the sequencer isn't in the paused state
             // and the channel volume is actually at an audible level! ( > 0 )
 
-            if ( Sequencer::playing && amount > 0 && channelVolume > 0.0 )
+            if ( Sequencer::playing && isFrozen && channelVolume > 0.0 &&
+                 channel->readFrozenBuffer( channelBuffer, bufferPos ))
+            {
+                firstProcessor = channel->getFrozenProcessorAmount();
+            }
+            else if ( Sequencer::playing && amount > 0 && channelVolume > 0.0 )
             {
                 if ( !isCached )
                 {
@@ -355,7 +420,7 @@ namespace MWEngine {
             ProcessingChain* chain = channel->processingChain;
             std::vector<BaseProcessor*> processors = chain->getActiveProcessors();
 
-            for ( int k = 0; k < processors.size(); k++ )
+            for ( int k = firstProcessor; k < processors.size(); k++ )
             {
                 BaseProcessor* processor = processors[ k ];
                 bool canCacheProcessor   = processor->isCacheable();
@@ -381,15 +446,46 @@ namespace MWEngine {
             if ( channel->hasLiveEvents && channelVolume == 0.0 )
                 channelVolume = 1.0;
 
-            channel->mixBuffer( inBuffer, channelVolume );
+            if ( metering )
+                LevelMeter::measure( meterSlot++, channel->instanceId, channelBuffer, amountOfSamples, channelVolume );
+
+#ifdef RECORD_TO_DISK
+            if ( recordStems )
+                DiskWriter::appendStem( channel, channelBuffer, amountOfSamples, channelVolume );
+#endif
+
+            // mix into the group bus the channel outputs into (when registered) or into the master bus
+
+            AudioBus* outputBus       = channel->getOutputBus();
+            AudioBuffer* outputBuffer = outputBus != nullptr ? outputBus->getOutputBuffer() : nullptr;
+
+            channel->mixBuffer( outputBuffer != nullptr ? outputBuffer : inBuffer, channelVolume );
+
+            // accumulate the sends into the auxiliary buses (post fader)
+            if ( channel->hasSends())
+                channel->mixSends( channelVolume );
+
+            channel->endRender();
         }
 
+        // apply the group and auxiliary bus processors (once for all their sources) in
+        // scheduled order and mix the buses outputting into the master bus
+
+        routing->process( inBuffer, isMono );
+
         // apply master bus processors (e.g. high pass filter, limiter, etc.)
         std::vector<BaseProcessor*> processors = masterBus->getActiveProcessors();
 
         for ( int k = 0; k < processors.size(); k++ )
             processors[ k ]->process( inBuffer, isMono );
 
+        // measure the levels of the master bus and publish the levels of all channels
+
+        if ( metering ) {
+            LevelMeter::measure( 0, LevelMeter::MASTER_ID, inBuffer, amountOfSamples, volume );
+            LevelMeter::publish( meterSlot, amountOfSamples );
+        }
+
         // write the accumulated buffers into the output buffer
         for ( i = 0, c = 0; i < amountOfSamples; i++, c += outputChannels )
         {
@@ -399,6 +495,7 @@ namespace MWEngine {
                 sample = ( float ) inBuffer->getBufferForChannel( ci )[ i ] * volume;
 
                 // and perform a fail-safe check in case we're exceeding the headroom ceiling
+                // (this should not engage when the master bus ends in a LookAheadLimiter)
 
                 if ( sample < -0.9999 )
                     sample = -0.9999f;
@@ -415,7 +512,18 @@ namespace MWEngine {
             // update the buffer pointers and sequencer position
             if ( Sequencer::playing )
             {
-                if ( bufferPosition % ( int ) samples_per_step == 0 )
+                if ( tempoMap != nullptr )
+                {
+                    // the tempo and time signature change at the exact position of the change in the map
+                    // (splitting the sequencer position updates at the change point)
+
+                    if ( bufferPosition == tempoMapNextChange )
+                        syncTempoMap( bufferPosition );
+
+                    if ( bufferPosition == tempoMapNextStep )
+                        handleSequencerPositionUpdate( i );
+                }
+                else if ( bufferPosition % ( int ) samples_per_step == 0 )
                 {
                     // for higher accuracy we must calculate using floating point precision, it
                     // is a more expensive calculation than using integer modulo though, so we check
@@ -430,7 +538,12 @@ namespace MWEngine {
                 bufferPosition++;
 
                 if ( bufferPosition > max_buffer_position )
+                {
                     bufferPosition = min_buffer_position;
+
+                    if ( tempoMap != nullptr )
+                        syncTempoMap( bufferPosition );
+                }
             }
         }
 
@@ -438,12 +551,19 @@ namespace MWEngine {
         // the output into the audio hardware will lock execution until the next buffer
         // is enqueued (additionally, we prevent writing to device storage when recording/bouncing)
 
-        if ( thread == 0 )
+        if ( thread == 0 ) {
+            ++renderCyclesCompleted;
             return false;
+        }
 
         // write the synthesized output into the audio driver (unless we are bouncing as writing the
         // output to the hardware makes it both unnecessarily audible and stalls execution)
 
+#ifdef RECORD_DEVICE_INPUT
+        // inject the latency calibration signal (when calibration has been requested)
+        InputCapture::processOutput( outBuffer, amountOfSamples, outputChannels );
+#endif
+
         if ( !bouncing )
             DriverAdapter::writeOutput( outBuffer, amountOfSamples * outputChannels );
 
@@ -451,26 +571,20 @@ namespace MWEngine {
         // write the output to disk if a recording state is active
         if (( Sequencer::playing && recordOutputToDisk ) || recordInputToDisk )
         {
-#ifdef RECORD_DEVICE_INPUT
-            if ( recordInputToDisk ) // recording from device input ? > write the record buffer
-                DiskWriter::appendBuffer( inputChannel->getOutputBuffer() );
-            else                    // recording global output ? > write the combined buffer
-#endif
+            // recording from device input is handled by InputCapture (see above)
+            // otherwise we're recording global output > write the combined buffer
+
+            if ( !recordInputToDisk )
                 DiskWriter::appendBuffer( outBuffer, amountOfSamples, outputChannels );
 
             // are we bouncing the current sequencer range and have we played through the full range?
 
             if ( bouncing && ( loopStarted || bufferPosition == bounceRangeStart || bufferPosition >= bounceRangeEnd ))
             {
-                // write current snippet onto disk and finish recording
-                // (this can be done synchronously as rendering will now halt)
-
-                DiskWriter::writeBufferToFile( DiskWriter::currentBufferIndex, false );
-                DiskWriter::finish();
-
-                // broadcast update via JNI
+                // write the remainder of the recording onto disk and finish recording, this is
+                // handed to the writer threads which broadcast the update (via JNI) once complete
 
-                Notifier::broadcast( Notifications::BOUNCE_COMPLETE );
+                DiskWriter::finishAsync( Notifications::BOUNCE_COMPLETE );
 
                 // stops thread, halts rendering
 
@@ -480,29 +594,21 @@ namespace MWEngine {
                 bouncing           =
                 recordOutputToDisk = false;
 
+                ++renderCyclesCompleted;
                 return false;
             }
-
-            // exceeded maximum recording buffer amount ? > write current recording to temporary storage
-
-            if ( DiskWriter::bufferFull())
-            {
-                // when bouncing do this synchronously (engine is not writing to hardware), otherwise
-                // broadcast that a snippet has recorded in full and can be written onto storage
-
-                if ( bouncing )
-                    DiskWriter::writeBufferToFile( DiskWriter::currentBufferIndex, false );
-                else
-                    Notifier::broadcast( Notifications::RECORDED_SNIPPET_READY, DiskWriter::currentBufferIndex );
-
-                DiskWriter::prepareSnippet();
-            }
         }
 #endif
-        // tempo update queued ?
-        if ( queuedTempo != tempo )
+        // tempo map update queued ?
+        if ( queuedTempoMap != tempoMap || queuedTempoMapVersion != tempoMapVersion )
+            handleTempoMapUpdate( queuedTempoMap );
+
+        // tempo update queued ? (only applies when no tempo map is set, as the map dictates the tempo)
+        if ( queuedTempo != tempo && tempoMap == nullptr )
             handleTempoUpdate( queuedTempo, true );
 
+        ++renderCyclesCompleted;
+
 #if DRIVER == 1
         // bit fugly, during bounce on AAudio driver, keep render loop going until bounce completes
         if ( bouncing && thread == 1 )
@@ -517,8 +623,12 @@ namespace MWEngine {
     {
         float ratio = 1;
 
+        // note positions are absolute when a tempo map is applied (and are not rescaled)
+
         if ( broadcastUpdate ) {
-            ratio = tempo / aQueuedTempo;
+            if ( tempoMap == nullptr )
+                ratio = tempo / aQueuedTempo;
+
             tempo = aQueuedTempo;
         };
 
@@ -529,48 +639,64 @@ namespace MWEngine {
         samples_per_beat = samples_per_bar / time_sig_beat_amount;
         samples_per_step = samples_per_bar / steps_per_bar;
 
-        int loopLength = max_buffer_position - min_buffer_position;
+        // make sure relative positions remain in sync (when unchanged, these are left as is as
+        // single precision floats cannot represent all sample positions of longer sequences)
+
+        if ( ratio != 1 )
+        {
+            int loopLength = max_buffer_position - min_buffer_position;
 
-        min_buffer_position = ( int )(( float ) min_buffer_position * ratio );
-        max_buffer_position = min_buffer_position + ( int )(( float ) loopLength * ratio );
+            min_buffer_position = ( int )(( float ) min_buffer_position * ratio );
+            max_buffer_position = min_buffer_position + ( int )(( float ) loopLength * ratio );
 
-        // make sure relative positions remain in sync
-        bufferPosition = ( int )(( float ) bufferPosition * ratio );
-        if ( marked_buffer_position > 0 ) {
-            marked_buffer_position = ( int )(( float ) marked_buffer_position * ratio );
+            bufferPosition = ( int )(( float ) bufferPosition * ratio );
+            if ( marked_buffer_position > 0 ) {
+                marked_buffer_position = ( int )(( float ) marked_buffer_position * ratio );
+            }
         }
 
-        // inform sequencer of the update
-        Sequencer::updateEvents();
+        // note the events of the sequencer are not updated here, each event is positioned in
+        // musical time and syncs its buffer range to the new tempo / time signature lazily, once
+        // it is queried by the Sequencer (see BaseAudioEvent::syncTiming())
 
-        // broadcast update (so the Sequencer can invoke a re-calculation
-        // on all existing audio events to match the new tempo / time signature)
+        Freezer::requestUpdate(); // frozen buffers are rendered for the previous tempo
 
         if ( broadcastUpdate )
-        {
-#ifdef USE_JNI
-            // when using the engine through JNI with Java, we don't broadcast using
-            // the Notifier, but instantly invoke a callback directly on the bridge
-            // as it allows us to update multiple parameters at once
+            broadcastTempoUpdate();
+    }
 
-            jmethodID native_method_id = JavaBridge::getJavaMethod( JavaAPIs::TEMPO_UPDATED );
+    void AudioEngine::handleTempoMapUpdate( TempoMap* aTempoMap )
+    {
+        tempoMap       = aTempoMap;
+        queuedTempoMap = aTempoMap;
 
-            if ( native_method_id != 0 )
-            {
-                JNIEnv* env = JavaBridge::getEnvironment();
+        tempoMapVersion       = aTempoMap != nullptr ? aTempoMap->getVersion() : 0;
+        queuedTempoMapVersion = tempoMapVersion;
 
-                if ( env != 0 )
-                    env->CallStaticVoidMethod( JavaBridge::getJavaInterface(), native_method_id, AudioEngine::tempo );
-            }
-#else
-            Notifier::broadcast( Notifications::SEQUENCER_TEMPO_UPDATED );
-#endif
-        }
+        tempoMapNextChange = -1;
+        tempoMapNextStep   = -1;
+
+        Freezer::requestUpdate();
+
+        // note that when removing the map, the last tempo and time signature remain
+        // (the sequencer positions are absolute in the map, as such they are not rescaled)
+
+        if ( tempoMap != nullptr )
+            syncTempoMap( bufferPosition );
     }
 
     void AudioEngine::handleSequencerPositionUpdate( int bufferOffset )
     {
-        stepPosition = ( int ) floor( bufferPosition / samples_per_step );
+        if ( tempoMap != nullptr )
+        {
+            double step  = tempoMap->getStepPosition( tempoMap->getTickPosition( bufferPosition ), steps_per_bar );
+            stepPosition = ( int ) floor( step + 1e-6 );
+
+            tempoMapNextStep = getTempoMapStepPosition( stepPosition + 1 );
+        }
+        else {
+            stepPosition = ( int ) floor( bufferPosition / samples_per_step );
+        }
 
         if ( stepPosition > max_step_position )
             stepPosition = min_step_position;
@@ -578,6 +704,71 @@ namespace MWEngine {
         Notifier::broadcast( Notifications::SEQUENCER_POSITION_UPDATED, bufferOffset );
     }
 
+    void AudioEngine::syncTempoMap( int position )
+    {
+        double ticks   = tempoMap->getTickPosition( position );
+        float mapTempo = tempoMap->getTempo( ticks );
+        int beatAmount = tempoMap->getBeatAmount( ticks );
+        int beatUnit   = tempoMap->getBeatUnit( ticks );
+        int nextChange = tempoMap->getNextChange( position );
+
+        // note during a tempo ramp the tempo is synced per buffer, but only broadcast when reaching a change
+
+        bool update    = mapTempo != tempo || beatAmount != time_sig_beat_amount || beatUnit != time_sig_beat_unit;
+        bool broadcast = update && nextChange != tempoMapNextChange;
+
+        // the tempo map dictates the tempo (discards requests made via SequencerController::setTempo())
+
+        queuedTempo = mapTempo;
+
+        if ( update )
+        {
+            tempo                      = mapTempo;
+            queuedTime_sig_beat_amount = beatAmount;
+            queuedTime_sig_beat_unit   = beatUnit;
+
+            handleTempoUpdate( tempo, false ); // updates the sample based properties for the new tempo / time signature
+        }
+        tempoMapNextChange = nextChange;
+
+        // the next sequencer step (which can be at the current position)
+
+        int step         = ( int ) floor( tempoMap->getStepPosition( ticks, steps_per_bar ) + 1e-6 );
+        tempoMapNextStep = getTempoMapStepPosition( step );
+
+        if ( tempoMapNextStep < position )
+            tempoMapNextStep = getTempoMapStepPosition( step + 1 );
+
+        if ( broadcast )
+            broadcastTempoUpdate();
+    }
+
+    int AudioEngine::getTempoMapStepPosition( int step )
+    {
+        return ( int ) ceil( tempoMap->getSamplePosition( tempoMap->getTickPositionForStep( step, steps_per_bar )));
+    }
+
+    void AudioEngine::broadcastTempoUpdate()
+    {
+#ifdef USE_JNI
+        // when using the engine through JNI with Java, we don't broadcast using
+        // the Notifier, but instantly invoke a callback directly on the bridge
+        // as it allows us to update multiple parameters at once
+
+        jmethodID native_method_id = JavaBridge::getJavaMethod( JavaAPIs::TEMPO_UPDATED );
+
+        if ( native_method_id != 0 )
+        {
+            JNIEnv* env = JavaBridge::getEnvironment();
+
+            if ( env != 0 )
+                env->CallStaticVoidMethod( JavaBridge::getJavaInterface(), native_method_id, AudioEngine::tempo );
+        }
+#else
+        Notifier::broadcast( Notifications::SEQUENCER_TEMPO_UPDATED );
+#endif
+    }
+
     bool AudioEngine::writeChannelCache( AudioChannel* channel, AudioBuffer* channelBuffer, int cacheReadPos )
     {
         // mustCache isn't the same as isCaching (likely sequencer is waiting for start offset ;))
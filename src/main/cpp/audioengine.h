@@ -24,9 +24,13 @@
 #define __MWENGINE__AUDIOENGINE_H_INCLUDED__
 
 #include "audiobuffer.h"
+#include "routinggraph.h"
 #include "audiochannel.h"
 #include "global.h"
 #include "processingchain.h"
+#include <utilities/tempomap.h>
+#include <atomic>
+#include <thread>
 
 namespace MWEngine {
 class AudioEngine
@@ -53,6 +57,16 @@ class AudioEngine
 
         static bool render( int amountOfSamples );
 
+        // blocks until the render cycle in progress (if any) has completed. Invoke (outside of the
+        // render thread) after unpublishing a resource from the render thread, prior to freeing it
+
+        static void waitForRenderCycle();
+
+        // whether the calling thread is the thread running the render cycles (e.g. for
+        // shared state the rendering thread should not wait for when it is in use elsewhere)
+
+        static bool isRenderThread();
+
         /* engine properties */
 
         static int samples_per_beat;      // the amount of samples necessary for a single beat at the current tempo and sample rate
@@ -86,15 +100,26 @@ class AudioEngine
         static int time_sig_beat_unit;          // time signature lower numeral (i.e. the "4" in 3/4)
         static int queuedTime_sig_beat_amount;  // the time signature beat amount the sequencer moves to on next cycle
         static int queuedTime_sig_beat_unit;    // the time signature beat unit the sequencer moves to on next cycle
+        static TempoMap* tempoMap;              // when set, the tempo and time signature follow this map (see SequencerController::setTempoMap())
+        static TempoMap* queuedTempoMap;        // the TempoMap the sequencer will apply once current render cycle completes
+        static unsigned int tempoMapVersion;       // version of the tempoMap contents at the moment it was applied
+        static unsigned int queuedTempoMapVersion; // version of the queuedTempoMap contents (re-applies an altered map)
 
         /* output related */
 
         static float volume;                // master volume
         static ProcessingChain* masterBus;  // processing chain for the master bus
 
+        // the group and auxiliary (send / return) buses registered in the routing graph are processed
+        // once per render cycle, after all channels have been rendered and prior to the master bus
+        // (see AudioChannel::setOutputBus() and AudioChannel::setSendLevel())
+
+        static RoutingGraph* routing;
+
         /* internal methods */
 
         static void handleTempoUpdate( float aQueuedTempo, bool broadcastUpdate );
+        static void handleTempoMapUpdate( TempoMap* aTempoMap );
 
 #ifdef MOCK_ENGINE
 
@@ -123,6 +148,9 @@ class AudioEngine
         static int  loopAmount;   // amount of samples we must read from the current loop ranges start offset (== min_buffer_position)
         static int  outputChannels;
         static bool isMono;
+        static std::atomic<unsigned long> renderCyclesStarted;
+        static std::atomic<unsigned long> renderCyclesCompleted;
+        static std::atomic<std::thread::id> renderThreadId;
         static std::vector<AudioChannel*>* channels;
         static AudioBuffer* inBuffer;
         static float*       outBuffer;
@@ -133,9 +161,17 @@ class AudioEngine
 #endif
         static int thread;
 
+        /* tempo map properties */
+
+        static int tempoMapNextChange; // buffer position of the next change in the tempo map (-1 when none follows)
+        static int tempoMapNextStep;   // buffer position of the next sequencer step in the tempo map
+
         /* internal render methods */
 
         static void handleSequencerPositionUpdate( int bufferOffset );
+        static void syncTempoMap                 ( int position );
+        static int  getTempoMapStepPosition      ( int step );
+        static void broadcastTempoUpdate         ();
         static bool writeChannelCache            ( AudioChannel* channel, AudioBuffer* channelBuffer, int cacheReadPos );
 };
 } // E.O namespace MWEngine
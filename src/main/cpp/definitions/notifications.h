@@ -44,10 +44,17 @@ class Notifications
 
             /* recording actions */
 
-            RECORDED_SNIPPET_READY,     // single snippet is ready for writing to storage
-            RECORDED_SNIPPET_SAVED,     // single snippet has been written to storage and flushed from memory
-            RECORDING_COMPLETED,        // recording has completed in full all snippets have been saved into requested output file, memory and temp files flushed
+            RECORDED_SNIPPET_READY,     // deprecated, recordings are streamed to storage (no longer broadcast)
+            RECORDED_SNIPPET_SAVED,     // deprecated, recordings are streamed to storage (no longer broadcast)
+            RECORDING_COMPLETED,        // recording has completed in full and has been written into the requested output file
             BOUNCE_COMPLETE,            // bouncing has completed, see RECORDING_COMPLETED
+            LATENCY_CALIBRATED,         // input latency calibration has completed, value describes the latency in samples (-1 on failure)
+            RENDER_COMPLETE,            // asynchronous render into memory has completed (see AudioRenderer)
+
+            /* caching */
+
+            BULK_CACHE_PROGRESS,        // BulkCacher has cached an event, value describes the amount of events remaining in its queue
+            BULK_CACHE_COMPLETE,        // BulkCacher has cached all queued events
 
             /* system messages */
 
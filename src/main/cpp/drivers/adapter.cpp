@@ -113,6 +113,17 @@ namespace DriverAdapter {
 
         return 0;
     }
+
+    int getLatency() {
+
+#if DRIVER == 0
+        // OpenSL enqueues a single buffer for both input and output
+        return AudioEngineProps::BUFFER_SIZE * 2;
+#elif DRIVER == 1
+        // AAudio reports the latency of its output stream
+        return ( int )( driver_aAudio->getCurrentOutputLatencyMillis() * AudioEngineProps::SAMPLE_RATE / 1000 );
+#endif
+    }
 }
 
 } // E.O namespace MWEngine
@@ -74,6 +74,10 @@ namespace DriverAdapter {
     // returns integer value of amount of recorded samples
     int getInput( float* recordBuffer );
 
+    // the estimated round-trip latency (in samples) between writing
+    // output into the driver and receiving the same audio at its input
+    int getLatency();
+
 
 #if DRIVER == 0
     // OpenSL
@@ -127,6 +127,11 @@ void BaseAudioEvent::addToSequencer()
     }
 }
 
+void BaseAudioEvent::prefetch()
+{
+    // override in derived classes
+}
+
 void BaseAudioEvent::removeFromSequencer()
 {
     if ( _instrument == nullptr )
@@ -140,11 +145,13 @@ void BaseAudioEvent::removeFromSequencer()
 
 int BaseAudioEvent::getEventLength()
 {
+    syncTiming();
     return _eventLength;
 }
 
 void BaseAudioEvent::setEventLength( int value )
 {
+    syncTiming();
     _eventLength = value;
 
     // the existing event end must not be smaller than (or equal to)
@@ -160,15 +167,18 @@ void BaseAudioEvent::setEventLength( int value )
 
     // update end position in seconds
     _endPosition = BufferUtility::bufferToSeconds( _eventEnd, AudioEngineProps::SAMPLE_RATE );
+    markModified();
 }
 
 int BaseAudioEvent::getEventStart()
 {
+    syncTiming();
     return _eventStart;
 }
 
 void BaseAudioEvent::setEventStart( int value )
 {
+    syncTiming();
     _eventStart = value;
 
     if ( _eventEnd <= _eventStart )
@@ -183,15 +193,19 @@ void BaseAudioEvent::setEventStart( int value )
     }
     // update start position in seconds
     _startPosition = BufferUtility::bufferToSeconds( _eventStart, AudioEngineProps::SAMPLE_RATE );
+    markModified();
 }
 
 int BaseAudioEvent::getEventEnd()
 {
+    syncTiming();
     return _eventEnd;
 }
 
 void BaseAudioEvent::setEventEnd( int value )
 {
+    syncTiming();
+
     // the event end cannot exceed beyond the start and the total
     // event length (it can be smaller though for a cut-off playback)
 
@@ -202,6 +216,100 @@ void BaseAudioEvent::setEventEnd( int value )
 
     // update end position in seconds
     _endPosition = BufferUtility::bufferToSeconds( _eventEnd, AudioEngineProps::SAMPLE_RATE );
+    markModified();
+}
+
+void BaseAudioEvent::syncTiming()
+{
+    // nothing changed since the last sync ? return without locking
+
+    if ( _eventStart == _syncedStart && _eventEnd == _syncedEnd && _eventLength == _syncedLength && isTimingSynced())
+        return;
+
+    std::unique_lock<std::recursive_mutex> guard( _timingLock, std::defer_lock );
+
+    if ( !AudioEngine::isRenderThread())
+        guard.lock();
+    else if ( !guard.try_lock())
+        return;
+
+    // buffer regions have been altered since the last sync ? update the musical
+    // timing (using the tempo (or TempoMap) the regions were positioned at)
+
+    if ( _eventStart != _syncedStart || _eventEnd != _syncedEnd || _eventLength != _syncedLength )
+    {
+        _startTicks  = samplesToTicks( _eventStart );
+        _endTicks    = samplesToTicks( _eventEnd + 1 ); // as the end is inclusive
+        _lengthTicks = samplesToTicks( _eventStart + _eventLength ) - _startTicks;
+
+        _syncedStart  = _eventStart;
+        _syncedEnd    = _eventEnd;
+        _syncedLength = _eventLength;
+    }
+
+    TempoMap* tempoMap      = AudioEngine::tempoMap;
+    unsigned int mapVersion = tempoMap != nullptr ? tempoMap->getVersion() : 0;
+
+    // when a TempoMap is applied, the buffer regions are absolute within the map
+    // (e.g. remain unchanged while the tempo changes along the map during playback)
+
+    if ( mapVersion == _timingMapVersion &&
+       ( mapVersion > 0 || ( _timingTempo == AudioEngine::tempo && _timingStepSize == AudioEngine::samples_per_step )))
+        return;
+
+    // note the sync properties are updated prior to updating the buffer regions so
+    // derived classes can invoke the setters in their updateTiming() implementation
+
+    _timingTempo        = AudioEngine::tempo;
+    _timingStepSize     = AudioEngine::samples_per_step;
+    _timingTicksPerStep = getTicksPerStep();
+    _timingMapVersion   = mapVersion;
+
+    updateTiming();
+
+    _syncedStart  = _eventStart;
+    _syncedEnd    = _eventEnd;
+    _syncedLength = _eventLength;
+}
+
+bool BaseAudioEvent::isTimingSynced()
+{
+    TempoMap* tempoMap      = AudioEngine::tempoMap;
+    unsigned int mapVersion = tempoMap != nullptr ? tempoMap->getVersion() : 0;
+
+    return mapVersion == _timingMapVersion &&
+         ( mapVersion > 0 || ( _timingTempo == AudioEngine::tempo && _timingStepSize == AudioEngine::samples_per_step ));
+}
+
+bool BaseAudioEvent::overlapsTicks( double startTicks, double endTicks )
+{
+    TempoMap* tempoMap = AudioEngine::tempoMap;
+
+    // buffer regions altered since the last sync or a change in time signature (moving
+    // events positioned at sequencer steps) ? the musical timing can't be relied upon
+
+    if ( _eventStart != _syncedStart || _eventEnd != _syncedEnd || _eventLength != _syncedLength ||
+       ( tempoMap == nullptr && _timingTicksPerStep != getTicksPerStep()))
+        return true;
+
+    if ( _startTicks >= endTicks )
+        return false;
+
+    if ( _endTicks > startTicks )
+        return true;
+
+    // the duration of some events is tempo independent (e.g. samples), as
+    // such also determine where their duration ends at the current tempo
+
+    double duration = ( double )( _eventEnd - _eventStart + 1 );
+    double end;
+
+    if ( tempoMap != nullptr )
+        end = tempoMap->getTickPosition( tempoMap->getSamplePosition( _startTicks ) + duration );
+    else
+        end = _startTicks + duration / BufferUtility::getSamplesPerTick( AudioEngineProps::SAMPLE_RATE, AudioEngine::tempo );
+
+    return end > startTicks;
 }
 
 void BaseAudioEvent::positionEvent( int startMeasure, int subdivisions, int offset )
@@ -217,6 +325,7 @@ void BaseAudioEvent::positionEvent( int startMeasure, int subdivisions, int offs
 
 void BaseAudioEvent::setStartPosition( float value )
 {
+    syncTiming();
     _startPosition = value;
 
     if ( _endPosition < _startPosition ) {
@@ -227,10 +336,12 @@ void BaseAudioEvent::setStartPosition( float value )
     // update position in buffer samples
     _eventStart  = BufferUtility::secondsToBuffer( _startPosition, AudioEngineProps::SAMPLE_RATE );
     _eventLength = std::max( 0, ( _eventEnd - 1 ) - _eventStart );
+    markModified();
 }
 
 void BaseAudioEvent::setEndPosition( float value )
 {
+    syncTiming();
     _endPosition = value;
 
     if ( _endPosition < _startPosition ) {
@@ -240,6 +351,7 @@ void BaseAudioEvent::setEndPosition( float value )
     // update position in buffer samples
     _eventEnd    = BufferUtility::secondsToBuffer( _endPosition, AudioEngineProps::SAMPLE_RATE );
     _eventLength = std::max( 0, ( _eventEnd - 1 ) - _eventStart );
+    markModified();
 }
 
 void BaseAudioEvent::setDuration( float value )
@@ -249,16 +361,19 @@ void BaseAudioEvent::setDuration( float value )
 
 float BaseAudioEvent::getStartPosition()
 {
+    syncTiming();
     return _startPosition;
 }
 
 float BaseAudioEvent::getEndPosition()
 {
+    syncTiming();
     return _endPosition;
 }
 
 float BaseAudioEvent::getDuration()
 {
+    syncTiming();
     return _endPosition - _startPosition;
 }
 
@@ -270,6 +385,7 @@ bool BaseAudioEvent::isDeletable()
 void BaseAudioEvent::setDeletable( bool value )
 {
     _deleteMe = value;
+    markModified();
 }
 
 bool BaseAudioEvent::isEnabled()
@@ -280,6 +396,7 @@ bool BaseAudioEvent::isEnabled()
 void BaseAudioEvent::setEnabled( bool value )
 {
     _enabled = value;
+    markModified();
 }
 
 void BaseAudioEvent::lock()
@@ -316,6 +433,7 @@ float BaseAudioEvent::getVolumeLogarithmic()
 void BaseAudioEvent::setVolume( float value )
 {
     _volume = VolumeUtil::toLog( value );
+    markModified();
 }
 
 void BaseAudioEvent::mixBuffer( AudioBuffer* outputBuffer, int bufferPosition,
@@ -390,7 +508,8 @@ void BaseAudioEvent::mixBuffer( AudioBuffer* outputBuffer, int bufferPosition,
                     srcBuffer = _buffer->getBufferForChannel( mixMono ? 0 : c );
                     tgtBuffer = outputBuffer->getBufferForChannel( c );
 
-                    tgtBuffer[ i ] += ( srcBuffer[ readPointer ] * _volume );
+                    if ( readPointer < maxReadPos )
+                        tgtBuffer[ i ] += ( srcBuffer[ readPointer ] * _volume );
                 }
             }
         }
@@ -417,6 +536,7 @@ void BaseAudioEvent::setBuffer( AudioBuffer* buffer, bool destroyable )
     _destroyableBuffer = destroyable;
     destroyBuffer(); // clears existing buffer (if destroyable)
     _buffer = buffer;
+    markModified();
 }
 
 bool BaseAudioEvent::hasBuffer()
@@ -442,6 +562,69 @@ void BaseAudioEvent::construct()
     _deleteMe          = false;
     _livePlayback      = false;
     isSequenced        = true;
+    _startTicks        = 0.0;
+    _endTicks          = 0.0;
+    _lengthTicks       = 0.0;
+    _timingTempo       = AudioEngine::tempo;
+    _timingStepSize    = AudioEngine::samples_per_step;
+    _timingTicksPerStep = getTicksPerStep();
+    _timingMapVersion  = AudioEngine::tempoMap != nullptr ? AudioEngine::tempoMap->getVersion() : 0;
+    _syncedStart       = 0;
+    _syncedEnd         = 0;
+    _syncedLength      = 0;
+}
+
+void BaseAudioEvent::updateTiming()
+{
+    _eventStart  = ticksToSamples( _startTicks );
+    _eventLength = ticksToSamples( _startTicks + _lengthTicks ) - _eventStart;
+    _eventEnd    = std::max( _eventStart, ticksToSamples( _endTicks ) - 1 );
+
+    if ( _eventLength > 0 )
+        _eventEnd = std::min( _eventEnd, _eventStart + ( _eventLength - 1 ));
+
+    _startPosition = BufferUtility::bufferToSeconds( _eventStart, AudioEngineProps::SAMPLE_RATE );
+    _endPosition   = BufferUtility::bufferToSeconds( _eventEnd,   AudioEngineProps::SAMPLE_RATE );
+}
+
+double BaseAudioEvent::samplesToTicks( int samples )
+{
+    TempoMap* tempoMap = AudioEngine::tempoMap;
+
+    if ( _timingMapVersion > 0 && tempoMap != nullptr && tempoMap->getVersion() == _timingMapVersion )
+        return tempoMap->getTickPosition( samples );
+
+    return ( double ) samples / BufferUtility::getSamplesPerTick( AudioEngineProps::SAMPLE_RATE, _timingTempo );
+}
+
+/**
+ * positions are rounded (rather than truncated) so repeated tempo changes do not
+ * accumulate errors, as each is calculated from the (unaltered) musical timing
+ */
+int BaseAudioEvent::ticksToSamples( double ticks )
+{
+    TempoMap* tempoMap = AudioEngine::tempoMap;
+
+    if ( _timingMapVersion > 0 && tempoMap != nullptr && tempoMap->getVersion() == _timingMapVersion )
+        return ( int ) round( tempoMap->getSamplePosition( ticks ));
+
+    return ( int ) round( ticks * BufferUtility::getSamplesPerTick( AudioEngineProps::SAMPLE_RATE, _timingTempo ));
+}
+
+double BaseAudioEvent::getTicksPerStep()
+{
+    return ( double ) TICKS_PER_BEAT * 4.0 * AudioEngine::time_sig_beat_amount /
+           (( double ) AudioEngine::time_sig_beat_unit * AudioEngine::steps_per_bar );
+}
+
+int BaseAudioEvent::stepsToSamples( double steps )
+{
+    TempoMap* tempoMap = AudioEngine::tempoMap;
+
+    if ( _timingMapVersion > 0 && tempoMap != nullptr && tempoMap->getVersion() == _timingMapVersion )
+        return ( int ) round( tempoMap->getSamplePosition( tempoMap->getTickPositionForStep( steps, AudioEngine::steps_per_bar )));
+
+    return ( int )( steps * AudioEngine::samples_per_step );
 }
 
 void BaseAudioEvent::destroyBuffer()
@@ -465,6 +648,12 @@ bool BaseAudioEvent::isAddedToSequencer()
     return false;
 }
 
+void BaseAudioEvent::markModified()
+{
+    if ( _instrument != nullptr )
+        _instrument->markModified();
+}
+
 /* TO BE DEPRECATED */
 
 void BaseAudioEvent::setSampleLength( int value ) {
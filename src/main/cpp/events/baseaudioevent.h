@@ -24,6 +24,7 @@
 #define __MWENGINE__BASEAUDIOEVENT_H_INCLUDED__
 
 #include "../audiobuffer.h"
+#include <mutex>
 
 namespace MWEngine {
 
@@ -88,6 +89,10 @@ class BaseAudioEvent
         virtual void stop(); // immediately stops playing the live-auditioned event (e.g. "noteOff")
         virtual void resetPlayState();
 
+        // invoked by the Sequencer when this event is about to be played back, allowing
+        // the event to prepare its contents (e.g. fetching a streamed sample from storage)
+        virtual void prefetch();
+
         /* event sequencing */
 
         virtual void addToSequencer();      // add / remove event from Instruments events list
@@ -137,6 +142,23 @@ class BaseAudioEvent
         // ( 1, 32, 4 ) positions audioEvent at 4 / 32 = 1/8th note in the second measure
         virtual void positionEvent( int startMeasure, int subdivisions, int offset );
 
+        // the range of the AudioEvent is stored in musical time (see TICKS_PER_BEAT) and translated into
+        // buffer samples lazily, e.g. the first time the event is queried after a tempo change (or after
+        // applying a TempoMap), rather than updating all events of the Sequencer at once.
+        // This is invoked by above getters and setters from both the rendering thread and other threads
+        // (e.g. the UI), a single thread syncs at a time. The rendering thread never waits for a sync in
+        // progress on another thread, instead it uses the current buffer regions until its next query.
+        // The Sequencer only queries the events near the playhead (see overlapsTicks()), to sync all
+        // events at once, invoke Sequencer::updateEvents() (outside of the rendering thread)
+        void syncTiming();
+
+        // whether the buffer regions are synced to the current tempo (or TempoMap), lock free
+        bool isTimingSynced();
+
+        // whether the event (possibly) overlaps given range (in ticks) without syncing its timing, used by
+        // the Sequencer to skip unsynced events far from the playhead. Errs on the side of overlapping
+        bool overlapsTicks( double startTicks, double endTicks );
+
         /* internally used properties */
 
         virtual bool isDeletable();   // query whether this event is queued for deletion
@@ -184,6 +206,32 @@ class BaseAudioEvent
         float _startPosition;
         float _endPosition;
 
+        // musical timing (from which the buffer regions are derived after a tempo change)
+
+        double _startTicks;
+        double _endTicks;
+        double _lengthTicks;
+        float  _timingTempo;    // the tempo the buffer regions were last synced to
+        int    _timingStepSize; // the step size (see AudioEngine::samples_per_step) the buffer regions were last synced to
+        double _timingTicksPerStep; // the length of a sequencer step (in ticks) the buffer regions were last synced to
+        unsigned int _timingMapVersion; // the version of the TempoMap the buffer regions were last synced to (0 for none)
+        int    _syncedStart;    // the buffer regions at the time of the last sync, used to
+        int    _syncedEnd;      // detect whether they have been altered since (and the
+        int    _syncedLength;   // musical timing should be updated accordingly)
+        std::recursive_mutex _timingLock; // held while syncing (recursive as updateTiming() can invoke the setters)
+
+        // updates the buffer regions from the musical timing to match the current tempo
+        // override in derived classes for custom positioning (e.g. tempo independent lengths)
+        virtual void updateTiming();
+
+        // translate between buffer samples, ticks and sequencer steps, using the
+        // tempo (or TempoMap) the buffer regions were last synced to
+
+        double samplesToTicks( int samples );
+        int    ticksToSamples( double ticks );
+        int    stepsToSamples( double steps );
+        static double getTicksPerStep(); // at the current time signature
+
         // properties
         bool _enabled;
         bool _livePlayback;
@@ -191,6 +239,9 @@ class BaseAudioEvent
         bool isAddedToSequencer();   // whether this event exists in the instruments event list (and is eligible for playback)
         BaseInstrument* _instrument; // the BaseInstrument this event belongs to
 
+        // notifies the instrument of a change affecting this events output (see BaseInstrument::markModified())
+        void markModified();
+
         // cached buffer
         AudioBuffer* _buffer;
         void destroyBuffer();
@@ -31,11 +31,19 @@ BaseCacheableAudioEvent::BaseCacheableAudioEvent( BaseInstrument* instrument )
 {
     setInstrument( instrument );
     construct();
+
+    _cancel        = false;
+    _bulkCacheable = false;
+    _autoCache     = false;
+
+    resetCache();
 }
 
 BaseCacheableAudioEvent::~BaseCacheableAudioEvent()
 {
-
+    // cancel pending caching (waits when this event is being cached), note derived classes
+    // overriding cache() should do the same in their destructor as this destructor runs last
+    Sequencer::bulkCacher->removeFromQueue( this );
 }
 
 /* public methods */
@@ -58,6 +66,8 @@ void BaseCacheableAudioEvent::setAutoCache( bool aValue )
 /**
  * (pre-)cache the contents of the BaseSynthEvent in its entirety
  * this can be done in idle time to make optimum use of resources
+ * note: when invoked by the BulkCacher, this is executed on one of its worker threads
+ * doCallback is no longer used as the BulkCacher schedules its queue by itself
  */
 void BaseCacheableAudioEvent::cache( bool doCallback )
 {
@@ -67,9 +77,6 @@ void BaseCacheableAudioEvent::cache( bool doCallback )
 
     // custom  derived class cache implementation here
 
-    if ( doCallback )
-        Sequencer::bulkCacher->cacheQueue();
-
     _caching = false;
 }
 
@@ -187,18 +187,8 @@ void BaseSynthEvent::calculateBuffers()
         return;
     }
 
-    if ( isSequenced )
-    {
-        setEventStart( position * ( int ) AudioEngine::samples_per_step );
-        setEventLength(( int )( length * AudioEngine::samples_per_step ));
-        setEventEnd( _eventStart + _eventLength );
-    }
-    else {
-        // quick releases of a noteOn-instruction should ring for at least a 64th note
-        setEventLength( AudioEngine::samples_per_bar );     // important for amplitude swell in
-        _minLength    = AudioEngine::samples_per_bar / 64;
-        _hasMinLength = false;                          // keeping track if the min length has been rendered
-    }
+    syncTiming(); // ensures the range is calculated using the current tempo (or TempoMap)
+    updateTiming();
 
     // buffer is only instantiated once as it is the size of the engines BUFFER_SIZE
     // (this event will not be cached in its entirety but will repeatedly render snippets into its buffer)
@@ -356,6 +346,26 @@ void BaseSynthEvent::updateProperties()
     calculateBuffers();
 }
 
+void BaseSynthEvent::updateTiming()
+{
+    // SynthEvents are positioned relative to the measure's subdivisions
+
+    if ( isSequenced )
+    {
+        int eventStart = stepsToSamples( position );
+
+        setEventStart( eventStart );
+        setEventLength( stepsToSamples( position + length ) - eventStart );
+        setEventEnd( _eventStart + _eventLength );
+    }
+    else {
+        // quick releases of a noteOn-instruction should ring for at least a 64th note
+        setEventLength( AudioEngine::samples_per_bar );     // important for amplitude swell in
+        _minLength    = AudioEngine::samples_per_bar / 64;
+        _hasMinLength = false;                          // keeping track if the min length has been rendered
+    }
+}
+
 void BaseSynthEvent::setDeletable( bool value )
 {
     // sequenced event or synthesized event has min length ? schedule for immediate deletion
@@ -364,6 +374,8 @@ void BaseSynthEvent::setDeletable( bool value )
         _deleteMe = value;
     else
         _queuedForDeletion = value;
+
+    markModified();
 }
 
 void BaseSynthEvent::triggerRelease()
@@ -125,6 +125,7 @@ class BaseSynthEvent : public BaseAudioEvent
         // render related
         virtual void updateProperties();
         virtual void triggerRelease();
+        void updateTiming();
 };
 } // E.O namespace MWEngine
 
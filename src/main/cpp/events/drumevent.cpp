@@ -23,6 +23,7 @@
 #include "drumevent.h"
 #include "../audioengine.h"
 #include "../global.h"
+#include "../utilities/bufferutility.h"
 #include "../utilities/samplemanager.h"
 #include <cstdlib>
 
@@ -100,6 +101,21 @@ void DrumEvent::unlock()
     _updateAfterUnlock = false;
 }
 
+/* protected methods */
+
+void DrumEvent::updateTiming()
+{
+    // DrumEvents are positioned at a sequencer step, their length is that of their sample
+
+    int eventStart = stepsToSamples( position );
+
+    _eventEnd   = eventStart + ( _eventEnd - _eventStart );
+    _eventStart = eventStart;
+
+    _startPosition = BufferUtility::bufferToSeconds( _eventStart, AudioEngineProps::SAMPLE_RATE );
+    _endPosition   = BufferUtility::bufferToSeconds( _eventEnd,   AudioEngineProps::SAMPLE_RATE );
+}
+
 /* private methods */
 
 void DrumEvent::updateSample()
@@ -140,7 +156,9 @@ void DrumEvent::updateSample()
                 smp = "hh";
             break;
     }
-    setSample( SampleManager::getSample( smp ));
+    AudioBuffer* sampleBuffer = SampleManager::retainSample( smp );
+    setSample( sampleBuffer );
+    SampleManager::releaseBuffer( sampleBuffer );
 }
 
 } // E.O namespace MWEngine
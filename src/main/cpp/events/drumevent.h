@@ -42,6 +42,9 @@ class DrumEvent : public SampleEvent
         void setType( int aType );
         void unlock();
 
+    protected:
+        void updateTiming();
+
     private:
         int _timbre;
         int _type;
@@ -25,6 +25,8 @@
 #include "../audioengine.h"
 #include "../global.h"
 #include "../sequencer.h"
+#include "../utilities/samplemanager.h"
+#include "../utilities/resampler.h"
 
 namespace MWEngine {
 
@@ -44,7 +46,15 @@ SampleEvent::SampleEvent( BaseInstrument* aInstrument )
 
 SampleEvent::~SampleEvent()
 {
-    // nowt...
+    // remove from the sequencer before releasing the shared buffer
+    // (the SampleManager can free it once it is no longer referenced)
+
+    removeFromSequencer();
+    clearStretch();
+    SampleManager::releaseBuffer( _sharedBuffer );
+
+    if ( _stream != nullptr )
+        _stream->release();
 }
 
 /* public methods */
@@ -58,11 +68,13 @@ void SampleEvent::play()
     _readPointerF         = ( float ) _readPointer;
     _lastPlaybackPosition = _bufferRangeStart;
 
+    prefetch();
     BaseAudioEvent::play();
 }
 
 void SampleEvent::setEventLength( int value )
 {
+    syncTiming();
     _eventLength = value;
 
     if ( _loopeable ) {
@@ -80,6 +92,7 @@ void SampleEvent::setEventLength( int value )
 
         // update end position in seconds
         _endPosition = BufferUtility::bufferToSeconds( _eventEnd, AudioEngineProps::SAMPLE_RATE );
+        markModified();
     }
     else {
         BaseAudioEvent::setEventLength( value );
@@ -88,6 +101,7 @@ void SampleEvent::setEventLength( int value )
 
 void SampleEvent::setEventStart( int value )
 {
+    syncTiming();
     _eventStart = value;
 
     // assume length remains unchanged (e.g. play full sample)
@@ -96,10 +110,12 @@ void SampleEvent::setEventStart( int value )
     // update start and end positions in seconds
     _startPosition = BufferUtility::bufferToSeconds( _eventStart, AudioEngineProps::SAMPLE_RATE );
     _endPosition   = BufferUtility::bufferToSeconds( _eventEnd,   AudioEngineProps::SAMPLE_RATE );
+    markModified();
 }
 
 void SampleEvent::setEventEnd( int value )
 {
+    syncTiming();
     if ( !_loopeable ) {
         BaseAudioEvent::setEventEnd( value );
         return;
@@ -109,6 +125,7 @@ void SampleEvent::setEventEnd( int value )
 
     // update end position in seconds
     _endPosition = BufferUtility::bufferToSeconds( _eventEnd, AudioEngineProps::SAMPLE_RATE );
+    markModified();
 }
 
 int SampleEvent::getBufferRangeStart()
@@ -135,11 +152,12 @@ void SampleEvent::setBufferRangeStart( int value )
 
     // buffer range may never exceed the length of the source buffer (which can be unequal to the sample length)
 
-    if ( _buffer != nullptr && _bufferRangeEnd >= _buffer->bufferSize )
-        setBufferRangeEnd( _buffer->bufferSize - 1 );
+    if ( _buffer != nullptr && _bufferRangeEnd >= getSourceLength() )
+        setBufferRangeEnd( getSourceLength() - 1 );
 
     _bufferRangeLength = ( _bufferRangeEnd - _bufferRangeStart ) + 1;
     setRangeBasedPlayback( _bufferRangeLength != _eventLength );
+    markModified();
 }
 
 int SampleEvent::getBufferRangeEnd()
@@ -150,7 +168,7 @@ int SampleEvent::getBufferRangeEnd()
 void SampleEvent::setBufferRangeEnd( int value )
 {
     // buffer range may never exceed the length of the source buffer (which can be unequal to the sample length)
-    _bufferRangeEnd = ( _buffer != nullptr ) ? std::min( value, _buffer->bufferSize - 1 ): value;
+    _bufferRangeEnd = ( _buffer != nullptr ) ? std::min( value, getSourceLength() - 1 ): value;
 
     if ( _rangePointer > _bufferRangeEnd )
         _rangePointer = _bufferRangeEnd;
@@ -163,6 +181,7 @@ void SampleEvent::setBufferRangeEnd( int value )
 
     _bufferRangeLength = ( _bufferRangeEnd - _bufferRangeStart ) + 1;
     setRangeBasedPlayback( getBufferRangeLength() != getEventLength() );
+    markModified();
 }
 
 int SampleEvent::getBufferRangeLength()
@@ -200,6 +219,9 @@ bool SampleEvent::setSample( AudioBuffer* sampleBuffer, unsigned int sampleRate
     bool wasLocked = _locked;
     _locked        = true;
 
+    // stretched contents are rendered anew for the new sample
+    clearStretch();
+
     int sampleLength = sampleBuffer->bufferSize;
 
     // delete previous contents
@@ -215,6 +237,22 @@ bool SampleEvent::setSample( AudioBuffer* sampleBuffer, unsigned int sampleRate
     else
         _buffer = sampleBuffer;
 
+    // when sharing a buffer registered in the SampleManager, keep its reference count
+    // in check so the buffer cannot be evicted/freed while this event references it
+
+    AudioBuffer* sharedBuffer = _destroyableBuffer ? nullptr : sampleBuffer;
+
+    if ( sharedBuffer != _sharedBuffer ) {
+        SampleManager::retainBuffer ( sharedBuffer );
+        SampleManager::releaseBuffer( _sharedBuffer );
+        _sharedBuffer = sharedBuffer;
+    }
+
+    if ( _stream != nullptr ) {
+        _stream->release();
+        _stream = nullptr;
+    }
+
     _buffer->loopeable = _loopeable;
     setEventLength( sampleLength );
     setEventEnd   ( _eventStart + ( _eventLength - 1 ));
@@ -241,6 +279,51 @@ bool SampleEvent::setSample( AudioBuffer* sampleBuffer, unsigned int sampleRate
 
     _updateAfterUnlock = false; // unnecessary
 
+    updateStretch();
+
+    if ( !wasLocked )
+        _locked = false;
+
+    return true;
+}
+
+bool SampleEvent::setSample( std::string aIdentifier )
+{
+    SampleStream* stream = SampleManager::getStream( aIdentifier );
+
+    if ( stream == nullptr )
+    {
+        // retain the buffer so it can't be evicted before this event has retained it
+
+        AudioBuffer* sampleBuffer = SampleManager::retainSample( aIdentifier );
+        bool result = setSample( sampleBuffer, SampleManager::getSampleRateForSample( aIdentifier ));
+        SampleManager::releaseBuffer( sampleBuffer );
+
+        return result;
+    }
+
+    bool wasLocked = _locked;
+    _locked        = true;
+
+    // streamed samples reference their resident pre-roll (see mixBuffer())
+
+    setSample( stream->getPreRoll(), stream->getSampleRate() );
+    _stream = stream;
+
+    clearStretch(); // streamed samples are not stretched
+
+    // while the event describes the full sample length
+
+    int sampleLength = stream->getSampleLength();
+
+    setEventLength( sampleLength );
+    setEventEnd   ( _eventStart + ( _eventLength - 1 ));
+
+    _bufferRangeEnd    = sampleLength - 1;
+    _bufferRangeLength = sampleLength;
+    _loopEndOffset     = sampleLength - 1;
+    cacheFades();
+
     if ( !wasLocked )
         _locked = false;
 
@@ -258,6 +341,51 @@ void SampleEvent::setPlaybackRate( float value )
     _playbackRate = std::max( 0.01f, std::min( 100.f, value ));
 }
 
+float SampleEvent::getStretchRatio()
+{
+    return _stretchRatio;
+}
+
+void SampleEvent::setStretchRatio( float value )
+{
+    _stretchRatio = std::max( 0.1f, std::min( 10.f, value ));
+    updateStretch();
+}
+
+float SampleEvent::getStretchTempo()
+{
+    return _stretchTempo;
+}
+
+void SampleEvent::setStretchTempo( float value )
+{
+    _stretchTempo = std::max( 0.f, value );
+
+    // tempo changes (on the rendering thread) request stretch updates from the background thread
+    if ( _stretchTempo > 0.f )
+        StretchCache::start();
+
+    updateStretch();
+}
+
+float SampleEvent::getAppliedStretchRatio()
+{
+    return _appliedStretchRatio;
+}
+
+int SampleEvent::getResamplingQuality()
+{
+    return _resamplingQuality;
+}
+
+void SampleEvent::setResamplingQuality( int quality )
+{
+    // create lookup tables (if required) outside of the rendering thread
+    Resampler::prepare( quality );
+
+    _resamplingQuality = quality;
+}
+
 bool SampleEvent::isLoopeable()
 {
     return _loopeable;
@@ -305,22 +433,61 @@ void SampleEvent::setLoopEndOffset( int value )
 
 int SampleEvent::getEventLength()
 {
+    syncTiming();
     return ( _playbackRate == 1.f || _loopeable ) ? _eventLength : ( int )(( float ) _eventLength / _playbackRate );
 }
 
 int SampleEvent::getOriginalEventLength()
 {
+    syncTiming();
     return _eventLength;
 }
 
 int SampleEvent::getEventEnd()
 {
+    syncTiming();
     return ( _playbackRate == 1.f || _loopeable ) ? _eventEnd : _eventStart + getEventLength();
 }
 
 void SampleEvent::mixBuffer( AudioBuffer* outputBuffer, int bufferPosition,
                              int minBufferPosition, int maxBufferPosition,
                              bool loopStarted, int loopOffset, bool useChannelRange )
+{
+    applyStretch();
+
+    if ( _stream == nullptr ) {
+        mixSample( outputBuffer, bufferPosition, minBufferPosition, maxBufferPosition,
+                   loopStarted, loopOffset, useChannelRange );
+        return;
+    }
+
+    // streamed sample: read from the full sample contents when resident, otherwise (while
+    // these are being fetched) read from the pre-roll. As the pre-roll only holds the start of
+    // the sample, loopeable and range based playback remain silent until the contents are resident
+
+    AudioBuffer* body = _stream->beginRead();
+
+    if ( body != nullptr )
+    {
+        AudioBuffer* preRoll = _buffer;
+        _buffer = body;
+
+        mixSample( outputBuffer, bufferPosition, minBufferPosition, maxBufferPosition,
+                   loopStarted, loopOffset, useChannelRange );
+
+        _buffer = preRoll;
+    }
+    else if ( !_loopeable && !_useBufferRange )
+    {
+        mixSample( outputBuffer, bufferPosition, minBufferPosition, maxBufferPosition,
+                   loopStarted, loopOffset, useChannelRange );
+    }
+    _stream->endRead();
+}
+
+void SampleEvent::mixSample( AudioBuffer* outputBuffer, int bufferPosition,
+                             int minBufferPosition, int maxBufferPosition,
+                             bool loopStarted, int loopOffset, bool useChannelRange )
 {
     if ( !hasBuffer() )
         return;
@@ -334,7 +501,7 @@ void SampleEvent::mixBuffer( AudioBuffer* outputBuffer, int bufferPosition,
     }
 
     int bufferSize = outputBuffer->bufferSize;
-    int maxReadPos = _loopEndOffset;
+    int maxReadPos = std::min( _loopEndOffset, _buffer->bufferSize - 1 ); // buffer can be shorter than the sample (pre-roll)
     bool crossfade = _crossfadeStart != _loopEndOffset || _crossfadeEnd != 0;
 
     // if the buffer channel amount differs from the output channel amount, we might
@@ -417,11 +584,9 @@ void SampleEvent::mixBuffer( AudioBuffer* outputBuffer, int bufferPosition,
 
     // custom playback rate
 
-    int i, t, t2, c, ca;
-    float frac;
+    int i, t, c;
     SAMPLE_TYPE* srcBuffer;
     SAMPLE_TYPE* tgtBuffer;
-    SAMPLE_TYPE s1, s2;
 
     // at custom playback rate we require floating point precision for these properties
     // also we translate the values relative to the playback speed
@@ -449,6 +614,12 @@ void SampleEvent::mixBuffer( AudioBuffer* outputBuffer, int bufferPosition,
     {
         fEventEnd = _eventEnd; // use unstretched end (see below fBufferPointer calculation)
 
+        // contiguous reads from the source buffer are collected into runs which
+        // are resampled in blocks (runs are broken on jumps in the read position)
+
+        int runStart = -1;
+        float runReadPointer = 0.f;
+
         for ( i = 0; i < bufferSize; ++i, fi += _playbackRate )
         {
             // NOTE buffer pointer progresses by the playback rate
@@ -464,35 +635,34 @@ void SampleEvent::mixBuffer( AudioBuffer* outputBuffer, int bufferPosition,
                     break;
             }
 
-            if ( fBufferPointer >= fEventStart && fBufferPointer <= fEventEnd )
-            {
-                // mind the offset ! ( source buffer starts at 0 while
-                // the eventStart defines where the event is positioned )
-                // subtract it from current sequencer position to get the
-                // offset relative to the source buffer
+            // mind the offset ! ( source buffer starts at 0 while
+            // the eventStart defines where the event is positioned )
+            // subtract it from current sequencer position to get the
+            // offset relative to the source buffer
 
-                fReadPointer = fBufferPointer - fEventStart;
+            fReadPointer = fBufferPointer - fEventStart;
 
-                t    = ( int ) fReadPointer;
-                frac = fReadPointer - t; // between 0 - 1 range
+            bool readable = fBufferPointer >= fEventStart && fBufferPointer <= fEventEnd &&
+                            ( int ) fReadPointer < maxReadPos; // interpolated read must remain in range
 
-                for ( c = 0; c < outputChannels; ++c )
-                {
-                    srcBuffer = _buffer->getBufferForChannel( mixMono ? 0 : c );
-                    tgtBuffer = outputBuffer->getBufferForChannel( c );
-
-                    t2 = t + 1;
-
-                    if ( t2 > maxReadPos )
-                        break;
-
-                    s1 = srcBuffer[ t ];
-                    s2 = srcBuffer[ t2 ];
+            if ( runStart >= 0 )
+            {
+                float expected = runReadPointer + ( i - runStart ) * _playbackRate;
 
-                    tgtBuffer[ i ] += (( s1 + ( s2 - s1 ) * frac ) * _volume );
+                if ( !readable || fabs( fReadPointer - expected ) > 0.5f ) {
+                    mixResampled( outputBuffer, runStart, i - runStart, runReadPointer, maxReadPos, _volume );
+                    runStart = -1;
                 }
             }
+
+            if ( readable && runStart < 0 ) {
+                runStart       = i;
+                runReadPointer = fReadPointer;
+            }
         }
+
+        if ( runStart >= 0 )
+            mixResampled( outputBuffer, runStart, i - runStart, runReadPointer, maxReadPos, _volume );
     }
     else
     {
@@ -545,8 +715,7 @@ void SampleEvent::mixBuffer( AudioBuffer* outputBuffer, int bufferPosition,
                     fReadPointer = ( float ) _loopStartOffset + fmod( fReadPointer, fMaxReadPos - ( float ) _loopStartOffset );
                 }
 
-                t    = ( int ) fReadPointer;
-                frac = fReadPointer - t; // between 0 - 1 range
+                t = ( int ) fReadPointer;
 
                 if ( crossfade )
                 {
@@ -562,20 +731,18 @@ void SampleEvent::mixBuffer( AudioBuffer* outputBuffer, int bufferPosition,
                 }
 
                 // use range pointers to read within the specific buffer ranges
-                for ( c = 0, ca = outputChannels; c < ca; ++c )
-                {
-                    srcBuffer = _buffer->getBufferForChannel( mixMono ? 0 : c );
-                    tgtBuffer = outputBuffer->getBufferForChannel( c );
-
-                    t2 = t + 1;
-
-                    if ( t2 > maxReadPos )
-                        break;
+                // (interpolated read must remain within the max position)
 
-                    s1 = srcBuffer[ t ];
-                    s2 = srcBuffer[ t2 ];
+                if ( t < maxReadPos )
+                {
+                    for ( c = 0; c < outputChannels; ++c )
+                    {
+                        srcBuffer = _buffer->getBufferForChannel( mixMono ? 0 : c );
+                        tgtBuffer = outputBuffer->getBufferForChannel( c );
 
-                    tgtBuffer[ i ] += (( s1 + ( s2 - s1 ) * frac ) * volume );
+                        tgtBuffer[ i ] += Resampler::interpolate( _resamplingQuality, srcBuffer, maxReadPos + 1,
+                                                                  fReadPointer, _playbackRate ) * volume;
+                    }
                 }
 
                 // this is a loopeable event (thus using internal read pointer)
@@ -617,6 +784,12 @@ void SampleEvent::mixBuffer( AudioBuffer* outputBuffer )
     }
 }
 
+void SampleEvent::prefetch()
+{
+    if ( _stream != nullptr )
+        _stream->requestFetch();
+}
+
 bool SampleEvent::getRangeBasedPlayback()
 {
     return _useBufferRange;
@@ -681,19 +854,14 @@ bool SampleEvent::getBufferForRange( AudioBuffer* buffer, int readPos )
 
         // custom playback speed
 
-        int t;
-        SAMPLE_TYPE s1, s2;
+        int sourceLength     = _buffer->bufferSize;
         float bufferRangeEnd = ( float ) getBufferRangeEnd();
-        float frac;
 
         for ( int i = 0; i < bufferSize; ++i )
         {
             // read sample when the read pointer is within sample start and end points
             if ( readPos >= eventStart && readPos <= eventEnd )
             {
-                t    = ( int ) _rangePointerF;
-                frac = _rangePointerF - t; // between 0 - 1 range
-
                 // use range pointers to read within the specific sample ranges
                 for ( int c = 0; c < amountOfChannels; ++c )
                 {
@@ -703,11 +871,9 @@ bool SampleEvent::getBufferForRange( AudioBuffer* buffer, int readPos )
                     else
                         srcBuffer = _buffer->getBufferForChannel( 0 );
 
-                    s1 = srcBuffer[ t ];
-                    s2 = srcBuffer[ t + 1 ];
-
                     SAMPLE_TYPE* targetBuffer = buffer->getBufferForChannel( c );
-                    targetBuffer[ i ]        += (( s1 + ( s2 - s1 ) * frac ) * _volume );
+                    targetBuffer[ i ]        += Resampler::interpolate( _resamplingQuality, srcBuffer, sourceLength,
+                                                                        _rangePointerF, _playbackRate ) * _volume;
                 }
 
                 if (( _rangePointerF += _playbackRate ) > bufferRangeEnd )
@@ -749,10 +915,68 @@ void SampleEvent::init( BaseInstrument* instrument )
     _lastPlaybackPosition = 0;
     _playbackRate         = 1.f;
     _readPointerF         = 0.f;
+    _resamplingQuality    = Resampler::LINEAR;
     _destroyableBuffer    = false; // is referenced via SampleManager !
     _useBufferRange       = false;
     _instrument           = instrument;
     _sampleRate           = ( unsigned int ) AudioEngineProps::SAMPLE_RATE;
+    _sharedBuffer         = nullptr;
+    _stream               = nullptr;
+    _stretchRatio         = 1.f;
+    _stretchTempo         = 0.f;
+    _appliedStretchRatio  = 1.f;
+    _unstretchedBuffer    = nullptr;
+    _stretch              = nullptr;
+    _pendingStretch.store( nullptr );
+    _stretchUpdateRequested.store( false );
+}
+
+void SampleEvent::updateTiming()
+{
+    // the length of a sample is tempo independent, as such only its start offset moves
+    // (unless the event is loopeable, in which case its end spans a musical range)
+
+    int eventStart = ticksToSamples( _startTicks );
+
+    if ( _loopeable )
+        _eventEnd = std::max( eventStart, ticksToSamples( _endTicks ) - 1 );
+    else
+        _eventEnd = eventStart + ( _eventEnd - _eventStart );
+
+    _eventStart = eventStart;
+
+    _startPosition = BufferUtility::bufferToSeconds( _eventStart, AudioEngineProps::SAMPLE_RATE );
+    _endPosition   = BufferUtility::bufferToSeconds( _eventEnd,   AudioEngineProps::SAMPLE_RATE );
+
+    // stretched samples following the sequencer tempo are rendered at the new tempo (as this
+    // can be invoked from the rendering thread, the render is requested by the background thread)
+    if ( _stretchTempo > 0.f )
+        StretchCache::requestUpdate( this );
+}
+
+int SampleEvent::getSourceLength()
+{
+    // streamed samples reference their pre-roll, which is shorter than the full sample
+    if ( _stream != nullptr )
+        return _stream->getSampleLength();
+
+    return ( _buffer != nullptr ) ? _buffer->bufferSize : 0;
+}
+
+void SampleEvent::mixResampled( AudioBuffer* outputBuffer, int offset, int amount,
+                                double readPointer, int maxReadPos, SAMPLE_TYPE volume )
+{
+    int outputChannels = outputBuffer->amountOfChannels;
+    bool mixMono       = _buffer->amountOfChannels < outputChannels;
+
+    for ( int c = 0; c < outputChannels; ++c )
+    {
+        SAMPLE_TYPE* srcBuffer = _buffer->getBufferForChannel( mixMono ? 0 : c );
+        SAMPLE_TYPE* tgtBuffer = outputBuffer->getBufferForChannel( c ) + offset;
+
+        Resampler::mix( _resamplingQuality, srcBuffer, maxReadPos + 1, tgtBuffer,
+                        amount, readPointer, _playbackRate, volume );
+    }
 }
 
 void SampleEvent::cacheFades()
@@ -770,4 +994,137 @@ void SampleEvent::cacheFades()
     }
 }
 
+float SampleEvent::getTargetStretchRatio()
+{
+    float ratio = _stretchRatio;
+
+    if ( _stretchTempo > 0.f && AudioEngine::tempo > 0.f )
+        ratio *= _stretchTempo / AudioEngine::tempo;
+
+    return ratio;
+}
+
+void SampleEvent::updateStretch()
+{
+    AudioBuffer* source = ( _unstretchedBuffer != nullptr ) ? _unstretchedBuffer : _buffer;
+
+    if ( source == nullptr || _stream != nullptr )
+        return;
+
+    int key = StretchCache::getRatioKey( getTargetStretchRatio() );
+    StretchCache::Entry* pending = _pendingStretch.load();
+
+    // requested ratio is already playing or being rendered ?
+
+    if ( pending != nullptr ) {
+        if ( pending->source == source && StretchCache::getRatioKey( pending->ratio ) == key )
+            return;
+    }
+    else if ( StretchCache::getRatioKey( _appliedStretchRatio ) == key ) {
+        return;
+    }
+
+    // no render is required when returning to the playing ratio or to the original
+    // sample (the latter is restored by applyStretch())
+
+    StretchCache::Entry* entry = nullptr;
+
+    if ( key != StretchCache::getRatioKey( _appliedStretchRatio ) && key != StretchCache::RATIO_RESOLUTION )
+        entry = StretchCache::retain( source, getTargetStretchRatio() );
+
+    StretchCache::release( _pendingStretch.exchange( entry ));
+}
+
+void SampleEvent::applyStretch()
+{
+    StretchCache::Entry* pending = _pendingStretch.load();
+
+    if ( pending != nullptr )
+    {
+        if ( !pending->ready.load() || !_pendingStretch.compare_exchange_strong( pending, nullptr ))
+            return;
+
+        StretchCache::Entry* previous = _stretch;
+        _stretch = pending;
+
+        swapStretchedBuffer( pending->buffer, pending->ratio );
+        StretchCache::releaseDeferred( previous );
+    }
+    else if ( _stretch != nullptr && StretchCache::getRatioKey( getTargetStretchRatio() ) == StretchCache::RATIO_RESOLUTION )
+    {
+        swapStretchedBuffer( _unstretchedBuffer, 1.f );
+        StretchCache::releaseDeferred( _stretch );
+        _stretch = nullptr;
+    }
+}
+
+void SampleEvent::clearStretch()
+{
+    // ensure the background thread isn't updating (or about to update) the stretch of this event
+    StretchCache::cancelUpdate( this );
+
+    StretchCache::release( _pendingStretch.exchange( nullptr ));
+
+    if ( _stretch != nullptr )
+    {
+        _buffer            = _unstretchedBuffer;
+        _unstretchedBuffer = nullptr;
+
+        StretchCache::release( _stretch );
+        _stretch = nullptr;
+    }
+    _appliedStretchRatio = 1.f;
+
+    // the sample buffer can be freed after this invocation, ensure it is no longer being stretched
+    StretchCache::waitForRenders( _buffer );
+}
+
+/**
+ * swaps the current sample contents for the contents at given stretch ratio, the regions
+ * within the sample (and for non-loopeable events, the event length) are scaled accordingly
+ */
+void SampleEvent::swapStretchedBuffer( AudioBuffer* buffer, float ratio )
+{
+    float factor  = ratio / _appliedStretchRatio;
+    int oldLength = _buffer->bufferSize;
+    int newLength = buffer->bufferSize;
+
+    auto scale = [ factor, oldLength, newLength ]( int value ) -> int
+    {
+        // regions ending at the sample end remain at the sample end
+        if ( value >= oldLength - 1 )
+            return newLength - 1;
+
+        return std::min( newLength - 1, ( int ) round( value * factor ));
+    };
+
+    _loopStartOffset   = scale( _loopStartOffset );
+    _loopEndOffset     = scale( _loopEndOffset );
+    _bufferRangeStart  = scale( _bufferRangeStart );
+    _bufferRangeEnd    = scale( _bufferRangeEnd );
+    _bufferRangeLength = ( _bufferRangeEnd - _bufferRangeStart ) + 1;
+    _rangePointer      = scale( _rangePointer );
+    _rangePointerF    *= factor;
+    _readPointer       = scale( _readPointer );
+    _readPointerF     *= factor;
+
+    if ( !_loopeable )
+    {
+        _eventLength = ( _eventLength == oldLength ) ? newLength : ( int ) round( _eventLength * factor );
+        _eventEnd    = _eventStart + ( _eventLength - 1 );
+        _endPosition = BufferUtility::bufferToSeconds( _eventEnd, AudioEngineProps::SAMPLE_RATE );
+    }
+
+    if ( _unstretchedBuffer == nullptr )
+        _unstretchedBuffer = _buffer;
+
+    if ( buffer == _unstretchedBuffer )
+        _unstretchedBuffer = nullptr;
+
+    _buffer              = buffer;
+    _appliedStretchRatio = ratio;
+
+    cacheFades();
+}
+
 } // E.O namespace MWEngine
@@ -25,6 +25,10 @@
 
 #include "baseaudioevent.h"
 #include <instruments/baseinstrument.h>
+#include <utilities/samplestream.h>
+#include <utilities/stretchcache.h>
+#include <atomic>
+#include <string>
 
 namespace MWEngine {
 class SampleEvent : public BaseAudioEvent
@@ -56,9 +60,42 @@ class SampleEvent : public BaseAudioEvent
 
         bool setSample( AudioBuffer* sampleBuffer, unsigned int sampleRate );
 
+        // set the sample registered in the SampleManager under given identifier (at its sample rate)
+        // when the sample is streamed, playback starts from its resident pre-roll while the
+        // remainder of the sample is fetched (note: loopeable and range based playback of
+        // streamed samples start once the full sample has been fetched)
+
+        bool setSample( std::string aIdentifier );
+
         float getPlaybackRate();
         void setPlaybackRate( float value );
 
+        // the interpolation used when playing back at a custom playback rate (or at a
+        // sample rate that differs from the engine), see Resampler::Quality (defaults to LINEAR)
+
+        int getResamplingQuality();
+        void setResamplingQuality( int quality );
+
+        // time stretching changes the duration of the sample without affecting its pitch (e.g. 2.0
+        // doubles the duration). The stretched contents are rendered in the background (see StretchCache)
+        // until these are available, the sample keeps playing at its current duration
+        // note: streamed samples are not stretched
+
+        float getStretchRatio();
+        void setStretchRatio( float value );
+
+        // when the tempo the sample was recorded at is known, the sample can be stretched to
+        // follow the sequencer tempo (e.g. a loop recorded at 120 BPM plays at twice its duration
+        // at 60 BPM), this is applied on top of the stretch ratio. Pass 0 to disable
+
+        float getStretchTempo();
+        void setStretchTempo( float value );
+
+        // the stretch ratio of the currently playing contents (which can differ from the
+        // requested ratio while the stretched contents are being rendered)
+
+        float getAppliedStretchRatio();
+
         // use these to repeat this SampleEvents buffer for the total
         // event duration. Optionally specify the point at which the loop will start
         // for samples where the end and start offsets are not at a zero crossing
@@ -86,6 +123,8 @@ class SampleEvent : public BaseAudioEvent
 
         void mixBuffer( AudioBuffer* outputBuffer );
 
+        void prefetch();
+
         // whether to mix sample data from a specific range instead of the full sampleLength range
 
         bool getRangeBasedPlayback();
@@ -124,14 +163,46 @@ class SampleEvent : public BaseAudioEvent
         bool _useBufferRange;
         float _playbackRate;
         float _readPointerF;
+        int _resamplingQuality;
 
         unsigned int _sampleRate;
 
         AudioBuffer* _liveBuffer;
+        AudioBuffer* _sharedBuffer; // buffer retained from the SampleManager
+        SampleStream* _stream;      // stream retained from the SampleManager (when playing a streamed sample)
         int _lastPlaybackPosition;
 
+        // time stretching
+
+        float _stretchRatio;
+        float _stretchTempo;
+        float _appliedStretchRatio;
+        AudioBuffer* _unstretchedBuffer;   // the original sample while playing stretched contents
+        StretchCache::Entry* _stretch;     // the stretched contents currently playing
+        std::atomic<StretchCache::Entry*> _pendingStretch; // the stretched contents being rendered
+        std::atomic<bool> _stretchUpdateRequested;         // whether updateStretch() is queued (see StretchCache::requestUpdate())
+
         void init( BaseInstrument* aInstrument );
         void cacheFades();
+        void updateTiming();
+
+        // mixes given amount of samples read contiguously at the current playback rate
+        // from given (fractional) readPointer into outputBuffer at given offset
+        int getSourceLength(); // the length of the source sample
+
+        void mixSample( AudioBuffer* outputBuffer, int bufferPos, int minBufferPosition, int maxBufferPosition,
+                        bool loopStarted, int loopOffset, bool useChannelRange );
+
+        void mixResampled( AudioBuffer* outputBuffer, int offset, int amount,
+                           double readPointer, int maxReadPos, SAMPLE_TYPE volume );
+
+        float getTargetStretchRatio();
+        void updateStretch();   // requests rendering of the stretched contents when the target ratio changed (not on the rendering thread)
+        void applyStretch();    // invoked from the rendering thread, swaps in rendered contents
+        void clearStretch();    // restores the original sample
+        void swapStretchedBuffer( AudioBuffer* buffer, float ratio );
+
+        friend class StretchCache; // performs requested stretch updates on its background thread
 };
 } // E.O namespace MWEngine
 
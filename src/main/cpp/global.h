@@ -99,6 +99,7 @@ const SAMPLE_TYPE TWO_PI = PI * 2.0;
 // other
 
 const int WAVE_TABLE_PRECISION = 128; // the amount of samples contained within a wave table
+const int TICKS_PER_BEAT       = 960; // resolution of musical (tempo independent) time, in ticks per quarter note
 extern void *print_message( void* );
 
 } // E.O namespace MWEngine
@@ -23,6 +23,7 @@
 #include "baseinstrument.h"
 #include "../audioengine.h"
 #include "../sequencer.h"
+#include <utilities/freezer.h>
 #include <algorithm>
 
 namespace MWEngine {
@@ -37,6 +38,7 @@ BaseInstrument::BaseInstrument()
 BaseInstrument::~BaseInstrument()
 {
     unregisterFromSequencer();
+    Freezer::unfreeze( this );
     clearEvents();
 
     delete audioChannel;
@@ -72,35 +74,21 @@ std::vector<BaseAudioEvent*>* BaseInstrument::getLiveEvents()
 
 void BaseInstrument::updateEvents()
 {
-    // when updating to reflect changes in the instruments propertes
-    // or to update event properties responding to tempo changes
+    // when updating to reflect changes in the instruments properties
     // override this function in your derived class for custom implementations
 
-    if ( _oldTempo != AudioEngine::tempo ) {
+    // note events respond to tempo changes lazily (see BaseAudioEvent::syncTiming()), as
+    // such the Sequencer no longer invokes this method on tempo change. When invoked, this
+    // will sync all events to the current tempo at once
 
-        //std::lock_guard<std::mutex> guard( _lock );
-        toggleReadLock( true );
-
-        // when tempo has updated, we update the offsets of all associated events
-
-        float ratio = _oldTempo / AudioEngine::tempo;
-
-        for ( int i = 0, l = _audioEvents->size(); i < l; ++i )
-        {
-            BaseAudioEvent* event = _audioEvents->at( i );
-
-            auto orgStart  = ( float ) event->getEventStart();
-            auto orgEnd    = ( float ) event->getEventEnd();
-            auto orgLength = ( float ) event->getEventLength();
+    //std::lock_guard<std::mutex> guard( _lock );
+    toggleReadLock( true );
 
-            event->setEventStart ( orgStart  * ratio );
-            event->setEventLength( orgLength * ratio );
-            event->setEventEnd   (( orgEnd + 1 ) * ratio ); // add 1 to correct for rounding of float
-        }
-        _oldTempo = AudioEngine::tempo;
+    for ( int i = 0, l = _audioEvents->size(); i < l; ++i )
+        _audioEvents->at( i )->syncTiming();
 
-        toggleReadLock( false );
-    }
+    toggleReadLock( false );
+    markModified();
 }
 
 void BaseInstrument::clearEvents()
@@ -131,6 +119,7 @@ void BaseInstrument::addEvent( BaseAudioEvent* audioEvent, bool isLiveEvent )
         _audioEvents->push_back( audioEvent );
     }
     toggleReadLock( false );
+    markModified();
 }
 
 bool BaseInstrument::removeEvent( BaseAudioEvent* audioEvent, bool isLiveEvent )
@@ -175,13 +164,15 @@ bool BaseInstrument::removeEvent( BaseAudioEvent* audioEvent, bool isLiveEvent )
 //#endif
     toggleReadLock( false );
 
+    if ( removed )
+        markModified();
+
     return removed;
 }
 
 void BaseInstrument::registerInSequencer()
 {
-    index     = Sequencer::registerInstrument( this );
-    _oldTempo = AudioEngine::tempo;
+    index = Sequencer::registerInstrument( this );
 }
 
 void BaseInstrument::unregisterFromSequencer()
@@ -203,11 +194,23 @@ void BaseInstrument::toggleReadLock( bool locked )
 #endif
 }
 
+unsigned int BaseInstrument::getModificationCount()
+{
+    return _modificationCount;
+}
+
+void BaseInstrument::markModified()
+{
+    ++_modificationCount;
+    Freezer::requestUpdate();
+}
+
 /* protected methods */
 
 void BaseInstrument::construct()
 {
-    audioChannel = new AudioChannel( 1.0 );
+    audioChannel       = new AudioChannel( 1.0 );
+    _modificationCount = 0;
 
     // events
 
@@ -25,6 +25,7 @@
 
 #include "../audiochannel.h"
 #include <events/baseaudioevent.h>
+#include <atomic>
 #include <mutex>
 
 namespace MWEngine {
@@ -36,7 +37,7 @@ class BaseInstrument
 
         virtual bool hasEvents();     // whether the instrument has events to sequence
         virtual bool hasLiveEvents(); // whether the instruments has events to synthesize on the fly
-        virtual void updateEvents();  // updates all associated events after changing instrument properties / tempo change
+        virtual void updateEvents();  // updates all associated events after changing instrument properties
 
         virtual std::vector<BaseAudioEvent*>* getEvents();
         virtual std::vector<BaseAudioEvent*>* getLiveEvents();
@@ -46,6 +47,13 @@ class BaseInstrument
         virtual bool removeEvent( BaseAudioEvent* audioEvent, bool isLiveEvent );
 
         void toggleReadLock( bool locked );
+
+        // incremented whenever the events (or their properties) change, allows detecting
+        // changes without locking and iterating the events (see Freezer)
+
+        unsigned int getModificationCount();
+        void markModified();
+
         void registerInSequencer();
         void unregisterFromSequencer();
 
@@ -58,10 +66,10 @@ class BaseInstrument
         std::vector<BaseAudioEvent*>* _audioEvents;
         std::vector<BaseAudioEvent*>* _liveAudioEvents;
 
-        float _oldTempo; // last known sequencer tempo
-
         // mutex to lock event vector mutations
         std::mutex _lock;
+
+        std::atomic<unsigned int> _modificationCount;
 };
 } // E.O namespace MWEngine
 
@@ -64,6 +64,7 @@ void DrumInstrument::updateEvents()
     for ( int i = 0, l = drumPatterns->size(); i < l; ++i ) {
         drumPatterns->at( i )->cacheEvents( drumTimbre );
     }
+    markModified();
 }
 
 void DrumInstrument::clearEvents()
@@ -80,6 +81,7 @@ void DrumInstrument::clearEvents()
 //        drumPatterns->clear();
     }
     activeDrumPattern = 0;
+    markModified();
 }
 
 bool DrumInstrument::removeEvent( BaseAudioEvent* audioEvent, bool isLiveEvent )
@@ -112,6 +114,7 @@ bool DrumInstrument::removeEvent( BaseAudioEvent* audioEvent, bool isLiveEvent )
         if ( removed ) {
             delete audioEvent;
             audioEvent = nullptr;
+            markModified();
         }
     }
     return removed;
@@ -42,27 +42,4 @@ SampledInstrument::~SampledInstrument()
     // nowt... see BaseInstrument
 }
 
-/* public methods */
-
-void SampledInstrument::updateEvents()
-{
-    // for a SampledInstrument we don't update the events length range
-    // as the length cannot exceed the bufferSize of its sample
-
-    if ( _oldTempo != AudioEngine::tempo ) {
-
-        // when tempo has updated, we update the offsets of all associated events
-
-        float ratio = _oldTempo / AudioEngine::tempo;
-
-        for ( int i = 0, l = _audioEvents->size(); i < l; ++i )
-        {
-            SampleEvent* event = ( SampleEvent* ) _audioEvents->at( i );
-            event->setEventStart(( int )(( float ) event->getEventStart() * ratio ));
-            event->setEventEnd( event->getEventStart() + event->getOriginalEventLength() );
-        }
-        _oldTempo = AudioEngine::tempo;
-    }
-}
-
 } // E.O namespace MWEngine
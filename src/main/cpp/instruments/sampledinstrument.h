@@ -32,8 +32,6 @@ class SampledInstrument : public BaseInstrument
     public:
         SampledInstrument();
         ~SampledInstrument();
-
-        void updateEvents();
 };
 } // E.O namespace MWEngine
 
@@ -23,6 +23,7 @@
 #include "javautilities.h"
 #include "../audiobuffer.h"
 #include "..//wavetable.h"
+#include <utilities/levelmeter.h>
 #include <utilities/samplemanager.h>
 #include <utilities/tablepool.h>
 #include <generators/wavegenerator.h>
@@ -45,7 +46,22 @@ bool JavaUtilities::createSampleFromFile( jstring aKey, jstring aWAVFilePath )
     if ( WAV.buffer == nullptr )
         return false;
 
-    SampleManager::setSample( JavaBridge::getString( aKey ), WAV.buffer, WAV.sampleRate );
+    SampleManager::setSample( JavaBridge::getString( aKey ), WAV.buffer, WAV.sampleRate, thePath );
+
+    return true;
+}
+
+bool JavaUtilities::createStreamedSampleFromFile( jstring aKey, jstring aWAVFilePath )
+{
+    std::string thePath = JavaBridge::getString( aWAVFilePath );
+    waveFile WAV = WaveReader::fileToBuffer( thePath );
+
+    // error during loading of WAV file ?
+
+    if ( WAV.buffer == nullptr )
+        return false;
+
+    SampleManager::setStreamedSample( JavaBridge::getString( aKey ), WAV.buffer, WAV.sampleRate, thePath );
 
     return true;
 }
@@ -226,4 +242,20 @@ bool JavaUtilities::createTableFromFile( jstring tableId, jstring aWAVFilePath )
     return true;
 }
 
+/* LevelMeter hooks */
+
+int JavaUtilities::getLevels( jfloatArray aLevels )
+{
+    JNIEnv* env = JavaBridge::getEnvironment();
+
+    float levels[ LevelMeter::MAX_METERS * LevelMeter::STRIDE ];
+    int maxMeters = env->GetArrayLength( aLevels ) / LevelMeter::STRIDE;
+    int amount    = LevelMeter::read( levels, std::min( maxMeters, ( int ) LevelMeter::MAX_METERS ));
+
+    // copy all levels in a single region write (no pinning of the Java array required)
+    env->SetFloatArrayRegion( aLevels, 0, amount * LevelMeter::STRIDE, levels );
+
+    return amount;
+}
+
 } // E.O namespace MWEngine
@@ -40,6 +40,11 @@ class JavaUtilities
 
         static bool createSampleFromFile( jstring aKey, jstring aWAVFilePath );
 
+        // creates an AudioBuffer from a given WAV file and stores it inside the SampleManager
+        // under given key "aKey" as a streamed sample (only its pre-roll is guaranteed to remain in memory)
+
+        static bool createStreamedSampleFromFile( jstring aKey, jstring aWAVFilePath );
+
         // creates an AudioBuffer from a packaged asset and stores it inside
         // the SampleManager under given key "aKey". cacheDir specifies the cache directory
         // the application can make a temporary swap file in during reading
@@ -61,6 +66,12 @@ class JavaUtilities
         // convert it to a WaveTable to be stored under given waveformType identifier inside the TablePool
 
         static bool createTableFromFile( jstring tableId, jstring aWAVFilePath );
+
+        // copies the levels of the master bus and all channels (see LevelMeter) into given
+        // array in a single call, the array should hold LevelMeter::MAX_METERS * LevelMeter::STRIDE
+        // values. Returns the amount of meters that were copied
+
+        static int getLevels( jfloatArray aLevels );
 };
 } // E.O namespace MWEngine
 
@@ -72,6 +72,17 @@ class LFO
             return std::min( _max, _min + _range * ( float ) _table->peek() );
         }
 
+        // sweep the LFO by given amount of samples and return the modulated
+        // value at the last of these samples (e.g. for control rate modulation)
+
+        inline float sweep( int amount )
+        {
+            if ( amount > 1 )
+                _table->advance( amount - 1 );
+
+            return sweep();
+        }
+
 
     protected:
         float _rate;
@@ -18,15 +18,19 @@ using namespace MWEngine;
 #include "jni/javautilities.h"
 #include "definitions/notifications.h"
 #include "definitions/waveforms.h"
+#include "audiobus.h"
 #include "audiochannel.h"
 #include "processingchain.h"
+#include "routinggraph.h"
 #include "processors/bitcrusher.h"
+#include "processors/convolutionreverb.h"
 #include "processors/baseprocessor.h"
 #include "processors/decimator.h"
 #include "processors/delay.h"
 #include "processors/filter.h"
 #include "processors/flanger.h"
 #include "processors/limiter.h"
+#include "processors/lookaheadlimiter.h"
 #include "processors/fm.h"
 #include "processors/formantfilter.h"
 #include "processors/glitcher.h"
@@ -40,14 +44,23 @@ using namespace MWEngine;
 #include "processors/waveshaper.h"
 #include "utilities/bufferutility.h"
 #include "utilities/bulkcacher.h"
+#include "utilities/levelmeter.h"
+#include "utilities/audiorenderer.h"
+#include "utilities/freezer.h"
+#include "utilities/tempomap.h"
+#include "utilities/inputcapture.h"
 #include "utilities/levelutility.h"
+#include "utilities/resampler.h"
 #include "drumpattern.h"
 #include "modules/adsr.h"
 #include "modules/arpeggiator.h"
 #include "modules/lfo.h"
 #include "modules/routeableoscillator.h"
+#include "utilities/samplestream.h"
 #include "utilities/samplemanager.h"
 #include "utilities/sampleutility.h"
+#include "utilities/baseencoder.h"
+#include "utilities/waveencoder.h"
 #include "instruments/baseinstrument.h"
 #include "instruments/druminstrument.h"
 #include "instruments/sampledinstrument.h"
@@ -85,6 +98,7 @@ using namespace MWEngine;
 %include "jni/javautilities.h"
 %include "definitions/notifications.h"
 %include "definitions/waveforms.h"
+%include "audiobus.h"
 %include "audiochannel.h"
 %include "modules/adsr.h"
 %include "modules/arpeggiator.h"
@@ -92,13 +106,16 @@ using namespace MWEngine;
 %include "modules/routeableoscillator.h"
 %include "audiochannel.h"
 %include "processingchain.h"
+%include "routinggraph.h"
 %include "processors/baseprocessor.h"
 %include "processors/bitcrusher.h"
+%include "processors/convolutionreverb.h"
 %include "processors/decimator.h"
 %include "processors/delay.h"
 %include "processors/filter.h"
 %include "processors/flanger.h"
 %include "processors/limiter.h"
+%include "processors/lookaheadlimiter.h"
 %include "processors/lowpassfilter.h"
 %include "processors/lpfhpfilter.h"
 %include "processors/fm.h"
@@ -112,10 +129,19 @@ using namespace MWEngine;
 %include "processors/waveshaper.h"
 %include "utilities/bufferutility.h"
 %include "utilities/bulkcacher.h"
+%include "utilities/levelmeter.h"
+%include "utilities/audiorenderer.h"
+%include "utilities/freezer.h"
+%include "utilities/tempomap.h"
+%include "utilities/inputcapture.h"
 %include "utilities/levelutility.h"
+%include "utilities/resampler.h"
 %include "utilities/sampleutility.h"
 %include "drumpattern.h"
+%include "utilities/samplestream.h"
 %include "utilities/samplemanager.h"
+%include "utilities/baseencoder.h"
+%include "utilities/waveencoder.h"
 %include "instruments/baseinstrument.h"
 %include "instruments/druminstrument.h"
 %include "instruments/sampledinstrument.h"
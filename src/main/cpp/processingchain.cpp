@@ -68,4 +68,14 @@ std::vector<BaseProcessor*> ProcessingChain::getActiveProcessors()
     return _activeProcessors;
 }
 
+int ProcessingChain::getLatency()
+{
+    int latency = 0;
+
+    for ( size_t i = 0; i < _activeProcessors.size(); ++i )
+        latency += _activeProcessors.at( i )->getLatency();
+
+    return latency;
+}
+
 } // E.O namespace MWEngine
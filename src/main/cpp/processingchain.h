@@ -41,6 +41,9 @@ class ProcessingChain
         void removeProcessor( BaseProcessor* aProcessor );
         void reset();
 
+        // the summed latency (in samples) of all active processors
+        int getLatency();
+
     private:
 
         /* cached chains */
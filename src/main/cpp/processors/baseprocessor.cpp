@@ -55,4 +55,9 @@ bool BaseProcessor::isCacheable()
     return false;   // override in subclass
 }
 
+int BaseProcessor::getLatency()
+{
+    return 0;   // override in subclass
+}
+
 } // E.O namespace MWEngine
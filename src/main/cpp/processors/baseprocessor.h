@@ -50,6 +50,12 @@ class BaseProcessor
          */
         virtual bool isCacheable();
 
+        /**
+         * the amount of samples by which this processors output is delayed
+         * relative to its input, allowing the engine to compensate for it
+         */
+        virtual int getLatency();
+
         /**
          * Store a reference to the processing that contains
          * this processor. This allows the BaseProcessor to unregister
@@ -0,0 +1,440 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "convolutionreverb.h"
+#include "../global.h"
+#include "../audioengine.h"
+#include <utilities/denormalguard.h>
+#include <utilities/resampler.h>
+#include <utilities/samplemanager.h>
+#include <utilities/wavereader.h>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+
+namespace MWEngine {
+
+const int ConvolutionReverb::TAIL_FACTOR;
+
+/* constructor / destructor */
+
+ConvolutionReverb::ConvolutionReverb( int partitionSize, float dry, float wet, int amountOfChannels )
+{
+    _partitionSize = 16;
+    while ( _partitionSize < partitionSize )
+        _partitionSize <<= 1;
+
+    _tailSize              = _partitionSize * TAIL_FACTOR;
+    _amountOfChannels      = amountOfChannels;
+    _impulseResponseLength = 0;
+    _dry                   = dry;
+    _wet                   = wet;
+
+    _inputBlock   = new AudioBuffer( amountOfChannels, _partitionSize );
+    _outputBlock  = new AudioBuffer( amountOfChannels, _partitionSize );
+    _tailInput    = new AudioBuffer( amountOfChannels, _tailSize );
+    _tailJobInput = new AudioBuffer( amountOfChannels, _tailSize );
+    _tailFront    = new AudioBuffer( amountOfChannels, _tailSize );
+    _tailBack     = new AudioBuffer( amountOfChannels, _tailSize );
+    _blockIndex   = 0;
+    _tailIndex    = 0;
+
+    _pendingSet       = nullptr;
+    _retiredSets      = nullptr;
+    _activeSet        = nullptr;
+    _resetRequested   = false;
+    _tailStale        = true;
+    _tailResetPending = false;
+    _tailJobSet       = nullptr;
+    _tailJobChannels  = 0;
+    _tailJobReset     = false;
+    _tailJobPending   = false;
+    _running          = true;
+    _tailThread      = std::thread( &ConvolutionReverb::handleTailThread, this );
+}
+
+ConvolutionReverb::~ConvolutionReverb()
+{
+    _running = false;
+    _tailSignal.signal();
+    _tailThread.join();
+
+    if ( _activeSet != nullptr )
+        retireSet( _activeSet );
+
+    deleteSets( _pendingSet.exchange( nullptr ));
+    deleteSets( _retiredSets.exchange( nullptr ));
+
+    delete _inputBlock;
+    delete _outputBlock;
+    delete _tailInput;
+    delete _tailJobInput;
+    delete _tailFront;
+    delete _tailBack;
+}
+
+/* public methods */
+
+bool ConvolutionReverb::loadImpulseResponse( std::string sampleIdentifier )
+{
+    if ( !SampleManager::hasSample( sampleIdentifier ))
+        return false;
+
+    AudioBuffer* impulseResponse = SampleManager::retainSample( sampleIdentifier );
+
+    if ( impulseResponse == nullptr )
+        return false;
+
+    setImpulseResponse( impulseResponse, SampleManager::getSampleRateForSample( sampleIdentifier ));
+    SampleManager::releaseBuffer( impulseResponse );
+
+    return true;
+}
+
+bool ConvolutionReverb::loadImpulseResponseFromFile( std::string filePath )
+{
+    waveFile file = WaveReader::fileToBuffer( filePath );
+
+    if ( file.buffer == nullptr )
+        return false;
+
+    setImpulseResponse( file.buffer, file.sampleRate );
+    delete file.buffer;
+
+    return true;
+}
+
+void ConvolutionReverb::setImpulseResponse( AudioBuffer* impulseResponse, unsigned int sampleRate )
+{
+    int length = impulseResponse->bufferSize;
+    AudioBuffer* source = impulseResponse;
+
+    // convert the impulse response to the engine sample rate
+
+    if ( sampleRate > 0 && ( int ) sampleRate != AudioEngineProps::SAMPLE_RATE )
+    {
+        double increment = ( double ) sampleRate / ( double ) AudioEngineProps::SAMPLE_RATE;
+        length = ( int ) ceil( impulseResponse->bufferSize / increment );
+        source = new AudioBuffer( impulseResponse->amountOfChannels, length );
+
+        for ( int c = 0; c < impulseResponse->amountOfChannels; ++c ) {
+            Resampler::mix( Resampler::SINC, impulseResponse->getBufferForChannel( c ), impulseResponse->bufferSize,
+                            source->getBufferForChannel( c ), length, 0.0, increment, 1.0 );
+        }
+    }
+
+    // partition the impulse response for each channel, the head spans the first two tail partitions
+
+    int headLength = std::min( length, _tailSize * 2 );
+    int tailLength = length - headLength;
+
+    ConvolverSet* set = new ConvolverSet();
+    set->next = nullptr;
+
+    for ( int c = 0; c < _amountOfChannels; ++c )
+    {
+        SAMPLE_TYPE* kernel = source->getBufferForChannel( std::min( c, source->amountOfChannels - 1 ));
+
+        set->head.push_back( new PartitionedConvolver( _partitionSize, kernel, headLength ));
+
+        if ( tailLength > 0 )
+            set->tail.push_back( new PartitionedConvolver( _tailSize, kernel + headLength, tailLength ));
+    }
+
+    if ( source != impulseResponse )
+        delete source;
+
+    // publish the set to the audio thread, a previously published set that wasn't
+    // picked up yet has never been used and can be deleted right away
+
+    _impulseResponseLength = length;
+    deleteSets( _pendingSet.exchange( set ));
+}
+
+int ConvolutionReverb::getImpulseResponseLength()
+{
+    return _impulseResponseLength;
+}
+
+int ConvolutionReverb::getPartitionSize()
+{
+    return _partitionSize;
+}
+
+float ConvolutionReverb::getDry()
+{
+    return _dry;
+}
+
+void ConvolutionReverb::setDry( float value )
+{
+    _dry = std::max( 0.f, std::min( 1.f, value ));
+}
+
+float ConvolutionReverb::getWet()
+{
+    return _wet;
+}
+
+void ConvolutionReverb::setWet( float value )
+{
+    _wet = std::max( 0.f, std::min( 1.f, value ));
+}
+
+void ConvolutionReverb::process( AudioBuffer* sampleBuffer, bool isMonoSource )
+{
+    ConvolverSet* set = _pendingSet.exchange( nullptr );
+
+    if ( set != nullptr ) {
+        if ( _activeSet != nullptr )
+            retireSet( _activeSet );
+
+        _activeSet = set;
+        clearBuffers();
+    }
+
+    if ( _activeSet == nullptr )
+        return;
+
+    if ( _resetRequested.exchange( false )) {
+        for ( size_t i = 0; i < _activeSet->head.size(); ++i )
+            _activeSet->head.at( i )->reset();
+
+        // the tail convolvers can be in use by the tail thread, these are reset by the next job
+        clearBuffers();
+        _tailResetPending = true;
+    }
+
+    // decaying tails produce denormal numbers, flush these to zero
+    DenormalGuard denormalGuard;
+
+    int bufferSize       = sampleBuffer->bufferSize;
+    int amountOfChannels = isMonoSource ? 1 : std::min( _amountOfChannels, sampleBuffer->amountOfChannels );
+
+    for ( int offset = 0; offset < bufferSize; )
+    {
+        int amount = std::min( _partitionSize - _blockIndex, bufferSize - offset );
+
+        // gather the input and write the output of the previously convolved block
+
+        for ( int c = 0; c < amountOfChannels; ++c )
+        {
+            SAMPLE_TYPE* channelBuffer = sampleBuffer->getBufferForChannel( c ) + offset;
+            SAMPLE_TYPE* inputBlock    = _inputBlock->getBufferForChannel( c ) + _blockIndex;
+            SAMPLE_TYPE* outputBlock   = _outputBlock->getBufferForChannel( c ) + _blockIndex;
+
+            for ( int i = 0; i < amount; ++i )
+            {
+                inputBlock[ i ]    = channelBuffer[ i ];
+                channelBuffer[ i ] = channelBuffer[ i ] * _dry + outputBlock[ i ] * _wet;
+            }
+        }
+        offset      += amount;
+        _blockIndex += amount;
+
+        if ( _blockIndex == _partitionSize ) {
+            processBlock( amountOfChannels );
+            _blockIndex = 0;
+        }
+    }
+
+    if ( isMonoSource )
+        sampleBuffer->applyMonoSource();
+}
+
+int ConvolutionReverb::getLatency()
+{
+    return _partitionSize;
+}
+
+void ConvolutionReverb::reset()
+{
+    _resetRequested = true;
+}
+
+void ConvolutionReverb::waitForTail()
+{
+    while ( _tailJobPending )
+        std::this_thread::sleep_for( std::chrono::microseconds( 100 ));
+}
+
+/* private methods */
+
+void ConvolutionReverb::processBlock( int amountOfChannels )
+{
+    for ( int c = 0; c < amountOfChannels; ++c )
+    {
+        SAMPLE_TYPE* inputBlock  = _inputBlock->getBufferForChannel( c );
+        SAMPLE_TYPE* outputBlock = _outputBlock->getBufferForChannel( c );
+
+        _activeSet->head.at( c )->process( inputBlock, outputBlock );
+
+        if ( _activeSet->tail.empty())
+            continue;
+
+        // mix in the tail output for this block and gather the input for the next tail partition
+
+        SAMPLE_TYPE* tailOutput = _tailFront->getBufferForChannel( c ) + _tailIndex;
+        SAMPLE_TYPE* tailInput  = _tailInput->getBufferForChannel( c ) + _tailIndex;
+
+        for ( int i = 0; i < _partitionSize; ++i ) {
+            outputBlock[ i ] += tailOutput[ i ];
+            tailInput[ i ]    = inputBlock[ i ];
+        }
+    }
+
+    if ( _activeSet->tail.empty())
+        return;
+
+    _tailIndex += _partitionSize;
+
+    if ( _tailIndex == _tailSize ) {
+        submitTailJob( amountOfChannels );
+        _tailIndex = 0;
+    }
+}
+
+/**
+ * hands the gathered tail partition to the tail thread. The output of the previously
+ * submitted partition is required from here on. The tail thread was given the duration of
+ * an entire tail partition to compute it, should it still be busy the audio thread does
+ * not wait: the gathered partition is dropped and the tail is silenced for the next
+ * period (as is the late output, once it arrives). When processing isn't bound to real
+ * time (bouncing or rendering outside of the engine, e.g. AudioRenderer) the tail is awaited
+ */
+void ConvolutionReverb::submitTailJob( int amountOfChannels )
+{
+    if ( AudioEngine::bouncing || !AudioEngine::isRenderThread())
+        waitForTail();
+
+    if ( _tailJobPending.load( std::memory_order_acquire )) {
+        _tailFront->silenceBuffers();
+        _tailStale = true;
+        return;
+    }
+
+    if ( _tailStale ) {
+        _tailBack->silenceBuffers();
+        _tailStale = false;
+    }
+    std::swap( _tailFront, _tailBack );
+    std::swap( _tailInput, _tailJobInput );
+
+    _tailJobSet       = _activeSet;
+    _tailJobChannels  = amountOfChannels;
+    _tailJobReset     = _tailResetPending;
+    _tailResetPending = false;
+
+    _tailJobPending.store( true, std::memory_order_release );
+    _tailSignal.signal();
+}
+
+void ConvolutionReverb::handleTailThread()
+{
+    // flush-to-zero is set per thread, as such it is enabled for the lifetime of the tail thread
+    DenormalGuard denormalGuard;
+
+    while ( _running )
+    {
+        // collect the retired sets before checking for a job: a job referencing a retired
+        // set was submitted before it was retired, so it is processed before the set is deleted
+
+        ConvolverSet* retired = _retiredSets.exchange( nullptr, std::memory_order_acquire );
+
+        bool hasJob = _tailJobPending.load( std::memory_order_acquire );
+
+        if ( hasJob )
+        {
+            ConvolverSet* set = _tailJobSet;
+
+            if ( _tailJobReset ) {
+                for ( size_t i = 0; i < set->tail.size(); ++i )
+                    set->tail.at( i )->reset();
+            }
+
+            for ( int c = 0; c < _tailJobChannels; ++c )
+                set->tail.at( c )->process( _tailJobInput->getBufferForChannel( c ), _tailBack->getBufferForChannel( c ));
+
+            _tailJobPending.store( false, std::memory_order_release );
+        }
+        deleteSets( retired );
+
+        // await the next job or retired set (signals raised while processing wake the thread right away)
+
+        if ( !hasJob )
+            _tailSignal.wait();
+    }
+}
+
+/**
+ * invoked by the audio thread to hand a set that is no longer in use to the tail
+ * thread for deletion (lock-free push onto the retired set stack)
+ */
+void ConvolutionReverb::retireSet( ConvolverSet* set )
+{
+    ConvolverSet* head = _retiredSets.load( std::memory_order_relaxed );
+
+    do {
+        set->next = head;
+    } while ( !_retiredSets.compare_exchange_weak( head, set, std::memory_order_release, std::memory_order_relaxed ));
+
+    _tailSignal.signal();
+}
+
+void ConvolutionReverb::deleteSets( ConvolverSet* set )
+{
+    while ( set != nullptr )
+    {
+        ConvolverSet* next = set->next;
+
+        clearConvolvers( set->head );
+        clearConvolvers( set->tail );
+        delete set;
+
+        set = next;
+    }
+}
+
+void ConvolutionReverb::clearBuffers()
+{
+    _inputBlock->silenceBuffers();
+    _outputBlock->silenceBuffers();
+    _tailInput->silenceBuffers();
+    _tailFront->silenceBuffers();
+
+    // the job buffers can be in use by the tail thread, the back buffer is
+    // silenced before it is swapped to the front
+
+    _blockIndex = 0;
+    _tailIndex  = 0;
+    _tailStale  = true;
+}
+
+void ConvolutionReverb::clearConvolvers( std::vector<PartitionedConvolver*>& convolvers )
+{
+    for ( size_t i = 0; i < convolvers.size(); ++i )
+        delete convolvers.at( i );
+
+    convolvers.clear();
+}
+
+} // E.O namespace MWEngine
@@ -0,0 +1,170 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__CONVOLUTIONREVERB_H_INCLUDED__
+#define __MWENGINE__CONVOLUTIONREVERB_H_INCLUDED__
+
+#include "baseprocessor.h"
+#include <utilities/partitionedconvolver.h>
+#include <utilities/worksignal.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+namespace MWEngine {
+
+/**
+ * ConvolutionReverb convolves its input with a sampled impulse response (e.g. a
+ * recorded space or a cabinet), using non-uniformly partitioned FFT convolution
+ *
+ * the impulse response is split in two segments: the head is convolved on the audio
+ * thread using partitions of partitionSize samples (which determines the latency),
+ * while the (much longer) tail is convolved on a background thread using partitions
+ * of partitionSize * TAIL_FACTOR samples, keeping the CPU load of multi-second impulse
+ * responses manageable. The head spans two tail partitions, so a block of tail output
+ * is computed during the period in which the next tail block of input is gathered
+ */
+class ConvolutionReverb : public BaseProcessor
+{
+    public:
+
+        static const int TAIL_FACTOR = 8;
+
+        /**
+         * @param partitionSize {int} amount of samples per partition of the head, rounded up to a
+         *                      power of two, equals the latency of this processor (e.g. the buffer size)
+         * @param dry           {float} 0-1, volume of the unprocessed signal
+         * @param wet           {float} 0-1, volume of the convolved signal
+         * @param amountOfChannels {int} amount of output channels
+         */
+        ConvolutionReverb( int partitionSize, float dry, float wet, int amountOfChannels );
+        ~ConvolutionReverb();
+
+        // load the impulse response from a sample registered in the SampleManager
+
+        bool loadImpulseResponse( std::string sampleIdentifier );
+
+        // load the impulse response from a WAV file
+
+        bool loadImpulseResponseFromFile( std::string filePath );
+
+        /**
+         * set the impulse response, the contents of given buffer are copied (resampled when
+         * sampleRate differs from the engine's). A mono impulse response is applied to all
+         * channels, otherwise each channel is convolved with its own impulse response channel
+         * NOTE: partitioning a long impulse response is expensive, invoke outside of the audio thread
+         */
+        void setImpulseResponse( AudioBuffer* impulseResponse, unsigned int sampleRate );
+
+        int getImpulseResponseLength();
+        int getPartitionSize();
+
+        float getDry();
+        void setDry( float value );
+        float getWet();
+        void setWet( float value );
+
+        void process( AudioBuffer* sampleBuffer, bool isMonoSource );
+        int getLatency();
+
+        // clear the reverb tail, applied by the audio thread at the start of the next process() call
+
+        void reset();
+
+        /**
+         * blocks until the tail thread has convolved the last submitted tail partition. The audio
+         * thread only waits for the tail while bouncing, processing outside of the audio thread
+         * (e.g. AudioRenderer) always awaits the tail, as such this should rarely be invoked directly
+         * NOTE: never invoke this on the audio thread
+         */
+        void waitForTail();
+
+    private:
+
+        float _dry;
+        float _wet;
+
+        int _partitionSize;
+        int _tailSize;         // partition size of the tail
+        int _amountOfChannels;
+        int _impulseResponseLength;
+
+        // convolvers per channel (the tail convolvers are only created for long impulse responses)
+        // a set is built outside of the audio thread and published through _pendingSet, the audio
+        // thread picks it up at the start of process() and retires the previous set, which is
+        // deleted by the tail thread once it can no longer be referenced by a tail job
+
+        struct ConvolverSet {
+            std::vector<PartitionedConvolver*> head;
+            std::vector<PartitionedConvolver*> tail;
+            ConvolverSet* next; // next retired set
+        };
+
+        std::atomic<ConvolverSet*> _pendingSet;
+        std::atomic<ConvolverSet*> _retiredSets;
+        ConvolverSet* _activeSet; // only accessed by the audio thread
+        std::atomic<bool> _resetRequested;
+
+        // the audio thread gathers partitionSize samples of input before convolving these,
+        // output is read from the previously convolved block (per channel)
+
+        AudioBuffer* _inputBlock;
+        AudioBuffer* _outputBlock;
+        int _blockIndex;
+
+        // the tail input is gathered per tail partition and handed to the background thread,
+        // which writes its result into the back buffer. Once the next tail partition has been
+        // gathered the front and back buffers are swapped (per channel). When the tail thread
+        // hasn't finished in time, the audio thread doesn't wait: the gathered partition is
+        // dropped and the tail is silent until a job completes in time again
+
+        AudioBuffer* _tailInput;
+        AudioBuffer* _tailJobInput;
+        AudioBuffer* _tailFront;
+        AudioBuffer* _tailBack;
+        int  _tailIndex;
+        bool _tailStale;        // whether the back buffer holds output that must not be heard
+        bool _tailResetPending; // whether the tail convolvers must be reset before the next job
+
+        // job description, written by the audio thread before _tailJobPending is set
+
+        ConvolverSet* _tailJobSet;
+        int  _tailJobChannels;
+        bool _tailJobReset;
+
+        std::thread _tailThread;
+        WorkSignal _tailSignal; // wakes the tail thread, signalled by the audio thread (submitted jobs and retired sets)
+        std::atomic<bool> _tailJobPending;
+        std::atomic<bool> _running;
+
+        void processBlock( int amountOfChannels );
+        void submitTailJob( int amountOfChannels );
+        void handleTailThread();
+        void retireSet( ConvolverSet* set );
+        void deleteSets( ConvolverSet* set );
+        void clearBuffers();
+        void clearConvolvers( std::vector<PartitionedConvolver*>& convolvers );
+};
+} // E.O namespace MWEngine
+
+#endif
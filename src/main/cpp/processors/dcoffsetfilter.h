@@ -26,6 +26,7 @@
 #define __MWENGINE__DCOFFSETFILTER_H_INCLUDED__
 
 #include "baseprocessor.h"
+#include <utilities/biquadcascade.h>
 
 namespace MWEngine {
 class DCOffsetFilter : public BaseProcessor
@@ -37,9 +38,8 @@ class DCOffsetFilter : public BaseProcessor
         void process( AudioBuffer* sampleBuffer, bool isMonoSource );
 
     private:
-        SAMPLE_TYPE* _lastInSamples;
-        SAMPLE_TYPE* _lastOutSamples;
-        SAMPLE_TYPE  R;
+        BiquadCascade* _biquad;
+        SAMPLE_TYPE    R;
 };
 } // E.O namespace MWEngine
 
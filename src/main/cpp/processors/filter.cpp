@@ -23,9 +23,12 @@
 #include "filter.h"
 #include "../global.h"
 #include <math.h>
+#include <algorithm>
 
 namespace MWEngine {
 
+const int Filter::CONTROL_RATE;
+
 /**
  * @param aCutoffFrequency {float} desired cutoff frequency in Hz
  * @param aResonance {float} resonance
@@ -58,69 +61,48 @@ Filter::~Filter()
 {
     //delete _lfo; // nope... belongs to routeable oscillator in the instrument
 
-    delete[] in1;
-    delete[] in2;
-    delete[] out1;
-    delete[] out2;
-
-    in1 = in2 = out1 = out2 = nullptr;
+    delete _biquad;
+    _biquad = nullptr;
 }
 
 /* public methods */
 
 void Filter::process( AudioBuffer* sampleBuffer, bool isMonoSource )
 {
-    int bufferSize               = sampleBuffer->bufferSize;
-    bool doLFO                   = hasLFO();
-    SAMPLE_TYPE initialLFOOffset = doLFO ? _lfo->getTable()->getAccumulator() : 0.0;
-    float orgCutoff              = _tempCutoff;
+    int bufferSize = sampleBuffer->bufferSize;
 
     if ( amountOfChannels < sampleBuffer->amountOfChannels )
         isMonoSource = true;
 
-    for ( int i = 0, l = sampleBuffer->amountOfChannels; i < l; ++i )
-    {
-        SAMPLE_TYPE* channelBuffer = sampleBuffer->getBufferForChannel( i );
+    // save CPU cycles when source is mono (only the first channel is filtered)
+    // all channels are processed in a single pass so they share the same LFO movement
 
-        // each channel needs the same offset to get the same LFO movement ;)
-        if ( doLFO && i > 0 )
-        {
-            _lfo->getTable()->setAccumulator( initialLFOOffset );
-            _tempCutoff = orgCutoff;
-            calculateParameters();
-        }
+    int channels = isMonoSource ? 1 : sampleBuffer->amountOfChannels;
 
-        for ( int j = 0; j < bufferSize; ++j )
+    if ( !hasLFO() )
+    {
+        _biquad->process( sampleBuffer, channels, 0, bufferSize );
+    }
+    else {
+        for ( int i = 0; i < bufferSize; i += CONTROL_RATE )
         {
-            SAMPLE_TYPE input = channelBuffer[ j ];
-            output            = a1 * input + a2 * in1[ i ] + a3 * in2[ i ] - b1 * out1[ i ] - b2 * out2[ i ];
-
-            in2 [ i ] = in1[ i ];
-            in1 [ i ] = input;
-            out2[ i ] = out1[ i ];
-            out1[ i ] = output;
+            int blockSize = std::min( CONTROL_RATE, bufferSize - i );
 
             // oscillator attached to Filter ? travel the cutoff values
             // between the minimum and maximum frequencies, as
-            // defined by the range in the class constructor
+            // defined by the range in the class constructor. The coefficients
+            // for the LFO position at the end of the block are calculated
+            // once, the coefficients within the block are interpolated
 
-            if ( doLFO )
-            {
-                _tempCutoff = _lfo->sweep();
-                calculateParameters();
-            }
+            _tempCutoff = _lfo->sweep( blockSize );
+            calculateParameters( blockSize );
 
-            // commit the effect
-            channelBuffer[ j ] = output;
-        }
-
-        // save CPU cycles when source is mono
-        if ( isMonoSource )
-        {
-            sampleBuffer->applyMonoSource();
-            break;
+            _biquad->process( sampleBuffer, channels, i, blockSize );
         }
     }
+
+    if ( isMonoSource )
+        sampleBuffer->applyMonoSource();
 }
 
 bool Filter::isCacheable()
@@ -197,24 +179,22 @@ void Filter::init( float cutoff )
     _cutoff     = _maxFreq;
     _tempCutoff = _cutoff;
 
-    in1  = new SAMPLE_TYPE[ amountOfChannels ];
-    in2  = new SAMPLE_TYPE[ amountOfChannels ];
-    out1 = new SAMPLE_TYPE[ amountOfChannels ];
-    out2 = new SAMPLE_TYPE[ amountOfChannels ];
-
-    for ( int i = 0; i < amountOfChannels; ++i )
-    {
-        in1 [ i ] = 0.0;
-        in2 [ i ] = 0.0;
-        out1[ i ] = 0.0;
-        out2[ i ] = 0.0;
-    }
+    _biquad = new BiquadCascade( amountOfChannels, 1 );
 
     // using this setter caches appropriate values
     setCutoff( cutoff );
 }
 
 void Filter::calculateParameters()
+{
+    calculateParameters( 0 );
+}
+
+/**
+ * @param rampSamples {int} when larger than 0, the amount of samples over
+ *        which the filter interpolates towards the calculated coefficients
+ */
+void Filter::calculateParameters( int rampSamples )
 {
     c  = 1.f / tan( PI * _tempCutoff / SAMPLE_RATE );
     a1 = 1.f / ( 1.f + _resonance * c + c * c );
@@ -222,6 +202,13 @@ void Filter::calculateParameters()
     a3 = a1;
     b1 = 2.f * ( 1.f - c * c ) * a1;
     b2 = ( 1.f - _resonance * c + c * c ) * a1;
+
+    // a1 - a3 are the feedforward and b1 - b2 the feedback coefficients
+
+    if ( rampSamples > 0 )
+        _biquad->rampCoefficients( 0, a1, a2, a3, b1, b2, rampSamples );
+    else
+        _biquad->setCoefficients( 0, a1, a2, a3, b1, b2 );
 }
 
 } // E.O namespace MWEngine
@@ -25,6 +25,7 @@
 
 #include "baseprocessor.h"
 #include <modules/lfo.h>
+#include <utilities/biquadcascade.h>
 
 namespace MWEngine {
 class Filter : public BaseProcessor
@@ -44,6 +45,11 @@ class Filter : public BaseProcessor
         void process( AudioBuffer* sampleBuffer, bool isMonoSource );
         bool isCacheable();
 
+        // when modulated by an LFO, the filter coefficients are calculated
+        // once per CONTROL_RATE samples and interpolated in between
+
+        static const int CONTROL_RATE = 32;
+
     protected:
         float _cutoff;
         float _resonance;
@@ -65,16 +71,13 @@ class Filter : public BaseProcessor
         SAMPLE_TYPE b1;
         SAMPLE_TYPE b2;
         SAMPLE_TYPE c;
-        SAMPLE_TYPE output;
 
-        SAMPLE_TYPE* in1;
-        SAMPLE_TYPE* in2;
-        SAMPLE_TYPE* out1;
-        SAMPLE_TYPE* out2;
+        BiquadCascade* _biquad;
 
     private:
         void init( float cutoff );
         void calculateParameters();
+        void calculateParameters( int rampSamples );
 };
 } // E.O namespace MWEngine
 
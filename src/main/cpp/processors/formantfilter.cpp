@@ -24,9 +24,16 @@
 #include "formantfilter.h"
 #include "../utilities/utils.h"
 #include <cmath>
+#include <complex>
 
 namespace MWEngine {
 
+const int FormantFilter::VOWEL_A;
+const int FormantFilter::VOWEL_E;
+const int FormantFilter::VOWEL_I;
+const int FormantFilter::VOWEL_O;
+const int FormantFilter::VOWEL_U;
+
 /* constructor / destructor */
 
 /**
@@ -35,12 +42,10 @@ namespace MWEngine {
  */
 FormantFilter::FormantFilter( double aVowel )
 {
-    int i = 0;
-    for ( ; i < 11; i++ )
+    for ( int i = 0; i < 11; i++ )
         _currentCoeffs[ i ] = 0.0;
 
-    for ( i = 0; i < 10; i++ )
-        _memory[ i ] = 0.0;
+    _biquad = new BiquadCascade( AudioEngineProps::OUTPUT_CHANNELS, 5 );
 
     calculateCoeffs();
     setVowel( aVowel );
@@ -48,7 +53,8 @@ FormantFilter::FormantFilter( double aVowel )
 
 FormantFilter::~FormantFilter()
 {
-    // _currentCoeffs and _memory weren't allocated with new[], nothing to delete[] ;)
+    // _currentCoeffs weren't allocated with new[], nothing to delete[] ;)
+    delete _biquad;
 }
 
 /* public methods */
@@ -96,75 +102,95 @@ void FormantFilter::setVowel( double aVowel )
             _currentCoeffs[ i ] = delta < .5 ? minCoeff : maxCoeff;
         }
     }
+    calculateSections();
 }
 
 void FormantFilter::process( AudioBuffer* sampleBuffer, bool isMonoSource )
 {
-    int bufferSize = sampleBuffer->bufferSize;
+    _biquad->process( sampleBuffer, isMonoSource );
+}
+
+bool FormantFilter::isCacheable()
+{
+    return true;
+}
+
+/* private methods */
 
-    for ( int c = 0, ca = sampleBuffer->amountOfChannels; c < ca; ++c )
+/**
+ * the vowel filter is an all pole filter of the 10th order, e.g.:
+ * y(n) = c0 * x(n) + c1 * y(n-1) + c2 * y(n-2) + ... + c10 * y(n-10)
+ *
+ * its poles are the roots of z^10 - c1 * z^9 - ... - c10, which are found using
+ * the Durand-Kerner method and paired into five second order sections. Running
+ * the filter as a cascade of sections keeps it stable where the direct form
+ * lacks the precision for these (highly resonant) coefficients
+ */
+void FormantFilter::calculateSections()
+{
+    std::complex<double> roots[ 10 ];
+    std::complex<double> seed( 0.4, 0.9 );
+
+    roots[ 0 ] = 1.0;
+    for ( int i = 1; i < 10; ++i )
+        roots[ i ] = roots[ i - 1 ] * seed;
+
+    for ( int iteration = 0; iteration < 500; ++iteration )
     {
-        SAMPLE_TYPE* channelBuffer = sampleBuffer->getBufferForChannel( c );
+        double change = 0.0;
 
-        for ( int i = 0; i < bufferSize; ++i )
+        for ( int i = 0; i < 10; ++i )
         {
-            double res = ( _currentCoeffs[ 0 ]  * channelBuffer[ i ] +
-                           _currentCoeffs[ 1 ]  * _memory[ 0 ] +
-                           _currentCoeffs[ 2 ]  * _memory[ 1 ] +
-                           _currentCoeffs[ 3 ]  * _memory[ 2 ] +
-                           _currentCoeffs[ 4 ]  * _memory[ 3 ] +
-                           _currentCoeffs[ 5 ]  * _memory[ 4 ] +
-                           _currentCoeffs[ 6 ]  * _memory[ 5 ] +
-                           _currentCoeffs[ 7 ]  * _memory[ 6 ] +
-                           _currentCoeffs[ 8 ]  * _memory[ 7 ] +
-                           _currentCoeffs[ 9 ]  * _memory[ 8 ] +
-                           _currentCoeffs[ 10 ] * _memory[ 9 ] );
-
-            _memory[ 9 ] = _memory[ 8 ];
-            _memory[ 8 ] = _memory[ 7 ];
-            _memory[ 7 ] = _memory[ 6 ];
-            _memory[ 6 ] = _memory[ 5 ];
-            _memory[ 5 ] = _memory[ 4 ];
-            _memory[ 4 ] = _memory[ 3 ];
-            _memory[ 3 ] = _memory[ 2 ];
-            _memory[ 2 ] = _memory[ 1 ];
-            _memory[ 1 ] = _memory[ 0 ];
-            _memory[ 0 ] = res;
-
-            // 32-bit float resolution is too low on certain coefficients, below "hack"
-            // cheaply prevents extreme self oscillation to exceed the max. capacity
-
-            #if PRECISION == 1
-                float output;
-
-                if ( res > FLT_MAX )
-                    output = FLT_MAX;
-                else if ( res < -FLT_MAX )
-                    output = -FLT_MAX;
-                else
-                    output = ( float ) res;
-
-                channelBuffer[ i ] = output;
-            #else
-                channelBuffer[ i ] = res;
-            #endif
+            std::complex<double> value = 1.0, denominator = 1.0;
+
+            for ( int k = 1; k < 11; ++k )
+                value = value * roots[ i ] - _currentCoeffs[ k ];
+
+            for ( int j = 0; j < 10; ++j ) {
+                if ( j != i )
+                    denominator *= ( roots[ i ] - roots[ j ]);
+            }
+            std::complex<double> delta = value / denominator;
+            roots[ i ] -= delta;
+            change = std::max( change, std::abs( delta ));
         }
-
-        // omit unnecessary cycles by copying the mono content
-        if ( isMonoSource )
-        {
-            sampleBuffer->applyMonoSource();
+        if ( change < 1e-14 )
             break;
+    }
+
+    // complex poles form a section with their conjugate, real poles are paired
+
+    double a1[ 5 ] = { 0.0 }, a2[ 5 ] = { 0.0 };
+    double reals[ 10 ];
+    int section = 0, amountOfReals = 0;
+
+    for ( int i = 0; i < 10; ++i )
+    {
+        if ( std::abs( roots[ i ].imag() ) < 1e-9 )
+            reals[ amountOfReals++ ] = roots[ i ].real();
+        else if ( roots[ i ].imag() > 0.0 && section < 5 ) {
+            a1[ section ] = -2.0 * roots[ i ].real();
+            a2[ section ] = std::norm( roots[ i ]);
+            ++section;
         }
     }
-}
 
-bool FormantFilter::isCacheable()
-{
-    return true;
-}
+    for ( int i = 0; i < amountOfReals && section < 5; i += 2, ++section )
+    {
+        if ( i + 1 < amountOfReals ) {
+            a1[ section ] = -( reals[ i ] + reals[ i + 1 ]);
+            a2[ section ] = reals[ i ] * reals[ i + 1 ];
+        }
+        else {
+            a1[ section ] = -reals[ i ];
+        }
+    }
 
-/* private methods */
+    // the gain (c0) is applied by the first section
+
+    for ( int s = 0; s < 5; ++s )
+        _biquad->setCoefficients( s, s == 0 ? _currentCoeffs[ 0 ] : 1.0, 0.0, 0.0, a1[ s ], a2[ s ] );
+}
 
 // store the vowel coefficients
 
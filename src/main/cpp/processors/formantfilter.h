@@ -25,6 +25,7 @@
 #define __MWENGINE__FORMANTFILTER_H_INCLUDED__
 
 #include "baseprocessor.h"
+#include <utilities/biquadcascade.h>
 
 namespace MWEngine {
 class FormantFilter : public BaseProcessor
@@ -49,8 +50,9 @@ class FormantFilter : public BaseProcessor
         double  _vowel;
         double _currentCoeffs[ 11 ];
         double _coeffs[ 5 ][ 11 ];
-        double _memory[ 10 ];
+        BiquadCascade* _biquad;
         void calculateCoeffs();
+        void calculateSections();
 };
 } // E.O namespace MWEngine
 
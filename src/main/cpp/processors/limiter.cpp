@@ -87,12 +87,6 @@ float Limiter::getLinearGR()
 
 void Limiter::process( AudioBuffer* sampleBuffer, bool isMonoSource )
 {
-    if ( gain > 0.9999f && sampleBuffer->isSilent())
-    {
-        // don't process if input is silent
-        return;
-    }
-
     SAMPLE_TYPE g, at, re, tr, th, lev, ol, or_;
 
     th = thresh;
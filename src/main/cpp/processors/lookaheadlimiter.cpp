@@ -0,0 +1,264 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "lookaheadlimiter.h"
+#include "../global.h"
+#include <utilities/denormalguard.h>
+#include <algorithm>
+#include <cmath>
+
+namespace MWEngine {
+
+const int LookAheadLimiter::OVERSAMPLING;
+const int LookAheadLimiter::TAPS_PER_PHASE;
+
+/* constructor / destructor */
+
+LookAheadLimiter::LookAheadLimiter( float lookAheadMs, float releaseMs, float ceilingDb, int amountOfChannels )
+{
+    _lookAhead        = std::max( 1, ( int ) round(( AudioEngineProps::SAMPLE_RATE / 1000.f ) * lookAheadMs ));
+    _latency          = _lookAhead + TAPS_PER_PHASE / 2;
+    _amountOfChannels = amountOfChannels;
+
+    int delaySize = 1;
+    while ( delaySize <= _latency )
+        delaySize <<= 1;
+
+    // the deque holds at most one entry per sample inside the window (of _lookAhead + 1 samples)
+
+    int dequeSize = 1;
+    while ( dequeSize <= _lookAhead + 1 )
+        dequeSize <<= 1;
+
+    _delayMask = delaySize - 1;
+    _dequeMask = dequeSize - 1;
+
+    for ( int c = 0; c < amountOfChannels; ++c ) {
+        _delayLines.push_back( std::vector<SAMPLE_TYPE>( delaySize, 0.0 ));
+        _histories.push_back ( std::vector<SAMPLE_TYPE>( TAPS_PER_PHASE * 2, 0.0 ));
+    }
+    _peakPositions.resize( dequeSize, 0 );
+    _peakValues.resize   ( dequeSize, 0.0 );
+    _gains.resize        ( _lookAhead + 1, 1.0 );
+
+    createInterpolator();
+    setRelease( releaseMs );
+    setCeiling( ceilingDb );
+    reset();
+}
+
+LookAheadLimiter::~LookAheadLimiter()
+{
+    // nowt...
+}
+
+/* public methods */
+
+float LookAheadLimiter::getLookAhead()
+{
+    return ( float ) _lookAhead / ( AudioEngineProps::SAMPLE_RATE / 1000.f );
+}
+
+float LookAheadLimiter::getRelease()
+{
+    return _releaseMs;
+}
+
+void LookAheadLimiter::setRelease( float releaseMs )
+{
+    _releaseMs = std::max( 1.f, releaseMs );
+    _releaseCoefficient = ( SAMPLE_TYPE ) exp( -1.0 / ( _releaseMs * 0.001 * AudioEngineProps::SAMPLE_RATE ));
+}
+
+float LookAheadLimiter::getCeiling()
+{
+    return _ceilingDb;
+}
+
+void LookAheadLimiter::setCeiling( float ceilingDb )
+{
+    _ceilingDb = std::min( 0.f, ceilingDb );
+    _ceiling   = ( SAMPLE_TYPE ) pow( 10.0, _ceilingDb / 20.0 );
+}
+
+float LookAheadLimiter::getLinearGR()
+{
+    return ( float ) _gain;
+}
+
+void LookAheadLimiter::process( AudioBuffer* sampleBuffer, bool isMonoSource )
+{
+    DenormalGuard denormalGuard;
+
+    int bufferSize       = sampleBuffer->bufferSize;
+    int amountOfChannels = std::min( _amountOfChannels, sampleBuffer->amountOfChannels );
+
+    if ( isMonoSource )
+        amountOfChannels = 1;
+
+    int windowSize          = ( int ) _gains.size();
+    SAMPLE_TYPE windowScale = 1.0 / windowSize;
+
+    for ( int i = 0; i < bufferSize; ++i, ++_position )
+    {
+        SAMPLE_TYPE peak = 0.0;
+
+        for ( int c = 0; c < amountOfChannels; ++c )
+        {
+            SAMPLE_TYPE sample   = sampleBuffer->getBufferForChannel( c )[ i ];
+            SAMPLE_TYPE* history = &_histories[ c ][ 0 ];
+
+            history[ _historyIndex ]                  = sample;
+            history[ _historyIndex + TAPS_PER_PHASE ] = sample;
+
+            peak = std::max( peak, getTruePeak( history + _historyIndex + 1 ));
+
+            _delayLines[ c ][ _writeIndex ] = sample;
+        }
+        _historyIndex = ( _historyIndex + 1 ) % TAPS_PER_PHASE;
+
+        // maintain the loudest peak inside the look-ahead window: remove all quieter peaks (these
+        // can never become the maximum) and the peak that has moved outside of the window
+
+        while ( _dequeBack != _dequeFront && _peakValues[( _dequeBack - 1 ) & _dequeMask ] <= peak )
+            _dequeBack = ( _dequeBack - 1 ) & _dequeMask;
+
+        _peakPositions[ _dequeBack ] = _position;
+        _peakValues   [ _dequeBack ] = peak;
+        _dequeBack = ( _dequeBack + 1 ) & _dequeMask;
+
+        if ( _peakPositions[ _dequeFront ] + windowSize <= _position )
+            _dequeFront = ( _dequeFront + 1 ) & _dequeMask;
+
+        SAMPLE_TYPE maxPeak  = _peakValues[ _dequeFront ];
+        SAMPLE_TYPE required = maxPeak > _ceiling ? _ceiling / maxPeak : 1.0;
+
+        // averaging the required gain over the window ensures the gain has been lowered to the
+        // required level by the time the peak leaves the delay line (as the window has been
+        // held at or below the required level for its full duration)
+
+        _gainSum += required - _gains[ _gainIndex ];
+        _gains[ _gainIndex ] = required;
+
+        if ( ++_gainIndex == windowSize )
+        {
+            // recalculate the running sum once per window to prevent accumulating rounding errors
+            _gainIndex = 0;
+            _gainSum   = 0.0;
+            for ( int j = 0; j < windowSize; ++j )
+                _gainSum += _gains[ j ];
+        }
+
+        SAMPLE_TYPE target = std::min(( SAMPLE_TYPE ) 1.0, _gainSum * windowScale );
+
+        // attack instantly (the average is already smoothed), recover at the release rate
+
+        _gain = target < _gain ? target : target + ( _gain - target ) * _releaseCoefficient;
+
+        int readIndex = ( _writeIndex - _latency ) & _delayMask;
+
+        for ( int c = 0; c < amountOfChannels; ++c )
+            sampleBuffer->getBufferForChannel( c )[ i ] = _delayLines[ c ][ readIndex ] * _gain;
+
+        _writeIndex = ( _writeIndex + 1 ) & _delayMask;
+    }
+
+    if ( isMonoSource )
+        sampleBuffer->applyMonoSource();
+}
+
+int LookAheadLimiter::getLatency()
+{
+    return _latency;
+}
+
+void LookAheadLimiter::reset()
+{
+    for ( size_t c = 0; c < _delayLines.size(); ++c ) {
+        std::fill( _delayLines[ c ].begin(), _delayLines[ c ].end(), 0.0 );
+        std::fill( _histories[ c ].begin(),  _histories[ c ].end(),  0.0 );
+    }
+    std::fill( _gains.begin(), _gains.end(), 1.0 );
+
+    _gainSum      = ( SAMPLE_TYPE ) _gains.size();
+    _gainIndex    = 0;
+    _gain         = 1.0;
+    _writeIndex   = 0;
+    _historyIndex = 0;
+    _dequeFront   = 0;
+    _dequeBack    = 0;
+    _position     = 0;
+}
+
+/* private methods */
+
+void LookAheadLimiter::createInterpolator()
+{
+    // Hann windowed sinc interpolating at the fractional positions in between the two center
+    // taps, each phase is normalized to unity gain at DC
+
+    int center = TAPS_PER_PHASE / 2;
+
+    for ( int p = 1; p < OVERSAMPLING; ++p )
+    {
+        SAMPLE_TYPE sum = 0.0;
+
+        for ( int k = 0; k < TAPS_PER_PHASE; ++k )
+        {
+            // tap k holds the sample k positions before the newest one, the interpolated
+            // position lies p / OVERSAMPLING after the sample center positions before the newest one
+
+            SAMPLE_TYPE x      = ( SAMPLE_TYPE ) k - center + ( SAMPLE_TYPE ) p / OVERSAMPLING;
+            SAMPLE_TYPE sinc   = ( x == 0.0 ) ? 1.0 : sin( PI * x ) / ( PI * x );
+            SAMPLE_TYPE window = 0.5 * ( 1.0 + cos( PI * x / ( center + 1 )));
+
+            _interpolator[ p - 1 ][ k ] = sinc * window;
+            sum += sinc * window;
+        }
+        for ( int k = 0; k < TAPS_PER_PHASE; ++k )
+            _interpolator[ p - 1 ][ k ] /= sum;
+    }
+}
+
+/**
+ * history points to the last TAPS_PER_PHASE samples in chronological order, the peak is
+ * determined for the sample TAPS_PER_PHASE / 2 positions before the newest sample and the
+ * interpolated positions following it (hence the latency of the true peak detection)
+ */
+SAMPLE_TYPE LookAheadLimiter::getTruePeak( SAMPLE_TYPE* history )
+{
+    SAMPLE_TYPE* newest = history + TAPS_PER_PHASE - 1;
+    SAMPLE_TYPE peak    = std::abs( newest[ -( TAPS_PER_PHASE / 2 ) ]);
+
+    for ( int p = 0; p < OVERSAMPLING - 1; ++p )
+    {
+        SAMPLE_TYPE value = 0.0;
+
+        for ( int k = 0; k < TAPS_PER_PHASE; ++k )
+            value += _interpolator[ p ][ k ] * newest[ -k ];
+
+        peak = std::max( peak, std::abs( value ));
+    }
+    return peak;
+}
+
+} // E.O namespace MWEngine
@@ -0,0 +1,120 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__LOOKAHEADLIMITER_H_INCLUDED__
+#define __MWENGINE__LOOKAHEADLIMITER_H_INCLUDED__
+
+#include "baseprocessor.h"
+#include <vector>
+
+namespace MWEngine {
+
+/**
+ * LookAheadLimiter is a brickwall limiter meant for the master bus, ensuring the output
+ * never exceeds the ceiling (rendering the AudioEngine's hard clipping obsolete)
+ *
+ * the input is delayed by the look-ahead time, during which the gain is lowered gradually
+ * towards the level required by upcoming peaks. Peaks are detected as true peaks, e.g. including
+ * the inter-sample peaks that occur after D/A conversion (estimated by OVERSAMPLING times
+ * oversampling). The loudest peak inside the look-ahead window is tracked using a monotonic deque
+ * (constant time per sample regardless of the look-ahead time). All channels share a single gain
+ * so the stereo image remains intact
+ */
+class LookAheadLimiter : public BaseProcessor
+{
+    public:
+
+        static const int OVERSAMPLING   = 4;
+        static const int TAPS_PER_PHASE = 8; // length of the true peak interpolation filter per phase
+
+        /**
+         * @param lookAheadMs {float} look-ahead time in milliseconds, fixed for the lifetime of
+         *                    the instance as it determines the latency (e.g. 1.5 - 5 ms)
+         * @param releaseMs   {float} time in milliseconds for the gain reduction to recover
+         * @param ceilingDb   {float} maximum output level in dBTP (e.g. -1.0)
+         * @param amountOfChannels {int} amount of output channels
+         */
+        LookAheadLimiter( float lookAheadMs, float releaseMs, float ceilingDb, int amountOfChannels );
+        ~LookAheadLimiter();
+
+        float getLookAhead();
+        float getRelease();
+        void setRelease( float releaseMs );
+        float getCeiling();
+        void setCeiling( float ceilingDb );
+
+        // the currently applied gain (1.0 when not limiting), e.g. for metering gain reduction
+
+        float getLinearGR();
+
+        void process( AudioBuffer* sampleBuffer, bool isMonoSource );
+        int getLatency();
+
+        // clears the delayed input and gain reduction
+
+        void reset();
+
+    private:
+
+        int _lookAhead;  // in samples
+        int _latency;    // look-ahead plus the delay of the true peak interpolation filter
+        int _amountOfChannels;
+
+        float _releaseMs;
+        float _ceilingDb;
+        SAMPLE_TYPE _ceiling;
+        SAMPLE_TYPE _releaseCoefficient;
+        SAMPLE_TYPE _gain;
+
+        // delayed input (per channel, power of two size sharing a single write index)
+
+        std::vector<std::vector<SAMPLE_TYPE>> _delayLines;
+        int _delayMask;
+        int _writeIndex;
+
+        // last TAPS_PER_PHASE input samples (per channel, mirrored so they can be read without wrapping)
+
+        std::vector<std::vector<SAMPLE_TYPE>> _histories;
+        int _historyIndex;
+        SAMPLE_TYPE _interpolator[ OVERSAMPLING - 1 ][ TAPS_PER_PHASE ];
+
+        // monotonic deque of ( sample number, peak ) pairs, where the peaks are in descending order
+
+        std::vector<unsigned long> _peakPositions;
+        std::vector<SAMPLE_TYPE> _peakValues;
+        int _dequeMask;
+        int _dequeFront;
+        int _dequeBack;
+        unsigned long _position;
+
+        // moving average of the required gain over the look-ahead window (smoothing the attack)
+
+        std::vector<SAMPLE_TYPE> _gains;
+        int _gainIndex;
+        SAMPLE_TYPE _gainSum;
+
+        void createInterpolator();
+        SAMPLE_TYPE getTruePeak( SAMPLE_TYPE* history );
+};
+} // E.O namespace MWEngine
+
+#endif
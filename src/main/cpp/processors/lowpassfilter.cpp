@@ -29,12 +29,13 @@ namespace MWEngine {
 
 LowPassFilter::LowPassFilter( float cutoff )
 {
+    _biquad = new BiquadCascade( AudioEngineProps::OUTPUT_CHANNELS, 1 );
     setCutoff( cutoff );
 }
 
 LowPassFilter::~LowPassFilter()
 {
-
+    delete _biquad;
 }
 
 /* public methods */
@@ -48,65 +49,33 @@ void LowPassFilter::setCutoff( float value )
 {
     _cutoff = value;
 
-    SAMPLE_TYPE Q = 1.1f;
-    w0 = TWO_PI * _cutoff / ( SAMPLE_TYPE ) AudioEngineProps::SAMPLE_RATE;
-    alpha = sin(w0) / (2.0 * Q);
-    b0 =  (1.0 - cos(w0))/2;
-    b1 =   1.0 - cos(w0);
-    b2 =  (1.0 - cos(w0))/2;
-    a0 =   1.0 + alpha;
-    a1 =  -2.0 * cos(w0);
-    a2 = 1.0 - alpha;
-    x1 = x2 = y1 = y2 = 0;
+    SAMPLE_TYPE Q     = 1.1f;
+    SAMPLE_TYPE w0    = TWO_PI * _cutoff / ( SAMPLE_TYPE ) AudioEngineProps::SAMPLE_RATE;
+    SAMPLE_TYPE alpha = sin(w0) / (2.0 * Q);
+    SAMPLE_TYPE b0    = (1.0 - cos(w0))/2;
+    SAMPLE_TYPE b1    =  1.0 - cos(w0);
+    SAMPLE_TYPE b2    = (1.0 - cos(w0))/2;
+    SAMPLE_TYPE a0    =  1.0 + alpha;
+    SAMPLE_TYPE a1    = -2.0 * cos(w0);
+    SAMPLE_TYPE a2    =  1.0 - alpha;
+
+    _biquad->setCoefficients( 0, b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0 );
+    _biquad->reset();
 }
 
 void LowPassFilter::process( AudioBuffer* sampleBuffer, bool isMonoSource )
 {
-    int bufferSize = sampleBuffer->bufferSize;
-
-    for ( int i = 0, l = sampleBuffer->amountOfChannels; i < l; ++i )
-    {
-        SAMPLE_TYPE* channelBuffer = sampleBuffer->getBufferForChannel( i );
-
-        // store current values for this channel
-        SAMPLE_TYPE orgx1 = x1,
-                    orgx2 = x2,
-                    orgy1 = y1,
-                    orgy2 = y2;
-
-        for ( int j = 0; j < bufferSize; ++j )
-            channelBuffer[ j ] = processSingle( channelBuffer[ j ] );
-
-        // omit unnecessary cycles by copying the mono content
-        if ( isMonoSource )
-        {
-            sampleBuffer->applyMonoSource();
-            break;
-        }
-
-        // restore values for next channel
-
-        x1 = orgx1;
-        x2 = orgx2;
-        y1 = orgy1;
-        y2 = orgy2;
-    }
+    _biquad->process( sampleBuffer, isMonoSource );
 }
 
 void LowPassFilter::store()
 {
-    orgx1 = x1;
-    orgx2 = x2;
-    orgy1 = y1;
-    orgy2 = y2;
+    _biquad->store();
 }
 
 void LowPassFilter::restore()
 {
-    x1 = orgx1;
-    x2 = orgx2;
-    y1 = orgy1;
-    y2 = orgy2;
+    _biquad->restore();
 }
 
 } // E.O namespace MWEngine
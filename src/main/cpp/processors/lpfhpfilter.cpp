@@ -32,23 +32,15 @@ namespace MWEngine {
 
 LPFHPFilter::LPFHPFilter( float aLPCutoff, float aHPCutoff, int amountOfChannels )
 {
+    _biquad = new BiquadCascade( amountOfChannels, 1 );
+
     setLPF( aLPCutoff, AudioEngineProps::SAMPLE_RATE );
     setHPF( aHPCutoff, AudioEngineProps::SAMPLE_RATE );
-
-    outSamples = new SAMPLE_TYPE[ amountOfChannels ];
-    inSamples  = new SAMPLE_TYPE[ amountOfChannels ];
-
-    for ( int i = 0; i < amountOfChannels; ++i )
-    {
-        outSamples[ i ] = 0.0;
-        inSamples[ i ]  = 0.0;
-    }
 }
 
 LPFHPFilter::~LPFHPFilter()
 {
-    delete[] outSamples;
-    delete[] inSamples;
+    delete _biquad;
 }
 
 /* public methods */
@@ -62,6 +54,9 @@ void LPFHPFilter::setLPF( float aCutOffFrequency, int aSampleRate )
     Norm              = 1.0 / ( aCutOffFrequency + w );
     b1                = ( w - aCutOffFrequency ) * Norm;
     a0                = a1 = aCutOffFrequency * Norm;
+
+    // first order section, b1 is the feedback coefficient
+    _biquad->setCoefficients( 0, a0, a1, 0.0, -b1, 0.0 );
 }
 
 void LPFHPFilter::setHPF( float aCutOffFrequency, int aSampleRate )
@@ -74,32 +69,13 @@ void LPFHPFilter::setHPF( float aCutOffFrequency, int aSampleRate )
     a0                = w * Norm;
     a1                = -a0;
     b1                = ( w - aCutOffFrequency ) * Norm;
+
+    _biquad->setCoefficients( 0, a0, a1, 0.0, -b1, 0.0 );
 }
 
 void LPFHPFilter::process( AudioBuffer* sampleBuffer, bool isMonoSource )
 {
-    int bufferSize = sampleBuffer->bufferSize;
-
-    for ( int c = 0, ca = sampleBuffer->amountOfChannels; c < ca; ++c )
-    {
-        SAMPLE_TYPE* channelBuffer = sampleBuffer->getBufferForChannel( c );
-
-        for ( int i = 0; i < bufferSize; ++i )
-        {
-            SAMPLE_TYPE sample = channelBuffer[ i ];
-
-            channelBuffer[ i ] = sample * a0 + inSamples[ c ] * a1 + outSamples[ c ] * b1;
-            inSamples[ c ]     = sample; // store this unprocessed sample for next iteration
-            outSamples[ c ]    = channelBuffer[ i ]; // and the processed sample too
-        }
-
-        // save CPU cycles when source is mono
-        if ( isMonoSource )
-        {
-            sampleBuffer->applyMonoSource();
-            break;
-        }
-    }
+    _biquad->process( sampleBuffer, isMonoSource );
 }
 
 } // E.O namespace MWEngine
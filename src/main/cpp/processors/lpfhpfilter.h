@@ -25,6 +25,7 @@
 
 #include "baseprocessor.h"
 #include "../audiobuffer.h"
+#include <utilities/biquadcascade.h>
 
 namespace MWEngine {
 class LPFHPFilter : public BaseProcessor
@@ -42,9 +43,7 @@ class LPFHPFilter : public BaseProcessor
         SAMPLE_TYPE a1;
         SAMPLE_TYPE b1;
 
-        // for each channel we store the previous in- and output samples
-        SAMPLE_TYPE* outSamples;
-        SAMPLE_TYPE* inSamples;
+        BiquadCascade* _biquad;
 };
 } // E.O namespace MWEngine
 
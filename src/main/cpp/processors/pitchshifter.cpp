@@ -29,6 +29,7 @@
  */
 #include "pitchshifter.h"
 #include "../audioengine.h"
+#include <algorithm>
 
 namespace MWEngine {
 
@@ -36,6 +37,73 @@ namespace MWEngine {
 
 PitchShifter::PitchShifter( float shiftAmount, long osampAmount )
 {
+    init( shiftAmount, osampAmount, SPECTRAL );
+}
+
+PitchShifter::PitchShifter( float shiftAmount, long osampAmount, int mode )
+{
+    init( shiftAmount, osampAmount, mode );
+}
+
+PitchShifter::~PitchShifter()
+{
+    delete _fft;
+    delete _grainBuffer;
+    delete[] _grainWindow;
+    delete[] _writeIndices;
+    delete[] _grainPhases;
+    delete[] _grainDelays;
+}
+
+/* public methods */
+
+void PitchShifter::process( AudioBuffer* sampleBuffer, bool isMonoSource )
+{
+    // pitch shifted to "normal" ? omit processing and save CPU cycles
+
+    if ( pitchShift == 1.0f )
+        return;
+
+    if ( _mode == TIME_DOMAIN )
+        processTimeDomain( sampleBuffer, isMonoSource );
+    else
+        processSpectral( sampleBuffer, isMonoSource );
+}
+
+bool PitchShifter::isCacheable()
+{
+    return true;
+}
+
+int PitchShifter::getLatency()
+{
+    if ( pitchShift == 1.0f )
+        return 0;
+
+    if ( _mode == SPECTRAL )
+        return ( int ) inFifoLatency;
+
+    // grains start within the search range and drift over the length of the grain
+
+    double ratio = std::max( 0.5, std::min( 2.0, ( double ) pitchShift ));
+    return ( int ) round( fabs( 1.0 - ratio ) * _grainSize / 2 + _searchRange / 2 );
+}
+
+int PitchShifter::getMode()
+{
+    return _mode;
+}
+
+void PitchShifter::setMode( int mode )
+{
+    _mode = mode;
+}
+
+/* private methods */
+
+void PitchShifter::init( float shiftAmount, long osampAmount, int mode )
+{
+    _mode        = mode;
     gRover       = false;
     pitchShift   = shiftAmount; // 0.5 is octave down, 1 == normal, 2 is octave up
 
@@ -47,48 +115,77 @@ PitchShifter::PitchShifter( float shiftAmount, long osampAmount )
     freqPerBin    = ( SAMPLE_TYPE ) AudioEngineProps::SAMPLE_RATE / ( SAMPLE_TYPE ) fftFrameSize;
     expct         = 2.0f * M_PI * ( SAMPLE_TYPE ) stepSize /( SAMPLE_TYPE ) fftFrameSize;
     inFifoLatency = fftFrameSize - stepSize;
+    osampPI2      = osamp / ( 2.0 * M_PI );
+
+    // the inverse transform sums the full (mirrored) spectrum, as such the
+    // doubled synthesis magnitudes are halved in addition to the overlap-add scaling
+
+    outputScale = 1.0 / ( SAMPLE_TYPE )( fftFrameSize2 * osamp );
+
+    _fft = new FFT(( int ) fftFrameSize );
 
     /* initialize our static arrays */
 
     memset( gInFIFO,      0, sizeof( float ) * MAX_FRAME_LENGTH );
     memset( gOutFIFO,     0, sizeof( float ) * MAX_FRAME_LENGTH );
-    memset( gFFTworksp,   0, sizeof( float ) * 2 * MAX_FRAME_LENGTH );
+    memset( gFFTworksp,   0, sizeof( float ) * ( MAX_FRAME_LENGTH + 2 ));
     memset( gLastPhase,   0, sizeof( float ) * ( MAX_FRAME_LENGTH / 2 + 1 ));
     memset( gSumPhase,    0, sizeof( float ) * ( MAX_FRAME_LENGTH / 2 + 1 ));
     memset( gOutputAccum, 0, sizeof( float ) * 2 * MAX_FRAME_LENGTH );
     memset( gAnaFreq,     0, sizeof( float ) * MAX_FRAME_LENGTH );
     memset( gAnaMagn,     0, sizeof( float ) * MAX_FRAME_LENGTH );
-}
 
-PitchShifter::~PitchShifter()
-{
+    // TIME_DOMAIN mode (allocated regardless of mode so it can be switched at runtime)
+    // grains of 25 ms are crossfaded using a Hann window, as grains overlap by half their length
+    // the windows sum to unity
 
-}
+    _grainSize   = std::max( 2, ( int )( AudioEngineProps::SAMPLE_RATE * 0.025 ) & ~1 );
+    _searchRange = _grainSize / 8;
+    _grainWindow = new SAMPLE_TYPE[ _grainSize ];
 
-/* public methods */
-
-void PitchShifter::process( AudioBuffer* sampleBuffer, bool isMonoSource )
-{
-    // pitch shifted to "normal" ? omit processing and save CPU cycles
+    for ( int i = 0; i < _grainSize; ++i ) {
+        SAMPLE_TYPE s     = sin( M_PI * ( SAMPLE_TYPE ) i / ( SAMPLE_TYPE ) _grainSize );
+        _grainWindow[ i ] = s * s;
+    }
 
-    if ( pitchShift == 1.0f )
-        return;
+    // history must hold the largest delay (upward shifting an octave starts a
+    // grain a full grain length behind the input) plus the alignment window
+
+    int historySize = 1;
+    while ( historySize < _grainSize + _searchRange + CORRELATION_LENGTH + 4 )
+        historySize <<= 1;
+
+    _grainBufferMask  = historySize - 1;
+    _amountOfChannels = std::max( 2, AudioEngineProps::OUTPUT_CHANNELS );
+    _grainBuffer      = new AudioBuffer( _amountOfChannels, historySize );
+    _writeIndices     = new int[ _amountOfChannels ];
+    _grainPhases      = new int[ _amountOfChannels * 2 ];
+    _grainDelays      = new double[ _amountOfChannels * 2 ];
+
+    for ( int c = 0; c < _amountOfChannels; ++c ) {
+        _writeIndices[ c ]         = 0;
+        _grainPhases[ c * 2 ]      = 0;
+        _grainPhases[ c * 2 + 1 ]  = _grainSize / 2;
+        _grainDelays[ c * 2 ]      = 0.0;
+        _grainDelays[ c * 2 + 1 ]  = 0.0;
+    }
+}
 
-    int i, n, t;
+void PitchShifter::processSpectral( AudioBuffer* sampleBuffer, bool isMonoSource )
+{
+    int i;
     long k;
 
     if ( gRover == false )
         gRover = inFifoLatency;
 
     int bufferSize = sampleBuffer->bufferSize;
+    float* window  = _fft->getWindow();
 
     for ( int cn = 0, cl = sampleBuffer->amountOfChannels; cn < cl; ++cn )
     {
         SAMPLE_TYPE* channelBuffer = sampleBuffer->getBufferForChannel( cn );
-        SAMPLE_TYPE mPi2   = 2.0 * M_PI;
-        invFftFrameSizePI2 = mPi2 / fftFrameSize;
-        invFftFrameSize2   = 2 / ( fftFrameSize2 * osamp );
-        osampPI2           = osamp / mPi2;
+        SAMPLE_TYPE mPi2 = 2.0 * M_PI;
 
         /* main processing loop */
 
@@ -106,24 +203,14 @@ void PitchShifter::process( AudioBuffer* sampleBuffer, bool isMonoSource )
             {
                 gRover = inFifoLatency;
 
-                /* do windowing and re,im interleave */
+                /* do windowing (the real input needs no imaginary interleave) */
+
+                for ( k = 0; k < fftFrameSize; ++k )
+                    gFFTworksp[ k ] = gInFIFO[ k ] * window[ k ];
 
-/*              TODO: optimize window calculation like below
-                for ( k = 0, n = 0, t = 0; k < fftFrameSize; ++k, ++n, ++n, t += invFftFrameSizePI2 )                {
-                    window = -.5 * cos(( SAMPLE_TYPE ) t ) + .5;
-                    gFFTworksp[ n ]     = gInFIFO[ k ] * window;
-                    gFFTworksp[ n + 1 ] = 0.0;
-                }
-*/
-                for ( k = 0, n = 0; k < fftFrameSize; ++k, n += 2 )
-                {
-                    window              = -.5 * cos( mPi2 * ( SAMPLE_TYPE ) k / ( SAMPLE_TYPE ) fftFrameSize ) + .5;
-                    gFFTworksp[ n ]     = gInFIFO[ k ] * window;
-                    gFFTworksp[ n + 1 ] = 0.;
-                }
                 /* ***************** ANALYSIS ******************* */
                 /* do transform */
-                smbFft( gFFTworksp, fftFrameSize, -1 );
+                _fft->forward( gFFTworksp );
 
                 /* this is the analysis step */
 
@@ -205,27 +292,13 @@ void PitchShifter::process( AudioBuffer* sampleBuffer, bool isMonoSource )
                     gFFTworksp[ ( k << 1 ) + 1 ] = magn * sin( phase ); // [ (2 * k) + 1 ]
                 }
 
-                /* zero negative frequencies */
-                //for ( k = fftFrameSize + 2; k < 2 * fftFrameSize; ++k )
-                for ( k = fftFrameSize + 2, n = fftFrameSize << 1; k < n; ++k )
-                    gFFTworksp[ k ] = 0.;
-
-                /* do inverse transform */
-                smbFft( gFFTworksp, fftFrameSize, 1 );
+                /* do inverse transform (the real transform omits the negative frequencies) */
+                _fft->inverse( gFFTworksp );
 
                 /* do windowing and add to output accumulator */
-                /*
-                TODO: optimize window calculation like below
-                for ( k = 0, n = 0, t = 0; k < fftFrameSize; ++k, ++n, ++n, t += invFftFrameSizePI2 ){
-                    window             = -.5 * cos(( SAMPLE_TYPE ) t ) + .5;
-                    gOutputAccum[ k ] += window * gFFTworksp[ n ] * invFftFrameSize2;
-                }
-                */
-                for ( k = 0, n = 0, t = 0; k < fftFrameSize; ++k, n += 2, t += invFftFrameSizePI2 )
-                {
-                    window             = -.5 * cos( mPi2 * ( SAMPLE_TYPE ) k / ( SAMPLE_TYPE ) fftFrameSize ) + .5;
-                    gOutputAccum[ k ] += 2. * window * gFFTworksp[ n ] / ( fftFrameSize2 * osamp );
-                }
+                for ( k = 0; k < fftFrameSize; ++k )
+                    gOutputAccum[ k ] += window[ k ] * gFFTworksp[ k ] * outputScale;
+
                 for ( k = 0; k < stepSize; ++k )
                     gOutFIFO[ k ] = gOutputAccum[ k ];
 
@@ -246,9 +319,103 @@ void PitchShifter::process( AudioBuffer* sampleBuffer, bool isMonoSource )
     }
 }
 
-bool PitchShifter::isCacheable()
+void PitchShifter::processTimeDomain( AudioBuffer* sampleBuffer, bool isMonoSource )
 {
-    return true;
+    int bufferSize       = sampleBuffer->bufferSize;
+    int amountOfChannels = std::min( _amountOfChannels, sampleBuffer->amountOfChannels );
+
+    // each grain reads the history at a delay that changes by ( 1 - ratio ) per sample,
+    // grains shifting upwards should start far enough behind the input so they
+    // don't overtake the write position during their lifetime
+
+    double ratio    = std::max( 0.5, std::min( 2.0, ( double ) pitchShift ));
+    double rate     = 1.0 - ratio;
+    double minDelay = std::max( 0.0, ( ratio - 1.0 ) * _grainSize );
+    double maxDelay = ( double )( _grainBufferMask - 1 );
+
+    for ( int c = 0; c < amountOfChannels; ++c )
+    {
+        SAMPLE_TYPE* channelBuffer = sampleBuffer->getBufferForChannel( c );
+        SAMPLE_TYPE* history       = _grainBuffer->getBufferForChannel( c );
+        int* phases                = _grainPhases + c * 2;
+        double* delays             = _grainDelays + c * 2;
+        int writeIndex             = _writeIndices[ c ];
+
+        for ( int i = 0; i < bufferSize; ++i )
+        {
+            history[ writeIndex ] = channelBuffer[ i ];
+            SAMPLE_TYPE output    = 0.0;
+
+            for ( int g = 0; g < 2; ++g )
+            {
+                // grain (re)starts ? align it with the waveform of the currently sounding grain
+
+                if ( phases[ g ] == 0 )
+                    delays[ g ] = alignGrain( history, writeIndex, delays[ 1 - g ], minDelay );
+
+                double delay        = std::max( 0.0, std::min( maxDelay, delays[ g ] ));
+                double readPosition = ( double ) writeIndex - delay;
+
+                if ( readPosition < 0.0 )
+                    readPosition += ( double )( _grainBufferMask + 1 );
+
+                int r            = ( int ) readPosition;
+                SAMPLE_TYPE frac = readPosition - r;
+                SAMPLE_TYPE s1   = history[ r ];
+                SAMPLE_TYPE s2   = history[ ( r + 1 ) & _grainBufferMask ];
+
+                output += ( s1 + ( s2 - s1 ) * frac ) * _grainWindow[ phases[ g ]];
+
+                delays[ g ] += rate;
+
+                if ( ++phases[ g ] == _grainSize )
+                    phases[ g ] = 0;
+            }
+            channelBuffer[ i ] = output;
+            writeIndex = ( writeIndex + 1 ) & _grainBufferMask;
+        }
+        _writeIndices[ c ] = writeIndex;
+
+        // save CPU cycles when mono source
+        if ( isMonoSource )
+        {
+            sampleBuffer->applyMonoSource();
+            break;
+        }
+    }
+}
+
+/**
+ * WSOLA alignment : returns the delay (within the search range following minDelay) at
+ * which the history best resembles the history at the delay of the other (sounding) grain,
+ * so the crossfade between both grains doesn't cancel out or smear the waveform
+ */
+double PitchShifter::alignGrain( SAMPLE_TYPE* history, int writeIndex, double otherDelay, double minDelay )
+{
+    int startDelay     = ( int ) ceil( minDelay );
+    int otherPosition  = writeIndex - ( int ) otherDelay;
+    int bestDelay      = startDelay;
+    SAMPLE_TYPE bestScore = -1.0;
+
+    for ( int offset = 0; offset <= _searchRange; ++offset )
+    {
+        int position = writeIndex - startDelay - offset;
+        SAMPLE_TYPE correlation = 0.0, energy = 0.0;
+
+        for ( int j = 0; j < CORRELATION_LENGTH; ++j )
+        {
+            SAMPLE_TYPE a = history[ ( position - j ) & _grainBufferMask ];
+            correlation  += a * history[ ( otherPosition - j ) & _grainBufferMask ];
+            energy       += a * a;
+        }
+        SAMPLE_TYPE score = correlation / sqrt( energy + 1e-9 );
+
+        if ( score > bestScore || offset == 0 ) {
+            bestScore = score;
+            bestDelay = startDelay + offset;
+        }
+    }
+    return ( double ) bestDelay;
 }
 
 } // E.O namespace MWEngine
@@ -31,6 +31,7 @@
 #define __MWENGINE__PITCHSHIFTER_H_INCLUDED__
 
 #include "baseprocessor.h"
+#include <utilities/fft.h>
 #include <string.h>
 #include <math.h>
 #include <stdio.h>
@@ -43,6 +44,11 @@ class PitchShifter : public BaseProcessor
 {
     public:
 
+        enum Mode {
+            SPECTRAL,   // STFT phase vocoder, highest quality at the expense of CPU and latency
+            TIME_DOMAIN // WSOLA (overlapping grains aligned by waveform similarity), low CPU and latency for live use
+        };
+
         /**
          * DESCRIPTION: The routine takes a pitchShift factor value which is between 0.5
          * (one octave down) and 2. (one octave up). A value of exactly 1 does not change
@@ -61,15 +67,30 @@ class PitchShifter : public BaseProcessor
          * you would have to divide (and multiply) by 32768)
          */
         PitchShifter( float shiftAmount, long osampAmount );
+        PitchShifter( float shiftAmount, long osampAmount, int mode );
         ~PitchShifter();
         void process( AudioBuffer* sampleBuffer, bool isMonoSource );
         bool isCacheable();
+        int getLatency();
         float pitchShift;
 
+        // the mode can be changed at any time, the osampAmount only applies to the SPECTRAL mode
+
+        int getMode();
+        void setMode( int mode );
+
     private:
+        int _mode;
+
+        void init( float shiftAmount, long osampAmount, int mode );
+        void processSpectral( AudioBuffer* sampleBuffer, bool isMonoSource );
+        void processTimeDomain( AudioBuffer* sampleBuffer, bool isMonoSource );
+
+        /* SPECTRAL mode */
+
         float gInFIFO     [ MAX_FRAME_LENGTH ];
         float gOutFIFO    [ MAX_FRAME_LENGTH ];
-        float gFFTworksp  [ 2 * MAX_FRAME_LENGTH ];
+        float gFFTworksp  [ MAX_FRAME_LENGTH + 2 ];
         float gLastPhase  [ MAX_FRAME_LENGTH / 2 + 1 ];
         float gSumPhase   [ MAX_FRAME_LENGTH / 2 + 1 ];
         float gOutputAccum[ 2 * MAX_FRAME_LENGTH ];
@@ -78,61 +99,26 @@ class PitchShifter : public BaseProcessor
         float gSynFreq    [ MAX_FRAME_LENGTH ];
         float gSynMagn    [ MAX_FRAME_LENGTH ];
         long gRover;
-        SAMPLE_TYPE magn, phase, tmp, window, real, imag, freqPerBin, expct, invFftFrameSizePI2, invFftFrameSize2, osampPI2;
+        SAMPLE_TYPE magn, phase, tmp, real, imag, freqPerBin, expct, outputScale, osampPI2;
         long qpd, index, inFifoLatency, stepSize, fftFrameSize, fftFrameSize2, osamp;
 
-        // inlining this FFT routine (by S.M. Bernsee, 1996) provides a 21% performance boost
-
-        inline void smbFft( float *fftBuffer, long fftFrameSize, long sign )
-        {
-            float wr, wi, arg, *p1, *p2, temp;
-            float tr, ti, ur, ui, *p1r, *p1i, *p2r, *p2i;
-            long doubleFftFrameSize = 2 * fftFrameSize, i, end, bitm, j, le, le2, k;
-
-            for ( i = 2, end = doubleFftFrameSize - 2; i < end; i += 2 ) {
-                for ( bitm = 2, j = 0; bitm < doubleFftFrameSize; bitm <<= 1 ) {
-                    if ( i & bitm ) ++j;
-                    j <<= 1;
-                }
-                if ( i < j ) {
-                    p1 = fftBuffer+i;
-                    p2 = fftBuffer+j;
-                    temp = *p1; *(p1++) = *p2;
-                    *(p2++) = temp; temp = *p1;
-                    *p1 = *p2; *p2 = temp;
-                }
-            }
-
-            for ( k = 0, le = 2, end = ( long )( log( fftFrameSize ) / log( 2. ) + .5 ); k < end; ++k )
-            {
-                le <<= 1;
-                le2  = le >> 1;
-                ur  = 1.0;
-                ui  = 0.0;
-                arg = M_PI / ( le2 >>1 );
-                wr  = cos( arg );
-                wi  = sign * sin( arg );
-                for ( j = 0; j < le2; j += 2 ) {
-                    p1r = fftBuffer + j;
-                    p1i = p1r + 1;
-                    p2r = p1r + le2;
-                    p2i = p2r + 1;
-
-                    for ( i = j; i < doubleFftFrameSize; i += le ) {
-                        tr = *p2r * ur - *p2i * ui;
-                        ti = *p2r * ui + *p2i * ur;
-                        *p2r = *p1r - tr; *p2i = *p1i - ti;
-                        *p1r += tr; *p1i += ti;
-                        p1r += le; p1i += le;
-                        p2r += le; p2i += le;
-                    }
-                    tr = ur*wr - ui*wi;
-                    ui = ur*wi + ui*wr;
-                    ur = tr;
-                }
-            }
-        }
+        FFT* _fft;
+
+        /* TIME_DOMAIN mode */
+
+        static const int CORRELATION_LENGTH = 64; // amount of samples compared when aligning grains
+
+        AudioBuffer* _grainBuffer;     // history of the input, per channel
+        SAMPLE_TYPE* _grainWindow;     // crossfade window applied to each grain
+        int  _grainSize;
+        int  _searchRange;             // range (in samples) in which grain starts are aligned
+        int  _grainBufferMask;
+        int  _amountOfChannels;
+        int* _writeIndices;            // per channel
+        int* _grainPhases;             // per channel, two grains each
+        double* _grainDelays;          // per channel, two grains each
 
+        double alignGrain( SAMPLE_TYPE* history, int writeIndex, double otherDelay, double minDelay );
 };
 } // E.O namespace MWEngine
 
@@ -24,189 +24,231 @@
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #include "reverbsm.h"
+#include <utilities/denormalguard.h>
+#include <algorithm>
 
 namespace MWEngine {
 
-AllPass::AllPass()
-{
-    _bufIndex = 0;
-}
+static const int TOTAL_COMBS     = 16; // ReverbSM::NUM_COMBS for both sides
+static const int TOTAL_ALLPASSES = 8;  // ReverbSM::NUM_ALLPASSES for both sides
+static const int BLOCK_SIZE      = 64; // must not exceed the shortest (allpass) delay
 
-void AllPass::setBuffer( SAMPLE_TYPE *buf, int size )
-{
-    _buffer  = buf;
-    _bufSize = size;
-}
-
-void AllPass::mute()
+ReverbSM::ReverbSM()
 {
-    for ( int i = 0; i < _bufSize; i++ ) {
-        _buffer[ i ] = 0;
-    }
-}
+    static_assert( NUM_COMBS * 2 == TOTAL_COMBS && NUM_ALLPASSES * 2 == TOTAL_ALLPASSES, "filter amount mismatch" );
 
+    int combTunings[ TOTAL_COMBS ] = {
+        COMB_TUNING_L1, COMB_TUNING_L2, COMB_TUNING_L3, COMB_TUNING_L4,
+        COMB_TUNING_L5, COMB_TUNING_L6, COMB_TUNING_L7, COMB_TUNING_L8,
+        COMB_TUNING_R1, COMB_TUNING_R2, COMB_TUNING_R3, COMB_TUNING_R4,
+        COMB_TUNING_R5, COMB_TUNING_R6, COMB_TUNING_R7, COMB_TUNING_R8
+    };
+    int allPassTunings[ TOTAL_ALLPASSES ] = {
+        ALLPASS_TUNING_L1, ALLPASS_TUNING_R1, ALLPASS_TUNING_L2, ALLPASS_TUNING_R2,
+        ALLPASS_TUNING_L3, ALLPASS_TUNING_R3, ALLPASS_TUNING_L4, ALLPASS_TUNING_R4
+    };
 
-SAMPLE_TYPE AllPass::getFeedback()
-{
-    return _feedback;
-}
+    // each filter has a ring of (a power of two rounded) amount of samples to accommodate
+    // the longest delay, so reading and writing wraps using a mask (instead of a branch)
 
-void AllPass::setFeedback( SAMPLE_TYPE val )
-{
-    _feedback = val;
-}
-
-Comb::Comb()
-{
-    _filterStore = 0;
-    _bufIndex    = 0;
-}
+    int combSize = 1, allPassSize = 1;
 
-void Comb::setBuffer( SAMPLE_TYPE *buf, int size )
-{
-    _buffer  = buf;
-    _bufSize = size;
-}
+    for ( int i = 0; i < TOTAL_COMBS; ++i )
+    {
+        _combDelays[ i ] = combTunings[ i ];
+        while ( combSize < combTunings[ i ] )
+            combSize <<= 1;
+    }
 
-void Comb::mute()
-{
-    for ( int i = 0; i < _bufSize; i++ ) {
-        _buffer[ i ] = 0;
+    for ( int i = 0; i < TOTAL_ALLPASSES; ++i )
+    {
+        _allPassDelays[ i ] = allPassTunings[ i ];
+        while ( allPassSize < allPassTunings[ i ] )
+            allPassSize <<= 1;
     }
-}
 
-SAMPLE_TYPE Comb::getDamp()
-{
-    return _damp1;
-}
+    // the write index wraps using the comb mask, as such the comb rings must be the larger
+    combSize = std::max( combSize, allPassSize );
 
-void Comb::setDamp( SAMPLE_TYPE val )
-{
-    _damp1 = val;
-    _damp2 = 1 - val;
-}
+    _combMask      = combSize - 1;
+    _allPassMask   = allPassSize - 1;
+    _combBuffer    = new SAMPLE_TYPE[ combSize * TOTAL_COMBS ]();
+    _allPassBuffer = new SAMPLE_TYPE[ allPassSize * TOTAL_ALLPASSES ]();
+    _writeIndex    = 0;
 
-SAMPLE_TYPE Comb::getFeedback()
-{
-    return _feedback;
-}
+    for ( int i = 0; i < TOTAL_COMBS; ++i )
+        _combFilters[ i ] = 0.0;
 
-void Comb::setFeedback( SAMPLE_TYPE val )
-{
-    _feedback = val;
-}
-
-ReverbSM::ReverbSM()
-{
-    // Tie the components to their buffers
-    combL[ 0 ].setBuffer( bufCombL1, COMB_TUNING_L1 );
-    combR[ 0 ].setBuffer( bufCombR1, COMB_TUNING_R1 );
-    combL[ 1 ].setBuffer( bufCombL2, COMB_TUNING_L2 );
-    combR[ 1 ].setBuffer( bufCombR2, COMB_TUNING_R2 );
-    combL[ 2 ].setBuffer( bufCombL3, COMB_TUNING_L3 );
-    combR[ 2 ].setBuffer( bufCombR3, COMB_TUNING_R3 );
-    combL[ 3 ].setBuffer( bufCombL4, COMB_TUNING_L4 );
-    combR[ 3 ].setBuffer( bufCombR4, COMB_TUNING_R4 );
-    combL[ 4 ].setBuffer( bufCombL5, COMB_TUNING_L5 );
-    combR[ 4 ].setBuffer( bufCombR5, COMB_TUNING_R5 );
-    combL[ 5 ].setBuffer( bufCombL6, COMB_TUNING_L6 );
-    combR[ 5 ].setBuffer( bufCombR6, COMB_TUNING_R6 );
-    combL[ 6 ].setBuffer( bufCombL7, COMB_TUNING_L7 );
-    combR[ 6 ].setBuffer( bufCombR7, COMB_TUNING_R7 );
-    combL[ 7 ].setBuffer( bufCombL8, COMB_TUNING_L8 );
-    combR[ 7 ].setBuffer( bufCombR8, COMB_TUNING_R8 );
-    allPassL[ 0 ].setBuffer( bufAllPassL1, ALLPASS_TUNING_L1 );
-    allPassR[ 0 ].setBuffer( bufAllPassR1, ALLPASS_TUNING_R1 );
-    allPassL[ 1 ].setBuffer( bufAllPassL2, ALLPASS_TUNING_L2 );
-    allPassR[ 1 ].setBuffer( bufAllPassR2, ALLPASS_TUNING_R2 );
-    allPassL[ 2 ].setBuffer( bufAllPassL3, ALLPASS_TUNING_L3 );
-    allPassR[ 2 ].setBuffer( bufAllPassR3, ALLPASS_TUNING_R3 );
-    allPassL[ 3 ].setBuffer( bufAllPassL4, ALLPASS_TUNING_L4 );
-    allPassR[ 3 ].setBuffer( bufAllPassR4, ALLPASS_TUNING_R4 );
-    
     // Set default values
-    allPassL[ 0 ].setFeedback( 0.5f );
-    allPassR[ 0 ].setFeedback( 0.5f );
-    allPassL[ 1 ].setFeedback( 0.5f );
-    allPassR[ 1 ].setFeedback( 0.5f );
-    allPassL[ 2 ].setFeedback( 0.5f );
-    allPassR[ 2 ].setFeedback( 0.5f );
-    allPassL[ 3 ].setFeedback( 0.5f );
-    allPassR[ 3 ].setFeedback( 0.5f );
-    
+    _allPassFeedback = 0.5f;
+
     setWet     ( INITIAL_WET );
     setRoomSize( INITIAL_ROOM );
     setDry     ( INITIAL_DRY );
     setDamp    ( INITIAL_DAMP );
     setWidth   ( INITIAL_WIDTH );
     setMode    ( INITIAL_MODE );
-    
+
     // this will initialize the buffers with silence
     mute();
 }
 
+ReverbSM::~ReverbSM()
+{
+    delete[] _combBuffer;
+    delete[] _allPassBuffer;
+}
+
 void ReverbSM::mute()
 {
     if ( getMode() >= FREEZE_MODE )
         return;
-    
-    for ( int i = 0; i < NUM_COMBS; i++ ) {
-        combL[ i ].mute();
-        combR[ i ].mute();
-    }
 
-    for ( int i = 0; i < NUM_ALLPASSES; i++ ) {
-        allPassL[ i ].mute();
-        allPassR[ i ].mute();
-    }
+    std::fill( _combBuffer,    _combBuffer    + ( _combMask + 1 ) * TOTAL_COMBS, 0.0 );
+    std::fill( _allPassBuffer, _allPassBuffer + ( _allPassMask + 1 ) * TOTAL_ALLPASSES, 0.0 );
+    std::fill( _combFilters,   _combFilters   + TOTAL_COMBS, 0.0 );
 }
 
 void ReverbSM::process( AudioBuffer* audioBuffer, bool isMonoSource )
 {
-    int numSamples = audioBuffer->bufferSize;
-    int skip = 1;
+    // the comb feedback decays towards (slow to compute) denormal numbers, flush these to zero
+    DenormalGuard denormalGuard;
+
+    int bufferSize = audioBuffer->bufferSize;
+
+    if ( audioBuffer->amountOfChannels < 2 )
+        isMonoSource = true;
 
-    SAMPLE_TYPE* inputL  = audioBuffer->getBufferForChannel( 0 );
-    SAMPLE_TYPE* outputL = audioBuffer->getBufferForChannel( 0 );
-    SAMPLE_TYPE* inputR  = !isMonoSource ? audioBuffer->getBufferForChannel( 1 ) : nullptr;
-    SAMPLE_TYPE* outputR = !isMonoSource ? audioBuffer->getBufferForChannel( 1 ) : nullptr;
+    SAMPLE_TYPE* left  = audioBuffer->getBufferForChannel( 0 );
+    SAMPLE_TYPE* right = !isMonoSource ? audioBuffer->getBufferForChannel( 1 ) : nullptr;
 
-    SAMPLE_TYPE outL, outR, input;
+    int combSize    = _combMask + 1;
+    int allPassSize = _allPassMask + 1;
 
-    while ( numSamples-- > 0 )
+    SAMPLE_TYPE input[ BLOCK_SIZE ];
+    SAMPLE_TYPE outL [ BLOCK_SIZE ];
+    SAMPLE_TYPE outR [ BLOCK_SIZE ];
+
+    for ( int offset = 0; offset < bufferSize; offset += BLOCK_SIZE )
     {
-        outL  = outR = 0;
-        input = ( isMonoSource ? ( *inputL ) : ( *inputL + *inputR )) * _gain;
+        int blockSize = std::min( BLOCK_SIZE, bufferSize - offset );
 
-        // Accumulate comb filters in parallel
-        for ( int i = 0; i< NUM_COMBS; i++ ) {
-            outL += combL[ i ].process( input );
-            outR += combR[ i ].process( input );
+        for ( int j = 0, i = offset; j < blockSize; ++j, ++i ) {
+            input[ j ] = ( left[ i ] + ( !isMonoSource ? right[ i ] : 0.0 )) * _gain;
+            outL[ j ]  = 0.0;
+            outR[ j ]  = 0.0;
         }
 
-        // Feed through allPasses in series
-        for ( int i = 0; i < NUM_ALLPASSES; i++ ) {
-            outL = allPassL[ i ].process( outL );
-            outR = allPassR[ i ].process( outR );
+        // accumulate the comb filters of each side over the entire block. As the shortest delay
+        // exceeds the block size, the delayed samples were written in previous blocks and each
+        // comb only depends on its own filter state. Four combs are run at a time so their
+        // (otherwise serial) one-pole recursions overlap
+
+        for ( int c = 0; c < TOTAL_COMBS; c += 4 )
+        {
+            SAMPLE_TYPE* out = ( c < NUM_COMBS ) ? outL : outR;
+
+            SAMPLE_TYPE* ring0 = &_combBuffer[ c * combSize ];
+            SAMPLE_TYPE* ring1 = ring0 + combSize;
+            SAMPLE_TYPE* ring2 = ring1 + combSize;
+            SAMPLE_TYPE* ring3 = ring2 + combSize;
+
+            int read0 = _writeIndex - _combDelays[ c ];
+            int read1 = _writeIndex - _combDelays[ c + 1 ];
+            int read2 = _writeIndex - _combDelays[ c + 2 ];
+            int read3 = _writeIndex - _combDelays[ c + 3 ];
+
+            SAMPLE_TYPE filter0 = _combFilters[ c ];
+            SAMPLE_TYPE filter1 = _combFilters[ c + 1 ];
+            SAMPLE_TYPE filter2 = _combFilters[ c + 2 ];
+            SAMPLE_TYPE filter3 = _combFilters[ c + 3 ];
+
+            // split the block into runs where none of the ring indices wrap
+
+            for ( int j = 0; j < blockSize; )
+            {
+                int write = ( _writeIndex + j ) & _combMask;
+                int r0    = ( read0 + j ) & _combMask;
+                int r1    = ( read1 + j ) & _combMask;
+                int r2    = ( read2 + j ) & _combMask;
+                int r3    = ( read3 + j ) & _combMask;
+
+                int run = std::min( blockSize - j, combSize - write );
+                run = std::min( run, std::min( combSize - r0, combSize - r1 ));
+                run = std::min( run, std::min( combSize - r2, combSize - r3 ));
+
+                SAMPLE_TYPE* in0 = ring0 + r0;
+                SAMPLE_TYPE* in1 = ring1 + r1;
+                SAMPLE_TYPE* in2 = ring2 + r2;
+                SAMPLE_TYPE* in3 = ring3 + r3;
+
+                for ( int k = 0; k < run; ++k, ++j, ++write )
+                {
+                    SAMPLE_TYPE out0 = in0[ k ];
+                    SAMPLE_TYPE out1 = in1[ k ];
+                    SAMPLE_TYPE out2 = in2[ k ];
+                    SAMPLE_TYPE out3 = in3[ k ];
+
+                    filter0 = out0 * _combDamp2 + filter0 * _combDamp1;
+                    filter1 = out1 * _combDamp2 + filter1 * _combDamp1;
+                    filter2 = out2 * _combDamp2 + filter2 * _combDamp1;
+                    filter3 = out3 * _combDamp2 + filter3 * _combDamp1;
+
+                    ring0[ write ] = input[ j ] + filter0 * _combFeedback;
+                    ring1[ write ] = input[ j ] + filter1 * _combFeedback;
+                    ring2[ write ] = input[ j ] + filter2 * _combFeedback;
+                    ring3[ write ] = input[ j ] + filter3 * _combFeedback;
+
+                    out[ j ] += out0 + out1 + out2 + out3;
+                }
+            }
+            _combFilters[ c ]     = filter0;
+            _combFilters[ c + 1 ] = filter1;
+            _combFilters[ c + 2 ] = filter2;
+            _combFilters[ c + 3 ] = filter3;
         }
 
-        // Calculate output REPLACING anything already there
-        *outputL = outL * _wet1 + outR * _wet2 + *inputL * _dry;
-
-        if ( !isMonoSource ) {
-            *outputR = outR * _wet1 + outL * _wet2 + *inputR * _dry;
+        // feed through allPasses in series (these hold no state other than their delay
+        // line, as such each allpass processes the entire block before feeding the next)
+
+        for ( int a = 0; a < TOTAL_ALLPASSES; ++a )
+        {
+            SAMPLE_TYPE* out  = ( a % 2 == 0 ) ? outL : outR;
+            SAMPLE_TYPE* ring = &_allPassBuffer[ a * allPassSize ];
+            int readIndex     = _writeIndex - _allPassDelays[ a ];
+
+            for ( int j = 0; j < blockSize; )
+            {
+                int write = ( _writeIndex + j ) & _allPassMask;
+                int read  = ( readIndex + j ) & _allPassMask;
+                int run   = std::min( blockSize - j, std::min( allPassSize - write, allPassSize - read ));
+
+                SAMPLE_TYPE* in  = ring + read;
+                SAMPLE_TYPE* dst = ring + write;
+                SAMPLE_TYPE* x   = out + j;
+
+                for ( int k = 0; k < run; ++k )
+                {
+                    SAMPLE_TYPE bufout = in[ k ];
+
+                    dst[ k ] = x[ k ] + bufout * _allPassFeedback;
+                    x[ k ]   = bufout - x[ k ];
+                }
+                j += run;
+            }
         }
 
-        // Increment sample pointers, allowing for interleave (if any)
-        inputL  += skip;
-        outputL += skip;
+        // Calculate output REPLACING anything already there
+
+        for ( int j = 0, i = offset; j < blockSize; ++j, ++i )
+        {
+            left[ i ] = outL[ j ] * _wet1 + outR[ j ] * _wet2 + left[ i ] * _dry;
 
-        if ( !isMonoSource ) {
-            inputR  += skip;
-            outputR += skip;
+            if ( !isMonoSource )
+                right[ i ] = outR[ j ] * _wet1 + outL[ j ] * _wet2 + right[ i ] * _dry;
         }
+        _writeIndex = ( _writeIndex + blockSize ) & _combMask;
     }
-
 }
 
 void ReverbSM::update()
@@ -227,15 +269,9 @@ void ReverbSM::update()
         _gain      = FIXED_GAIN;
     }
     
-    for ( int i = 0; i < NUM_COMBS; i++ ) {
-        combL[ i ].setFeedback( _roomSize1 );
-        combR[ i ].setFeedback( _roomSize1 );
-    }
-    
-    for ( int i = 0; i < NUM_COMBS; i++ ) {
-        combL[ i ].setDamp( _damp1 );
-        combR[ i ].setDamp( _damp1 );
-    }
+    _combFeedback = _roomSize1;
+    _combDamp1    = _damp1;
+    _combDamp2    = 1 - _damp1;
 }
 
 void ReverbSM::setRoomSize( float value )
@@ -31,73 +31,6 @@
 
 namespace MWEngine {
 
-// inner classes for allPass and comb filtering
-
-class AllPass
-{
-    public:
-        AllPass();
-        void setBuffer( SAMPLE_TYPE *buf, int size );
-        inline SAMPLE_TYPE process( SAMPLE_TYPE input )
-        {
-            SAMPLE_TYPE output;
-            SAMPLE_TYPE bufout = _buffer[ _bufIndex ];
-            undenormalise( bufout );
-        
-            output = -input + bufout;
-            _buffer[ _bufIndex ] = input + ( bufout * _feedback );
-        
-            if ( ++_bufIndex >= _bufSize ) {
-                _bufIndex = 0;
-            }
-            return output;
-        }
-        void mute();
-        SAMPLE_TYPE getFeedback();
-        void setFeedback( SAMPLE_TYPE val );
-
-    private:
-        SAMPLE_TYPE  _feedback;
-        SAMPLE_TYPE* _buffer;
-        int _bufSize;
-        int _bufIndex;
-};
-
-class Comb
-{
-    public:
-        Comb();
-        void setBuffer( SAMPLE_TYPE *buf, int size );
-        inline SAMPLE_TYPE process( SAMPLE_TYPE input )
-        {
-            SAMPLE_TYPE output = _buffer[ _bufIndex ];
-            undenormalise( output );
-        
-            _filterStore = ( output * _damp2 ) + ( _filterStore * _damp1 );
-            undenormalise( _filterStore );
-        
-            _buffer[_bufIndex] = input + ( _filterStore * _feedback );
-            if ( ++_bufIndex >= _bufSize ) {
-                _bufIndex = 0;
-            }
-            return output;
-        }
-        void mute();
-        SAMPLE_TYPE getDamp();
-        void setDamp( SAMPLE_TYPE val );
-        SAMPLE_TYPE getFeedback();
-        void setFeedback( SAMPLE_TYPE val );
-
-    private:
-        SAMPLE_TYPE  _feedback;
-        SAMPLE_TYPE  _filterStore;
-        SAMPLE_TYPE  _damp1;
-        SAMPLE_TYPE  _damp2;
-        SAMPLE_TYPE* _buffer;
-        int _bufSize;
-        int _bufIndex;
-};
-
 // Reverb class
 
 class ReverbSM : public BaseProcessor {
@@ -151,6 +84,7 @@ class ReverbSM : public BaseProcessor {
 
     public:
         ReverbSM();
+        ~ReverbSM();
         void mute();
         void setRoomSize( float value );
         float getRoomSize();
@@ -176,46 +110,25 @@ class ReverbSM : public BaseProcessor {
         float _width;
         float _mode;
     
-        // The following are all declared inline 
-        // to remove the need for dynamic allocation
-        // with its subsequent error-checking messiness
-        // TODO: we will have to make these allocate dynamically when
-        // scaling the tuning constants at runtime
-    
-        // Comb filters and their buffers
-
-        Comb combL[ NUM_COMBS ];
-        Comb combR[ NUM_COMBS ];
-
-        SAMPLE_TYPE bufCombL1[ COMB_TUNING_L1 ];
-        SAMPLE_TYPE bufCombR1[ COMB_TUNING_R1 ];
-        SAMPLE_TYPE bufCombL2[ COMB_TUNING_L2 ];
-        SAMPLE_TYPE bufCombR2[ COMB_TUNING_R2 ];
-        SAMPLE_TYPE bufCombL3[ COMB_TUNING_L3 ];
-        SAMPLE_TYPE bufCombR3[ COMB_TUNING_R3 ];
-        SAMPLE_TYPE bufCombL4[ COMB_TUNING_L4 ];
-        SAMPLE_TYPE bufCombR4[ COMB_TUNING_R4 ];
-        SAMPLE_TYPE bufCombL5[ COMB_TUNING_L5 ];
-        SAMPLE_TYPE bufCombR5[ COMB_TUNING_R5 ];
-        SAMPLE_TYPE bufCombL6[ COMB_TUNING_L6 ];
-        SAMPLE_TYPE bufCombR6[ COMB_TUNING_R6 ];
-        SAMPLE_TYPE bufCombL7[ COMB_TUNING_L7 ];
-        SAMPLE_TYPE bufCombR7[ COMB_TUNING_R7 ];
-        SAMPLE_TYPE bufCombL8[ COMB_TUNING_L8 ];
-        SAMPLE_TYPE bufCombR8[ COMB_TUNING_R8 ];
-
-        // AllPass filters and their buffers
-
-        AllPass allPassL[ NUM_ALLPASSES ];
-        AllPass allPassR[ NUM_ALLPASSES ];
-        SAMPLE_TYPE bufAllPassL1[ ALLPASS_TUNING_L1 ];
-        SAMPLE_TYPE bufAllPassR1[ ALLPASS_TUNING_R1 ];
-        SAMPLE_TYPE bufAllPassL2[ ALLPASS_TUNING_L2 ];
-        SAMPLE_TYPE bufAllPassR2[ ALLPASS_TUNING_R2 ];
-        SAMPLE_TYPE bufAllPassL3[ ALLPASS_TUNING_L3 ];
-        SAMPLE_TYPE bufAllPassR3[ ALLPASS_TUNING_R3 ];
-        SAMPLE_TYPE bufAllPassL4[ ALLPASS_TUNING_L4 ];
-        SAMPLE_TYPE bufAllPassR4[ ALLPASS_TUNING_R4 ];
+        // the comb filters (of both sides) and the allpasses (of both sides) each share a single
+        // block of delay memory, holding a ring per filter (left filters followed by right filters
+        // for the combs, alternating left and right filters for the allpasses). Each filter reads
+        // at its own delay relative to a shared write index, wrapped using a power of two mask
+
+        SAMPLE_TYPE* _combBuffer;
+        SAMPLE_TYPE* _allPassBuffer;
+
+        int _combDelays   [ NUM_COMBS * 2 ];
+        int _allPassDelays[ NUM_ALLPASSES * 2 ];
+        int _combMask;
+        int _allPassMask;
+        int _writeIndex;
+
+        SAMPLE_TYPE _combFilters[ NUM_COMBS * 2 ]; // damping (low pass) filter state per comb
+        SAMPLE_TYPE _combFeedback;
+        SAMPLE_TYPE _combDamp1;
+        SAMPLE_TYPE _combDamp2;
+        SAMPLE_TYPE _allPassFeedback;
 };
 } // E.O namespace MWEngine
 
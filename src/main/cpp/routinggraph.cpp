@@ -0,0 +1,485 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "routinggraph.h"
+#include "audioengine.h"
+#include "sequencer.h"
+#include <algorithm>
+#include <cassert>
+
+namespace MWEngine {
+
+const int RoutingGraph::MAX_THREADS;
+
+/* constructor / destructor */
+
+RoutingGraph::RoutingGraph()
+{
+    _schedule.store( new Schedule());
+    _amountOfWorkers.store( 0 );
+
+    _activeSchedule = _schedule.load();
+    _activeWorkers  = 0;
+    _workLevel      = nullptr;
+    _workNext       = 0;
+    _workPending    = 0;
+    _workersBusy    = 0;
+    _workGeneration = 0;
+    _isMonoSource   = false;
+    _running        = false;
+}
+
+RoutingGraph::~RoutingGraph()
+{
+    stopThreads();
+
+    for ( size_t i = 0; i < _buses.size(); ++i )
+        _buses.at( i )->setOutputBuffer( nullptr );
+
+    for ( size_t i = 0; i < _buffers.size(); ++i )
+        delete _buffers.at( i );
+
+    delete _schedule.load();
+}
+
+/* public methods */
+
+void RoutingGraph::addBus( AudioBus* bus )
+{
+    std::unique_lock<std::mutex> guard( _lock );
+
+    if ( std::find( _buses.begin(), _buses.end(), bus ) != _buses.end())
+        return;
+
+    // take a buffer from the pool, growing the pool when all buffers are in use
+
+    AudioBuffer* buffer;
+
+    if ( _freeBuffers.empty()) {
+        buffer = new AudioBuffer( AudioEngineProps::OUTPUT_CHANNELS, AudioEngineProps::BUFFER_SIZE );
+        _buffers.push_back( buffer );
+    } else {
+        buffer = _freeBuffers.back();
+        _freeBuffers.pop_back();
+
+        // engine properties changed while the buffer was unused ? recreate it
+
+        if ( buffer->amountOfChannels != AudioEngineProps::OUTPUT_CHANNELS ||
+             buffer->bufferSize       != AudioEngineProps::BUFFER_SIZE )
+        {
+            AudioBuffer* replacement = new AudioBuffer( AudioEngineProps::OUTPUT_CHANNELS, AudioEngineProps::BUFFER_SIZE );
+            std::replace( _buffers.begin(), _buffers.end(), buffer, replacement );
+            delete buffer;
+            buffer = replacement;
+        } else {
+            buffer->silenceBuffers();
+        }
+    }
+    bus->setOutputBuffer( buffer );
+    _buses.push_back( bus );
+
+    Schedule* previous = rebuildSchedule();
+    guard.unlock();
+
+    disposeSchedule( previous );
+}
+
+void RoutingGraph::removeBus( AudioBus* bus )
+{
+    // reroute all sources outputting into the bus into its output bus
+
+    std::vector<AudioBus*> buses;
+    {
+        std::lock_guard<std::mutex> guard( _lock );
+        buses = _buses;
+    }
+    AudioBus* outputBus = bus->getOutputBus();
+
+    for ( size_t i = 0; i < buses.size(); ++i )
+    {
+        if ( buses.at( i )->getOutputBus() == bus )
+            buses.at( i )->setOutputBus( outputBus );
+    }
+
+    std::vector<BaseInstrument*> instruments = Sequencer::instruments;
+
+    for ( size_t i = 0; i < instruments.size(); ++i )
+    {
+        AudioChannel* channel = instruments.at( i )->audioChannel;
+
+        if ( channel->getOutputBus() == bus )
+            channel->setOutputBus( outputBus );
+
+        channel->setSendLevel( bus, 0.f );
+    }
+
+    std::unique_lock<std::mutex> guard( _lock );
+
+    auto it = std::find( _buses.begin(), _buses.end(), bus );
+
+    if ( it == _buses.end()) {
+        // not scheduled, but the render thread might be mixing into the bus through a channel
+        guard.unlock();
+        AudioEngine::waitForRenderCycle();
+        return;
+    }
+    _buses.erase( it );
+
+    // withdraw the buffer from the pool while awaiting the render cycle (so createOutputBuffers()
+    // doesn't replace it in the meantime), once the schedule omitting the bus has been picked up
+    // by the render thread (and the channels no longer output into the bus) it returns to the pool
+
+    AudioBuffer* buffer = bus->getOutputBuffer();
+    _buffers.erase( std::remove( _buffers.begin(), _buffers.end(), buffer ), _buffers.end());
+
+    Schedule* previous = rebuildSchedule();
+    guard.unlock();
+
+    disposeSchedule( previous );
+
+    guard.lock();
+
+    _buffers.push_back( buffer );
+    _freeBuffers.push_back( buffer );
+    bus->setOutputBuffer( nullptr );
+}
+
+bool RoutingGraph::hasBus( AudioBus* bus )
+{
+    std::lock_guard<std::mutex> guard( _lock );
+    return std::find( _buses.begin(), _buses.end(), bus ) != _buses.end();
+}
+
+int RoutingGraph::getAmountOfBuses()
+{
+    std::lock_guard<std::mutex> guard( _lock );
+    return ( int ) _buses.size();
+}
+
+void RoutingGraph::rebuild()
+{
+    std::unique_lock<std::mutex> guard( _lock );
+
+    Schedule* previous = rebuildSchedule();
+    guard.unlock();
+
+    disposeSchedule( previous );
+}
+
+int RoutingGraph::getAmountOfLevels()
+{
+    std::lock_guard<std::mutex> guard( _lock );
+    return ( int ) _schedule.load()->levels.size();
+}
+
+int RoutingGraph::getLevel( AudioBus* bus )
+{
+    std::lock_guard<std::mutex> guard( _lock );
+
+    std::vector<std::vector<Node>>& levels = _schedule.load()->levels;
+
+    for ( size_t i = 0; i < levels.size(); ++i )
+    {
+        for ( size_t j = 0; j < levels[ i ].size(); ++j )
+        {
+            if ( levels[ i ][ j ].bus == bus )
+                return ( int ) i;
+        }
+    }
+    return -1;
+}
+
+void RoutingGraph::createOutputBuffers()
+{
+    std::unique_lock<std::mutex> guard( _lock );
+
+    std::vector<AudioBuffer*> replacedBuffers;
+
+    for ( size_t i = 0; i < _buffers.size(); ++i )
+    {
+        AudioBuffer* buffer = _buffers.at( i );
+
+        if ( buffer->amountOfChannels == AudioEngineProps::OUTPUT_CHANNELS &&
+             buffer->bufferSize       == AudioEngineProps::BUFFER_SIZE )
+            continue;
+
+        AudioBuffer* replacement = new AudioBuffer( AudioEngineProps::OUTPUT_CHANNELS, AudioEngineProps::BUFFER_SIZE );
+
+        for ( size_t j = 0; j < _buses.size(); ++j )
+        {
+            if ( _buses.at( j )->getOutputBuffer() == buffer )
+                _buses.at( j )->setOutputBuffer( replacement );
+        }
+        std::replace( _freeBuffers.begin(), _freeBuffers.end(), buffer, replacement );
+
+        _buffers.at( i ) = replacement;
+        replacedBuffers.push_back( buffer );
+    }
+
+    if ( replacedBuffers.empty())
+        return;
+
+    Schedule* previous = rebuildSchedule();
+    guard.unlock();
+
+    disposeSchedule( previous );
+
+    for ( size_t i = 0; i < replacedBuffers.size(); ++i )
+        delete replacedBuffers.at( i );
+}
+
+int RoutingGraph::getPoolSize()
+{
+    std::lock_guard<std::mutex> guard( _lock );
+    return ( int ) _buffers.size();
+}
+
+void RoutingGraph::setAmountOfThreads( int amount )
+{
+    assert( !AudioEngine::isRenderThread());
+
+    amount = std::max( 0, std::min( MAX_THREADS, amount ));
+
+    // ensure the render thread no longer dispatches to the current workers before joining these
+    // (the render cycle is awaited without holding the lock, should a concurrent invocation start
+    // workers in the meantime, stopping these is safe as the render thread processes unclaimed nodes itself)
+
+    _amountOfWorkers.store( 0 );
+    AudioEngine::waitForRenderCycle();
+
+    std::lock_guard<std::mutex> guard( _lock );
+
+    _amountOfWorkers.store( 0 );
+    stopThreads();
+
+    {
+        std::lock_guard<std::mutex> workGuard( _workLock );
+        _running = true;
+    }
+
+    for ( int i = 0; i < amount; ++i )
+        _threads.push_back( std::thread( &RoutingGraph::handleWorkerThread, this ));
+
+    _amountOfWorkers.store( amount );
+}
+
+int RoutingGraph::getAmountOfThreads()
+{
+    std::lock_guard<std::mutex> guard( _lock );
+    return ( int ) _threads.size();
+}
+
+void RoutingGraph::prepare()
+{
+    _activeSchedule = _schedule.load();
+    _activeWorkers  = _amountOfWorkers.load();
+
+    std::vector<std::vector<Node>>& levels = _activeSchedule->levels;
+
+    for ( size_t i = 0; i < levels.size(); ++i )
+    {
+        for ( size_t j = 0; j < levels[ i ].size(); ++j )
+            levels[ i ][ j ].buffer->silenceBuffers();
+    }
+}
+
+void RoutingGraph::process( AudioBuffer* masterBuffer, bool isMonoSource )
+{
+    _isMonoSource = isMonoSource;
+
+    std::vector<std::vector<Node>>& levels = _activeSchedule->levels;
+
+    for ( size_t i = 0; i < levels.size(); ++i )
+        processLevel( levels[ i ]);
+
+    std::vector<AudioBus*>& roots = _activeSchedule->roots;
+
+    for ( size_t i = 0; i < roots.size(); ++i )
+        roots[ i ]->mixBuffer( masterBuffer );
+}
+
+/* private methods */
+
+RoutingGraph::Schedule* RoutingGraph::rebuildSchedule()
+{
+    // the level of a bus is its maximum distance to the buses that have no registered
+    // inputs (level 0). Walking up from each bus, all its outputs are raised to at least
+    // their distance from it (as AudioBus::setOutputBus() prevents cycles, this terminates)
+
+    size_t amount = _buses.size();
+    std::vector<size_t> levels( amount, 0 );
+    size_t amountOfLevels = amount > 0 ? 1 : 0;
+
+    for ( size_t i = 0; i < amount; ++i )
+    {
+        size_t distance = 0;
+
+        for ( AudioBus* output = _buses[ i ]->getOutputBus(); output != nullptr; output = output->getOutputBus())
+        {
+            auto it = std::find( _buses.begin(), _buses.end(), output );
+
+            if ( it == _buses.end())
+                break;
+
+            size_t index = it - _buses.begin();
+            levels[ index ] = std::max( levels[ index ], ++distance );
+            amountOfLevels  = std::max( amountOfLevels, distance + 1 );
+        }
+    }
+
+    Schedule* schedule = new Schedule();
+    schedule->levels.resize( amountOfLevels );
+
+    for ( size_t i = 0; i < amount; ++i )
+    {
+        AudioBus* bus = _buses[ i ];
+        Node node     = { bus, bus->getOutputBuffer(), std::vector<AudioBus*>() };
+
+        for ( size_t j = 0; j < amount; ++j )
+        {
+            if ( _buses[ j ]->getOutputBus() == bus )
+                node.inputs.push_back( _buses[ j ]);
+        }
+        schedule->levels[ levels[ i ]].push_back( node );
+
+        if ( std::find( _buses.begin(), _buses.end(), bus->getOutputBus()) == _buses.end())
+            schedule->roots.push_back( bus );
+    }
+
+    // publish the schedule, the previous one is freed once the render thread no longer uses it
+
+    return _schedule.exchange( schedule );
+}
+
+void RoutingGraph::disposeSchedule( Schedule* schedule )
+{
+    // awaiting the render cycle from the render thread would never complete
+
+    assert( !AudioEngine::isRenderThread());
+
+    AudioEngine::waitForRenderCycle();
+    delete schedule;
+}
+
+void RoutingGraph::processNode( Node& node )
+{
+    // the inputs have been processed in a preceding level
+
+    for ( size_t i = 0; i < node.inputs.size(); ++i )
+        node.inputs[ i ]->mixBuffer( node.buffer );
+
+    node.bus->process( _isMonoSource );
+}
+
+void RoutingGraph::processLevel( std::vector<Node>& level )
+{
+    if ( _activeWorkers == 0 || level.size() < 2 )
+    {
+        for ( size_t i = 0; i < level.size(); ++i )
+            processNode( level[ i ]);
+
+        return;
+    }
+
+    // hand the level to the workers (the state is published prior to the level itself)
+
+    _workNext.store( 0 );
+    _workPending.store( level.size());
+    _workLevel.store( &level );
+
+    ++_workGeneration;
+
+    // notifying without holding the lock can be missed by a worker that is about to wait, in
+    // which case the level is processed without it (the render thread claims all remaining nodes)
+
+    _workCondition.notify_all();
+
+    // the render thread processes nodes as well, then awaits completion of the nodes claimed by the workers
+
+    processJobs( level );
+
+    while ( _workPending.load() > 0 )
+        std::this_thread::yield();
+
+    // withdraw the level and await the workers that might still be referencing it
+
+    _workLevel.store( nullptr );
+
+    while ( _workersBusy.load() > 0 )
+        std::this_thread::yield();
+}
+
+void RoutingGraph::processJobs( std::vector<Node>& level )
+{
+    for ( size_t i = _workNext++; i < level.size(); i = _workNext++ )
+    {
+        processNode( level[ i ]);
+        --_workPending;
+    }
+}
+
+void RoutingGraph::handleWorkerThread()
+{
+    unsigned int generation = _workGeneration.load();
+
+    while ( true )
+    {
+        {
+            std::unique_lock<std::mutex> guard( _workLock );
+
+            while ( _running && _workGeneration.load() == generation )
+                _workCondition.wait( guard );
+
+            if ( !_running )
+                return;
+
+            generation = _workGeneration.load();
+        }
+
+        // register as busy prior to reading the level (see processLevel())
+
+        ++_workersBusy;
+
+        std::vector<Node>* level = _workLevel.load();
+
+        if ( level != nullptr )
+            processJobs( *level );
+
+        --_workersBusy;
+    }
+}
+
+void RoutingGraph::stopThreads()
+{
+    {
+        std::unique_lock<std::mutex> guard( _workLock );
+        _running = false;
+    }
+    _workCondition.notify_all();
+
+    for ( size_t i = 0; i < _threads.size(); ++i )
+        _threads.at( i ).join();
+
+    _threads.clear();
+}
+
+} // E.O namespace MWEngine
@@ -0,0 +1,153 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__ROUTINGGRAPH_H_INCLUDED__
+#define __MWENGINE__ROUTINGGRAPH_H_INCLUDED__
+
+#include "audiobus.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MWEngine {
+
+/**
+ * RoutingGraph describes how the registered AudioBuses output into each other. Buses can
+ * nest (e.g. a "drums" group bus outputting into a "rhythm" group bus) where the master bus
+ * is the root of the graph. Buses that output into an unregistered bus output into the master bus.
+ *
+ * whenever the routing changes, the graph is sorted topologically into a schedule of levels:
+ * a bus is processed only after all the buses that output into it have been processed. As the
+ * buses within a single level are independent, these can be processed in parallel (see
+ * setAmountOfThreads()).
+ *
+ * the output buffers of the buses are taken from a pool that is sized by the amount of registered
+ * buses. Buffers are allocated upon registration (and never from within the render cycle) and
+ * are returned to the pool (for reuse) when a bus is unregistered.
+ *
+ * the schedule is built outside of the render thread and published atomically, the render thread
+ * picks it up at the start of its cycle (see prepare()) and never takes a lock held by the mutating
+ * methods. A replaced schedule (and a removed bus) is only freed after the render thread has
+ * completed the cycle in which it could have referenced it (awaited without holding the lock, as
+ * such the mutating methods must not be invoked from the render thread).
+ *
+ * when processing in parallel, the render thread doesn't lock either: the buses of a level are
+ * claimed atomically by the render thread and the workers, after which the render thread spins
+ * until the buses claimed by the workers have been processed.
+ */
+class RoutingGraph
+{
+    public:
+        RoutingGraph();
+        ~RoutingGraph();
+
+        static const int MAX_THREADS = 4;
+
+        void addBus( AudioBus* bus );
+
+        // also reroutes all buses and instrument channels outputting into given bus into its
+        // output bus and removes the sends of all instruments channels to given bus. Upon return
+        // the render thread no longer references given bus
+
+        void removeBus( AudioBus* bus );
+        bool hasBus( AudioBus* bus );
+        int getAmountOfBuses();
+
+        // sorts the registered buses into the processing schedule, invoked whenever the routing changes
+
+        void rebuild();
+
+        // the processing schedule (level 0 is processed first), returns -1 for unregistered buses
+
+        int getAmountOfLevels();
+        int getLevel( AudioBus* bus );
+
+        // (re)creates the pooled buffers to match the engines properties, invoked when the engine starts
+
+        void createOutputBuffers();
+        int getPoolSize();
+
+        // the amount of worker threads (next to the render thread) that process the independent
+        // buses within a level. By default this is 0 (all buses are processed on the render thread)
+
+        void setAmountOfThreads( int amount );
+        int getAmountOfThreads();
+
+        // invoked by the AudioEngine during its render cycle, prepare() picks up the most recently
+        // published schedule and silences the output buffers of the buses (prior to rendering the channels),
+        // process() applies the processors of all buses in scheduled order and mixes the root buses into
+        // given masterBuffer. prepare() must precede process() within each cycle
+
+        void prepare();
+        void process( AudioBuffer* masterBuffer, bool isMonoSource );
+
+    private:
+        struct Node {
+            AudioBus* bus;
+            AudioBuffer* buffer;
+            std::vector<AudioBus*> inputs; // the buses outputting into this bus
+        };
+
+        struct Schedule {
+            std::vector<std::vector<Node>> levels;
+            std::vector<AudioBus*> roots; // the buses outputting into the master bus
+        };
+
+        Schedule* rebuildSchedule();                 // publishes a new schedule (invoke under _lock), returns the replaced schedule
+        void disposeSchedule( Schedule* schedule ); // frees a replaced schedule once the render thread no longer uses it (invoke without _lock)
+        void processNode( Node& node );
+        void processLevel( std::vector<Node>& level );
+        void processJobs( std::vector<Node>& level );
+        void handleWorkerThread();
+        void stopThreads();
+
+        // registered buses, buffer pool and worker threads, only accessed under _lock (never by the render thread)
+
+        std::vector<AudioBus*> _buses;
+        std::vector<AudioBuffer*> _buffers;
+        std::vector<AudioBuffer*> _freeBuffers;
+        std::vector<std::thread> _threads;
+        std::mutex _lock;
+
+        std::atomic<Schedule*> _schedule;      // most recently published schedule
+        std::atomic<int> _amountOfWorkers;     // the amount of worker threads the render thread may use
+        Schedule* _activeSchedule;             // schedule used by the current render cycle
+        int _activeWorkers;
+
+        // parallel processing of the current level (shared between the render thread and workers only)
+        // _workLock is only held by the workers while they wait for the next level (and when stopping these)
+
+        std::mutex _workLock;
+        std::condition_variable _workCondition;
+        std::atomic<std::vector<Node>*> _workLevel;
+        std::atomic<size_t> _workNext;         // index of the next node to claim within the current level
+        std::atomic<size_t> _workPending;      // amount of nodes in the current level that have yet to be processed
+        std::atomic<int> _workersBusy;         // amount of workers that might still reference the current level
+        std::atomic<unsigned int> _workGeneration; // incremented for each level handed to the workers
+        bool _isMonoSource;
+        bool _running;
+};
+} // E.O namespace MWEngine
+
+#endif
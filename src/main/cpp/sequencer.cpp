@@ -23,6 +23,7 @@
 #include "sequencer.h"
 #include "audioengine.h"
 #include <utilities/utils.h>
+#include <utilities/bufferutility.h>
 #include <vector>
 
 namespace MWEngine {
@@ -31,6 +32,7 @@ namespace MWEngine {
 
 bool Sequencer::playing           = false;
 BulkCacher* Sequencer::bulkCacher = new BulkCacher( true );
+int Sequencer::prefetchBuffers     = 8;
 std::vector<BaseInstrument*> Sequencer::instruments;
 
 /* public methods */
@@ -152,6 +154,23 @@ void Sequencer::collectSequencedEvents( BaseInstrument* instrument, int bufferPo
         }
     }
 
+    // look ahead range for prefetching, when it exceeds the
+    // sequencer loop, it continues from the loop start
+
+    int prefetchEnd     = bufferEnd + ( bufferEnd - bufferPosition + 1 ) * prefetchBuffers;
+    int prefetchWrapEnd = -1;
+
+    if ( prefetchEnd > AudioEngine::max_buffer_position )
+        prefetchWrapEnd = AudioEngine::min_buffer_position + ( prefetchEnd - AudioEngine::max_buffer_position );
+
+    // the range (in ticks) events must overlap to be queried, events that aren't synced to the current
+    // tempo are only synced once they enter this range (see BaseAudioEvent::syncTiming())
+
+    double rangeStart     = samplesToTicks( bufferPosition );
+    double rangeEnd       = samplesToTicks( prefetchEnd + 1 );
+    double wrapRangeStart = samplesToTicks( AudioEngine::min_buffer_position );
+    double wrapRangeEnd   = samplesToTicks( prefetchWrapEnd + 1 );
+
     int i = 0;
     int total = audioEvents->size();
 
@@ -161,6 +180,11 @@ void Sequencer::collectSequencedEvents( BaseInstrument* instrument, int bufferPo
 
         if ( audioEvent->isEnabled() )
         {
+            if ( !audioEvent->isTimingSynced() &&
+                 !audioEvent->overlapsTicks( rangeStart, rangeEnd ) &&
+               ( prefetchWrapEnd < 0 || !audioEvent->overlapsTicks( wrapRangeStart, wrapRangeEnd )))
+                continue;
+
             int eventStart = audioEvent->getEventStart();
             int eventEnd   = audioEvent->getEventEnd();
 
@@ -172,6 +196,11 @@ void Sequencer::collectSequencedEvents( BaseInstrument* instrument, int bufferPo
                 else
                     removes.push_back( audioEvent );
             }
+            else if (( eventStart > bufferEnd && eventStart <= prefetchEnd ) ||
+                     ( eventStart >= AudioEngine::min_buffer_position && eventStart <= prefetchWrapEnd ))
+            {
+                audioEvent->prefetch();
+            }
         }
     }
 
@@ -230,6 +259,17 @@ void Sequencer::collectLiveEvents( BaseInstrument* instrument )
     }
 }
 
+/**
+ * translates given buffer position into ticks at the current tempo (or TempoMap)
+ */
+double Sequencer::samplesToTicks( int samples )
+{
+    if ( AudioEngine::tempoMap != nullptr )
+        return AudioEngine::tempoMap->getTickPosition( samples );
+
+    return ( double ) samples / BufferUtility::getSamplesPerTick( AudioEngineProps::SAMPLE_RATE, AudioEngine::tempo );
+}
+
 /**
  * used by the cacheAudioEventsForMeasure-method, this collects
  * all AudioEvents in the requested measure for entry into the BulkCacher
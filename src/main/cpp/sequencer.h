@@ -47,6 +47,10 @@ class Sequencer
         static std::vector<BaseInstrument*> instruments;
         static BulkCacher* bulkCacher;
 
+        // the amount of buffers to look ahead when collecting events, events that are
+        // about to play within this range are requested to prefetch their contents
+        static int prefetchBuffers;
+
         static int registerInstrument   ( BaseInstrument* instrument );
         static bool unregisterInstrument( BaseInstrument* instrument );
 
@@ -60,6 +64,7 @@ class Sequencer
 
         static void collectSequencedEvents( BaseInstrument* aInstrument, int bufferPosition, int bufferEnd );
         static void collectLiveEvents     ( BaseInstrument* aInstrument );
+        static double samplesToTicks( int samples );
 
         static std::vector<BaseCacheableAudioEvent*>* collectCacheableSequencerEvents( int bufferPosition, int bufferEnd );
 };
@@ -27,6 +27,8 @@
 #include <messaging/notifier.h>
 #include <utilities/utils.h>
 #include <utilities/diskwriter.h>
+#include <utilities/freezer.h>
+#include <utilities/inputcapture.h>
 #include <utilities/volumeutil.h>
 
 namespace MWEngine {
@@ -82,6 +84,28 @@ void SequencerController::setTempoNow( float aTempo, int aTimeSigBeatAmount, int
     AudioEngine::handleTempoUpdate( AudioEngine::queuedTempo, true );
 }
 
+void SequencerController::setTempoMap( TempoMap* aTempoMap )
+{
+    AudioEngine::queuedTempoMapVersion = aTempoMap != nullptr ? aTempoMap->getVersion() : 0;
+    AudioEngine::queuedTempoMap        = aTempoMap;
+}
+
+void SequencerController::setTempoMapNow( TempoMap* aTempoMap )
+{
+    AudioEngine::handleTempoMapUpdate( aTempoMap );
+
+    // the render thread might still be reading the replaced map, once the current
+    // render cycle completes, the replaced map can safely be deleted by the caller
+
+    if ( !AudioEngine::isRenderThread())
+        AudioEngine::waitForRenderCycle();
+}
+
+TempoMap* SequencerController::getTempoMap()
+{
+    return AudioEngine::tempoMap;
+}
+
 void SequencerController::setVolume( float aVolume )
 {
     AudioEngine::volume = VolumeUtil::toLog( aVolume );
@@ -127,6 +151,7 @@ void SequencerController::setLoopRange( int aStartPosition, int aEndPosition, in
         AudioEngine::stepPosition = AudioEngine::min_step_position;
     }
     updateStepsPerBar( aStepsPerBar );
+    Freezer::requestUpdate();
 }
 
 int SequencerController::getStepPosition()
@@ -212,7 +237,8 @@ void SequencerController::setNotificationMarker( int aPosition )
 
 /**
  * used for intelligent pre-caching, get the BaseCacheableAudioEvents
- * belonging to a specific measure for on-demand caching
+ * belonging to a specific measure for on-demand caching. Caching is
+ * performed in the background (this method returns immediately)
  *
  * @param aMeasure {int} the measure containing the events we'd like to precache
  */
@@ -261,11 +287,10 @@ void SequencerController::setBounceState( bool aIsBouncing, int aMaxBuffers, cha
  * Record the output of the sequencer onto storage
  *
  * aRecording        {bool} toggles the recording state
- * aMaxBuffers        {int} the total recorded buffer size to store in memory
- *                          before writing the recorded snippet as .WAV file into
- *                          the given output file's directory.
- * aOutputDirectory {char*} name of the output WAV file to generate when recording completes
- *                          (when recording state is disabled), this will concatenate all snippets.
+ * aMaxBuffers        {int} the recorded buffer size that can be queued in memory
+ *                          while the recording is being streamed onto storage
+ * aOutputDirectory {char*} name of the output WAV file to write the recording into, the file
+ *                          is completed when the recording state is disabled
  */
 void SequencerController::setRecordingState( bool aRecording, int aMaxBuffers, char* aOutputFile )
 {
@@ -285,13 +310,10 @@ void SequencerController::setRecordingState( bool aRecording, int aMaxBuffers, c
     }
     else if ( wasRecording )
     {
-        // recording halted, write currently recording snippet into file
-        // and concatenate all recorded snippets into the requested output file name
+        // recording halted, write the remainder of the recording into the output file
         // we can do this synchronously as this method is called from outside the
         // rendering thread and thus won't lead to buffer under runs
 
-        DiskWriter::writeBufferToFile( DiskWriter::currentBufferIndex, false );
-
         if ( DiskWriter::finish())
             Notifier::broadcast( Notifications::RECORDING_COMPLETED );
     }
@@ -302,10 +324,9 @@ void SequencerController::setRecordingState( bool aRecording, int aMaxBuffers, c
  * not the remaining audio processed / generated by the engine
  *
  * aRecording        {bool} toggles the recording state
- * aMaxBuffers        {int} the total recorded buffer size to store in memory
- *                          before writing the recorded contents as .WAV file into
- *                          the given output directory.
- * aOutputDirectory {char*} name of the folder to write each snippet into
+ * aMaxBuffers        {int} the recorded buffer size that can be queued in memory
+ *                          while the recording is being streamed onto storage
+ * aOutputDirectory {char*} name of the output WAV file to write the recording into
  */
 void SequencerController::setRecordingFromDeviceState( bool aRecording, int aMaxBuffers, char* aOutputFile )
 {
@@ -313,34 +334,111 @@ void SequencerController::setRecordingFromDeviceState( bool aRecording, int aMax
     if ( AudioEngine::recordOutputToDisk )
         setRecordingState( false, 0, ( char* ) "\0" );
 
-    bool wasRecording              = AudioEngine::recordInputToDisk;
-    AudioEngine::recordInputToDisk = aRecording;
+    bool wasRecording = AudioEngine::recordInputToDisk;
 
-    if ( AudioEngine::recordInputToDisk )
+    if ( aRecording )
     {
+        // arm the capture path before the render thread starts recording so the
+        // first recorded buffer is already compensated for the input latency
+
         DiskWriter::prepare(
             std::string( aOutputFile ), roundTo( aMaxBuffers, AudioEngineProps::BUFFER_SIZE ),
             AudioEngineProps::INPUT_CHANNELS
         );
+        InputCapture::prepare();
     }
-    else if ( wasRecording )
+    AudioEngine::recordInputToDisk = aRecording;
+
+    if ( !aRecording && wasRecording )
     {
-        // recording halted, write currently recording snippet into file
-        // and concatenate all recorded snippets into the requested output file name
+        // recording halted, write the remainder of the recording into the output file
         // we can do this synchronously as this method is called from outside the
         // rendering thread and thus won't lead to buffer under runs
 
-        DiskWriter::writeBufferToFile( DiskWriter::currentBufferIndex, false );
-
         if ( DiskWriter::finish())
             Notifier::broadcast( Notifications::RECORDING_COMPLETED );
     }
 }
 
 /**
- * Save the contents of the snippet at given buffer index
- * onto storage. This should be invoked from a thread separate to the
- * audio rendering thread to prevent buffer under runs from happening
+ * Record the output of each instruments AudioChannel into a separate file (a "stem")
+ * while simultaneously recording the combined output of the sequencer
+ *
+ * aRecording         {bool} toggles the recording state
+ * aMaxBuffers         {int} the recorded buffer size that can be queued in memory (per file)
+ *                           while the recording is being streamed onto storage
+ * aOutputDirectory  {char*} name of the directory to write the recordings into. The combined output
+ *                           is written into "master", each instruments output into "channel_n" (where
+ *                           n is the index of the instrument in the order of registration)
+ */
+void SequencerController::setStemRecordingState( bool aRecording, int aMaxBuffers, char* aOutputDirectory )
+{
+    if ( !aRecording ) {
+        setRecordingState( false, 0, ( char* ) "\0" );
+        return;
+    }
+
+    // halt any running recording before preparing the stems (so the
+    // rendering thread isn't appending while the streams are being created)
+
+    if ( AudioEngine::recordInputToDisk )
+        setRecordingFromDeviceState( false, 0, ( char* ) "\0" );
+
+    AudioEngine::recordOutputToDisk = false;
+
+    std::string directory = std::string( aOutputDirectory );
+    int chunkSize         = roundTo( aMaxBuffers, AudioEngineProps::BUFFER_SIZE );
+
+    std::vector<AudioChannel*> channels;
+
+    for ( size_t i = 0; i < Sequencer::instruments.size(); ++i )
+        channels.push_back( Sequencer::instruments.at( i )->audioChannel );
+
+    DiskWriter::prepare( directory + "/master" + DiskWriter::getFileExtension(), chunkSize, AudioEngineProps::OUTPUT_CHANNELS );
+    DiskWriter::prepareStems( directory, channels, chunkSize );
+
+    AudioEngine::recordOutputToDisk = true;
+}
+
+void SequencerController::setStemBounceState( bool aIsBouncing, int aMaxBuffers, char* aOutputDirectory, int rangeStart, int rangeEnd )
+{
+    AudioEngine::bouncing = aIsBouncing;
+
+    if ( AudioEngine::bouncing )
+    {
+        AudioEngine::bounceRangeStart = rangeStart;
+        AudioEngine::bounceRangeEnd   = rangeEnd;
+        AudioEngine::bufferPosition   = rangeStart;
+        AudioEngine::stepPosition     = 0;
+    }
+    setStemRecordingState( aIsBouncing, aMaxBuffers, aOutputDirectory );
+
+    // triggering bounce state should instantly toggle the playback state of the engine
+
+    setPlaying( aIsBouncing );
+}
+
+void SequencerController::setRecordingFormat( int aFormat, bool aDither )
+{
+    DiskWriter::setOutputFormat( aFormat, aDither );
+}
+
+/**
+ * Recordings are committed to storage while recording, when the application is terminated
+ * during a recording (or bounce), the recorded audio can be recovered from the incomplete
+ * file on the next start.
+ *
+ * aDirectory {char*} the directory the recordings were written into
+ */
+int SequencerController::recoverRecordings( char* aDirectory )
+{
+    return ( int ) DiskWriter::recoverRecordings( std::string( aDirectory )).size();
+}
+
+/**
+ * Recordings are streamed directly onto storage and no longer
+ * require the saving of separate snippets. This method remains
+ * for API compatibility only and can be removed from your code
  */
 void SequencerController::saveRecordedSnippet( int snippetBufferIndex )
 {
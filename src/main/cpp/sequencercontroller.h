@@ -25,6 +25,7 @@
 
 #include "sequencer.h"
 #include <utilities/bulkcacher.h>
+#include <utilities/tempomap.h>
 
 /**
  * SequencerController acts as the interface to control the Sequencers
@@ -43,6 +44,16 @@ class SequencerController
         float getTempo  ();
         void setTempo   ( float aTempo, int aTimeSigBeatAmount, int aTimeSigBeatUnit );
         void setTempoNow( float aTempo, int aTimeSigBeatAmount, int aTimeSigBeatUnit );
+
+        // apply a TempoMap describing the tempo and time signature changes along the sequence (applied
+        // once the current render cycle completes), while applied, setTempo() has no effect. Pass
+        // nullptr to remove the map (the tempo and time signature at the current position remain).
+        // The caller retains ownership of the map. An altered map is applied anew by passing it again.
+        // A replaced map can be deleted once getTempoMap() no longer returns it (when using
+        // setTempoMap()) or once setTempoMapNow() returns (as it awaits the current render cycle)
+        void setTempoMap   ( TempoMap* aTempoMap );
+        void setTempoMapNow( TempoMap* aTempoMap );
+        TempoMap* getTempoMap();
         void setVolume  ( float aVolume );
         void setPlaying ( bool aPlaying );
 
@@ -68,6 +79,19 @@ class SequencerController
         void setRecordingState          ( bool aRecording,  int aMaxBuffers, char* aOutputFile );
         void setRecordingFromDeviceState( bool aRecording,  int aMaxBuffers, char* aOutputFile );
 
+        // record (or bounce) the output of each instruments AudioChannel into a separate file
+        // in a single pass, the combined output is recorded alongside as "master"
+        void setStemRecordingState( bool aRecording, int aMaxBuffers, char* aOutputDirectory );
+        void setStemBounceState   ( bool aIsBouncing, int aMaxBuffers, char* aOutputDirectory, int rangeStart, int rangeEnd );
+
+        // format (see WaveEncoder::Format) of all subsequent recordings and bounces
+        // dither is only applied to 16-bit recordings
+        void setRecordingFormat( int aFormat, bool aDither );
+
+        // recover the recordings in given directory that were interrupted by termination of the
+        // application (e.g. on the next start), returns the amount of recovered recordings
+        int recoverRecordings( char* aDirectory );
+
         void saveRecordedSnippet( int snippetBufferIndex );
 };
 } // E.O namespace MWEngine
@@ -0,0 +1,121 @@
+#include "../audiobus.h"
+#include "../audioengine.h"
+#include "../instruments/baseinstrument.h"
+#include "../utilities/volumeutil.h"
+
+// halves the volume of the buffer it processes
+
+class AudioBusTestProcessor : public BaseProcessor
+{
+    public:
+        void process( AudioBuffer* sampleBuffer, bool isMonoSource ) {
+            sampleBuffer->adjustBufferVolumes( 0.5 );
+        }
+};
+
+TEST( AudioBus, Construction )
+{
+    float volume  = ( float ) randomSample( 0, 1.0 );
+    AudioBus* bus = new AudioBus( volume );
+
+    EXPECT_FLOAT_EQ( volume, bus->getVolume() )
+        << "expected the non-logarithmic volume to equal the input volume";
+
+    EXPECT_EQ( VolumeUtil::toLog( volume ), bus->getVolumeLogarithmic() )
+        << "expected the logarithmically scaled value to equal the logarithmically scaled volume";
+
+    EXPECT_TRUE( bus->getOutputBus() == nullptr ) << "expected bus to output into the master bus by default";
+    EXPECT_TRUE( bus->getOutputBuffer() == nullptr ) << "expected no output buffer prior to registration";
+
+    AudioEngine::routing->addBus( bus );
+
+    ASSERT_FALSE( bus->getOutputBuffer() == nullptr )
+        << "expected output buffer to have been provided upon registration";
+
+    EXPECT_EQ( AudioEngineProps::OUTPUT_CHANNELS, bus->getOutputBuffer()->amountOfChannels );
+    EXPECT_EQ( AudioEngineProps::BUFFER_SIZE,     bus->getOutputBuffer()->bufferSize );
+
+    delete bus;
+}
+
+TEST( AudioBus, ProcessAndMix )
+{
+    AudioBus* bus = new AudioBus( 1.0 );
+    AudioEngine::routing->addBus( bus );
+
+    AudioBusTestProcessor* processor = new AudioBusTestProcessor();
+    bus->processingChain->addProcessor( processor );
+
+    AudioBuffer* busBuffer = bus->getOutputBuffer();
+    AudioBuffer* target    = new AudioBuffer( busBuffer->amountOfChannels, busBuffer->bufferSize );
+
+    fillAudioBuffer( busBuffer );
+    AudioBuffer* expected = busBuffer->clone();
+
+    bus->process( false );
+    bus->mixBuffer( target );
+
+    for ( int c = 0; c < target->amountOfChannels; ++c ) {
+        for ( int i = 0; i < target->bufferSize; ++i ) {
+            EXPECT_FLOAT_EQ( expected->getBufferForChannel( c )[ i ] * 0.5 * bus->getVolumeLogarithmic(),
+                             target->getBufferForChannel( c )[ i ] )
+                << "expected processed contents to have been mixed at the bus volume";
+        }
+    }
+
+    delete processor;
+    delete bus;
+    delete target;
+    delete expected;
+}
+
+TEST( AudioBus, Registration )
+{
+    AudioBus* bus = new AudioBus( 1.0 );
+    BaseInstrument* instrument = new BaseInstrument();
+
+    int amount = AudioEngine::routing->getAmountOfBuses();
+
+    AudioEngine::routing->addBus( bus );
+    AudioEngine::routing->addBus( bus );
+
+    EXPECT_EQ( amount + 1, AudioEngine::routing->getAmountOfBuses() ) << "expected bus to have been registered once";
+    EXPECT_TRUE( AudioEngine::routing->hasBus( bus ));
+
+    instrument->audioChannel->setSendLevel( bus, 0.5f );
+    instrument->audioChannel->setOutputBus( bus );
+
+    // deleting the bus unregisters it, removes the sends to it and reroutes the channels outputting into it
+
+    delete bus;
+
+    EXPECT_EQ( amount, AudioEngine::routing->getAmountOfBuses() ) << "expected bus to have been unregistered";
+    EXPECT_FALSE( instrument->audioChannel->hasSends() ) << "expected send to have been removed";
+    EXPECT_TRUE( instrument->audioChannel->getOutputBus() == nullptr ) << "expected channel to output into the master bus";
+
+    delete instrument;
+}
+
+TEST( AudioBus, SetOutputBus )
+{
+    AudioBus* bus1 = new AudioBus( 1.0 );
+    AudioBus* bus2 = new AudioBus( 1.0 );
+    AudioBus* bus3 = new AudioBus( 1.0 );
+
+    EXPECT_TRUE( bus1->setOutputBus( bus2 ));
+    EXPECT_TRUE( bus2->setOutputBus( bus3 ));
+
+    EXPECT_TRUE( bus2 == bus1->getOutputBus() ) << "expected output bus to have been set";
+
+    EXPECT_FALSE( bus1->setOutputBus( bus1 )) << "expected bus not to be able to output into itself";
+    EXPECT_FALSE( bus3->setOutputBus( bus1 )) << "expected routing that creates a cycle to be rejected";
+
+    EXPECT_TRUE( bus3->getOutputBus() == nullptr ) << "expected rejected routing to have left the output unchanged";
+
+    EXPECT_TRUE( bus1->setOutputBus( nullptr ));
+    EXPECT_TRUE( bus1->getOutputBus() == nullptr ) << "expected bus to output into the master bus";
+
+    delete bus1;
+    delete bus2;
+    delete bus3;
+}
@@ -1,4 +1,5 @@
 #include "../audiochannel.h"
+#include "../audioengine.h"
 #include "../global.h"
 #include "../utilities/volumeutil.h"
 
@@ -313,4 +314,159 @@ TEST( AudioChannel, MixPannedBuffer )
 
     delete audioChannel;
     delete mixBuffer;
-}
\ No newline at end of file
+}
+TEST( AudioChannel, Freeze )
+{
+    AudioChannel* audioChannel = new AudioChannel( 1 );
+
+    ASSERT_FALSE( audioChannel->isFrozen() );
+
+    // frozen buffer spanning the range 100 - 131 where each sample equals its position
+
+    int rangeStart = 100;
+    int rangeEnd   = 131;
+
+    AudioBuffer* frozenBuffer = new AudioBuffer( 2, rangeEnd - rangeStart + 1 );
+
+    for ( int c = 0; c < 2; ++c ) {
+        for ( int i = 0; i < frozenBuffer->bufferSize; ++i )
+            frozenBuffer->getBufferForChannel( c )[ i ] = rangeStart + i;
+    }
+    audioChannel->freeze( frozenBuffer, rangeStart, rangeEnd, 2 );
+
+    ASSERT_TRUE( audioChannel->isFrozen() );
+    EXPECT_EQ( 2, audioChannel->getFrozenProcessorAmount() );
+
+    // read across the end of the range (should continue from the range start)
+
+    AudioBuffer* output = new AudioBuffer( 2, 16 );
+    ASSERT_TRUE( audioChannel->readFrozenBuffer( output, 124 ));
+
+    for ( int i = 0; i < output->bufferSize; ++i )
+    {
+        int position = 124 + i;
+
+        if ( position > rangeEnd )
+            position -= ( rangeEnd - rangeStart + 1 );
+
+        EXPECT_EQ(( SAMPLE_TYPE ) position, output->getBufferForChannel( 1 )[ i ] )
+            << "expected frozen contents to loop within the frozen range";
+    }
+
+    audioChannel->unfreeze();
+
+    ASSERT_FALSE( audioChannel->isFrozen() );
+    ASSERT_FALSE( audioChannel->readFrozenBuffer( output, 124 )) << "expected no frozen contents after unfreezing";
+
+    // channels are not to be rendered while freezing
+
+    ASSERT_TRUE( audioChannel->beginRender() );
+    audioChannel->endRender();
+
+    audioChannel->setFreezing( true );
+    ASSERT_FALSE( audioChannel->beginRender() ) << "expected channel to not render while freezing";
+
+    audioChannel->setFreezing( false );
+    ASSERT_TRUE( audioChannel->beginRender() );
+    audioChannel->endRender();
+
+    delete output;
+    delete audioChannel;
+}
+
+TEST( AudioChannel, Sends )
+{
+    AudioChannel* audioChannel = new AudioChannel( 1.0 );
+    audioChannel->createOutputBuffer();
+
+    AudioBus* bus1 = new AudioBus( 1.0 );
+    AudioBus* bus2 = new AudioBus( 1.0 );
+
+    AudioEngine::routing->addBus( bus1 );
+    AudioEngine::routing->addBus( bus2 );
+
+    EXPECT_FALSE( audioChannel->hasSends() ) << "expected no sends upon construction";
+    EXPECT_EQ( 0.f, audioChannel->getSendLevel( bus1 )) << "expected no send level for unknown bus";
+
+    audioChannel->setSendLevel( bus1, 0.5f );
+    audioChannel->setSendLevel( bus2, 0.25f );
+    audioChannel->setSendLevel( bus2, 0.75f );
+
+    EXPECT_TRUE( audioChannel->hasSends() );
+    EXPECT_EQ( 0.5f,  audioChannel->getSendLevel( bus1 )) << "expected set send level";
+    EXPECT_EQ( 0.75f, audioChannel->getSendLevel( bus2 )) << "expected updated send level";
+
+    // mix the output into the buses
+
+    AudioBuffer* outputBuffer = audioChannel->getOutputBuffer();
+    fillAudioBuffer( outputBuffer );
+
+    bus1->getOutputBuffer()->silenceBuffers();
+    bus2->getOutputBuffer()->silenceBuffers();
+
+    float mixVolume = 0.8f;
+    audioChannel->mixSends( mixVolume );
+
+    for ( int c = 0; c < outputBuffer->amountOfChannels; ++c )
+    {
+        for ( int i = 0; i < outputBuffer->bufferSize; ++i )
+        {
+            SAMPLE_TYPE sample = outputBuffer->getBufferForChannel( c )[ i ];
+
+            EXPECT_FLOAT_EQ( sample * mixVolume * 0.5f,  bus1->getOutputBuffer()->getBufferForChannel( c )[ i ] )
+                << "expected output to have been mixed into the bus at the send level";
+
+            EXPECT_FLOAT_EQ( sample * mixVolume * 0.75f, bus2->getOutputBuffer()->getBufferForChannel( c )[ i ] )
+                << "expected output to have been mixed into the bus at the send level";
+        }
+    }
+
+    // a send level of 0 removes the send
+
+    audioChannel->setSendLevel( bus1, 0.f );
+    audioChannel->setSendLevel( bus2, 0.f );
+
+    EXPECT_FALSE( audioChannel->hasSends() ) << "expected sends to have been removed";
+
+    // the amount of sends is limited
+
+    std::vector<AudioBus*> buses;
+
+    for ( int i = 0; i < AudioChannel::MAX_SENDS; ++i ) {
+        buses.push_back( new AudioBus( 1.0 ));
+        EXPECT_TRUE( audioChannel->setSendLevel( buses.back(), 0.5f )) << "expected send to have been added";
+    }
+    EXPECT_FALSE( audioChannel->setSendLevel( bus1, 0.5f )) << "expected no send to be added when all slots are in use";
+    EXPECT_EQ( 0.f, audioChannel->getSendLevel( bus1 ));
+
+    audioChannel->setSendLevel( buses.at( 0 ), 0.f );
+
+    EXPECT_TRUE( audioChannel->setSendLevel( bus1, 0.5f )) << "expected send to occupy the freed slot";
+
+    delete audioChannel;
+
+    for ( size_t i = 0; i < buses.size(); ++i )
+        delete buses.at( i );
+
+    delete bus1;
+    delete bus2;
+}
+
+TEST( AudioChannel, OutputBus )
+{
+    AudioChannel* audioChannel = new AudioChannel( 1.0 );
+    AudioBus* bus = new AudioBus( 1.0 );
+
+    EXPECT_TRUE( audioChannel->getOutputBus() == nullptr ) << "expected channel to output into the master bus by default";
+
+    audioChannel->setOutputBus( bus );
+
+    EXPECT_TRUE( bus == audioChannel->getOutputBus() ) << "expected output bus to have been set";
+
+    audioChannel->setOutputBus( nullptr );
+
+    EXPECT_TRUE( audioChannel->getOutputBus() == nullptr ) << "expected channel to output into the master bus";
+
+    delete audioChannel;
+    delete bus;
+}
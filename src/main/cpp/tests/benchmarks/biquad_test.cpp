@@ -0,0 +1,81 @@
+#include "../../utilities/biquadcascade.h"
+#include <iostream>
+
+TEST( BiquadBenchmark, ChannelLanes )
+{
+    int bufferSize = 512;
+    int iterations = 5000;
+    int sections[] = { 1, 5 };
+
+    SAMPLE_TYPE b0 = 0.02, b1 = 0.04, b2 = 0.02, a1 = -1.56, a2 = 0.64;
+
+    for ( int amountOfSections : sections )
+    {
+        AudioBuffer* buffer = fillAudioBuffer( new AudioBuffer( 2, bufferSize ));
+
+        // test 1. channel by channel, direct form with separate state arrays (as the filters did before)
+
+        SAMPLE_TYPE* in1  = new SAMPLE_TYPE[ 2 * amountOfSections ]();
+        SAMPLE_TYPE* in2  = new SAMPLE_TYPE[ 2 * amountOfSections ]();
+        SAMPLE_TYPE* out1 = new SAMPLE_TYPE[ 2 * amountOfSections ]();
+        SAMPLE_TYPE* out2 = new SAMPLE_TYPE[ 2 * amountOfSections ]();
+
+        long long start = getTime();
+
+        for ( int i = 0; i < iterations; ++i )
+        {
+            for ( int c = 0; c < 2; ++c )
+            {
+                SAMPLE_TYPE* channelBuffer = buffer->getBufferForChannel( c );
+
+                for ( int s = 0; s < amountOfSections; ++s )
+                {
+                    int k = c * amountOfSections + s;
+
+                    for ( int j = 0; j < bufferSize; ++j )
+                    {
+                        SAMPLE_TYPE input  = channelBuffer[ j ];
+                        SAMPLE_TYPE output = b0 * input + b1 * in1[ k ] + b2 * in2[ k ] - a1 * out1[ k ] - a2 * out2[ k ];
+
+                        in2 [ k ] = in1[ k ];
+                        in1 [ k ] = input;
+                        out2[ k ] = out1[ k ];
+                        out1[ k ] = output;
+
+                        channelBuffer[ j ] = output;
+                    }
+                }
+            }
+        }
+        long long totalTest1 = std::max( 1LL, getTime() - start );
+
+        // test 2. BiquadCascade, channels processed as lanes
+
+        BiquadCascade* cascade = new BiquadCascade( 2, amountOfSections );
+
+        for ( int s = 0; s < amountOfSections; ++s )
+            cascade->setCoefficients( s, b0, b1, b2, a1, a2 );
+
+        fillAudioBuffer( buffer );
+
+        start = getTime();
+
+        for ( int i = 0; i < iterations; ++i )
+            cascade->process( buffer, false );
+
+        long long totalTest2 = std::max( 1LL, getTime() - start );
+
+        std::cout << amountOfSections << " section(s), " << iterations << " stereo buffers of " << bufferSize << " samples: per channel "
+                  << ( totalTest1 / 1000000 ) << " ms, cascade " << ( totalTest2 / 1000000 ) << " ms\n";
+
+        EXPECT_TRUE( totalTest2 < totalTest1 )
+            << "expected the lane based cascade to outperform channel by channel processing";
+
+        delete cascade;
+        delete buffer;
+        delete[] in1;
+        delete[] in2;
+        delete[] out1;
+        delete[] out2;
+    }
+}
@@ -0,0 +1,78 @@
+#include "../../processors/convolutionreverb.h"
+#include "../../utilities/partitionedconvolver.h"
+#include <iostream>
+
+// convolves ten seconds of stereo noise with impulse responses of 0.5 to 5 seconds, comparing
+// uniformly partitioned convolution (all partitions of the buffer size on the audio thread)
+// against the ConvolutionReverb (tail partitions convolved on a background thread). The time
+// spent in the audio thread (including waiting for the tail thread) is measured
+
+TEST( ConvolutionReverbBenchmark, ImpulseResponseLengths )
+{
+    int bufferSize = 256;
+    int iterations = AudioEngineProps::SAMPLE_RATE * 10 / bufferSize;
+    float lengths[ 4 ] = { 0.5f, 1.f, 2.f, 5.f };
+
+    AudioBuffer* buffer = new AudioBuffer( 2, bufferSize );
+
+    for ( int l = 0; l < 4; ++l )
+    {
+        int responseLength = ( int ) ( AudioEngineProps::SAMPLE_RATE * lengths[ l ]);
+        AudioBuffer* impulseResponse = new AudioBuffer( 2, responseLength );
+
+        for ( int c = 0; c < 2; ++c ) {
+            for ( int i = 0; i < responseLength; ++i )
+                impulseResponse->getBufferForChannel( c )[ i ] = randomSample( -1.0, 1.0 ) * exp( -6.0 * i / responseLength );
+        }
+
+        // test 1. uniformly partitioned convolution
+
+        PartitionedConvolver* convolvers[ 2 ];
+        for ( int c = 0; c < 2; ++c )
+            convolvers[ c ] = new PartitionedConvolver( bufferSize, impulseResponse->getBufferForChannel( c ), responseLength );
+
+        long long total1 = 0;
+
+        for ( int i = 0; i < iterations; ++i )
+        {
+            fillAudioBuffer( buffer );
+
+            long long start = getTime();
+            for ( int c = 0; c < 2; ++c )
+                convolvers[ c ]->process( buffer->getBufferForChannel( c ), buffer->getBufferForChannel( c ));
+            total1 += getTime() - start;
+        }
+
+        // test 2. non-uniformly partitioned ConvolutionReverb
+
+        ConvolutionReverb* reverb = new ConvolutionReverb( bufferSize, 0.f, 1.f, 2 );
+        reverb->setImpulseResponse( impulseResponse, AudioEngineProps::SAMPLE_RATE );
+
+        long long total2 = 0;
+
+        for ( int i = 0; i < iterations; ++i )
+        {
+            fillAudioBuffer( buffer );
+
+            long long start = getTime();
+            reverb->process( buffer, false );
+            total2 += getTime() - start;
+        }
+
+        std::cout << "ConvolutionReverb, " << lengths[ l ] << " s impulse response, 10 s of stereo audio: uniform partitions "
+                  << ( total1 / 1000000 ) << " ms, audio thread with tail partitions " << ( total2 / 1000000 ) << " ms\n";
+
+        // the uniformly partitioned convolution already is cheap for short impulse responses
+
+        if ( lengths[ l ] >= 1.f ) {
+            EXPECT_TRUE( total2 < total1 )
+                << "expected the ConvolutionReverb to outperform uniform partitions on the audio thread";
+        }
+
+        delete reverb;
+        delete convolvers[ 0 ];
+        delete convolvers[ 1 ];
+        delete impulseResponse;
+    }
+    delete buffer;
+}
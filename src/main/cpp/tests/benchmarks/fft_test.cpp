@@ -0,0 +1,128 @@
+#include "../../utilities/fft.h"
+#include <iostream>
+
+// the inline complex FFT previously used by the PitchShifter (by S.M. Bernsee, 1996)
+
+void smbFftBenchmark( float *fftBuffer, long fftFrameSize, long sign )
+{
+    float wr, wi, arg, *p1, *p2, temp;
+    float tr, ti, ur, ui, *p1r, *p1i, *p2r, *p2i;
+    long doubleFftFrameSize = 2 * fftFrameSize, i, end, bitm, j, le, le2, k;
+
+    for ( i = 2, end = doubleFftFrameSize - 2; i < end; i += 2 ) {
+        for ( bitm = 2, j = 0; bitm < doubleFftFrameSize; bitm <<= 1 ) {
+            if ( i & bitm ) ++j;
+            j <<= 1;
+        }
+        if ( i < j ) {
+            p1 = fftBuffer+i;
+            p2 = fftBuffer+j;
+            temp = *p1; *(p1++) = *p2;
+            *(p2++) = temp; temp = *p1;
+            *p1 = *p2; *p2 = temp;
+        }
+    }
+
+    for ( k = 0, le = 2, end = ( long )( log( fftFrameSize ) / log( 2. ) + .5 ); k < end; ++k )
+    {
+        le <<= 1;
+        le2  = le >> 1;
+        ur  = 1.0;
+        ui  = 0.0;
+        arg = M_PI / ( le2 >>1 );
+        wr  = cos( arg );
+        wi  = sign * sin( arg );
+        for ( j = 0; j < le2; j += 2 ) {
+            p1r = fftBuffer + j;
+            p1i = p1r + 1;
+            p2r = p1r + le2;
+            p2i = p2r + 1;
+
+            for ( i = j; i < doubleFftFrameSize; i += le ) {
+                tr = *p2r * ur - *p2i * ui;
+                ti = *p2r * ui + *p2i * ur;
+                *p2r = *p1r - tr; *p2i = *p1i - ti;
+                *p1r += tr; *p1i += ti;
+                p1r += le; p1i += le;
+                p2r += le; p2i += le;
+            }
+            tr = ur*wr - ui*wi;
+            ui = ur*wi + ui*wr;
+            ur = tr;
+        }
+    }
+}
+
+// measures the amount of analysis/synthesis frames (windowing, forward and
+// inverse transform, as performed by the PitchShifter) processed per second
+
+TEST( FFTBenchmark, InlineFFTVersusFFT )
+{
+    int sizes[] = { 1024, 2048, 4096 };
+    int iterations = 2000;
+
+    for ( int size : sizes )
+    {
+        float* input  = new float[ size ];
+        float* buffer = new float[ size * 2 ];
+
+        for ( int i = 0; i < size; ++i )
+            input[ i ] = randomFloat( -1.f, 1.f );
+
+        // test 1. inline complex FFT with per-sample window calculation
+
+        long long start = getTime();
+
+        for ( int i = 0; i < iterations; ++i )
+        {
+            for ( int k = 0, n = 0; k < size; ++k, n += 2 ) {
+                float window      = -.5 * cos( 2.0 * M_PI * ( double ) k / ( double ) size ) + .5;
+                buffer[ n ]     = input[ k ] * window;
+                buffer[ n + 1 ] = 0.f;
+            }
+            smbFftBenchmark( buffer, size, -1 );
+
+            for ( int k = size + 2, n = size << 1; k < n; ++k )
+                buffer[ k ] = 0.f;
+
+            smbFftBenchmark( buffer, size, 1 );
+
+            for ( int k = 0, n = 0; k < size; ++k, n += 2 ) {
+                float window = -.5 * cos( 2.0 * M_PI * ( double ) k / ( double ) size ) + .5;
+                input[ k ]  += window * buffer[ n ] * 1e-9f;
+            }
+        }
+        long long totalTest1 = std::max( 1LL, getTime() - start );
+
+        // test 2. real FFT with cached tables and window
+
+        FFT* fft      = new FFT( size );
+        float* window = fft->getWindow();
+
+        start = getTime();
+
+        for ( int i = 0; i < iterations; ++i )
+        {
+            for ( int k = 0; k < size; ++k )
+                buffer[ k ] = input[ k ] * window[ k ];
+
+            fft->forward( buffer );
+            fft->inverse( buffer );
+
+            for ( int k = 0; k < size; ++k )
+                input[ k ] += window[ k ] * buffer[ k ] * 1e-9f;
+        }
+        long long totalTest2 = std::max( 1LL, getTime() - start );
+
+        std::cout << "FFT size " << size << ": inline "
+                  << ( iterations * 1000000000LL / totalTest1 ) << " frames/s, FFT "
+                  << ( iterations * 1000000000LL / totalTest2 ) << " frames/s\n";
+
+        EXPECT_TRUE( totalTest2 < totalTest1 )
+            << "expected cached real FFT to outperform the inline complex FFT at size " << size;
+
+        delete fft;
+        delete[] input;
+        delete[] buffer;
+    }
+}
@@ -0,0 +1,99 @@
+#include "../../processors/filter.h"
+#include "../../modules/lfo.h"
+#include <iostream>
+
+// the Filter prior to control rate modulation: each channel is processed
+// separately (rewinding the LFO) and the coefficients are calculated per sample
+
+void legacyFilterProcess( AudioBuffer* sampleBuffer, LFO* lfo, float resonance,
+                          SAMPLE_TYPE* in1, SAMPLE_TYPE* in2, SAMPLE_TYPE* out1, SAMPLE_TYPE* out2 )
+{
+    SAMPLE_TYPE a1, a2, a3, b1, b2, c;
+    SAMPLE_TYPE initialLFOOffset = lfo->getTable()->getAccumulator();
+    float sampleRate = ( float ) AudioEngineProps::SAMPLE_RATE;
+    float orgCutoff  = lfo->sweep();
+    float cutoff     = orgCutoff;
+
+    for ( int i = 0; i < sampleBuffer->amountOfChannels; ++i )
+    {
+        SAMPLE_TYPE* channelBuffer = sampleBuffer->getBufferForChannel( i );
+
+        if ( i > 0 ) {
+            lfo->getTable()->setAccumulator( initialLFOOffset );
+            cutoff = orgCutoff;
+        }
+
+        for ( int j = 0; j < sampleBuffer->bufferSize; ++j )
+        {
+            c  = 1.f / tan( PI * cutoff / sampleRate );
+            a1 = 1.f / ( 1.f + resonance * c + c * c );
+            a2 = 2.f * a1;
+            a3 = a1;
+            b1 = 2.f * ( 1.f - c * c ) * a1;
+            b2 = ( 1.f - resonance * c + c * c ) * a1;
+
+            SAMPLE_TYPE input  = channelBuffer[ j ];
+            SAMPLE_TYPE output = a1 * input + a2 * in1[ i ] + a3 * in2[ i ] - b1 * out1[ i ] - b2 * out2[ i ];
+
+            in2 [ i ] = in1[ i ];
+            in1 [ i ] = input;
+            out2[ i ] = out1[ i ];
+            out1[ i ] = output;
+
+            cutoff = lfo->sweep();
+            channelBuffer[ j ] = output;
+        }
+    }
+}
+
+TEST( FilterBenchmark, LFOModulation )
+{
+    int bufferSize = 512;
+    int iterations = 2000;
+    float resonance = ( float ) sqrt( 1 ) / 2;
+
+    AudioBuffer* buffer = new AudioBuffer( 2, bufferSize );
+    fillAudioBuffer( buffer );
+
+    // test 1. per-sample coefficient calculation, channel by channel
+
+    LFO* lfo = new LFO();
+    lfo->setRate( LFO::MAX_RATE() );
+    lfo->cacheProperties( 2000.f, 40.f, 8000.f );
+
+    SAMPLE_TYPE state[ 8 ] = { 0.0 };
+
+    long long start = getTime();
+
+    for ( int i = 0; i < iterations; ++i )
+        legacyFilterProcess( buffer, lfo, resonance, &state[ 0 ], &state[ 2 ], &state[ 4 ], &state[ 6 ] );
+
+    long long totalTest1 = std::max( 1LL, getTime() - start );
+
+    // test 2. Filter with control rate coefficients, channels processed in a single pass
+
+    Filter* filter = new Filter( 2000.f, resonance, 40.f, 8000.f, 2 );
+    LFO* lfo2      = new LFO();
+    lfo2->setRate( LFO::MAX_RATE() );
+    filter->setLFO( lfo2 );
+
+    fillAudioBuffer( buffer );
+
+    start = getTime();
+
+    for ( int i = 0; i < iterations; ++i )
+        filter->process( buffer, false );
+
+    long long totalTest2 = std::max( 1LL, getTime() - start );
+
+    std::cout << "Filter with LFO, " << iterations << " stereo buffers of " << bufferSize << " samples: per sample "
+              << ( totalTest1 / 1000000 ) << " ms, control rate " << ( totalTest2 / 1000000 ) << " ms\n";
+
+    EXPECT_TRUE( totalTest2 < totalTest1 )
+        << "expected control rate coefficients to outperform per sample coefficient calculation";
+
+    delete filter;
+    delete lfo;
+    delete lfo2;
+    delete buffer;
+}
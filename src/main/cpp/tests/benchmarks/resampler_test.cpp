@@ -0,0 +1,80 @@
+#include "../../utilities/resampler.h"
+
+TEST( ResamplerBenchmark, InlineInterpolationVersusResampler )
+{
+    int iterations = 1000;
+
+    long long test1start;
+    long long test1end;
+    long long totalTest1;
+    long long totalTest2;
+    long long totalTest3;
+    long long totalTest4;
+
+    int sourceLength    = 88200;
+    int bufferSize      = randomInt( 512, 8192 );
+    float playbackRate  = randomFloat( 0.5f, 1.5f );
+    SAMPLE_TYPE* source = new SAMPLE_TYPE[ sourceLength ];
+    SAMPLE_TYPE* target = new SAMPLE_TYPE[ bufferSize ];
+
+    for ( int i = 0; i < sourceLength; ++i )
+        source[ i ] = randomSample( -1.0, 1.0 );
+
+    int i, j, t;
+    float fi, frac;
+    SAMPLE_TYPE s1, s2;
+
+    // test 1. per-sample linear interpolation as previously inlined in SampleEvent::mixBuffer
+
+    test1start = getTime();
+
+    for ( i = 0; i < iterations; ++i )
+    {
+        fi = 0.f;
+
+        for ( j = 0; j < bufferSize; ++j, fi += playbackRate )
+        {
+            t    = ( int ) fi;
+            frac = fi - t;
+
+            if ( t + 1 > sourceLength - 1 )
+                break;
+
+            s1 = source[ t ];
+            s2 = source[ t + 1 ];
+
+            target[ j ] += (( s1 + ( s2 - s1 ) * frac ) * 0.5 );
+        }
+    }
+
+    test1end   = getTime();
+    totalTest1 = test1end - test1start;
+
+    // test 2. to 4. block-wise resampling at each quality
+
+    Resampler::prepare( Resampler::SINC );
+
+    long long* totals[ 3 ] = { &totalTest2, &totalTest3, &totalTest4 };
+
+    for ( int quality = Resampler::LINEAR; quality <= Resampler::SINC; ++quality )
+    {
+        test1start = getTime();
+
+        for ( i = 0; i < iterations; ++i )
+            Resampler::mix( quality, source, sourceLength, target, bufferSize, 0.0, playbackRate, 0.5 );
+
+        test1end = getTime();
+        *totals[ quality ] = test1end - test1start;
+    }
+
+    ASSERT_TRUE( totalTest2 <= totalTest1 * 2 )
+        << "expected block-wise linear resampling to perform on par with inline interpolation";
+
+//    std::cout << "inline linear " << totalTest1 << " ms for " << iterations << " iterations\n";
+//    std::cout << "linear  " << totalTest2 << " ms for " << iterations << " iterations\n";
+//    std::cout << "hermite " << totalTest3 << " ms for " << iterations << " iterations\n";
+//    std::cout << "sinc    " << totalTest4 << " ms for " << iterations << " iterations\n";
+
+    delete[] source;
+    delete[] target;
+}
@@ -0,0 +1,196 @@
+#include "../../processors/reverbsm.h"
+#include <iostream>
+
+// the ReverbSM comb and allpass filters prior to block processing over shared delay memory,
+// with a separate buffer, wrap branch and denormal check per filter
+
+class LegacyComb
+{
+    public:
+        void setBuffer( SAMPLE_TYPE* buf, int size ) {
+            _buffer = buf; _bufSize = size; _bufIndex = 0; _filterStore = 0;
+            for ( int i = 0; i < size; ++i ) _buffer[ i ] = 0;
+        }
+        inline SAMPLE_TYPE process( SAMPLE_TYPE input )
+        {
+            SAMPLE_TYPE output = _buffer[ _bufIndex ];
+            undenormalise( output );
+
+            _filterStore = ( output * _damp2 ) + ( _filterStore * _damp1 );
+            undenormalise( _filterStore );
+
+            _buffer[_bufIndex] = input + ( _filterStore * _feedback );
+            if ( ++_bufIndex >= _bufSize ) {
+                _bufIndex = 0;
+            }
+            return output;
+        }
+        SAMPLE_TYPE _feedback, _filterStore, _damp1, _damp2;
+        SAMPLE_TYPE* _buffer;
+        int _bufSize, _bufIndex;
+};
+
+class LegacyAllPass
+{
+    public:
+        void setBuffer( SAMPLE_TYPE* buf, int size ) {
+            _buffer = buf; _bufSize = size; _bufIndex = 0; _feedback = 0.5f;
+            for ( int i = 0; i < size; ++i ) _buffer[ i ] = 0;
+        }
+        inline SAMPLE_TYPE process( SAMPLE_TYPE input )
+        {
+            SAMPLE_TYPE output;
+            SAMPLE_TYPE bufout = _buffer[ _bufIndex ];
+            undenormalise( bufout );
+
+            output = -input + bufout;
+            _buffer[ _bufIndex ] = input + ( bufout * _feedback );
+
+            if ( ++_bufIndex >= _bufSize ) {
+                _bufIndex = 0;
+            }
+            return output;
+        }
+        SAMPLE_TYPE _feedback;
+        SAMPLE_TYPE* _buffer;
+        int _bufSize, _bufIndex;
+};
+
+class LegacyReverbSM
+{
+    public:
+        LegacyReverbSM()
+        {
+            int combTunings[]    = { 1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617 };
+            int allPassTunings[] = { 556, 441, 341, 225 };
+
+            // default ReverbSM parameters
+
+            float wet  = ( 1.f / 3 ) * 3;
+            float room = ( 0.5f * 0.28f ) + 0.7f;
+            float damp = 0.5f * 0.4f;
+
+            _gain = 0.015f;
+            _wet1 = wet * ( 1.f / 2 + 0.5f );
+            _wet2 = wet * (( 1 - 1.f ) / 2 );
+            _dry  = 0.5f * 2;
+
+            for ( int i = 0; i < 8; ++i ) {
+                combL[ i ].setBuffer( new SAMPLE_TYPE[ combTunings[ i ]], combTunings[ i ] );
+                combR[ i ].setBuffer( new SAMPLE_TYPE[ combTunings[ i ] + 23 ], combTunings[ i ] + 23 );
+                combL[ i ]._feedback = combR[ i ]._feedback = room;
+                combL[ i ]._damp1    = combR[ i ]._damp1    = damp;
+                combL[ i ]._damp2    = combR[ i ]._damp2    = 1 - damp;
+            }
+            for ( int i = 0; i < 4; ++i ) {
+                allPassL[ i ].setBuffer( new SAMPLE_TYPE[ allPassTunings[ i ]], allPassTunings[ i ] );
+                allPassR[ i ].setBuffer( new SAMPLE_TYPE[ allPassTunings[ i ] + 23 ], allPassTunings[ i ] + 23 );
+            }
+        }
+
+        ~LegacyReverbSM()
+        {
+            for ( int i = 0; i < 8; ++i ) {
+                delete[] combL[ i ]._buffer;
+                delete[] combR[ i ]._buffer;
+            }
+            for ( int i = 0; i < 4; ++i ) {
+                delete[] allPassL[ i ]._buffer;
+                delete[] allPassR[ i ]._buffer;
+            }
+        }
+
+        void process( AudioBuffer* audioBuffer )
+        {
+            SAMPLE_TYPE* left  = audioBuffer->getBufferForChannel( 0 );
+            SAMPLE_TYPE* right = audioBuffer->getBufferForChannel( 1 );
+
+            for ( int j = 0; j < audioBuffer->bufferSize; ++j )
+            {
+                SAMPLE_TYPE outL = 0, outR = 0;
+                SAMPLE_TYPE input = ( left[ j ] + right[ j ] ) * _gain;
+
+                for ( int i = 0; i < 8; i++ ) {
+                    outL += combL[ i ].process( input );
+                    outR += combR[ i ].process( input );
+                }
+                for ( int i = 0; i < 4; i++ ) {
+                    outL = allPassL[ i ].process( outL );
+                    outR = allPassR[ i ].process( outR );
+                }
+                SAMPLE_TYPE inL = left[ j ];
+                left[ j ]  = outL * _wet1 + outR * _wet2 + inL * _dry;
+                right[ j ] = outR * _wet1 + outL * _wet2 + right[ j ] * _dry;
+            }
+        }
+
+        LegacyComb combL[ 8 ], combR[ 8 ];
+        LegacyAllPass allPassL[ 4 ], allPassR[ 4 ];
+        float _gain, _wet1, _wet2, _dry;
+};
+
+TEST( ReverbSMBenchmark, BlockProcessing )
+{
+    int bufferSize = 512;
+    int iterations = 2000;
+
+    AudioBuffer* input  = new AudioBuffer( 2, bufferSize );
+    AudioBuffer* buffer = new AudioBuffer( 2, bufferSize );
+
+    // a short burst of noise followed by silence (during which the tail decays towards denormals)
+
+    LegacyReverbSM* legacy = new LegacyReverbSM();
+    ReverbSM* reverb       = new ReverbSM();
+
+    long long totalTest1 = 0, totalTest2 = 0;
+    double maxDifference = 0.0;
+
+    for ( int i = 0; i < iterations; ++i )
+    {
+        if ( i < 4 )
+            fillAudioBuffer( input );
+        else
+            input->silenceBuffers();
+
+        // test 1. separate comb and allpass filters
+
+        buffer->silenceBuffers();
+        buffer->mergeBuffers( input, 0, 0, 1.0 );
+
+        long long start = getTime();
+        legacy->process( buffer );
+        totalTest1 += getTime() - start;
+
+        AudioBuffer* expected = buffer->clone();
+
+        // test 2. block processed filters over shared delay memory
+
+        buffer->silenceBuffers();
+        buffer->mergeBuffers( input, 0, 0, 1.0 );
+
+        start = getTime();
+        reverb->process( buffer, false );
+        totalTest2 += getTime() - start;
+
+        for ( int c = 0; c < 2; ++c ) {
+            for ( int j = 0; j < bufferSize; ++j )
+                maxDifference = std::max( maxDifference, std::abs( expected->getBufferForChannel( c )[ j ] - buffer->getBufferForChannel( c )[ j ] ));
+        }
+        delete expected;
+    }
+
+    std::cout << "ReverbSM, " << iterations << " stereo buffers of " << bufferSize << " samples: separate filters "
+              << ( totalTest1 / 1000000 ) << " ms, block processed " << ( totalTest2 / 1000000 ) << " ms (max. difference "
+              << maxDifference << ")\n";
+
+    EXPECT_LT( maxDifference, 1e-6 )
+        << "expected the block processed filters to produce the same output as the separate filters";
+
+    EXPECT_TRUE( totalTest2 < totalTest1 )
+        << "expected the block processed filters to outperform the separate filters";
+
+    delete legacy;
+    delete reverb;
+    delete input;
+    delete buffer;
+}
@@ -2,6 +2,7 @@
 #include "../../utilities/bufferutility.h"
 #include "../../instruments/baseinstrument.h"
 #include "../../audioengine.h"
+#include <thread>
 
 TEST( BaseAudioEvent, GettersSettersVolume )
 {
@@ -433,6 +434,136 @@ TEST( BaseAudioEvent, PositionEvent )
     delete audioEvent;
 }
 
+TEST( BaseAudioEvent, TempoChange )
+{
+    float orgTempo = AudioEngine::tempo;
+    AudioEngine::tempo = 120.f;
+
+    BaseAudioEvent* audioEvent = new BaseAudioEvent();
+
+    audioEvent->setEventStart ( 44100 );
+    audioEvent->setEventLength( 22050 );
+
+    // event should sync its range upon request, without explicit update
+
+    AudioEngine::tempo = 60.f;
+
+    EXPECT_EQ( 88200, audioEvent->getEventStart() )
+        << "expected event start to have been synced to the new tempo";
+
+    EXPECT_EQ( 44100, audioEvent->getEventLength() )
+        << "expected event length to have been synced to the new tempo";
+
+    EXPECT_EQ( 88200 + 44099, audioEvent->getEventEnd() )
+        << "expected event end to have been synced to the new tempo";
+
+    // the range set at the current tempo should be retained when changing the tempo back and forth
+
+    audioEvent->setEventStart( 66150 );
+
+    for ( int i = 0; i < 100; ++i ) {
+        AudioEngine::tempo = ( float ) randomInt( 40, 300 );
+        audioEvent->getEventStart();
+    }
+
+    AudioEngine::tempo = 60.f;
+
+    EXPECT_EQ( 66150, audioEvent->getEventStart() )
+        << "expected event start not to have drifted after repeated tempo changes";
+
+    EXPECT_EQ( 44100, audioEvent->getEventLength() )
+        << "expected event length not to have drifted after repeated tempo changes";
+
+    AudioEngine::tempo = orgTempo;
+
+    delete audioEvent;
+}
+
+TEST( BaseAudioEvent, TempoChangeConcurrentQueries )
+{
+    float orgTempo = AudioEngine::tempo;
+    AudioEngine::tempo = 120.f;
+
+    BaseAudioEvent* audioEvent = new BaseAudioEvent();
+
+    audioEvent->setEventStart ( 44100 );
+    audioEvent->setEventLength( 22050 );
+
+    // query the event from multiple threads after a tempo change, only one of these should sync
+
+    AudioEngine::tempo = 60.f;
+
+    auto query = [ audioEvent ]() {
+        for ( int i = 0; i < 1000; ++i ) {
+            audioEvent->getEventStart();
+            audioEvent->getEventLength();
+        }
+    };
+    std::thread first( query );
+    std::thread second( query );
+    first.join();
+    second.join();
+
+    EXPECT_EQ( 88200, audioEvent->getEventStart() )
+        << "expected event start to have been synced to the new tempo exactly once";
+
+    EXPECT_EQ( 44100, audioEvent->getEventLength() )
+        << "expected event length to have been synced to the new tempo exactly once";
+
+    AudioEngine::tempo = orgTempo;
+
+    delete audioEvent;
+}
+
+TEST( BaseAudioEvent, OverlapsTicks )
+{
+    float orgTempo = AudioEngine::tempo;
+    AudioEngine::tempo = 120.f;
+
+    BaseAudioEvent* audioEvent = new BaseAudioEvent();
+
+    audioEvent->setEventStart ( 44100 );
+    audioEvent->setEventLength( 22050 );
+    audioEvent->getEventStart(); // sync musical timing at the current tempo
+
+    EXPECT_TRUE( audioEvent->isTimingSynced() )
+        << "expected event timing to be in sync with the current tempo";
+
+    // after a tempo change the event should be found by its (tempo independent) musical timing
+
+    AudioEngine::tempo = 60.f;
+
+    EXPECT_FALSE( audioEvent->isTimingSynced() )
+        << "expected event timing not to be in sync after a tempo change";
+
+    double startTicks = ( double ) TICKS_PER_BEAT * 2; // 44100 samples at 120 BPM
+    double endTicks   = ( double ) TICKS_PER_BEAT * 3; // 66150 samples at 120 BPM
+
+    EXPECT_FALSE( audioEvent->overlapsTicks( 0, startTicks ))
+        << "expected event not to overlap a range ending at its start";
+
+    EXPECT_TRUE( audioEvent->overlapsTicks( startTicks, startTicks + 1 ))
+        << "expected event to overlap a range at its start";
+
+    EXPECT_TRUE( audioEvent->overlapsTicks( endTicks - 1, endTicks + 100 ))
+        << "expected event to overlap a range at its end";
+
+    EXPECT_FALSE( audioEvent->overlapsTicks( endTicks, endTicks + 100 ))
+        << "expected event not to overlap a range starting after its end";
+
+    EXPECT_FALSE( audioEvent->isTimingSynced() )
+        << "expected range queries not to sync the event timing";
+
+    audioEvent->getEventStart();
+
+    EXPECT_TRUE( audioEvent->isTimingSynced() )
+        << "expected event timing to be in sync after querying its range";
+
+    AudioEngine::tempo = orgTempo;
+
+    delete audioEvent;
+}
+
 TEST( BaseAudioEvent, Buffers )
 {
     BaseAudioEvent* audioEvent = new BaseAudioEvent();
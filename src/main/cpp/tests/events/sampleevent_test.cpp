@@ -1,5 +1,6 @@
 #include "../../events/sampleevent.h"
 #include "../../instruments/sampledinstrument.h"
+#include "../../utilities/resampler.h"
 
 TEST( SampleEvent, Constructor )
 {
@@ -341,6 +342,21 @@ TEST( SampleEvent, PlaybackRateSetter )
     delete sampleEvent;
 }
 
+TEST( SampleEvent, ResamplingQuality )
+{
+    SampleEvent* sampleEvent = new SampleEvent();
+
+    EXPECT_EQ( Resampler::LINEAR, sampleEvent->getResamplingQuality() )
+        << "expected linear interpolation by default";
+
+    sampleEvent->setResamplingQuality( Resampler::SINC );
+
+    EXPECT_EQ( Resampler::SINC, sampleEvent->getResamplingQuality() )
+        << "expected resampling quality to equal the set value";
+
+    delete sampleEvent;
+}
+
 TEST( SampleEvent, PlaybackRateLimit )
 {
     SampleEvent* sampleEvent = new SampleEvent();
@@ -1517,3 +1533,87 @@ TEST( SampleEvent, MixBufferCustomLoopStartAndEndOffsetWithCrossfade )
     delete sourceBuffer;
     delete sampleEvent;
 }
+
+TEST( SampleEvent, TimeStretch )
+{
+    AudioEngineProps::SAMPLE_RATE = 44100;
+
+    SampleEvent* sampleEvent  = new SampleEvent();
+    int sourceSize            = 4410;
+    AudioBuffer* sourceBuffer = fillAudioBuffer( new AudioBuffer( 1, sourceSize ));
+    AudioBuffer* targetBuffer = new AudioBuffer( 1, 512 );
+
+    sampleEvent->setSample( sourceBuffer );
+    sampleEvent->setStretchRatio( 2.f );
+
+    EXPECT_FLOAT_EQ( 2.f, sampleEvent->getStretchRatio() );
+
+    EXPECT_FLOAT_EQ( 1.f, sampleEvent->getAppliedStretchRatio() )
+        << "expected original sample to play until the stretched contents have been rendered";
+
+    waitForStretchCache();
+    sampleEvent->mixBuffer( targetBuffer, 0, 0, 512, false, 0, false );
+
+    EXPECT_FLOAT_EQ( 2.f, sampleEvent->getAppliedStretchRatio() )
+        << "expected stretched contents to be applied once rendered";
+
+    EXPECT_EQ( sourceSize * 2, sampleEvent->getEventLength() )
+        << "expected event length to have been stretched";
+
+    EXPECT_EQ( sampleEvent->getEventStart() + sourceSize * 2 - 1, sampleEvent->getEventEnd() )
+        << "expected event end to have been stretched";
+
+    // restore the original
+
+    sampleEvent->setStretchRatio( 1.f );
+    sampleEvent->mixBuffer( targetBuffer, 0, 0, 512, false, 0, false );
+
+    EXPECT_FLOAT_EQ( 1.f, sampleEvent->getAppliedStretchRatio() )
+        << "expected original sample to be restored without rendering";
+
+    EXPECT_EQ( sourceSize, sampleEvent->getEventLength() )
+        << "expected event length to have been restored";
+
+    delete sampleEvent;
+    delete targetBuffer;
+    delete sourceBuffer;
+}
+
+TEST( SampleEvent, TimeStretchFollowingTempo )
+{
+    AudioEngineProps::SAMPLE_RATE = 44100;
+    AudioEngine::tempo            = 120.f;
+
+    SampleEvent* sampleEvent  = new SampleEvent();
+    int sourceSize            = 4410;
+    AudioBuffer* sourceBuffer = fillAudioBuffer( new AudioBuffer( 1, sourceSize ));
+    AudioBuffer* targetBuffer = new AudioBuffer( 1, 512 );
+
+    sampleEvent->setSample( sourceBuffer );
+    sampleEvent->setLoopeable( true, 0 );
+    sampleEvent->setEventLength( sourceSize * 4 );
+    sampleEvent->setStretchTempo( 120.f );
+
+    EXPECT_EQ( 0, StretchCache::getPendingRenders() )
+        << "expected no render when the sample matches the sequencer tempo";
+
+    // halve the sequencer tempo (events sync to tempo changes when queried)
+
+    AudioEngine::tempo = 60.f;
+    sampleEvent->getEventStart();
+
+    waitForStretchCache();
+    sampleEvent->mixBuffer( targetBuffer, 0, 0, 512, false, 0, false );
+
+    EXPECT_FLOAT_EQ( 2.f, sampleEvent->getAppliedStretchRatio() )
+        << "expected sample to have been stretched to follow the sequencer tempo";
+
+    EXPECT_EQ( sourceSize * 2 - 1, sampleEvent->getLoopEndOffset() )
+        << "expected loop end to have been moved to the end of the stretched sample";
+
+    AudioEngine::tempo = 120.f;
+
+    delete sampleEvent;
+    delete targetBuffer;
+    delete sourceBuffer;
+}
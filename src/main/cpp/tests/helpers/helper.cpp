@@ -4,12 +4,15 @@
  */
 #include <cstdlib>
 #include <time.h>
+#include <chrono>
+#include <thread>
 #include "../../global.h"
 #include "../../audiobuffer.h"
 #include "../../events/baseaudioevent.h"
 #include "../../instruments/baseinstrument.h"
 #include "../../utilities/bufferutility.h"
 #include "../../utilities/samplemanager.h"
+#include "../../utilities/stretchcache.h"
 #include "../../utilities/utils.h"
 
 #define NANOS_IN_SECOND 1000000000
@@ -227,6 +230,15 @@ void prepareSampleManager() {
     SampleManager::setSample( "hhg", randomAudioBuffer(), AudioEngineProps::SAMPLE_RATE );
 }
 
+void waitForStretchCache()
+{
+    // renders (and the disposal of released entries) take place on a background thread,
+    // wait for these to complete
+
+    for ( int i = 0; i < 1000 && StretchCache::isProcessing(); ++i )
+        std::this_thread::sleep_for( std::chrono::milliseconds( 5 ));
+}
+
 void dumpEventProperties( BaseAudioEvent* audioEvent )
 {
     std::cout << "\n AudioEvent start: " << audioEvent->getEventStart() <<
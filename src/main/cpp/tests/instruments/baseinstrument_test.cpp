@@ -268,3 +268,43 @@ TEST( BaseInstrument, UpdateEvents )
     delete event;
     delete instrument;
 }
+
+TEST( BaseInstrument, ModificationCount )
+{
+    BaseInstrument* instrument = new BaseInstrument();
+    BaseAudioEvent* event      = new BaseAudioEvent( instrument );
+
+    unsigned int count = instrument->getModificationCount();
+
+    event->addToSequencer();
+
+    EXPECT_NE( count, instrument->getModificationCount() )
+        << "expected modification count to have changed after adding an event";
+
+    count = instrument->getModificationCount();
+    event->setEventStart( 1000 );
+
+    EXPECT_NE( count, instrument->getModificationCount() )
+        << "expected modification count to have changed after repositioning an event";
+
+    count = instrument->getModificationCount();
+    event->setVolume( .5f );
+
+    EXPECT_NE( count, instrument->getModificationCount() )
+        << "expected modification count to have changed after changing the volume of an event";
+
+    count = instrument->getModificationCount();
+    event->getEventStart();
+
+    EXPECT_EQ( count, instrument->getModificationCount() )
+        << "expected modification count to remain unchanged when querying an event";
+
+    count = instrument->getModificationCount();
+    event->removeFromSequencer();
+
+    EXPECT_NE( count, instrument->getModificationCount() )
+        << "expected modification count to have changed after removing an event";
+
+    delete event;
+    delete instrument;
+}
@@ -15,9 +15,11 @@ using namespace MWEngine;
 
 #include "audioengine_test.cpp"
 #include "audiobuffer_test.cpp"
+#include "audiobus_test.cpp"
 #include "audiochannel_test.cpp"
 #include "processingchain_test.cpp"
 #include "ringbuffer_test.cpp"
+#include "routinggraph_test.cpp"
 #include "sequencer_test.cpp"
 #include "sequencercontroller_test.cpp"
 #include "wavetable_test.cpp"
@@ -31,22 +33,51 @@ using namespace MWEngine;
 #include "modules/adsr_test.cpp"
 #include "modules/lfo_test.cpp"
 #include "processors/baseprocessor_test.cpp"
+#include "processors/convolutionreverb_test.cpp"
 #include "processors/delay_test.cpp"
 #include "processors/filter_test.cpp"
 #include "processors/flanger_test.cpp"
+#include "processors/formantfilter_test.cpp"
+#include "processors/lookaheadlimiter_test.cpp"
+#include "processors/pitchshifter_test.cpp"
 #include "processors/reverb_test.cpp"
+#include "processors/reverbsm_test.cpp"
 #include "processors/tremolo_test.cpp"
+#include "utilities/biquadcascade_test.cpp"
+#include "utilities/bulkcacher_test.cpp"
+#include "utilities/diskwriter_test.cpp"
+#include "utilities/audiorenderer_test.cpp"
 #include "utilities/fastmath_test.cpp"
+#include "utilities/fft_test.cpp"
+#include "utilities/freezer_test.cpp"
+#include "utilities/inputcapture_test.cpp"
+#include "utilities/levelmeter_test.cpp"
+#include "utilities/lockfreeringbuffer_test.cpp"
+#include "utilities/partitionedconvolver_test.cpp"
 #include "utilities/tablepool_test.cpp"
+#include "utilities/resampler_test.cpp"
 #include "utilities/samplemanager_test.cpp"
+#include "utilities/recordingstream_test.cpp"
+#include "utilities/samplestream_test.cpp"
 #include "utilities/sampleutility_test.cpp"
+#include "utilities/stretchcache_test.cpp"
+#include "utilities/tempomap_test.cpp"
+#include "utilities/timestretcher_test.cpp"
 #include "utilities/waveutil_test.cpp"
+#include "utilities/waveencoder_test.cpp"
+#include "utilities/worksignal_test.cpp"
 #include "utilities/volumeutil_test.cpp"
 #include "deprecation_test.cpp"
 
 // these aren't stability tests, but benchmarks to test certain performance assumptions
+//#include "benchmarks/biquad_test.cpp"
+//#include "benchmarks/convolutionreverb_test.cpp"
 //#include "benchmarks/buffer_test.cpp"
+//#include "benchmarks/fft_test.cpp"
+//#include "benchmarks/filter_test.cpp"
 //#include "benchmarks/inline_test.cpp"
+//#include "benchmarks/resampler_test.cpp"
+//#include "benchmarks/reverbsm_test.cpp"
 //#include "benchmarks/table_test.cpp"
 
 int main( int argc, char *argv[] )
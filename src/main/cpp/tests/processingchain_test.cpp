@@ -1,5 +1,6 @@
 #include "../processingchain.h"
 #include "../processors/baseprocessor.h"
+#include "../processors/pitchshifter.h"
 
 TEST( ProcessingChain, ProcessorAddition )
 {
@@ -106,3 +107,27 @@ TEST( ProcessingChain, Reset )
     delete processor2;
     delete chain;
 }
+
+TEST( ProcessingChain, Latency )
+{
+    AudioEngineProps::SAMPLE_RATE = 44100;
+
+    BaseProcessor* processor1 = new BaseProcessor();
+    PitchShifter* processor2  = new PitchShifter( 2.f, 4 );
+
+    ProcessingChain* chain = new ProcessingChain();
+
+    chain->addProcessor( processor1 );
+
+    EXPECT_EQ( 0, chain->getLatency() )
+        << "expected no latency for a chain without latent processors";
+
+    chain->addProcessor( processor2 );
+
+    EXPECT_EQ( processor2->getLatency(), chain->getLatency() )
+        << "expected the chain latency to equal the sum of its processors latencies";
+
+    delete processor1;
+    delete processor2;
+    delete chain;
+}
@@ -0,0 +1,156 @@
+#include "../../processors/convolutionreverb.h"
+#include "../../utilities/samplemanager.h"
+
+TEST( ConvolutionReverb, Construction )
+{
+    ConvolutionReverb* reverb = new ConvolutionReverb( 300, 1.f, 0.5f, 2 );
+
+    EXPECT_EQ( 512, reverb->getPartitionSize() )         << "expected partition size to have been rounded up to a power of two";
+    EXPECT_EQ( 512, reverb->getLatency() )               << "expected latency to equal the partition size";
+    EXPECT_EQ( 0,   reverb->getImpulseResponseLength() ) << "expected no impulse response to have been set";
+    EXPECT_FLOAT_EQ( 1.f,  reverb->getDry() );
+    EXPECT_FLOAT_EQ( 0.5f, reverb->getWet() );
+
+    delete reverb;
+}
+
+TEST( ConvolutionReverb, GetSetDryWet )
+{
+    ConvolutionReverb* reverb = new ConvolutionReverb( 64, 1.f, 1.f, 2 );
+
+    float value = randomFloat( 0.f, 1.f );
+
+    reverb->setDry( value );
+    EXPECT_EQ( value, reverb->getDry() ) << "expected set dry to have been returned unchanged";
+
+    reverb->setWet( value );
+    EXPECT_EQ( value, reverb->getWet() ) << "expected set wet to have been returned unchanged";
+
+    reverb->setDry( -1.f );
+    reverb->setWet( 2.f );
+
+    EXPECT_EQ( 0.f, reverb->getDry() ) << "expected dry to have been normalized to defined min value";
+    EXPECT_EQ( 1.f, reverb->getWet() ) << "expected wet to have been normalized to defined max value";
+
+    delete reverb;
+}
+
+TEST( ConvolutionReverb, ProcessImpulse )
+{
+    int partitionSize  = 64;
+    int responseLength = randomInt( 2000, 5000 ); // exceeds the head, requiring the tail to be convolved
+
+    ConvolutionReverb* reverb = new ConvolutionReverb( partitionSize, 0.f, 1.f, 2 );
+
+    // stereo impulse response of decaying noise
+
+    AudioBuffer* impulseResponse = new AudioBuffer( 2, responseLength );
+
+    for ( int c = 0; c < 2; ++c ) {
+        for ( int i = 0; i < responseLength; ++i )
+            impulseResponse->getBufferForChannel( c )[ i ] = randomSample( -1.0, 1.0 ) * exp( -4.0 * i / responseLength );
+    }
+    reverb->setImpulseResponse( impulseResponse, AudioEngineProps::SAMPLE_RATE );
+
+    EXPECT_EQ( responseLength, reverb->getImpulseResponseLength() );
+
+    // process an impulse followed by silence, using buffers that don't align with the partitions
+    // as this runs outside of the audio thread, the reverb awaits the tail thread itself
+
+    int bufferSize   = 100;
+    int outputLength = responseLength + partitionSize * 2;
+    AudioBuffer* buffer = new AudioBuffer( 2, bufferSize );
+    AudioBuffer* output = new AudioBuffer( 2, outputLength + bufferSize );
+
+    for ( int offset = 0; offset < outputLength; offset += bufferSize )
+    {
+        buffer->silenceBuffers();
+
+        if ( offset == 0 ) {
+            buffer->getBufferForChannel( 0 )[ 0 ] = 1.0;
+            buffer->getBufferForChannel( 1 )[ 0 ] = 1.0;
+        }
+        reverb->process( buffer, false );
+        output->mergeBuffers( buffer, 0, offset, 1.0 );
+    }
+
+    // the output should equal the impulse response, delayed by the latency
+
+    int latency = reverb->getLatency();
+
+    for ( int c = 0; c < 2; ++c )
+    {
+        SAMPLE_TYPE* expected = impulseResponse->getBufferForChannel( c );
+        SAMPLE_TYPE* actual   = output->getBufferForChannel( c );
+
+        for ( int i = 0; i < latency; ++i )
+            EXPECT_NEAR( 0.0, actual[ i ], 1e-6 ) << "expected silence during the latency at index " << i;
+
+        for ( int i = 0; i < outputLength - latency; ++i ) {
+            SAMPLE_TYPE sample = i < responseLength ? expected[ i ] : 0.0;
+            EXPECT_NEAR( sample, actual[ i + latency ], 1e-4 ) << "expected impulse response at index " << i << " for channel " << c;
+        }
+    }
+
+    // resetting clears the tail
+
+    reverb->reset();
+    buffer->silenceBuffers();
+
+    for ( int i = 0; i < 10; ++i ) {
+        reverb->waitForTail();
+        reverb->process( buffer, false );
+        for ( int j = 0; j < bufferSize; ++j )
+            EXPECT_NEAR( 0.0, buffer->getBufferForChannel( 0 )[ j ], 1e-6 ) << "expected silence after reset";
+    }
+
+    delete reverb;
+    delete impulseResponse;
+    delete buffer;
+    delete output;
+}
+
+TEST( ConvolutionReverb, ProcessMonoSource )
+{
+    ConvolutionReverb* reverb = new ConvolutionReverb( 64, 0.5f, 0.5f, 2 );
+
+    AudioBuffer* impulseResponse = new AudioBuffer( 1, 300 );
+    fillAudioBuffer( impulseResponse );
+    reverb->setImpulseResponse( impulseResponse, AudioEngineProps::SAMPLE_RATE );
+
+    AudioBuffer* buffer = new AudioBuffer( 2, 256 );
+    fillAudioBuffer( buffer );
+
+    reverb->process( buffer, true );
+
+    for ( int i = 0; i < buffer->bufferSize; ++i ) {
+        EXPECT_EQ( buffer->getBufferForChannel( 0 )[ i ], buffer->getBufferForChannel( 1 )[ i ])
+            << "expected the processed mono channel to have been copied into the remaining channel";
+    }
+
+    delete reverb;
+    delete impulseResponse;
+    delete buffer;
+}
+
+TEST( ConvolutionReverb, LoadImpulseResponse )
+{
+    ConvolutionReverb* reverb = new ConvolutionReverb( 64, 1.f, 1.f, 2 );
+
+    EXPECT_FALSE( reverb->loadImpulseResponse( "foo" )) << "expected unregistered sample not to load";
+    EXPECT_FALSE( reverb->loadImpulseResponseFromFile( "/foo/bar.wav" )) << "expected non existing file not to load";
+
+    // impulse responses recorded at a different sample rate are converted to the engine's
+
+    AudioBuffer* impulseResponse = new AudioBuffer( 1, 1000 );
+    fillAudioBuffer( impulseResponse );
+
+    SampleManager::setSample( "ir", impulseResponse, AudioEngineProps::SAMPLE_RATE / 2 );
+
+    EXPECT_TRUE( reverb->loadImpulseResponse( "ir" )) << "expected registered sample to load";
+    EXPECT_EQ( 2000, reverb->getImpulseResponseLength() ) << "expected impulse response to have been resampled";
+
+    SampleManager::removeSample( "ir", true );
+
+    delete reverb;
+}
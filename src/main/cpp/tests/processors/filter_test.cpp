@@ -99,6 +99,55 @@ TEST( Filter, LFO )
     delete lfo;
 }
 
+TEST( Filter, ProcessLFO )
+{
+    float minFreq   = randomFloat( 40.f, 440.f );
+    float maxFreq   = randomFloat( 880.f, 11025.f );
+    float cutoff    = randomFloat( minFreq, maxFreq );
+    float resonance = randomFloat( 0.1f, 1.f );
+    int bufferSize  = randomInt( 64, 1024 );
+
+    Filter* filter = new Filter( cutoff, resonance, minFreq, maxFreq, 2 );
+    LFO* lfo       = new LFO();
+    lfo->setRate( LFO::MAX_RATE() );
+    filter->setLFO( lfo );
+
+    AudioBuffer* buffer = new AudioBuffer( 2, bufferSize );
+    SAMPLE_TYPE* left   = buffer->getBufferForChannel( 0 );
+    SAMPLE_TYPE* right  = buffer->getBufferForChannel( 1 );
+
+    for ( int i = 0; i < bufferSize; ++i )
+        left[ i ] = right[ i ] = randomSample( -1.0, 1.0 );
+
+    filter->process( buffer, false );
+
+    // both channels should have been subject to the same LFO movement
+
+    for ( int i = 0; i < bufferSize; ++i )
+    {
+        EXPECT_EQ( left[ i ], right[ i ] )
+            << "expected both channels to be filtered identically at index " << i;
+
+        ASSERT_TRUE( std::isfinite( left[ i ] ) && std::abs( left[ i ] ) < 10.0 )
+            << "expected filter output to remain stable at index " << i;
+    }
+
+    // the LFO should have advanced by the buffer size (once, not once per channel)
+
+    WaveTable* ref = new WaveTable( lfo->getTable()->tableLength, lfo->getTable()->getFrequency() );
+
+    for ( int i = 0; i < bufferSize; ++i )
+        ref->peek();
+
+    EXPECT_NEAR( ref->getAccumulator(), lfo->getTable()->getAccumulator(), 0.001 )
+        << "expected LFO to have advanced by the buffer size";
+
+    delete ref;
+    delete buffer;
+    delete filter;
+    delete lfo;
+}
+
 TEST( Filter, IsCacheable )
 {
     float minFreq   = randomFloat( 40.f, 440.f );
@@ -0,0 +1,64 @@
+#include "../../processors/formantfilter.h"
+
+TEST( FormantFilter, Vowel )
+{
+    double vowel = randomSample( 0.0, 4.0 );
+    FormantFilter* filter = new FormantFilter( vowel );
+
+    EXPECT_EQ( vowel, filter->getVowel() )
+        << "expected vowel to equal the value given in the constructor";
+
+    filter->setVowel( FormantFilter::VOWEL_O );
+
+    EXPECT_EQ( FormantFilter::VOWEL_O, filter->getVowel() )
+        << "expected vowel to equal the value given in the setter";
+
+    delete filter;
+}
+
+TEST( FormantFilter, Process )
+{
+    int bufferSize = 2048;
+
+    // coefficients for vowel "A" (see FormantFilter::calculateCoeffs())
+
+    double coeffs[ 11 ] = {
+        8.11044e-06, 8.943665402, -36.83889529, 92.01697887, -154.337906, 181.6233289,
+        -151.8651235, 89.09614114, -35.10298511, 8.388101016, -0.923313471
+    };
+
+    FormantFilter* filter = new FormantFilter( FormantFilter::VOWEL_A );
+    AudioBuffer* buffer   = fillAudioBuffer( new AudioBuffer( 2, bufferSize ));
+    AudioBuffer* input    = buffer->clone();
+
+    filter->process( buffer, false );
+
+    // compare against the 10th order direct form filter
+
+    double memory[ 10 ] = { 0.0 };
+    double maxValue = 0.0, maxError = 0.0;
+    SAMPLE_TYPE* source = input->getBufferForChannel( 0 );
+
+    for ( int i = 0; i < bufferSize; ++i )
+    {
+        double expected = coeffs[ 0 ] * source[ i ];
+
+        for ( int k = 0; k < 10; ++k )
+            expected += coeffs[ k + 1 ] * memory[ k ];
+
+        for ( int k = 9; k > 0; --k )
+            memory[ k ] = memory[ k - 1 ];
+
+        memory[ 0 ] = expected;
+
+        maxValue = std::max( maxValue, std::abs( expected ));
+        maxError = std::max( maxError, std::abs( expected - buffer->getBufferForChannel( 0 )[ i ] ));
+    }
+
+    EXPECT_LT( maxError, maxValue * 1e-6 )
+        << "expected the cascaded sections to match the direct form filter";
+
+    delete filter;
+    delete buffer;
+    delete input;
+}
@@ -0,0 +1,159 @@
+#include "../../processors/lookaheadlimiter.h"
+
+TEST( LookAheadLimiter, Construction )
+{
+    LookAheadLimiter* limiter = new LookAheadLimiter( 2.f, 50.f, -1.f, 2 );
+
+    int lookAhead = ( int ) round(( AudioEngineProps::SAMPLE_RATE / 1000.f ) * 2.f );
+
+    EXPECT_EQ( lookAhead + LookAheadLimiter::TAPS_PER_PHASE / 2, limiter->getLatency() )
+        << "expected latency to equal the look-ahead plus the delay of the true peak detection";
+
+    EXPECT_NEAR( 2.f, limiter->getLookAhead(), 0.05f );
+    EXPECT_FLOAT_EQ( 50.f, limiter->getRelease() );
+    EXPECT_FLOAT_EQ( -1.f, limiter->getCeiling() );
+    EXPECT_FLOAT_EQ( 1.f,  limiter->getLinearGR() ) << "expected no gain reduction upon construction";
+
+    limiter->setCeiling( 3.f );
+    EXPECT_FLOAT_EQ( 0.f, limiter->getCeiling() ) << "expected the ceiling not to exceed 0 dB";
+
+    delete limiter;
+}
+
+TEST( LookAheadLimiter, Transparent )
+{
+    LookAheadLimiter* limiter = new LookAheadLimiter( 1.f, 50.f, -1.f, 2 );
+
+    int latency    = limiter->getLatency();
+    int bufferSize = 256;
+
+    AudioBuffer* buffer = new AudioBuffer( 2, bufferSize );
+
+    fillAudioBuffer( buffer );
+    buffer->adjustBufferVolumes( 0.5 ); // below the ceiling
+
+    AudioBuffer* input = buffer->clone();
+
+    limiter->process( buffer, false );
+
+    for ( int c = 0; c < 2; ++c )
+    {
+        SAMPLE_TYPE* in  = input->getBufferForChannel( c );
+        SAMPLE_TYPE* out = buffer->getBufferForChannel( c );
+
+        for ( int i = 0; i < bufferSize; ++i )
+        {
+            SAMPLE_TYPE expected = i < latency ? 0.0 : in[ i - latency ];
+            EXPECT_DOUBLE_EQ( expected, out[ i ] ) << "expected input below the ceiling to be delayed by the latency only";
+        }
+    }
+
+    delete limiter;
+    delete buffer;
+    delete input;
+}
+
+TEST( LookAheadLimiter, Ceiling )
+{
+    LookAheadLimiter* limiter = new LookAheadLimiter( 1.5f, 20.f, -1.f, 2 );
+
+    SAMPLE_TYPE ceiling = pow( 10.0, -1.0 / 20.0 );
+    int bufferSize      = 128;
+    AudioBuffer* buffer = new AudioBuffer( 2, bufferSize );
+
+    bool limited = false;
+
+    for ( int n = 0; n < 32; ++n )
+    {
+        fillAudioBuffer( buffer );
+        buffer->adjustBufferVolumes( 4.0 ); // exceeds the ceiling by a wide margin
+
+        limiter->process( buffer, false );
+
+        for ( int c = 0; c < 2; ++c ) {
+            for ( int i = 0; i < bufferSize; ++i ) {
+                SAMPLE_TYPE sample = buffer->getBufferForChannel( c )[ i ];
+                ASSERT_LE( std::abs( sample ), ceiling + 1e-9 ) << "expected output not to exceed the ceiling";
+
+                if ( sample != 0.0 )
+                    limited = true;
+            }
+        }
+    }
+    EXPECT_TRUE( limited ) << "expected the limited signal to be audible";
+    EXPECT_LT( limiter->getLinearGR(), 0.5f ) << "expected gain to have been reduced";
+
+    delete limiter;
+    delete buffer;
+}
+
+TEST( LookAheadLimiter, TruePeak )
+{
+    LookAheadLimiter* limiter = new LookAheadLimiter( 1.f, 50.f, 0.f, 1 );
+
+    // a sine at a quarter of the sample rate, sampled 45 degrees out of phase with its peaks
+    // has its sample values ( 1 / sqrt( 2 )) below its true peak (e.g. the sample peak is below the
+    // ceiling while the true peak of 1.2 is not)
+
+    int bufferSize      = 512;
+    AudioBuffer* buffer = new AudioBuffer( 1, bufferSize );
+    SAMPLE_TYPE* output = buffer->getBufferForChannel( 0 );
+
+    for ( int n = 0; n < 4; ++n )
+    {
+        for ( int i = 0; i < bufferSize; ++i )
+            output[ i ] = 1.2 * sin( PI / 2 * ( n * bufferSize + i ) + PI / 4 );
+
+        limiter->process( buffer, true );
+    }
+
+    SAMPLE_TYPE samplePeak = 0.0;
+
+    for ( int i = 0; i < bufferSize; ++i )
+        samplePeak = std::max( samplePeak, std::abs( output[ i ]));
+
+    EXPECT_NEAR( 1.0 / sqrt( 2.0 ), samplePeak, 0.02 ) << "expected the inter-sample peaks to have been limited to the ceiling";
+
+    delete limiter;
+    delete buffer;
+}
+
+TEST( LookAheadLimiter, Release )
+{
+    LookAheadLimiter* fastLimiter = new LookAheadLimiter( 1.f, 10.f,  -6.f, 1 );
+    LookAheadLimiter* slowLimiter = new LookAheadLimiter( 1.f, 200.f, -6.f, 1 );
+
+    int bufferSize      = 512;
+    AudioBuffer* buffer = new AudioBuffer( 1, bufferSize );
+
+    // limit a loud signal, followed by silence
+
+    fillAudioBuffer( buffer );
+    fastLimiter->process( buffer, true );
+    fillAudioBuffer( buffer );
+    slowLimiter->process( buffer, true );
+
+    EXPECT_LT( fastLimiter->getLinearGR(), 1.f );
+    EXPECT_LT( slowLimiter->getLinearGR(), 1.f );
+
+    for ( int n = 0; n < 4; ++n )
+    {
+        buffer->silenceBuffers();
+        fastLimiter->process( buffer, true );
+        buffer->silenceBuffers();
+        slowLimiter->process( buffer, true );
+    }
+    EXPECT_GT( fastLimiter->getLinearGR(), slowLimiter->getLinearGR() )
+        << "expected a shorter release time to recover faster";
+
+    EXPECT_NEAR( 1.f, fastLimiter->getLinearGR(), 0.01f ) << "expected gain to have recovered";
+
+    // resetting clears the gain reduction
+
+    slowLimiter->reset();
+    EXPECT_FLOAT_EQ( 1.f, slowLimiter->getLinearGR() );
+
+    delete fastLimiter;
+    delete slowLimiter;
+    delete buffer;
+}
@@ -0,0 +1,114 @@
+#include "../../processors/pitchshifter.h"
+#include "../../global.h"
+
+// returns the magnitude of given frequency within given buffer (Goertzel)
+
+SAMPLE_TYPE getMagnitudeForFrequency( SAMPLE_TYPE* buffer, int length, double frequency, int sampleRate )
+{
+    double coefficient = 2.0 * cos( 2.0 * M_PI * frequency / sampleRate );
+    double s1 = 0.0, s2 = 0.0;
+
+    for ( int i = 0; i < length; ++i ) {
+        double s = buffer[ i ] + coefficient * s1 - s2;
+        s2 = s1;
+        s1 = s;
+    }
+    return ( SAMPLE_TYPE ) sqrt( s1 * s1 + s2 * s2 - coefficient * s1 * s2 );
+}
+
+TEST( PitchShifter, Mode )
+{
+    AudioEngineProps::SAMPLE_RATE = 44100;
+
+    PitchShifter* pitchShifter = new PitchShifter( 1.5f, 4 );
+
+    EXPECT_EQ( PitchShifter::SPECTRAL, pitchShifter->getMode() )
+        << "expected the spectral mode by default";
+
+    pitchShifter->setMode( PitchShifter::TIME_DOMAIN );
+
+    EXPECT_EQ( PitchShifter::TIME_DOMAIN, pitchShifter->getMode() )
+        << "expected mode to have updated after using setter method";
+
+    delete pitchShifter;
+
+    pitchShifter = new PitchShifter( 1.5f, 4, PitchShifter::TIME_DOMAIN );
+
+    EXPECT_EQ( PitchShifter::TIME_DOMAIN, pitchShifter->getMode() )
+        << "expected mode to equal the value given to the constructor";
+
+    delete pitchShifter;
+}
+
+TEST( PitchShifter, Latency )
+{
+    AudioEngineProps::SAMPLE_RATE = 44100;
+
+    PitchShifter* pitchShifter = new PitchShifter( 2.f, 4, PitchShifter::SPECTRAL );
+
+    EXPECT_EQ( 3072, pitchShifter->getLatency() )
+        << "expected spectral latency to equal the frame size minus the hop size";
+
+    pitchShifter->setMode( PitchShifter::TIME_DOMAIN );
+
+    int latency = pitchShifter->getLatency();
+
+    EXPECT_GT( latency, 0 );
+    EXPECT_LT( latency, 1024 ) << "expected time domain mode to have a fraction of the spectral latency";
+
+    pitchShifter->pitchShift = 1.f;
+
+    EXPECT_EQ( 0, pitchShifter->getLatency() )
+        << "expected no latency when the pitch is not shifted (as processing is bypassed)";
+
+    delete pitchShifter;
+}
+
+TEST( PitchShifter, TimeDomainProcess )
+{
+    int sampleRate = 44100;
+    AudioEngineProps::SAMPLE_RATE = sampleRate;
+
+    float ratios[] = { 0.5f, 1.5f, 2.f };
+
+    for ( float ratio : ratios )
+    {
+        PitchShifter* pitchShifter = new PitchShifter( ratio, 4, PitchShifter::TIME_DOMAIN );
+
+        int bufferSize   = 512;
+        int amount       = 64;
+        double frequency = 441.0;
+
+        SAMPLE_TYPE* output = new SAMPLE_TYPE[ bufferSize * amount ];
+        AudioBuffer* buffer = new AudioBuffer( 1, bufferSize );
+        int position = 0;
+
+        for ( int i = 0; i < amount; ++i )
+        {
+            SAMPLE_TYPE* channel = buffer->getBufferForChannel( 0 );
+
+            for ( int j = 0; j < bufferSize; ++j, ++position )
+                channel[ j ] = sin( 2.0 * M_PI * frequency * position / sampleRate );
+
+            pitchShifter->process( buffer, true );
+
+            for ( int j = 0; j < bufferSize; ++j )
+                output[ i * bufferSize + j ] = channel[ j ];
+        }
+
+        // omit the first buffers containing the latency
+
+        int offset = bufferSize * 4;
+        int length = bufferSize * amount - offset;
+
+        SAMPLE_TYPE shifted  = getMagnitudeForFrequency( output + offset, length, frequency * ratio, sampleRate );
+        SAMPLE_TYPE original = getMagnitudeForFrequency( output + offset, length, frequency, sampleRate );
+
+        EXPECT_GT( shifted, original * 10 )
+            << "expected the shifted frequency to be dominant for ratio " << ratio;
+
+        delete pitchShifter;
+        delete buffer;
+        delete[] output;
+    }
+}
@@ -0,0 +1,74 @@
+#include "../../processors/reverbsm.h"
+
+TEST( ReverbSM, ProcessTail )
+{
+    ReverbSM* reverb = new ReverbSM();
+    reverb->setDry( 0.f );
+    reverb->setWet( 1.f );
+
+    int bufferSize      = 512;
+    AudioBuffer* buffer = new AudioBuffer( 2, bufferSize );
+
+    // an impulse is only heard once the shortest comb delay has passed
+
+    buffer->silenceBuffers();
+    buffer->getBufferForChannel( 0 )[ 0 ] = 1.0;
+    buffer->getBufferForChannel( 1 )[ 0 ] = 1.0;
+
+    reverb->process( buffer, false );
+
+    SAMPLE_TYPE* left = buffer->getBufferForChannel( 0 );
+
+    int shortestCombDelay = 1116; // ReverbSM::COMB_TUNING_L1, exceeds a single buffer
+
+    for ( int i = 0; i < bufferSize && i < shortestCombDelay; ++i )
+        EXPECT_EQ( 0.0, left[ i ] ) << "expected no output prior to the shortest comb delay at index " << i;
+
+    bool hasTail = false;
+
+    for ( int i = 0; i < 8; ++i )
+    {
+        buffer->silenceBuffers();
+        reverb->process( buffer, false );
+
+        for ( int j = 0; j < bufferSize; ++j ) {
+            if ( left[ j ] != 0.0 && buffer->getBufferForChannel( 1 )[ j ] != 0.0 )
+                hasTail = true;
+        }
+    }
+    EXPECT_TRUE( hasTail ) << "expected the impulse to produce a tail on both channels";
+
+    // muting clears the tail
+
+    reverb->mute();
+    buffer->silenceBuffers();
+    reverb->process( buffer, false );
+
+    for ( int c = 0; c < 2; ++c ) {
+        for ( int i = 0; i < bufferSize; ++i )
+            EXPECT_EQ( 0.0, buffer->getBufferForChannel( c )[ i ] ) << "expected no output after muting";
+    }
+
+    delete reverb;
+    delete buffer;
+}
+
+TEST( ReverbSM, ProcessMonoBuffer )
+{
+    ReverbSM* reverb = new ReverbSM();
+
+    int bufferSize      = 300; // not a multiple of the block size
+    AudioBuffer* buffer = new AudioBuffer( 1, bufferSize );
+
+    fillAudioBuffer( buffer );
+
+    reverb->process( buffer, false ); // single channel buffer must be processed as mono
+
+    SAMPLE_TYPE* left = buffer->getBufferForChannel( 0 );
+
+    for ( int i = 0; i < bufferSize; ++i )
+        EXPECT_FALSE( std::isnan( left[ i ] )) << "expected valid output at index " << i;
+
+    delete reverb;
+    delete buffer;
+}
@@ -0,0 +1,171 @@
+#include "../routinggraph.h"
+#include "../audioengine.h"
+
+// multiplies the contents of the buffer it processes by its factor
+
+class RoutingGraphTestProcessor : public BaseProcessor
+{
+    public:
+        RoutingGraphTestProcessor( SAMPLE_TYPE aFactor ) {
+            factor = aFactor;
+        }
+        void process( AudioBuffer* sampleBuffer, bool isMonoSource ) {
+            sampleBuffer->adjustBufferVolumes( factor );
+        }
+        SAMPLE_TYPE factor;
+};
+
+TEST( RoutingGraph, Schedule )
+{
+    RoutingGraph* graph = new RoutingGraph();
+
+    AudioBus* drums  = new AudioBus( 1.0 );
+    AudioBus* kicks  = new AudioBus( 1.0 );
+    AudioBus* snares = new AudioBus( 1.0 );
+    AudioBus* reverb = new AudioBus( 1.0 );
+
+    graph->addBus( drums );
+    graph->addBus( kicks );
+    graph->addBus( snares );
+    graph->addBus( reverb );
+
+    EXPECT_EQ( 1, graph->getAmountOfLevels() ) << "expected all buses to be processable at once";
+
+    // note as the buses are not registered in the engines routing, we route the buses manually
+
+    kicks->setOutputBus( drums );
+    snares->setOutputBus( drums );
+    graph->rebuild();
+
+    EXPECT_EQ( 2, graph->getAmountOfLevels() );
+    EXPECT_EQ( 0, graph->getLevel( kicks ));
+    EXPECT_EQ( 0, graph->getLevel( snares ));
+    EXPECT_EQ( 0, graph->getLevel( reverb ));
+    EXPECT_EQ( 1, graph->getLevel( drums )) << "expected group bus to be processed after its inputs";
+
+    // nest the drums into the reverb
+
+    drums->setOutputBus( reverb );
+    graph->rebuild();
+
+    EXPECT_EQ( 3, graph->getAmountOfLevels() );
+    EXPECT_EQ( 1, graph->getLevel( drums ));
+    EXPECT_EQ( 2, graph->getLevel( reverb )) << "expected bus to be processed after all nested inputs";
+
+    // unregistered buses are not scheduled
+
+    graph->removeBus( reverb );
+
+    EXPECT_EQ( -1, graph->getLevel( reverb ));
+    EXPECT_EQ( 2, graph->getAmountOfLevels() );
+    EXPECT_TRUE( reverb->getOutputBuffer() == nullptr ) << "expected buffer to have been returned to the pool";
+
+    delete graph;
+    delete drums;
+    delete kicks;
+    delete snares;
+    delete reverb;
+}
+
+TEST( RoutingGraph, BufferPool )
+{
+    RoutingGraph* graph = new RoutingGraph();
+
+    AudioBus* bus1 = new AudioBus( 1.0 );
+    AudioBus* bus2 = new AudioBus( 1.0 );
+
+    EXPECT_EQ( 0, graph->getPoolSize() ) << "expected no buffers to be allocated when no buses are registered";
+
+    graph->addBus( bus1 );
+    graph->addBus( bus2 );
+
+    EXPECT_EQ( 2, graph->getPoolSize() ) << "expected a buffer to have been allocated for each bus";
+    EXPECT_FALSE( bus1->getOutputBuffer() == bus2->getOutputBuffer() ) << "expected each bus to have its own buffer";
+
+    AudioBuffer* buffer = bus1->getOutputBuffer();
+    graph->removeBus( bus1 );
+
+    EXPECT_EQ( 2, graph->getPoolSize() ) << "expected buffer to remain in the pool";
+
+    AudioBus* bus3 = new AudioBus( 1.0 );
+    graph->addBus( bus3 );
+
+    EXPECT_EQ( 2, graph->getPoolSize() ) << "expected pool not to have grown";
+    EXPECT_TRUE( buffer == bus3->getOutputBuffer() ) << "expected the returned buffer to have been reused";
+
+    delete graph;
+    delete bus1;
+    delete bus2;
+    delete bus3;
+}
+
+TEST( RoutingGraph, Process )
+{
+    RoutingGraph* graph = new RoutingGraph();
+
+    AudioBus* group  = new AudioBus( 1.0 );
+    AudioBus* input1 = new AudioBus( 1.0 );
+    AudioBus* input2 = new AudioBus( 1.0 );
+
+    RoutingGraphTestProcessor* groupProcessor = new RoutingGraphTestProcessor( 0.5 );
+    RoutingGraphTestProcessor* inputProcessor = new RoutingGraphTestProcessor( 0.25 );
+
+    group->processingChain->addProcessor( groupProcessor );
+    input1->processingChain->addProcessor( inputProcessor );
+
+    graph->addBus( group );
+    graph->addBus( input1 );
+    graph->addBus( input2 );
+
+    input1->setOutputBus( group );
+    input2->setOutputBus( group );
+    graph->rebuild();
+
+    int amountOfChannels = group->getOutputBuffer()->amountOfChannels;
+    int bufferSize       = group->getOutputBuffer()->bufferSize;
+
+    AudioBuffer* masterBuffer = new AudioBuffer( amountOfChannels, bufferSize );
+
+    // run with and without worker threads, expecting equal output
+
+    for ( int threads = 0; threads <= 2; threads += 2 )
+    {
+        graph->setAmountOfThreads( threads );
+        EXPECT_EQ( threads, graph->getAmountOfThreads() );
+
+        graph->prepare();
+        masterBuffer->silenceBuffers();
+
+        fillAudioBuffer( input1->getOutputBuffer() );
+        fillAudioBuffer( input2->getOutputBuffer() );
+
+        AudioBuffer* source1 = input1->getOutputBuffer()->clone();
+        AudioBuffer* source2 = input2->getOutputBuffer()->clone();
+
+        graph->process( masterBuffer, false );
+
+        for ( int c = 0; c < amountOfChannels; ++c )
+        {
+            for ( int i = 0; i < bufferSize; ++i )
+            {
+                SAMPLE_TYPE expected = ( source1->getBufferForChannel( c )[ i ] * 0.25 * input1->getVolumeLogarithmic() +
+                                         source2->getBufferForChannel( c )[ i ] * input2->getVolumeLogarithmic()
+                                       ) * 0.5 * group->getVolumeLogarithmic();
+
+                EXPECT_NEAR( expected, masterBuffer->getBufferForChannel( c )[ i ], 1e-6 )
+                    << "expected the processed inputs to have been summed and processed by the group bus";
+            }
+        }
+        delete source1;
+        delete source2;
+    }
+    graph->setAmountOfThreads( 0 );
+
+    delete groupProcessor;
+    delete inputProcessor;
+    delete graph;
+    delete group;
+    delete input1;
+    delete input2;
+    delete masterBuffer;
+}
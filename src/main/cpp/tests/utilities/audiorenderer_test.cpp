@@ -0,0 +1,140 @@
+#include "../../utilities/audiorenderer.h"
+#include "../../utilities/samplemanager.h"
+#include <chrono>
+#include <thread>
+
+TEST( AudioRenderer, Render )
+{
+    AudioEngine::setup( 64, 48000, 2 );
+
+    BaseInstrument* instrument = new BaseInstrument();
+    BaseAudioEvent* event      = new BaseAudioEvent( instrument );
+
+    // mono event of 100 samples positioned at sample 50
+
+    int eventStart  = 50;
+    int eventLength = 100;
+
+    AudioBuffer* buffer = new AudioBuffer( 1, eventLength );
+
+    for ( int i = 0; i < eventLength; ++i )
+        buffer->getBufferForChannel( 0 )[ i ] = ( SAMPLE_TYPE ) i / eventLength;
+
+    event->setBuffer( buffer, false );
+    event->setEventStart( eventStart );
+    event->setEventLength( eventLength );
+    event->addToSequencer();
+
+    std::vector<BaseInstrument*> instruments;
+    instruments.push_back( instrument );
+
+    // render a range exceeding the event (and not aligned to the buffer size)
+
+    int rangeEnd = 199;
+    AudioBuffer* output = AudioRenderer::render( 0, rangeEnd, instruments, false, false );
+
+    ASSERT_FALSE( output == nullptr );
+    EXPECT_EQ( AudioEngineProps::OUTPUT_CHANNELS, output->amountOfChannels );
+    ASSERT_EQ( rangeEnd + 1, output->bufferSize ) << "expected the rendered buffer to span the full range";
+
+    for ( int c = 0; c < output->amountOfChannels; ++c )
+    {
+        SAMPLE_TYPE* channel = output->getBufferForChannel( c );
+
+        for ( int i = 0; i < output->bufferSize; ++i )
+        {
+            SAMPLE_TYPE expected = ( i >= eventStart && i < eventStart + eventLength ) ?
+                                   ( SAMPLE_TYPE )( i - eventStart ) / eventLength : 0.0;
+
+            EXPECT_NEAR( expected, channel[ i ], 0.0001 ) << "expected event contents at sample " << i;
+        }
+    }
+    delete output;
+
+    // render a range starting within the event
+
+    output = AudioRenderer::render( 60, 79, instruments, false, false );
+
+    ASSERT_EQ( 20, output->bufferSize );
+    EXPECT_NEAR(( SAMPLE_TYPE ) 10 / eventLength, output->getBufferForChannel( 0 )[ 0 ], 0.0001 )
+        << "expected rendering to start at the range start";
+
+    delete output;
+
+    // render with the channel mix applied
+
+    instrument->audioChannel->setVolume( .5f );
+    output = AudioRenderer::render( 0, rangeEnd, instruments, true, true );
+
+    EXPECT_NEAR(( SAMPLE_TYPE ) 50 / eventLength * instrument->audioChannel->getVolumeLogarithmic(),
+                output->getBufferForChannel( 1 )[ eventStart + 50 ], 0.0001 )
+        << "expected the channel volume to have been applied";
+
+    delete output;
+
+    ASSERT_TRUE( AudioRenderer::render( 10, 9, instruments, false, false ) == nullptr )
+        << "expected no output for an invalid range";
+
+    delete event;
+    delete instrument;
+    delete buffer;
+}
+
+TEST( AudioRenderer, RenderAsync )
+{
+    AudioEngine::setup( 64, 48000, 2 );
+
+    BaseInstrument* instrument = new BaseInstrument();
+    BaseAudioEvent* event      = new BaseAudioEvent( instrument );
+    AudioBuffer* buffer        = new AudioBuffer( 2, 256 );
+
+    fillAudioBuffer( buffer );
+
+    event->setBuffer( buffer, false );
+    event->setEventLength( buffer->bufferSize );
+    event->addToSequencer();
+
+    std::vector<BaseInstrument*> instruments;
+    instruments.push_back( instrument );
+
+    // channels that are being rendered elsewhere (e.g. by the Freezer) are not to be rendered
+
+    instrument->audioChannel->setFreezing( true );
+
+    EXPECT_FALSE( AudioRenderer::renderAsync( 0, 255, instruments, false, false ))
+        << "expected render to be refused while the channel is being frozen";
+
+    instrument->audioChannel->setFreezing( false );
+
+    ASSERT_TRUE( AudioRenderer::renderAsync( 0, 255, instruments, false, false ));
+
+    while ( AudioRenderer::isRendering())
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ));
+
+    AudioBuffer* output = AudioRenderer::getResult();
+
+    ASSERT_FALSE( output == nullptr ) << "expected result to be available after rendering";
+    EXPECT_FALSE( instrument->audioChannel->isFreezing() ) << "expected channel to be rendered by the engine again";
+    ASSERT_TRUE( AudioRenderer::getResult() == nullptr ) << "expected result to be retrievable only once";
+
+    for ( int c = 0; c < buffer->amountOfChannels; ++c ) {
+        for ( int i = 0; i < buffer->bufferSize; ++i ) {
+            EXPECT_NEAR( buffer->getBufferForChannel( c )[ i ], output->getBufferForChannel( c )[ i ], 0.0001 );
+        }
+    }
+    delete output;
+
+    // render to sample
+
+    std::string sampleKey = "mwengine_audiorenderer_test";
+
+    ASSERT_TRUE( AudioRenderer::renderToSample( sampleKey, 0, 127, instruments, false, false ));
+    ASSERT_TRUE( SampleManager::hasSample( sampleKey )) << "expected rendered buffer to be registered as a sample";
+    EXPECT_EQ( 128, SampleManager::getSampleLength( sampleKey ));
+
+    SampleManager::removeSample( sampleKey, true );
+
+    delete event;
+    delete instrument;
+    delete buffer;
+}
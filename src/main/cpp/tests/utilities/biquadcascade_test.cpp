@@ -0,0 +1,187 @@
+#include "../../utilities/biquadcascade.h"
+
+// transposed direct form II reference for a single section over a single channel
+
+void biquadReference( SAMPLE_TYPE* buffer, int length, SAMPLE_TYPE* coefficients, SAMPLE_TYPE* state )
+{
+    for ( int i = 0; i < length; ++i )
+    {
+        SAMPLE_TYPE input  = buffer[ i ];
+        SAMPLE_TYPE output = coefficients[ 0 ] * input + state[ 0 ];
+
+        state[ 0 ] = coefficients[ 1 ] * input - coefficients[ 3 ] * output + state[ 1 ];
+        state[ 1 ] = coefficients[ 2 ] * input - coefficients[ 4 ] * output;
+        buffer[ i ] = output;
+    }
+}
+
+// low pass coefficients (normalized) for given cutoff frequency
+
+void lowPassCoefficients( SAMPLE_TYPE* coefficients, SAMPLE_TYPE cutoff )
+{
+    SAMPLE_TYPE w0    = TWO_PI * cutoff / ( SAMPLE_TYPE ) AudioEngineProps::SAMPLE_RATE;
+    SAMPLE_TYPE alpha = sin( w0 ) / 1.4;
+    SAMPLE_TYPE a0    = 1.0 + alpha;
+
+    coefficients[ 0 ] = (( 1.0 - cos( w0 )) / 2 ) / a0;
+    coefficients[ 1 ] = ( 1.0 - cos( w0 )) / a0;
+    coefficients[ 2 ] = coefficients[ 0 ];
+    coefficients[ 3 ] = ( -2.0 * cos( w0 )) / a0;
+    coefficients[ 4 ] = ( 1.0 - alpha ) / a0;
+}
+
+TEST( BiquadCascade, Process )
+{
+    int channels   = 3; // spans a partially filled group of lanes
+    int sections   = 2;
+    int bufferSize = randomInt( 64, 512 );
+
+    SAMPLE_TYPE coefficients[ 2 ][ 5 ];
+    lowPassCoefficients( coefficients[ 0 ], randomFloat( 100.f, 5000.f ));
+    lowPassCoefficients( coefficients[ 1 ], randomFloat( 100.f, 5000.f ));
+
+    BiquadCascade* cascade = new BiquadCascade( channels, sections );
+
+    EXPECT_EQ( channels, cascade->getAmountOfChannels() );
+    EXPECT_EQ( sections, cascade->getAmountOfSections() );
+
+    for ( int s = 0; s < sections; ++s )
+        cascade->setCoefficients( s, coefficients[ s ][ 0 ], coefficients[ s ][ 1 ], coefficients[ s ][ 2 ],
+                                     coefficients[ s ][ 3 ], coefficients[ s ][ 4 ] );
+
+    AudioBuffer* buffer   = fillAudioBuffer( new AudioBuffer( channels, bufferSize ));
+    AudioBuffer* expected = buffer->clone();
+
+    for ( int c = 0; c < channels; ++c )
+    {
+        for ( int s = 0; s < sections; ++s ) {
+            SAMPLE_TYPE state[ 2 ] = { 0.0 };
+            biquadReference( expected->getBufferForChannel( c ), bufferSize, coefficients[ s ], state );
+        }
+    }
+
+    // process in two parts to ensure the state carries over
+
+    int split = bufferSize / 3;
+    cascade->process( buffer, channels, 0, split );
+    cascade->process( buffer, channels, split, bufferSize - split );
+
+    for ( int c = 0; c < channels; ++c )
+    {
+        for ( int i = 0; i < bufferSize; ++i ) {
+            EXPECT_NEAR( expected->getBufferForChannel( c )[ i ], buffer->getBufferForChannel( c )[ i ], 1e-9 )
+                << "expected matching output for channel " << c << " at index " << i;
+        }
+    }
+
+    delete cascade;
+    delete buffer;
+    delete expected;
+}
+
+TEST( BiquadCascade, MonoSource )
+{
+    int bufferSize = randomInt( 64, 512 );
+    SAMPLE_TYPE coefficients[ 5 ];
+    lowPassCoefficients( coefficients, randomFloat( 100.f, 5000.f ));
+
+    BiquadCascade* cascade = new BiquadCascade( 2, 1 );
+    cascade->setCoefficients( 0, coefficients[ 0 ], coefficients[ 1 ], coefficients[ 2 ], coefficients[ 3 ], coefficients[ 4 ] );
+
+    AudioBuffer* buffer   = fillAudioBuffer( new AudioBuffer( 2, bufferSize ));
+    AudioBuffer* expected = buffer->clone();
+
+    SAMPLE_TYPE state[ 2 ] = { 0.0 };
+    biquadReference( expected->getBufferForChannel( 0 ), bufferSize, coefficients, state );
+
+    cascade->process( buffer, true );
+
+    for ( int i = 0; i < bufferSize; ++i )
+    {
+        EXPECT_NEAR( expected->getBufferForChannel( 0 )[ i ], buffer->getBufferForChannel( 0 )[ i ], 1e-9 )
+            << "expected matching output at index " << i;
+
+        EXPECT_EQ( buffer->getBufferForChannel( 0 )[ i ], buffer->getBufferForChannel( 1 )[ i ] )
+            << "expected mono source to be copied into the second channel at index " << i;
+    }
+
+    delete cascade;
+    delete buffer;
+    delete expected;
+}
+
+TEST( BiquadCascade, RampCoefficients )
+{
+    int bufferSize = 256;
+    int rampLength = randomInt( 1, 200 );
+
+    SAMPLE_TYPE from[ 5 ], to[ 5 ];
+    lowPassCoefficients( from, 200.f );
+    lowPassCoefficients( to,   4000.f );
+
+    BiquadCascade* cascade = new BiquadCascade( 1, 1 );
+    cascade->setCoefficients( 0, from[ 0 ], from[ 1 ], from[ 2 ], from[ 3 ], from[ 4 ] );
+    cascade->rampCoefficients( 0, to[ 0 ], to[ 1 ], to[ 2 ], to[ 3 ], to[ 4 ], rampLength );
+
+    AudioBuffer* buffer   = fillAudioBuffer( new AudioBuffer( 1, bufferSize ));
+    AudioBuffer* expected = buffer->clone();
+
+    // reference interpolates the coefficients after each sample
+
+    SAMPLE_TYPE* reference = expected->getBufferForChannel( 0 );
+    SAMPLE_TYPE state[ 2 ] = { 0.0 };
+    SAMPLE_TYPE current[ 5 ];
+
+    for ( int i = 0; i < bufferSize; ++i )
+    {
+        SAMPLE_TYPE progress = std::min( 1.0, ( SAMPLE_TYPE ) i / ( SAMPLE_TYPE ) rampLength );
+
+        for ( int k = 0; k < 5; ++k )
+            current[ k ] = from[ k ] + ( to[ k ] - from[ k ]) * progress;
+
+        biquadReference( &reference[ i ], 1, current, state );
+    }
+
+    for ( int i = 0; i < bufferSize; i += 32 )
+        cascade->process( buffer, 1, i, 32 );
+
+    for ( int i = 0; i < bufferSize; ++i ) {
+        EXPECT_NEAR( reference[ i ], buffer->getBufferForChannel( 0 )[ i ], 1e-6 )
+            << "expected interpolated output at index " << i << " for ramp of " << rampLength << " samples";
+    }
+
+    delete cascade;
+    delete buffer;
+    delete expected;
+}
+
+TEST( BiquadCascade, StoreRestore )
+{
+    int bufferSize = randomInt( 64, 512 );
+    SAMPLE_TYPE coefficients[ 5 ];
+    lowPassCoefficients( coefficients, randomFloat( 100.f, 5000.f ));
+
+    BiquadCascade* cascade = new BiquadCascade( 1, 1 );
+    cascade->setCoefficients( 0, coefficients[ 0 ], coefficients[ 1 ], coefficients[ 2 ], coefficients[ 3 ], coefficients[ 4 ] );
+
+    // fill the filter history
+
+    AudioBuffer* buffer = fillAudioBuffer( new AudioBuffer( 1, bufferSize ));
+    cascade->process( buffer, false );
+
+    fillAudioBuffer( buffer );
+    AudioBuffer* copy = buffer->clone();
+
+    cascade->store();
+    cascade->process( buffer, false );
+    cascade->restore();
+
+    for ( int i = 0; i < bufferSize; ++i ) {
+        EXPECT_EQ( buffer->getBufferForChannel( 0 )[ i ], cascade->processSample( copy->getBufferForChannel( 0 )[ i ], 0 ))
+            << "expected restored state to produce the same output at index " << i;
+    }
+
+    delete cascade;
+    delete buffer;
+    delete copy;
+}
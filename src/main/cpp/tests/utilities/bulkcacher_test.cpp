@@ -0,0 +1,140 @@
+#include "../../utilities/bulkcacher.h"
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+// cacheable event that registers the order in which it was cached
+
+class BulkCacherTestEvent : public BaseCacheableAudioEvent
+{
+    public:
+        BulkCacherTestEvent( std::vector<BulkCacherTestEvent*>* order, std::mutex* lock ) : BaseCacheableAudioEvent( nullptr ) {
+            _order = order;
+            _orderLock = lock;
+        }
+
+        ~BulkCacherTestEvent() {
+            Sequencer::bulkCacher->removeFromQueue( this );
+        }
+
+        void cache( bool doCallback ) {
+            std::this_thread::sleep_for( std::chrono::milliseconds( 2 ));
+
+            std::lock_guard<std::mutex> guard( *_orderLock );
+            _order->push_back( this );
+            _cachingCompleted = true;
+        }
+
+    protected:
+        std::vector<BulkCacherTestEvent*>* _order;
+        std::mutex* _orderLock;
+};
+
+void waitForBulkCacher( BulkCacher* cacher )
+{
+    while ( cacher->hasQueue())
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ));
+}
+
+TEST( BulkCacher, PrioritisedQueue )
+{
+    int orgPosition    = AudioEngine::bufferPosition;
+    int orgMinPosition = AudioEngine::min_buffer_position;
+    int orgMaxPosition = AudioEngine::max_buffer_position;
+
+    AudioEngine::min_buffer_position = 0;
+    AudioEngine::max_buffer_position = 9999;
+    AudioEngine::bufferPosition      = 4000;
+
+    std::vector<BulkCacherTestEvent*> order;
+    std::mutex orderLock;
+
+    BulkCacher* cacher = new BulkCacher( true );
+
+    // events at increasing distance from the playhead (the last lies behind the playhead and will play after looping)
+
+    BulkCacherTestEvent* event1 = new BulkCacherTestEvent( &order, &orderLock );
+    BulkCacherTestEvent* event2 = new BulkCacherTestEvent( &order, &orderLock );
+    BulkCacherTestEvent* event3 = new BulkCacherTestEvent( &order, &orderLock );
+    BulkCacherTestEvent* event4 = new BulkCacherTestEvent( &order, &orderLock );
+
+    event1->setEventStart( 4500 );
+    event2->setEventStart( 6000 );
+    event3->setEventStart( 9000 );
+    event4->setEventStart( 1000 );
+
+    std::vector<BaseCacheableAudioEvent*> events = { event3, event4, event1, event2 };
+    cacher->addToQueue( &events );
+    cacher->addToQueue( event1 );
+
+    EXPECT_EQ( 4, cacher->getQueueSize() ) << "expected events to be queued only once";
+
+    // removed events should not be cached
+
+    BulkCacherTestEvent* event5 = new BulkCacherTestEvent( &order, &orderLock );
+    event5->setEventStart( 4100 );
+    cacher->addToQueue( event5 );
+
+    ASSERT_TRUE( cacher->removeFromQueue( event5 ));
+    ASSERT_FALSE( cacher->removeFromQueue( event5 ));
+
+    cacher->cacheQueue();
+    waitForBulkCacher( cacher );
+
+    ASSERT_EQ( 4, ( int ) order.size() ) << "expected all queued events to have been cached";
+
+    EXPECT_EQ( event1, order.at( 0 )) << "expected events to be cached by distance from the playhead";
+    EXPECT_EQ( event2, order.at( 1 ));
+    EXPECT_EQ( event3, order.at( 2 ));
+    EXPECT_EQ( event4, order.at( 3 ));
+
+    ASSERT_FALSE( event5->isCached() );
+
+    // cached events are not queued again
+
+    cacher->addToQueue( event1 );
+    EXPECT_EQ( 0, cacher->getQueueSize() );
+
+    delete cacher;
+    delete event1;
+    delete event2;
+    delete event3;
+    delete event4;
+    delete event5;
+
+    AudioEngine::bufferPosition      = orgPosition;
+    AudioEngine::min_buffer_position = orgMinPosition;
+    AudioEngine::max_buffer_position = orgMaxPosition;
+}
+
+TEST( BulkCacher, ConcurrentCaching )
+{
+    std::vector<BulkCacherTestEvent*> order;
+    std::mutex orderLock;
+
+    BulkCacher* cacher = new BulkCacher( false );
+    std::vector<BulkCacherTestEvent*> events;
+
+    for ( int i = 0; i < 32; ++i ) {
+        events.push_back( new BulkCacherTestEvent( &order, &orderLock ));
+        cacher->addToQueue( events.back() );
+    }
+    cacher->cacheQueue();
+
+    // events queued after starting are cached as they are added
+
+    BulkCacherTestEvent* lateEvent = new BulkCacherTestEvent( &order, &orderLock );
+    cacher->addToQueue( lateEvent );
+
+    waitForBulkCacher( cacher );
+
+    EXPECT_EQ( 33, ( int ) order.size() ) << "expected all events to have been cached";
+    ASSERT_TRUE( lateEvent->isCached() );
+
+    delete cacher;
+
+    for ( size_t i = 0; i < events.size(); ++i )
+        delete events.at( i );
+
+    delete lateEvent;
+}
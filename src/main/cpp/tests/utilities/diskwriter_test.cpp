@@ -0,0 +1,178 @@
+#include "../../utilities/diskwriter.h"
+#include "../../utilities/wavereader.h"
+#include "../../utilities/wavewriter.h"
+#include "../../definitions/notifications.h"
+#include <fstream>
+#include <cstdio>
+
+TEST( DiskWriter, StreamingRecording )
+{
+    std::string outputFile = "mwengine_diskwriter_test.wav";
+
+    int amountOfChannels = 2;
+    int bufferSize       = 256;
+    int iterations       = 10;
+
+    DiskWriter::prepare( outputFile, bufferSize, amountOfChannels );
+
+    float* buffer = new float[ bufferSize * amountOfChannels ];
+
+    for ( int i = 0; i < iterations; ++i )
+    {
+        for ( int j = 0, l = bufferSize * amountOfChannels; j < l; ++j )
+            buffer[ j ] = ( float ) i / iterations;
+
+        DiskWriter::appendBuffer( buffer, bufferSize, amountOfChannels );
+    }
+
+    ASSERT_FALSE( DiskWriter::bufferFull() ) << "expected snippets to no longer be used";
+    ASSERT_TRUE( DiskWriter::finish() ) << "expected recording to have completed";
+    ASSERT_FALSE( DiskWriter::finish() ) << "expected recording to have been completed only once";
+
+    EXPECT_EQ( 0UL, DiskWriter::getDroppedFrames() );
+
+    waveFile WAV = WaveReader::fileToBuffer( outputFile );
+
+    ASSERT_FALSE( WAV.buffer == nullptr ) << "expected a valid WAV file to have been written";
+    EXPECT_EQ( bufferSize * iterations, WAV.buffer->bufferSize ) << "expected all recorded frames to have been written";
+
+    for ( int i = 0; i < iterations; ++i ) {
+        EXPECT_NEAR(( SAMPLE_TYPE ) i / iterations, WAV.buffer->getBufferForChannel( 1 )[ i * bufferSize ], 0.0001 )
+            << "expected recorded contents to have been written in order";
+    }
+
+    delete WAV.buffer;
+    delete[] buffer;
+
+    remove( outputFile.c_str() );
+}
+
+TEST( DiskWriter, FinishAsync )
+{
+    std::string outputFile = "mwengine_diskwriter_async_test.wav";
+
+    int amountOfChannels = 2;
+    int bufferSize       = 256;
+    int iterations       = 10;
+
+    DiskWriter::prepare( outputFile, bufferSize, amountOfChannels );
+
+    float* buffer = new float[ bufferSize * amountOfChannels ];
+
+    for ( int i = 0; i < iterations; ++i )
+    {
+        for ( int j = 0, l = bufferSize * amountOfChannels; j < l; ++j )
+            buffer[ j ] = 0.5f;
+
+        DiskWriter::appendBuffer( buffer, bufferSize, amountOfChannels );
+    }
+
+    // finishing asynchronously returns immediately, subsequent appends are ignored
+
+    DiskWriter::finishAsync( Notifications::BOUNCE_COMPLETE );
+    DiskWriter::appendBuffer( buffer, bufferSize, amountOfChannels );
+
+    ASSERT_FALSE( DiskWriter::finish() ) << "expected recording to have been completed asynchronously";
+
+    waveFile WAV = WaveReader::fileToBuffer( outputFile );
+
+    ASSERT_FALSE( WAV.buffer == nullptr ) << "expected a valid WAV file to have been written";
+    EXPECT_EQ( bufferSize * iterations, WAV.buffer->bufferSize ) << "expected all recorded frames to have been written";
+
+    delete WAV.buffer;
+    delete[] buffer;
+
+    remove( outputFile.c_str() );
+}
+
+TEST( DiskWriter, StemRecording )
+{
+    std::string directory = ".";
+    int amountOfChannels  = 2;
+    int bufferSize        = 128;
+    int iterations        = 4;
+
+    std::vector<AudioChannel*> channels;
+    channels.push_back( new AudioChannel( 1.f ));
+    channels.push_back( new AudioChannel( 1.f ));
+
+    DiskWriter::prepare( directory + "/master.wav", bufferSize, amountOfChannels );
+
+    ASSERT_FALSE( DiskWriter::hasStems() );
+
+    DiskWriter::prepareStems( directory, channels, bufferSize );
+
+    ASSERT_TRUE( DiskWriter::hasStems() );
+    EXPECT_EQ( ".wav", DiskWriter::getFileExtension() );
+
+    AudioBuffer* buffer = new AudioBuffer( amountOfChannels, bufferSize );
+
+    for ( int i = 0; i < iterations; ++i )
+    {
+        for ( int c = 0; c < amountOfChannels; ++c ) {
+            for ( int j = 0; j < bufferSize; ++j )
+                buffer->getBufferForChannel( c )[ j ] = 0.5;
+        }
+        // second channel is recorded at half volume
+        DiskWriter::appendStem( channels.at( 0 ), buffer, bufferSize, 1.f );
+        DiskWriter::appendStem( channels.at( 1 ), buffer, bufferSize, .5f );
+        DiskWriter::appendBuffer( buffer );
+    }
+    ASSERT_TRUE( DiskWriter::finish() );
+    ASSERT_FALSE( DiskWriter::hasStems() ) << "expected stem recording to have completed";
+
+    std::string files[ 3 ]     = { "/master.wav", "/channel_0.wav", "/channel_1.wav" };
+    SAMPLE_TYPE expected[ 3 ] = { 0.5, 0.5, 0.25 };
+
+    for ( int f = 0; f < 3; ++f )
+    {
+        waveFile WAV = WaveReader::fileToBuffer( directory + files[ f ] );
+
+        ASSERT_FALSE( WAV.buffer == nullptr ) << "expected file " << files[ f ] << " to have been written";
+        EXPECT_EQ( bufferSize * iterations, WAV.buffer->bufferSize );
+        EXPECT_NEAR( expected[ f ], WAV.buffer->getBufferForChannel( 1 )[ bufferSize ], 0.0001 )
+            << "expected file " << files[ f ] << " to contain the recorded output";
+
+        delete WAV.buffer;
+        remove(( directory + files[ f ] ).c_str() );
+    }
+
+    delete buffer;
+    delete channels.at( 0 );
+    delete channels.at( 1 );
+}
+
+TEST( DiskWriter, RecoverRecordings )
+{
+    std::string outputFile = "./mwengine_diskwriter_recover_test.wav";
+    int amountOfFrames     = 256;
+
+    // simulate a recording interrupted by termination of the application (e.g. its
+    // header describes no data and its journal was never removed)
+
+    std::ofstream stream = WaveWriter::createWAVStream( outputFile.c_str(), 0, 44100, 1 );
+    std::vector<INT16> frames( amountOfFrames, 0 );
+    stream.write(( const char* ) frames.data(), frames.size() * sizeof( INT16 ));
+    stream.close();
+
+    std::string journalFile = RecordingStream::getJournalFile( outputFile );
+    std::ofstream journal( journalFile.c_str() );
+    journal << outputFile;
+    journal.close();
+
+    std::vector<std::string> recovered = DiskWriter::recoverRecordings( "." );
+
+    ASSERT_EQ( 1, ( int ) recovered.size() ) << "expected a single recording to have been recovered";
+    EXPECT_EQ( outputFile, recovered.at( 0 ));
+    ASSERT_FALSE( std::ifstream( journalFile.c_str() ).good() ) << "expected journal to have been removed";
+
+    waveFile WAV = WaveReader::fileToBuffer( outputFile );
+
+    ASSERT_FALSE( WAV.buffer == nullptr );
+    EXPECT_EQ( amountOfFrames, WAV.buffer->bufferSize ) << "expected all written frames to have been recovered";
+
+    ASSERT_EQ( 0, ( int ) DiskWriter::recoverRecordings( "." ).size() ) << "expected nothing left to recover";
+
+    delete WAV.buffer;
+    remove( outputFile.c_str() );
+}
@@ -0,0 +1,74 @@
+#include "../../utilities/fft.h"
+
+TEST( FFT, Forward )
+{
+    int sizes[] = { 4, 8, 64, 1024 };
+
+    for ( int size : sizes )
+    {
+        FFT* fft    = new FFT( size );
+        float* data = new float[ size + 2 ];
+        float* src  = new float[ size ];
+
+        ASSERT_EQ( size, fft->getSize() );
+
+        for ( int i = 0; i < size; ++i )
+            data[ i ] = src[ i ] = randomFloat( -1.f, 1.f );
+
+        fft->forward( data );
+
+        // compare against the naive DFT
+
+        for ( int k = 0; k <= size / 2; ++k )
+        {
+            double real = 0.0, imag = 0.0;
+
+            for ( int n = 0; n < size; ++n ) {
+                double angle = -2.0 * M_PI * ( double ) k * ( double ) n / ( double ) size;
+                real += src[ n ] * cos( angle );
+                imag += src[ n ] * sin( angle );
+            }
+            EXPECT_NEAR( real, data[ k * 2 ],     1e-3 ) << "expected matching real part for bin " << k << " at size " << size;
+            EXPECT_NEAR( imag, data[ k * 2 + 1 ], 1e-3 ) << "expected matching imaginary part for bin " << k << " at size " << size;
+        }
+
+        delete fft;
+        delete[] data;
+        delete[] src;
+    }
+}
+
+TEST( FFT, Inverse )
+{
+    int size    = 2048;
+    FFT* fft    = new FFT( size );
+    float* data = new float[ size + 2 ];
+    float* src  = new float[ size ];
+
+    for ( int i = 0; i < size; ++i )
+        data[ i ] = src[ i ] = randomFloat( -1.f, 1.f );
+
+    fft->forward( data );
+    fft->inverse( data );
+
+    for ( int i = 0; i < size; ++i )
+        EXPECT_NEAR( src[ i ], data[ i ] / size, 1e-5 ) << "expected inverse transform to restore the input at " << i;
+
+    delete fft;
+    delete[] data;
+    delete[] src;
+}
+
+TEST( FFT, Window )
+{
+    int size = 512;
+    FFT* fft = new FFT( size );
+
+    float* window = fft->getWindow();
+
+    EXPECT_FLOAT_EQ( 0.f, window[ 0 ] );
+    EXPECT_FLOAT_EQ( 1.f, window[ size / 2 ] );
+    EXPECT_NEAR( window[ 1 ], window[ size - 1 ], 1e-6 ) << "expected periodic Hann window to be symmetrical";
+
+    delete fft;
+}
@@ -0,0 +1,82 @@
+#include "../../utilities/freezer.h"
+
+TEST( Freezer, Freeze )
+{
+    AudioEngine::setup( 64, 48000, 2 );
+
+    int orgMinPosition  = AudioEngine::min_buffer_position;
+    int orgMaxPosition  = AudioEngine::max_buffer_position;
+    bool orgPlayState   = Sequencer::playing;
+
+    AudioEngine::min_buffer_position = 0;
+    AudioEngine::max_buffer_position = 511;
+    Sequencer::playing               = false;
+
+    BaseInstrument* instrument = new BaseInstrument();
+    BaseAudioEvent* event      = new BaseAudioEvent( instrument );
+    AudioBuffer* buffer        = new AudioBuffer( 1, 100 );
+
+    for ( int i = 0; i < buffer->bufferSize; ++i )
+        buffer->getBufferForChannel( 0 )[ i ] = .5;
+
+    event->setBuffer( buffer, false );
+    event->setEventLength( buffer->bufferSize );
+    event->addToSequencer();
+
+    Freezer::freeze( instrument );
+
+    ASSERT_TRUE( Freezer::isFrozen( instrument ));
+
+    Freezer::update(); // freeze synchronously
+
+    ASSERT_TRUE( instrument->audioChannel->isFrozen() ) << "expected frozen buffer to have been rendered";
+    ASSERT_FALSE( Freezer::hasPendingFreezes() );
+
+    AudioBuffer* output = new AudioBuffer( 2, 16 );
+    instrument->audioChannel->readFrozenBuffer( output, 96 );
+
+    EXPECT_EQ( .5, output->getBufferForChannel( 0 )[ 3 ] ) << "expected frozen buffer to contain the event";
+    EXPECT_EQ( 0., output->getBufferForChannel( 0 )[ 4 ] ) << "expected frozen buffer to be silent after the event";
+
+    // changing the event during playback should restore real time rendering
+    // and postpone rendering the frozen buffer until playback stops
+
+    Sequencer::playing = true;
+    event->setEventStart( 200 );
+    Freezer::update();
+
+    ASSERT_FALSE( instrument->audioChannel->isFrozen() ) << "expected frozen buffer to be discarded after a change";
+    ASSERT_TRUE( Freezer::hasPendingFreezes() );
+
+    Sequencer::playing = false;
+    Freezer::update();
+
+    ASSERT_TRUE( instrument->audioChannel->isFrozen() ) << "expected frozen buffer to have been rebuilt";
+
+    output->silenceBuffers();
+    instrument->audioChannel->readFrozenBuffer( output, 96 );
+
+    EXPECT_EQ( 0., output->getBufferForChannel( 0 )[ 3 ] ) << "expected frozen buffer to reflect the changed event";
+
+    // explicit invalidation
+
+    Sequencer::playing = true;
+    Freezer::invalidate( instrument );
+
+    ASSERT_FALSE( instrument->audioChannel->isFrozen() );
+    ASSERT_TRUE( Freezer::hasPendingFreezes() );
+
+    Freezer::unfreeze( instrument );
+
+    ASSERT_FALSE( Freezer::isFrozen( instrument ));
+    ASSERT_FALSE( Freezer::hasPendingFreezes() );
+
+    AudioEngine::min_buffer_position = orgMinPosition;
+    AudioEngine::max_buffer_position = orgMaxPosition;
+    Sequencer::playing               = orgPlayState;
+
+    delete output;
+    delete event;
+    delete instrument;
+    delete buffer;
+}
@@ -0,0 +1,116 @@
+#include "../../utilities/inputcapture.h"
+#include "../../drivers/adapter.h"
+#include "../../utilities/diskwriter.h"
+#include "../../utilities/wavereader.h"
+#include <cstdio>
+
+TEST( InputCapture, Latency )
+{
+    InputCapture::setLatency( 512 );
+    EXPECT_EQ( 512, InputCapture::getLatency() ) << "expected set latency to be returned";
+
+    InputCapture::setLatency( -1 );
+    EXPECT_EQ( DriverAdapter::getLatency(), InputCapture::getLatency() )
+        << "expected driver estimate to be returned when no latency is set";
+}
+
+TEST( InputCapture, Calibration )
+{
+    int amountOfChannels = 2;
+    int bufferSize       = 64;
+    int roundTrip        = 150; // simulated round trip in samples
+
+    float* outputBuffer     = new float[ bufferSize * amountOfChannels ];
+    AudioBuffer* inputBuffer = new AudioBuffer( 1, bufferSize );
+
+    InputCapture::setLatency( -1 );
+    InputCapture::startCalibration();
+
+    ASSERT_TRUE( InputCapture::isCalibrating() );
+
+    // the loopback delays everything written to the output by roundTrip samples
+
+    float* loopback = new float[ bufferSize * 8 ]();
+
+    for ( int cycle = 0; cycle < 6 && InputCapture::isCalibrating(); ++cycle )
+    {
+        inputBuffer->silenceBuffers();
+        SAMPLE_TYPE* input = inputBuffer->getBufferForChannel( 0 );
+
+        for ( int i = 0; i < bufferSize; ++i ) {
+            int readIndex = cycle * bufferSize + i - roundTrip;
+            input[ i ] = ( readIndex >= 0 ) ? loopback[ readIndex ] : 0.0;
+        }
+
+        InputCapture::processInput( inputBuffer, bufferSize, false );
+
+        for ( int i = 0, l = bufferSize * amountOfChannels; i < l; ++i )
+            outputBuffer[ i ] = 0.f;
+
+        InputCapture::processOutput( outputBuffer, bufferSize, amountOfChannels );
+
+        for ( int i = 0; i < bufferSize; ++i )
+            loopback[ cycle * bufferSize + i ] = outputBuffer[ i * amountOfChannels ];
+    }
+
+    ASSERT_FALSE( InputCapture::isCalibrating() ) << "expected calibration to have completed";
+
+    EXPECT_EQ( roundTrip, InputCapture::getLatency() ) << "expected measured latency to equal the round trip";
+
+    InputCapture::setLatency( -1 );
+
+    delete[] loopback;
+    delete[] outputBuffer;
+    delete inputBuffer;
+}
+
+TEST( InputCapture, LatencyCompensatedRecording )
+{
+    std::string outputFile = "mwengine_inputcapture_test.wav";
+
+    int bufferSize = 100;
+    int latency    = 150;
+    int iterations = 5;
+
+    AudioBuffer* inputBuffer = new AudioBuffer( 1, bufferSize );
+
+    InputCapture::setLatency( latency );
+    DiskWriter::prepare( outputFile, bufferSize, 1 );
+    InputCapture::prepare();
+
+    // each input sample contains its own frame index (scaled)
+
+    for ( int i = 0; i < iterations; ++i )
+    {
+        SAMPLE_TYPE* input = inputBuffer->getBufferForChannel( 0 );
+
+        for ( int j = 0; j < bufferSize; ++j )
+            input[ j ] = ( SAMPLE_TYPE )( i * bufferSize + j ) / 1000.0;
+
+        InputCapture::processInput( inputBuffer, bufferSize, true );
+    }
+    ASSERT_TRUE( DiskWriter::finish() ) << "expected recording to have completed";
+
+    EXPECT_EQ( AudioEngine::bufferPosition, InputCapture::getRecordingStartPosition() )
+        << "expected start position to equal the sequencer position at the start of the recording";
+
+    waveFile WAV = WaveReader::fileToBuffer( outputFile );
+
+    ASSERT_FALSE( WAV.buffer == nullptr ) << "expected a valid WAV file to have been written";
+    ASSERT_EQ( bufferSize * iterations - latency, WAV.buffer->bufferSize )
+        << "expected the input received during the latency period to have been omitted";
+
+    EXPECT_NEAR(( SAMPLE_TYPE ) latency / 1000.0, WAV.buffer->getBufferForChannel( 0 )[ 0 ], 0.0001 )
+        << "expected the recording to start at the latency compensated input frame";
+
+    EXPECT_NEAR(( SAMPLE_TYPE )( bufferSize * iterations - 1 ) / 1000.0,
+                WAV.buffer->getBufferForChannel( 0 )[ WAV.buffer->bufferSize - 1 ], 0.0001 )
+        << "expected the recording to end at the last input frame";
+
+    InputCapture::setLatency( -1 );
+
+    delete WAV.buffer;
+    delete inputBuffer;
+
+    remove( outputFile.c_str() );
+}
@@ -0,0 +1,130 @@
+#include "../../utilities/levelmeter.h"
+
+void fillBuffer( AudioBuffer* buffer, SAMPLE_TYPE value )
+{
+    for ( int c = 0; c < buffer->amountOfChannels; ++c ) {
+        SAMPLE_TYPE* channelBuffer = buffer->getBufferForChannel( c );
+        for ( int i = 0; i < buffer->bufferSize; ++i )
+            channelBuffer[ i ] = value;
+    }
+}
+
+TEST( LevelMeter, DisabledByDefault )
+{
+    EXPECT_FALSE( LevelMeter::isEnabled() )         << "expected metering to be opt-in";
+    EXPECT_FALSE( LevelMeter::isTruePeakEnabled() ) << "expected true-peak detection to be opt-in";
+}
+
+TEST( LevelMeter, MeasureAndRead )
+{
+    LevelMeter::reset();
+
+    AudioBuffer* master  = new AudioBuffer( 2, 64 );
+    AudioBuffer* channel = new AudioBuffer( 1, 64 );
+
+    fillBuffer( master,   0.5 );
+    fillBuffer( channel, -0.25 );
+
+    LevelMeter::measure( 0, LevelMeter::MASTER_ID, master, 64, 1.0 );
+    LevelMeter::measure( 1, 7, channel, 64, 2.0 );
+    LevelMeter::publish( 2, 64 );
+
+    float levels[ LevelMeter::MAX_METERS * LevelMeter::STRIDE ];
+
+    ASSERT_EQ( 2, LevelMeter::read( levels, LevelMeter::MAX_METERS ))
+        << "expected the master bus and a single channel to have been published";
+
+    EXPECT_EQ( LevelMeter::MASTER_ID, ( int ) levels[ LevelMeter::ID ] );
+    EXPECT_FLOAT_EQ( 0.5f, levels[ LevelMeter::PEAK_LEFT ] );
+    EXPECT_FLOAT_EQ( 0.5f, levels[ LevelMeter::PEAK_RIGHT ] );
+    EXPECT_FLOAT_EQ( 0.5f, levels[ LevelMeter::RMS_LEFT ] );
+    EXPECT_FLOAT_EQ( 0.5f, levels[ LevelMeter::RMS_RIGHT ] );
+    EXPECT_GE( levels[ LevelMeter::TRUE_PEAK_LEFT ], levels[ LevelMeter::PEAK_LEFT ] );
+
+    float* channelLevels = &levels[ LevelMeter::STRIDE ];
+
+    EXPECT_EQ( 7, ( int ) channelLevels[ LevelMeter::ID ] );
+    EXPECT_FLOAT_EQ( 0.5f, channelLevels[ LevelMeter::PEAK_LEFT ] )  << "expected gain to have been applied";
+    EXPECT_FLOAT_EQ( 0.5f, channelLevels[ LevelMeter::PEAK_RIGHT ] ) << "expected mono buffer to be metered on both sides";
+    EXPECT_FLOAT_EQ( 0.5f, channelLevels[ LevelMeter::RMS_LEFT ] );
+
+    ASSERT_EQ( 1, LevelMeter::read( levels, 1 )) << "expected read to be limited to the given amount of meters";
+
+    delete master;
+    delete channel;
+}
+
+TEST( LevelMeter, AccumulateUntilRead )
+{
+    LevelMeter::reset();
+
+    AudioBuffer* buffer = new AudioBuffer( 2, 32 );
+    float levels[ LevelMeter::MAX_METERS * LevelMeter::STRIDE ];
+
+    // two cycles rendered before the reader polls
+
+    fillBuffer( buffer, 0.8 );
+    LevelMeter::measure( 0, LevelMeter::MASTER_ID, buffer, 32, 1.0 );
+    LevelMeter::publish( 1, 32 );
+
+    fillBuffer( buffer, 0.2 );
+    LevelMeter::measure( 0, LevelMeter::MASTER_ID, buffer, 32, 1.0 );
+    LevelMeter::publish( 1, 32 );
+
+    LevelMeter::read( levels, 1 );
+
+    EXPECT_FLOAT_EQ( 0.8f, levels[ LevelMeter::PEAK_LEFT ] )
+        << "expected the peak of the first cycle to have been retained until read";
+    EXPECT_NEAR( sqrt(( 0.64 + 0.04 ) / 2 ), levels[ LevelMeter::RMS_LEFT ], 0.0001 )
+        << "expected RMS to cover both cycles";
+
+    // new cycle after read
+
+    LevelMeter::measure( 0, LevelMeter::MASTER_ID, buffer, 32, 1.0 );
+    LevelMeter::publish( 1, 32 );
+    LevelMeter::read( levels, 1 );
+
+    EXPECT_FLOAT_EQ( 0.2f, levels[ LevelMeter::PEAK_LEFT ] )
+        << "expected a new measurement window to have started after reading";
+
+    delete buffer;
+}
+
+TEST( LevelMeter, TruePeak )
+{
+    LevelMeter::reset();
+
+    // a sine at a quarter of the sample rate with its phase offset by 45 degrees
+    // has all of its samples at +/- 0.707 while the actual waveform peaks at 1.0
+
+    int bufferSize      = 256;
+    AudioBuffer* buffer = new AudioBuffer( 1, bufferSize );
+    SAMPLE_TYPE* samples = buffer->getBufferForChannel( 0 );
+
+    for ( int i = 0; i < bufferSize; ++i )
+        samples[ i ] = sin( PI / 2 * i + PI / 4 );
+
+    float levels[ LevelMeter::MAX_METERS * LevelMeter::STRIDE ];
+
+    LevelMeter::setTruePeakEnabled( false );
+    LevelMeter::measure( 0, LevelMeter::MASTER_ID, buffer, bufferSize, 1.0 );
+    LevelMeter::publish( 1, bufferSize );
+    LevelMeter::read( levels, 1 );
+
+    EXPECT_NEAR( 0.707f, levels[ LevelMeter::PEAK_LEFT ], 0.001f );
+    EXPECT_FLOAT_EQ( levels[ LevelMeter::PEAK_LEFT ], levels[ LevelMeter::TRUE_PEAK_LEFT ] )
+        << "expected true-peak to equal sample peak when true-peak detection is disabled";
+
+    LevelMeter::setTruePeakEnabled( true );
+    LevelMeter::measure( 0, LevelMeter::MASTER_ID, buffer, bufferSize, 1.0 );
+    LevelMeter::publish( 1, bufferSize );
+    LevelMeter::read( levels, 1 );
+
+    EXPECT_NEAR( 0.707f, levels[ LevelMeter::PEAK_LEFT ], 0.001f );
+    EXPECT_NEAR( 1.0f, levels[ LevelMeter::TRUE_PEAK_LEFT ], 0.05f )
+        << "expected true-peak to detect the inter-sample peak";
+
+    LevelMeter::setTruePeakEnabled( false );
+
+    delete buffer;
+}
@@ -0,0 +1,63 @@
+#include "../../utilities/lockfreeringbuffer.h"
+
+TEST( LockFreeRingBuffer, Construction )
+{
+    LockFreeRingBuffer* ringBuffer = new LockFreeRingBuffer( 100 );
+
+    EXPECT_EQ( 128, ( int ) ringBuffer->getCapacity() )
+        << "expected capacity to have been rounded up to the nearest power of two";
+
+    EXPECT_EQ( 0,   ( int ) ringBuffer->getReadAvailable() );
+    EXPECT_EQ( 128, ( int ) ringBuffer->getWriteAvailable() );
+
+    delete ringBuffer;
+}
+
+TEST( LockFreeRingBuffer, WriteAndRead )
+{
+    LockFreeRingBuffer* ringBuffer = new LockFreeRingBuffer( 16 );
+
+    float input[ 24 ];
+    float output[ 24 ];
+
+    for ( int i = 0; i < 24; ++i )
+        input[ i ] = ( float ) i;
+
+    EXPECT_EQ( 10, ( int ) ringBuffer->write( input, 10 ));
+    EXPECT_EQ( 10, ( int ) ringBuffer->getReadAvailable() );
+
+    EXPECT_EQ( 6, ( int ) ringBuffer->write( input + 10, 14 ))
+        << "expected write to have been limited to the remaining capacity";
+
+    EXPECT_EQ( 0, ( int ) ringBuffer->getWriteAvailable() );
+
+    EXPECT_EQ( 12, ( int ) ringBuffer->read( output, 12 ));
+
+    for ( int i = 0; i < 12; ++i )
+        EXPECT_FLOAT_EQ( input[ i ], output[ i ] );
+
+    // write across the end of the buffer
+
+    EXPECT_EQ( 8, ( int ) ringBuffer->write( input + 16, 8 ));
+    EXPECT_EQ( 12, ( int ) ringBuffer->read( output, 24 ))
+        << "expected read to have been limited to the available contents";
+
+    for ( int i = 0; i < 12; ++i )
+        EXPECT_FLOAT_EQ( input[ i + 12 ], output[ i ] ) << "expected values to be read in written order";
+
+    delete ringBuffer;
+}
+
+TEST( LockFreeRingBuffer, Clear )
+{
+    LockFreeRingBuffer* ringBuffer = new LockFreeRingBuffer( 16 );
+
+    float input[ 8 ] = { 0 };
+    ringBuffer->write( input, 8 );
+    ringBuffer->clear();
+
+    EXPECT_EQ( 0,  ( int ) ringBuffer->getReadAvailable() );
+    EXPECT_EQ( 16, ( int ) ringBuffer->getWriteAvailable() );
+
+    delete ringBuffer;
+}
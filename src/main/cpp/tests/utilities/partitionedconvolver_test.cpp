@@ -0,0 +1,65 @@
+#include "../../utilities/partitionedconvolver.h"
+
+TEST( PartitionedConvolver, Construction )
+{
+    SAMPLE_TYPE kernel[ 200 ] = { 0 };
+    PartitionedConvolver* convolver = new PartitionedConvolver( 64, kernel, 200 );
+
+    EXPECT_EQ( 64, convolver->getBlockSize() )         << "expected given block size";
+    EXPECT_EQ( 4,  convolver->getAmountOfPartitions() ) << "expected kernel to span 4 partitions";
+
+    delete convolver;
+}
+
+TEST( PartitionedConvolver, Process )
+{
+    int blockSize    = 64;
+    int kernelLength = randomInt( 1, 1000 );
+    int inputLength  = blockSize * 24;
+
+    SAMPLE_TYPE* kernel   = new SAMPLE_TYPE[ kernelLength ];
+    SAMPLE_TYPE* input    = new SAMPLE_TYPE[ inputLength ];
+    SAMPLE_TYPE* output   = new SAMPLE_TYPE[ inputLength ];
+    SAMPLE_TYPE* expected = new SAMPLE_TYPE[ inputLength ];
+
+    for ( int i = 0; i < kernelLength; ++i )
+        kernel[ i ] = randomSample( -1.0, 1.0 ) / sqrt(( SAMPLE_TYPE ) kernelLength );
+
+    for ( int i = 0; i < inputLength; ++i )
+        input[ i ] = randomSample( -1.0, 1.0 );
+
+    // direct convolution as reference
+
+    for ( int i = 0; i < inputLength; ++i )
+    {
+        expected[ i ] = 0.0;
+        for ( int j = 0; j <= i && j < kernelLength; ++j )
+            expected[ i ] += input[ i - j ] * kernel[ j ];
+    }
+
+    PartitionedConvolver* convolver = new PartitionedConvolver( blockSize, kernel, kernelLength );
+
+    for ( int i = 0; i < inputLength; i += blockSize )
+        convolver->process( &input[ i ], &output[ i ] );
+
+    for ( int i = 0; i < inputLength; ++i )
+        EXPECT_NEAR( expected[ i ], output[ i ], 1e-4 ) << "expected convolved output at index " << i;
+
+    // after resetting, the history of the input should no longer be audible
+
+    convolver->reset();
+
+    for ( int i = 0; i < blockSize; ++i )
+        input[ i ] = 0.0;
+
+    convolver->process( input, output );
+
+    for ( int i = 0; i < blockSize; ++i )
+        EXPECT_NEAR( 0.0, output[ i ], 1e-6 ) << "expected silence after reset at index " << i;
+
+    delete convolver;
+    delete[] kernel;
+    delete[] input;
+    delete[] output;
+    delete[] expected;
+}
@@ -0,0 +1,66 @@
+#include "../../utilities/recordingstream.h"
+#include "../../utilities/wavereader.h"
+#include <cstdio>
+#include <fstream>
+
+TEST( RecordingStream, WriteToFile )
+{
+    std::string outputFile = "mwengine_recordingstream_test.wav";
+
+    int amountOfChannels = 2;
+    int bufferSize       = 64;
+    RecordingStream* stream = new RecordingStream( outputFile, amountOfChannels, 44100, bufferSize * 2 );
+
+    ASSERT_TRUE( stream->open() );
+
+    std::string journalFile = RecordingStream::getJournalFile( outputFile );
+    ASSERT_TRUE( std::ifstream( journalFile.c_str() ).good() ) << "expected a journal to exist while recording";
+
+    AudioBuffer* buffer = new AudioBuffer( amountOfChannels, bufferSize );
+
+    for ( int i = 0; i < bufferSize; ++i ) {
+        buffer->getBufferForChannel( 0 )[ i ] = +0.5;
+        buffer->getBufferForChannel( 1 )[ i ] = -0.25;
+    }
+
+    EXPECT_EQ( bufferSize, stream->write( buffer, bufferSize ));
+    EXPECT_EQ( bufferSize, stream->write( buffer, bufferSize ));
+
+    EXPECT_EQ( 0, stream->write( buffer, bufferSize ))
+        << "expected no frames to be queued when the queue is full";
+
+    EXPECT_EQ(( unsigned long ) bufferSize, stream->getDroppedFrames() );
+    EXPECT_EQ( bufferSize * 2, stream->flush() ) << "expected all queued frames to have been written";
+
+    // interleaved write
+
+    float interleaved[ 8 ] = { 0.5f, -0.25f, 0.5f, -0.25f, 0.5f, -0.25f, 0.5f, -0.25f };
+    EXPECT_EQ( 4, stream->write( interleaved, 4 ));
+
+    stream->close();
+
+    ASSERT_FALSE( std::ifstream( journalFile.c_str() ).good() ) << "expected journal to be removed on completion";
+
+    EXPECT_EQ(( unsigned long )( bufferSize * 2 + 4 ), stream->getWrittenFrames() );
+
+    // read the written file
+
+    waveFile WAV = WaveReader::fileToBuffer( outputFile );
+
+    ASSERT_FALSE( WAV.buffer == nullptr ) << "expected a valid WAV file to have been written";
+
+    EXPECT_EQ( amountOfChannels, WAV.buffer->amountOfChannels );
+    EXPECT_EQ( bufferSize * 2 + 4, WAV.buffer->bufferSize ) << "expected header to describe all written frames";
+    EXPECT_EQ( 44100, ( int ) WAV.sampleRate );
+
+    for ( int i = 0; i < WAV.buffer->bufferSize; ++i ) {
+        EXPECT_NEAR( +0.5,  WAV.buffer->getBufferForChannel( 0 )[ i ], 0.0001 );
+        EXPECT_NEAR( -0.25, WAV.buffer->getBufferForChannel( 1 )[ i ], 0.0001 );
+    }
+
+    delete WAV.buffer;
+    delete buffer;
+    delete stream;
+
+    remove( outputFile.c_str() );
+}
@@ -0,0 +1,197 @@
+#include "../../utilities/resampler.h"
+#include <cmath>
+
+// generates a sine wave of given frequency (relative to the sample rate, e.g. 0.25 = sampleRate / 4)
+
+SAMPLE_TYPE* generateSine( int length, double frequency )
+{
+    SAMPLE_TYPE* buffer = new SAMPLE_TYPE[ length ];
+
+    for ( int i = 0; i < length; ++i )
+        buffer[ i ] = ( SAMPLE_TYPE ) sin( 2.0 * M_PI * frequency * i );
+
+    return buffer;
+}
+
+// returns the peak amplitude of given buffer (omitting given margin at the edges)
+
+SAMPLE_TYPE getAmplitude( SAMPLE_TYPE* buffer, int length, int margin )
+{
+    SAMPLE_TYPE rms = 0.0;
+
+    for ( int i = margin; i < length - margin; ++i )
+        rms += buffer[ i ] * buffer[ i ];
+
+    return sqrt( rms / ( length - margin * 2 )) * sqrt( 2.0 );
+}
+
+TEST( Resampler, Linear )
+{
+    SAMPLE_TYPE source[ 4 ] = { -1.0, 0.0, 1.0, 0.5 };
+
+    EXPECT_EQ( 0.0, Resampler::interpolate( Resampler::LINEAR, source, 4, 1.0, 1.0 ))
+        << "expected sample to be returned as-is at an integer position";
+
+    EXPECT_EQ( -0.5, Resampler::interpolate( Resampler::LINEAR, source, 4, 0.5, 1.0 ))
+        << "expected linear interpolation between two samples";
+
+    EXPECT_EQ( 0.75, Resampler::interpolate( Resampler::LINEAR, source, 4, 2.5, 1.0 ))
+        << "expected linear interpolation between two samples";
+
+    EXPECT_EQ( 0.0, Resampler::interpolate( Resampler::LINEAR, source, 4, 4.0, 1.0 ))
+        << "expected silence when reading outside of the source range";
+}
+
+TEST( Resampler, Hermite )
+{
+    SAMPLE_TYPE source[ 6 ] = { 0.0, -1.0, 0.0, 1.0, 0.5, 0.0 };
+
+    for ( int i = 1; i < 4; ++i ) {
+        EXPECT_EQ( source[ i ], Resampler::interpolate( Resampler::HERMITE, source, 6, ( double ) i, 1.0 ))
+            << "expected sample to be returned as-is at an integer position";
+    }
+
+    // Hermite interpolation passes through the samples while preserving their slope
+
+    SAMPLE_TYPE value = Resampler::interpolate( Resampler::HERMITE, source, 6, 2.5, 1.0 );
+
+    EXPECT_TRUE( value > 0.5 && value < 1.0 )
+        << "expected interpolated value to lie on the curve between the two samples, got " << value;
+}
+
+TEST( Resampler, MixAtIncrement )
+{
+    int length          = 16;
+    SAMPLE_TYPE* source = new SAMPLE_TYPE[ length ];
+    SAMPLE_TYPE* target = new SAMPLE_TYPE[ length ];
+
+    for ( int i = 0; i < length; ++i ) {
+        source[ i ] = ( SAMPLE_TYPE ) i;
+        target[ i ] = 1.0;
+    }
+
+    double position = Resampler::mix( Resampler::LINEAR, source, length, target, 8, 2.0, 0.5, 0.5 );
+
+    EXPECT_EQ( 6.0, position ) << "expected read position to have advanced by the increment for each mixed sample";
+
+    for ( int i = 0; i < 8; ++i ) {
+        EXPECT_EQ( 1.0 + ( 2.0 + i * 0.5 ) * 0.5, target[ i ] )
+            << "expected interpolated sample at the volume to have been mixed into the existing contents";
+    }
+
+    for ( int i = 8; i < length; ++i )
+        EXPECT_EQ( 1.0, target[ i ] ) << "expected samples beyond the mixed amount to remain unchanged";
+
+    delete[] source;
+    delete[] target;
+}
+
+TEST( Resampler, SincAccuracy )
+{
+    // compare interpolated values of a band limited signal against the reference
+    // (analytic) values at fractional positions (e.g. reading at a lowered playback rate)
+
+    int length          = 4096;
+    double frequency    = 0.2;
+    double increment    = 0.37;
+    SAMPLE_TYPE* source = generateSine( length, frequency );
+
+    double maxLinearError = 0.0;
+    double maxSincError   = 0.0;
+
+    for ( int i = 0; i < 2048; ++i )
+    {
+        double position  = 100.0 + i * increment;
+        double reference = sin( 2.0 * M_PI * frequency * position );
+
+        maxLinearError = std::max( maxLinearError, fabs( Resampler::interpolate( Resampler::LINEAR, source, length, position, increment ) - reference ));
+        maxSincError   = std::max( maxSincError,   fabs( Resampler::interpolate( Resampler::SINC,   source, length, position, increment ) - reference ));
+    }
+
+    EXPECT_TRUE( maxSincError < 0.001 )
+        << "expected windowed-sinc interpolation to closely match the reference, got error " << maxSincError;
+
+    EXPECT_TRUE( maxSincError < maxLinearError )
+        << "expected windowed-sinc interpolation to be more accurate than linear interpolation";
+
+    delete[] source;
+}
+
+TEST( Resampler, SincAliasing )
+{
+    // reading at double speed halves the Nyquist frequency, a tone at 0.4 times
+    // the sample rate would alias (fold back) into the audible range
+
+    int length          = 4096;
+    int outputLength    = length / 2;
+    int margin          = Resampler::SINC_TAPS * Resampler::MAX_DECIMATION;
+    SAMPLE_TYPE* source = generateSine( length, 0.4 );
+
+    SAMPLE_TYPE* linearOutput = new SAMPLE_TYPE[ outputLength ];
+    SAMPLE_TYPE* sincOutput   = new SAMPLE_TYPE[ outputLength ];
+
+    for ( int i = 0; i < outputLength; ++i ) {
+        linearOutput[ i ] = 0.0;
+        sincOutput[ i ]   = 0.0;
+    }
+
+    Resampler::mix( Resampler::LINEAR, source, length, linearOutput, outputLength, 0.0, 2.0, 1.0 );
+    Resampler::mix( Resampler::SINC,   source, length, sincOutput,   outputLength, 0.0, 2.0, 1.0 );
+
+    EXPECT_TRUE( getAmplitude( linearOutput, outputLength, margin ) > 0.5 )
+        << "expected linear interpolation to contain the aliased tone";
+
+    EXPECT_TRUE( getAmplitude( sincOutput, outputLength, margin ) < 0.001 )
+        << "expected windowed-sinc interpolation to have filtered the tone above the Nyquist frequency";
+
+    // tones below the Nyquist frequency must however pass
+
+    delete[] source;
+    source = generateSine( length, 0.05 );
+
+    for ( int i = 0; i < outputLength; ++i )
+        sincOutput[ i ] = 0.0;
+
+    Resampler::mix( Resampler::SINC, source, length, sincOutput, outputLength, 0.0, 2.0, 1.0 );
+
+    EXPECT_NEAR( 1.0, getAmplitude( sincOutput, outputLength, margin ), 0.01 )
+        << "expected windowed-sinc interpolation to preserve the tone below the Nyquist frequency";
+
+    delete[] source;
+    delete[] linearOutput;
+    delete[] sincOutput;
+}
+
+TEST( Resampler, ResampleBuffer )
+{
+    int length          = 2048;
+    AudioBuffer* buffer = new AudioBuffer( 2, length );
+    SAMPLE_TYPE* sine   = generateSine( length, 0.05 );
+
+    for ( int c = 0; c < buffer->amountOfChannels; ++c ) {
+        for ( int i = 0; i < length; ++i )
+            buffer->getBufferForChannel( c )[ i ] = sine[ i ];
+    }
+
+    AudioBuffer* output = Resampler::resampleBuffer( buffer, 22050, 44100, Resampler::SINC );
+
+    EXPECT_EQ( buffer->amountOfChannels, output->amountOfChannels )
+        << "expected resampled buffer to have the same channel amount";
+
+    EXPECT_EQ( length * 2, output->bufferSize )
+        << "expected resampled buffer length to have been scaled by the sample rate ratio";
+
+    // at twice the sample rate the frequency relative to the sample rate is halved
+
+    double maxError = 0.0;
+
+    for ( int i = 100; i < output->bufferSize - 100; ++i )
+        maxError = std::max( maxError, fabs( output->getBufferForChannel( 1 )[ i ] - sin( 2.0 * M_PI * 0.025 * i )));
+
+    EXPECT_TRUE( maxError < 0.001 )
+        << "expected resampled contents to match the reference, got error " << maxError;
+
+    delete[] sine;
+    delete buffer;
+    delete output;
+}
@@ -1,5 +1,11 @@
 #include "../../utilities/samplemanager.h"
+#include "../../events/sampleevent.h"
 #include "../../audiobuffer.h"
+#include "../../utilities/resampler.h"
+#include "../../utilities/wavewriter.h"
+#include <cstdio>
+#include <chrono>
+#include <thread>
 
 TEST( SampleManager, EmptyByDefault )
 {
@@ -128,3 +134,287 @@ TEST( SampleManager, Flush )
 
     // buffers deleted by SampleManager.flushSamples()
 }
+
+TEST( SampleManager, ReferenceCounting )
+{
+    std::string id = "foo";
+    AudioBuffer* buffer = new AudioBuffer( 1, 10 );
+
+    SampleManager::setSample( id, buffer, AudioEngineProps::SAMPLE_RATE );
+
+    EXPECT_EQ( 0, SampleManager::getReferenceCount( id ))
+        << "expected no references by default";
+
+    SampleEvent* event1 = new SampleEvent();
+    SampleEvent* event2 = new SampleEvent();
+
+    event1->setSample( SampleManager::getSample( id ));
+    event2->setSample( SampleManager::getSample( id ));
+
+    EXPECT_EQ( 2, SampleManager::getReferenceCount( id ))
+        << "expected both SampleEvents to have retained the shared buffer";
+
+    delete event1;
+
+    EXPECT_EQ( 1, SampleManager::getReferenceCount( id ))
+        << "expected destroyed SampleEvent to have released the shared buffer";
+
+    // removing a referenced sample defers the deletion of its buffer
+
+    SampleManager::removeSample( id, true );
+
+    ASSERT_FALSE( SampleManager::hasSample( id ))
+        << "expected no Sample to be found as it has been removed";
+
+    EXPECT_EQ( buffer, event2->getBuffer() ) << "expected buffer to remain available to the referencing event";
+    EXPECT_EQ( 10, event2->getBuffer()->bufferSize );
+
+    delete event2; // releases and deletes the buffer
+}
+
+TEST( SampleManager, MemoryBudget )
+{
+    AudioBuffer* buffer1 = new AudioBuffer( 1, 10 );
+    AudioBuffer* buffer2 = new AudioBuffer( 1, 10 );
+    AudioBuffer* buffer3 = new AudioBuffer( 1, 10 );
+
+    unsigned long bufferSize = 10 * sizeof( SAMPLE_TYPE );
+
+    // samples registered with a source path are evictable, samples without cannot be reloaded
+
+    SampleManager::setSample( "foo", buffer1, AudioEngineProps::SAMPLE_RATE, "/nonexistent/foo.wav" );
+    SampleManager::setSample( "bar", buffer2, AudioEngineProps::SAMPLE_RATE, "/nonexistent/bar.wav" );
+    SampleManager::setSample( "baz", buffer3, AudioEngineProps::SAMPLE_RATE );
+
+    EXPECT_EQ( bufferSize * 3, SampleManager::getMemoryUsage() )
+        << "expected memory usage to equal the size of all registered buffers";
+
+    // reference "bar" and access "foo" so "bar" is the least recently used sample yet in use
+
+    SampleEvent* event = new SampleEvent();
+    event->setSample( SampleManager::getSample( "bar" ));
+    SampleManager::getSample( "foo" );
+
+    SampleManager::setMemoryBudget( bufferSize );
+
+    EXPECT_EQ( bufferSize, SampleManager::getMemoryBudget() );
+
+    ASSERT_FALSE( SampleManager::isSampleLoaded( "foo" ))
+        << "expected unreferenced sample with a source path to have been evicted";
+
+    ASSERT_TRUE( SampleManager::isSampleLoaded( "bar" ))
+        << "expected referenced sample not to have been evicted";
+
+    ASSERT_TRUE( SampleManager::isSampleLoaded( "baz" ))
+        << "expected sample without source path not to have been evicted";
+
+    ASSERT_TRUE( SampleManager::hasSample( "foo" ))
+        << "expected evicted sample to remain registered";
+
+    EXPECT_EQ( 10, SampleManager::getSampleLength( "foo" ))
+        << "expected evicted sample to retain its properties";
+
+    EXPECT_EQ( bufferSize * 2, SampleManager::getMemoryUsage() );
+
+    // releasing the last reference makes the sample eligible for eviction
+
+    delete event;
+
+    ASSERT_FALSE( SampleManager::isSampleLoaded( "bar" ))
+        << "expected released sample to have been evicted as memory usage exceeds the budget";
+
+    EXPECT_EQ( bufferSize, SampleManager::getMemoryUsage() );
+
+    ASSERT_TRUE( SampleManager::getSample( "foo" ) == nullptr )
+        << "expected evicted sample to not be reloadable as its source file does not exist";
+
+    SampleManager::setMemoryBudget( 0 );
+    SampleManager::flushSamples();
+
+    EXPECT_EQ( 0UL, SampleManager::getMemoryUsage() );
+}
+
+TEST( SampleManager, RetainSample )
+{
+    std::string id         = "foo";
+    std::string sourcePath = "mwengine_samplemanager_test.wav";
+    AudioBuffer* buffer    = new AudioBuffer( 1, 100 );
+
+    fillAudioBuffer( buffer );
+    WaveWriter::bufferToWAV( sourcePath, buffer, AudioEngineProps::SAMPLE_RATE );
+
+    unsigned long bufferSize = 100 * sizeof( SAMPLE_TYPE );
+
+    SampleManager::setSample( id, buffer, AudioEngineProps::SAMPLE_RATE, sourcePath );
+
+    ASSERT_TRUE( SampleManager::retainSample( id ) == buffer ) << "expected registered AudioBuffer to have been returned";
+    EXPECT_EQ( 1, SampleManager::getReferenceCount( id )) << "expected returned buffer to have been retained";
+
+    SampleManager::releaseBuffer( buffer );
+    EXPECT_EQ( 0, SampleManager::getReferenceCount( id ));
+
+    // a budget smaller than the sample evicts it
+
+    SampleManager::setMemoryBudget( bufferSize / 2 );
+    ASSERT_FALSE( SampleManager::isSampleLoaded( id )) << "expected unreferenced sample to have been evicted";
+
+    // yet the reloaded sample is not evicted while it is being returned
+
+    AudioBuffer* reloaded = SampleManager::retainSample( id );
+
+    ASSERT_FALSE( reloaded == nullptr ) << "expected evicted sample to have been reloaded from its source file";
+    EXPECT_EQ( 100, reloaded->bufferSize );
+    EXPECT_EQ( 1, SampleManager::getReferenceCount( id ));
+    EXPECT_EQ( bufferSize, SampleManager::getMemoryUsage() );
+
+    // the retained sample can't be evicted until it is released
+
+    SampleManager::setMemoryBudget( bufferSize / 4 );
+    ASSERT_TRUE( SampleManager::isSampleLoaded( id )) << "expected retained sample not to have been evicted";
+
+    SampleManager::releaseBuffer( reloaded );
+    ASSERT_FALSE( SampleManager::isSampleLoaded( id )) << "expected released sample to have been evicted";
+
+    SampleManager::setMemoryBudget( 0 );
+    SampleManager::removeSample( id, true );
+
+    remove( sourcePath.c_str());
+}
+
+TEST( SampleManager, ConvertSample )
+{
+    std::string id      = "foo";
+    int sampleRate      = AudioEngineProps::SAMPLE_RATE / 2;
+    AudioBuffer* buffer = new AudioBuffer( 1, 10 );
+
+    SampleManager::setSample( id, buffer, sampleRate );
+
+    // reference the original buffer prior to conversion
+
+    SampleEvent* event = new SampleEvent();
+    event->setSample( SampleManager::getSample( id ), sampleRate );
+
+    ASSERT_TRUE( SampleManager::convertSample( id ))
+        << "expected sample to have been converted";
+
+    EXPECT_EQ( AudioEngineProps::SAMPLE_RATE, SampleManager::getSampleRateForSample( id ))
+        << "expected converted sample to be at the engine sample rate";
+
+    EXPECT_EQ( 20, SampleManager::getSampleLength( id ))
+        << "expected converted sample length to have been scaled by the sample rate ratio";
+
+    ASSERT_FALSE( SampleManager::getSample( id ) == buffer )
+        << "expected original buffer to have been replaced by the converted buffer";
+
+    EXPECT_EQ( buffer, event->getBuffer() )
+        << "expected SampleEvent to keep referencing the original buffer";
+
+    ASSERT_FALSE( SampleManager::convertSample( id ))
+        << "expected sample to not be converted again as it matches the engine sample rate";
+
+    delete event; // releases and deletes the original buffer
+
+    SampleManager::removeSample( id, true );
+}
+
+TEST( SampleManager, SampleRateConversionOnLoad )
+{
+    std::string id = "foo";
+    AudioBuffer* buffer = new AudioBuffer( 2, 441 );
+
+    SampleManager::setSampleRateConversion( true, Resampler::LINEAR );
+
+    ASSERT_TRUE( SampleManager::getSampleRateConversion() );
+
+    SampleManager::setSample( id, buffer, 48000 );
+
+    // conversion takes place on a background thread, wait for it to complete
+
+    for ( int i = 0; i < 1000 && SampleManager::getPendingConversions() > 0; ++i )
+        std::this_thread::sleep_for( std::chrono::milliseconds( 5 ));
+
+    EXPECT_EQ( 0, SampleManager::getPendingConversions() )
+        << "expected all conversions to have completed";
+
+    EXPECT_EQ( AudioEngineProps::SAMPLE_RATE, SampleManager::getSampleRateForSample( id ))
+        << "expected sample to have been converted to the engine sample rate upon registration";
+
+    EXPECT_EQ( 2, SampleManager::getSample( id )->amountOfChannels )
+        << "expected converted sample to retain its channel amount";
+
+    SampleManager::setSampleRateConversion( false, Resampler::LINEAR );
+    SampleManager::removeSample( id, true );
+}
+
+TEST( SampleManager, StreamedSample )
+{
+    std::string id      = "foo";
+    int sampleLength    = AudioEngineProps::SAMPLE_RATE; // one second
+    AudioBuffer* buffer = new AudioBuffer( 1, sampleLength );
+
+    for ( int i = 0; i < sampleLength; ++i )
+        buffer->getBufferForChannel( 0 )[ i ] = 1.0;
+
+    SampleManager::setPreRollDuration( 100 );
+    SampleManager::setStreamedSample( id, buffer, AudioEngineProps::SAMPLE_RATE, "/nonexistent/foo.wav" );
+
+    SampleStream* stream = SampleManager::getStream( id );
+
+    ASSERT_FALSE( stream == nullptr ) << "expected stream to have been registered";
+
+    int preRollLength  = AudioEngineProps::SAMPLE_RATE / 10;
+    unsigned long size = sizeof( SAMPLE_TYPE );
+
+    EXPECT_EQ( preRollLength, stream->getPreRoll()->bufferSize )
+        << "expected pre-roll to hold the first 100 milliseconds of the sample";
+
+    EXPECT_EQ(( sampleLength + preRollLength ) * size, SampleManager::getMemoryUsage() )
+        << "expected memory usage to account for both pre-roll and contents";
+
+    stream->release();
+
+    SampleEvent* event = new SampleEvent();
+    event->setSample( id );
+
+    EXPECT_EQ( sampleLength, event->getEventLength() )
+        << "expected event length to equal the full sample length rather than the pre-roll length";
+
+    // while the contents are resident, these can be read beyond the pre-roll
+
+    int bufferSize            = 64;
+    AudioBuffer* targetBuffer = new AudioBuffer( 1, bufferSize );
+    int readOffset            = preRollLength * 2;
+
+    event->mixBuffer( targetBuffer, readOffset, 0, sampleLength, false, 0, false );
+    EXPECT_EQ( 1.0, targetBuffer->getBufferForChannel( 0 )[ 0 ] ) << "expected resident contents to have been mixed";
+
+    // contents that are being played back are not evicted when exceeding the memory budget
+
+    SampleManager::setMemoryBudget( preRollLength * size );
+
+    ASSERT_TRUE( SampleManager::isSampleLoaded( id )) << "expected contents in use to remain resident";
+
+    // once no longer played back, exceeding the memory budget evicts the contents, leaving the pre-roll
+
+    std::this_thread::sleep_for( std::chrono::milliseconds( SampleStream::IN_USE_DURATION + 10 ));
+    SampleManager::setMemoryBudget( preRollLength * size );
+
+    ASSERT_FALSE( SampleManager::isSampleLoaded( id )) << "expected contents to have been evicted";
+    EXPECT_EQ( preRollLength * size, SampleManager::getMemoryUsage() );
+
+    targetBuffer->silenceBuffers();
+    event->mixBuffer( targetBuffer, 0, 0, sampleLength, false, 0, false );
+    EXPECT_EQ( 1.0, targetBuffer->getBufferForChannel( 0 )[ 0 ] ) << "expected pre-roll to have been mixed";
+
+    targetBuffer->silenceBuffers();
+    event->mixBuffer( targetBuffer, readOffset, 0, sampleLength, false, 0, false );
+    EXPECT_EQ( 0.0, targetBuffer->getBufferForChannel( 0 )[ 0 ] ) << "expected silence beyond the pre-roll";
+
+    delete event;
+    delete targetBuffer;
+
+    SampleManager::setMemoryBudget( 0 );
+    SampleManager::removeSample( id, true );
+
+    EXPECT_EQ( 0UL, SampleManager::getMemoryUsage() );
+}
@@ -0,0 +1,59 @@
+#include "../../utilities/samplestream.h"
+
+TEST( SampleStream, Construction )
+{
+    AudioBuffer* preRoll = new AudioBuffer( 2, 10 );
+    SampleStream* stream = new SampleStream( "/nonexistent/foo.wav", preRoll, 100, 48000 );
+
+    EXPECT_EQ( preRoll, stream->getPreRoll() );
+    EXPECT_EQ( 100, stream->getSampleLength() );
+    EXPECT_EQ( 48000, ( int ) stream->getSampleRate() );
+
+    ASSERT_FALSE( stream->isResident() ) << "expected stream contents not to be resident by default";
+    ASSERT_FALSE( stream->isFetchRequested() ) << "expected no fetch to have been requested by default";
+
+    stream->release(); // deletes stream and pre-roll
+}
+
+TEST( SampleStream, ReadRequestsFetch )
+{
+    SampleStream* stream = new SampleStream( "/nonexistent/foo.wav", new AudioBuffer( 1, 10 ), 100, 44100 );
+
+    ASSERT_TRUE( stream->beginRead() == nullptr )
+        << "expected no contents to be returned as these aren't resident";
+
+    ASSERT_TRUE( stream->isReading() );
+
+    stream->endRead();
+
+    ASSERT_FALSE( stream->isReading() );
+    ASSERT_TRUE( stream->isFetchRequested() )
+        << "expected reading non-resident contents to have requested a fetch";
+
+    EXPECT_EQ( 0UL, stream->fetch() )
+        << "expected fetch of a nonexistent file to not have loaded any contents";
+
+    ASSERT_FALSE( stream->isFetchRequested() ) << "expected request to have been processed";
+
+    stream->release();
+}
+
+TEST( SampleStream, Eviction )
+{
+    SampleStream* stream = new SampleStream( "/nonexistent/foo.wav", new AudioBuffer( 1, 10 ), 100, 44100 );
+    AudioBuffer* body    = new AudioBuffer( 1, 100 );
+
+    stream->setBody( body );
+
+    ASSERT_TRUE( stream->isResident() );
+    EXPECT_EQ( body, stream->beginRead() ) << "expected resident contents to be returned";
+    stream->endRead();
+
+    EXPECT_EQ( 100 * sizeof( SAMPLE_TYPE ), stream->evict() )
+        << "expected the size of the evicted contents to have been returned";
+
+    ASSERT_FALSE( stream->isResident() ) << "expected contents to have been evicted";
+    EXPECT_EQ( 0UL, stream->evict() ) << "expected nothing to evict";
+
+    stream->release();
+}
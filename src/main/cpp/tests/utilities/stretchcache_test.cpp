@@ -0,0 +1,77 @@
+#include "../../utilities/stretchcache.h"
+
+TEST( StretchCache, RetainRelease )
+{
+    AudioEngineProps::SAMPLE_RATE = 44100;
+
+    AudioBuffer* source = fillAudioBuffer( new AudioBuffer( 1, 4410 ));
+
+    StretchCache::Entry* entry1 = StretchCache::retain( source, 1.5f );
+    StretchCache::Entry* entry2 = StretchCache::retain( source, 1.5001f );
+    StretchCache::Entry* entry3 = StretchCache::retain( source, 2.f );
+
+    EXPECT_TRUE( entry1 == entry2 ) << "expected entries for the same source and (rounded) ratio to be shared";
+    EXPECT_FALSE( entry1 == entry3 ) << "expected entries for different ratios to be unique";
+    EXPECT_EQ( 2, StretchCache::getCacheSize() );
+
+    waitForStretchCache();
+
+    EXPECT_EQ( 0, StretchCache::getPendingRenders() ) << "expected all renders to have completed";
+
+    ASSERT_TRUE( entry1->ready.load() ) << "expected entry to have been rendered";
+    ASSERT_TRUE( entry3->ready.load() ) << "expected entry to have been rendered";
+
+    EXPECT_EQ( 6615, entry1->buffer->bufferSize ) << "expected rendered buffer to be stretched by the ratio";
+    EXPECT_EQ( 8820, entry3->buffer->bufferSize ) << "expected rendered buffer to be stretched by the ratio";
+
+    StretchCache::release( entry1 );
+
+    EXPECT_EQ( 2, StretchCache::getCacheSize() ) << "expected entry to remain cached while it is referenced";
+
+    StretchCache::release( entry2 );
+    StretchCache::release( entry3 );
+
+    EXPECT_EQ( 0, StretchCache::getCacheSize() ) << "expected unreferenced entries to have been removed";
+
+    waitForStretchCache();
+    delete source;
+}
+
+TEST( StretchCache, ReleaseWhileRendering )
+{
+    AudioEngineProps::SAMPLE_RATE = 44100;
+
+    AudioBuffer* source = fillAudioBuffer( new AudioBuffer( 2, 441000 ));
+
+    StretchCache::Entry* entry = StretchCache::retain( source, 2.f );
+    StretchCache::release( entry );
+
+    // source can be deleted once its render has been cancelled
+
+    StretchCache::waitForRenders( source );
+    delete source;
+
+    waitForStretchCache();
+
+    EXPECT_EQ( 0, StretchCache::getPendingRenders() );
+    EXPECT_EQ( 0, StretchCache::getCacheSize() );
+}
+
+TEST( StretchCache, ReleaseDeferred )
+{
+    AudioEngineProps::SAMPLE_RATE = 44100;
+
+    AudioBuffer* source = fillAudioBuffer( new AudioBuffer( 1, 4410 ));
+
+    StretchCache::Entry* entry = StretchCache::retain( source, 1.5f );
+    waitForStretchCache();
+
+    // the rendering thread hands its releases over to the background thread
+
+    StretchCache::releaseDeferred( entry );
+    waitForStretchCache();
+
+    EXPECT_EQ( 0, StretchCache::getCacheSize() ) << "expected the deferred release to have been processed";
+
+    delete source;
+}
@@ -0,0 +1,190 @@
+#include "../../utilities/tempomap.h"
+#include "../../sequencercontroller.h"
+
+TEST( TempoMap, ConstantTempo )
+{
+    TempoMap* tempoMap = new TempoMap( 120.f, 4, 4 );
+    double samplesPerBeat = AudioEngineProps::SAMPLE_RATE * 60.0 / 120.0;
+
+    EXPECT_FLOAT_EQ( 120.f, tempoMap->getTempo( 0 ));
+    EXPECT_EQ( 4, tempoMap->getBeatAmount( 0 ));
+    EXPECT_EQ( 4, tempoMap->getBeatUnit( 0 ));
+
+    EXPECT_DOUBLE_EQ( samplesPerBeat * 3, tempoMap->getSamplePosition( TICKS_PER_BEAT * 3 ))
+        << "expected tick position to translate into the sample position for the tempo";
+
+    EXPECT_NEAR( TICKS_PER_BEAT * 3, tempoMap->getTickPosition( samplesPerBeat * 3 ), 1e-6 )
+        << "expected sample position to translate into the tick position for the tempo";
+
+    EXPECT_EQ( -1, tempoMap->getNextChange( 0 )) << "expected no changes to follow";
+
+    delete tempoMap;
+}
+
+TEST( TempoMap, TempoChanges )
+{
+    TempoMap* tempoMap = new TempoMap( 120.f, 4, 4 );
+    double samplesPerMinute = AudioEngineProps::SAMPLE_RATE * 60.0;
+
+    // instant change to 60 BPM on the third beat, ramp towards 180 BPM on the seventh beat
+
+    tempoMap->addTempoChange( TICKS_PER_BEAT * 6, 180.f, true );
+    tempoMap->addTempoChange( TICKS_PER_BEAT * 2, 60.f, false );
+
+    EXPECT_EQ( 2, tempoMap->getTempoChangeAmount() );
+
+    EXPECT_FLOAT_EQ( 120.f, tempoMap->getTempo( TICKS_PER_BEAT * 2 - 1 ));
+    EXPECT_FLOAT_EQ( 60.f,  tempoMap->getTempo( TICKS_PER_BEAT * 2 ));
+    EXPECT_FLOAT_EQ( 120.f, tempoMap->getTempo( TICKS_PER_BEAT * 4 )) << "expected tempo to be halfway the ramp";
+    EXPECT_FLOAT_EQ( 180.f, tempoMap->getTempo( TICKS_PER_BEAT * 8 ));
+
+    // two beats at 120 BPM, followed by the first half of the ramp (the integral of its linearly increasing tempo)
+
+    double expected = samplesPerMinute * ( 2.0 / 120.0 + ( 4.0 / 120.0 ) * log( 120.0 / 60.0 ));
+
+    EXPECT_NEAR( expected, tempoMap->getSamplePosition( TICKS_PER_BEAT * 4 ), 1e-6 );
+
+    // the full ramp spans four beats
+
+    double rampStart = samplesPerMinute * ( 2.0 / 120.0 );
+    double rampEnd   = rampStart + samplesPerMinute * ( 4.0 / 120.0 ) * log( 180.0 / 60.0 );
+
+    EXPECT_NEAR( rampEnd, tempoMap->getSamplePosition( TICKS_PER_BEAT * 6 ), 1e-6 );
+    EXPECT_NEAR( rampEnd + samplesPerMinute / 180.0, tempoMap->getSamplePosition( TICKS_PER_BEAT * 7 ), 1e-6 );
+
+    // positions should translate back and forth without loss of precision
+
+    for ( int i = 0; i < 100; ++i )
+    {
+        double position = randomInt( 0, TICKS_PER_BEAT * 16 ) + 0.5;
+
+        EXPECT_NEAR( position, tempoMap->getTickPosition( tempoMap->getSamplePosition( position )), 1e-6 )
+            << "expected tick position to be retained after translating to samples and back";
+    }
+
+    // changes should be reported at the first sample they apply to
+
+    EXPECT_EQ(( int ) ceil( rampStart ), tempoMap->getNextChange( 0 ));
+    EXPECT_EQ(( int ) ceil( rampEnd ), tempoMap->getNextChange(( int ) ceil( rampStart )));
+    EXPECT_EQ( -1, tempoMap->getNextChange(( int ) ceil( rampEnd )));
+
+    int version = tempoMap->getVersion();
+    tempoMap->clear();
+
+    EXPECT_EQ( 0, tempoMap->getTempoChangeAmount() );
+    EXPECT_NE( version, tempoMap->getVersion() ) << "expected version to change after altering the map";
+
+    delete tempoMap;
+}
+
+TEST( TempoMap, TimeSignatureChanges )
+{
+    TempoMap* tempoMap = new TempoMap( 120.f, 4, 4 );
+    int ticksPerBar    = TICKS_PER_BEAT * 4;
+
+    // two measures of 4/4 followed by 3/4 and a change to 6/8 halfway the fourth measure
+
+    tempoMap->addTimeSignatureChange( ticksPerBar * 2, 3, 4 );
+    tempoMap->addTimeSignatureChange( ticksPerBar * 2 + TICKS_PER_BEAT * 4, 6, 8 );
+
+    EXPECT_EQ( 4, tempoMap->getBeatAmount( ticksPerBar * 2 - 1 ));
+    EXPECT_EQ( 3, tempoMap->getBeatAmount( ticksPerBar * 2 ));
+    EXPECT_EQ( 4, tempoMap->getBeatUnit( ticksPerBar * 2 ));
+    EXPECT_EQ( 6, tempoMap->getBeatAmount( ticksPerBar * 3 ));
+    EXPECT_EQ( 8, tempoMap->getBeatUnit( ticksPerBar * 3 ));
+
+    int stepsPerBar = 16;
+
+    EXPECT_DOUBLE_EQ( 32, tempoMap->getStepPosition( ticksPerBar * 2, stepsPerBar ));
+    EXPECT_DOUBLE_EQ( 40, tempoMap->getStepPosition( ticksPerBar * 2 + TICKS_PER_BEAT * 1.5, stepsPerBar ));
+
+    // the fourth measure is cut short by the change to 6/8 (which starts the fifth measure)
+
+    EXPECT_DOUBLE_EQ( 64, tempoMap->getStepPosition( ticksPerBar * 2 + TICKS_PER_BEAT * 4, stepsPerBar ));
+
+    EXPECT_DOUBLE_EQ( ticksPerBar * 2 + TICKS_PER_BEAT * 1.5, tempoMap->getTickPositionForStep( 40, stepsPerBar ));
+    EXPECT_DOUBLE_EQ( ticksPerBar * 2 + TICKS_PER_BEAT * 4,   tempoMap->getTickPositionForStep( 64, stepsPerBar ));
+    EXPECT_DOUBLE_EQ( ticksPerBar * 2 + TICKS_PER_BEAT * 4,   tempoMap->getTickPositionForStep( 60, stepsPerBar ))
+        << "expected steps in the cut measure to be clamped to the change";
+
+    delete tempoMap;
+}
+
+TEST( TempoMap, Sequencer )
+{
+    float orgTempo     = AudioEngine::tempo;
+    int orgPosition    = AudioEngine::bufferPosition;
+    int orgStepsPerBar = AudioEngine::steps_per_bar;
+
+    AudioEngine::bufferPosition = 0;
+    AudioEngine::steps_per_bar  = 16;
+
+    SequencerController* controller = new SequencerController();
+    controller->setTempoNow( 120.f, 4, 4 );
+
+    BaseInstrument* instrument = new BaseInstrument();
+    BaseAudioEvent* event      = new BaseAudioEvent( instrument );
+
+    int samplesPerBeat = AudioEngineProps::SAMPLE_RATE / 2; // at 120 BPM
+
+    event->setEventStart ( samplesPerBeat * 4 );
+    event->setEventLength( samplesPerBeat );
+
+    // halve the tempo after the second beat
+
+    TempoMap* tempoMap = new TempoMap( 120.f, 4, 4 );
+    tempoMap->addTempoChange( TICKS_PER_BEAT * 2, 60.f, false );
+
+    controller->setTempoMapNow( tempoMap );
+
+    EXPECT_EQ( tempoMap, controller->getTempoMap() );
+    EXPECT_FLOAT_EQ( 120.f, AudioEngine::tempo ) << "expected tempo at the current position";
+
+    EXPECT_EQ( samplesPerBeat * 6, event->getEventStart() )
+        << "expected event to be positioned within the tempo map";
+
+    EXPECT_EQ( samplesPerBeat * 2, event->getEventLength() )
+        << "expected event length to be positioned within the tempo map";
+
+    // tempo should follow the map while the position changes, without affecting event positions
+
+    AudioEngine::handleTempoMapUpdate( nullptr );
+    AudioEngine::bufferPosition = samplesPerBeat * 3;
+    controller->setTempoMapNow( tempoMap );
+
+    EXPECT_FLOAT_EQ( 60.f, AudioEngine::tempo ) << "expected tempo at the current position";
+    EXPECT_EQ( samplesPerBeat * 6, event->getEventStart() );
+
+    // applying an altered map anew should queue its update, even though the map is the same instance
+
+    tempoMap->addTempoChange( TICKS_PER_BEAT * 2, 90.f, false );
+    controller->setTempoMap( tempoMap );
+
+    EXPECT_NE( AudioEngine::tempoMapVersion, AudioEngine::queuedTempoMapVersion )
+        << "expected the altered map to be queued for application";
+
+    controller->setTempoMapNow( tempoMap );
+
+    EXPECT_FLOAT_EQ( 90.f, AudioEngine::tempo ) << "expected tempo of the altered map at the current position";
+    EXPECT_EQ( AudioEngine::tempoMapVersion, AudioEngine::queuedTempoMapVersion );
+
+    // removing the map restores the positioning by tempo
+
+    controller->setTempoMapNow( nullptr );
+    controller->setTempoNow( 120.f, 4, 4 );
+
+    EXPECT_EQ( samplesPerBeat * 4, event->getEventStart() )
+        << "expected event to be positioned by the tempo after removing the tempo map";
+
+    delete event;
+    delete instrument;
+    delete tempoMap;
+    delete controller;
+
+    controller = new SequencerController();
+    controller->setTempoNow( orgTempo, 4, 4 );
+    delete controller;
+
+    AudioEngine::bufferPosition = orgPosition;
+    AudioEngine::steps_per_bar  = orgStepsPerBar;
+}
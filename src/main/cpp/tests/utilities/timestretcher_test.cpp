@@ -0,0 +1,70 @@
+#include "../../utilities/timestretcher.h"
+
+// counts the amount of upward zero crossings within given range of a buffer
+
+int countZeroCrossings( SAMPLE_TYPE* buffer, int start, int end )
+{
+    int crossings = 0;
+
+    for ( int i = start + 1; i < end; ++i ) {
+        if ( buffer[ i - 1 ] < 0.0 && buffer[ i ] >= 0.0 )
+            ++crossings;
+    }
+    return crossings;
+}
+
+TEST( TimeStretcher, Stretch )
+{
+    AudioEngineProps::SAMPLE_RATE = 44100;
+
+    int length          = 44100;
+    int channels        = 2;
+    double frequency    = 441.0;
+    AudioBuffer* source = new AudioBuffer( channels, length );
+
+    for ( int c = 0; c < channels; ++c )
+    {
+        SAMPLE_TYPE* buffer = source->getBufferForChannel( c );
+
+        for ( int i = 0; i < length; ++i )
+            buffer[ i ] = sin( 2.0 * M_PI * frequency * i / AudioEngineProps::SAMPLE_RATE );
+    }
+
+    double ratios[] = { 0.5, 0.75, 1.5, 2.0 };
+
+    for ( double ratio : ratios )
+    {
+        AudioBuffer* stretched = TimeStretcher::stretch( source, ratio );
+
+        EXPECT_EQ(( int ) round( length * ratio ), stretched->bufferSize )
+            << "expected stretched length to equal the source length multiplied by the ratio " << ratio;
+
+        EXPECT_EQ( channels, stretched->amountOfChannels )
+            << "expected stretched buffer to retain the channel amount";
+
+        // pitch should remain unchanged : measure frequency over one second excluding the edges
+
+        SAMPLE_TYPE* buffer = stretched->getBufferForChannel( 0 );
+        int start = stretched->bufferSize / 4;
+        int end   = stretched->bufferSize * 3 / 4;
+
+        double measured = countZeroCrossings( buffer, start, end ) * AudioEngineProps::SAMPLE_RATE / ( double )( end - start );
+
+        EXPECT_NEAR( frequency, measured, frequency * 0.03 )
+            << "expected pitch to remain unchanged when stretching by " << ratio;
+
+        delete stretched;
+    }
+    delete source;
+}
+
+TEST( TimeStretcher, Cancel )
+{
+    AudioBuffer* source = fillAudioBuffer( new AudioBuffer( 1, 44100 ));
+    std::atomic<bool> cancel( true );
+
+    EXPECT_TRUE( TimeStretcher::stretch( source, 2.0, &cancel ) == nullptr )
+        << "expected no buffer to be returned when stretching was cancelled";
+
+    delete source;
+}
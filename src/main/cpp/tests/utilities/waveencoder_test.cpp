@@ -0,0 +1,179 @@
+#include "../../utilities/waveencoder.h"
+#include "../../utilities/wavereader.h"
+#include "../../utilities/wavewriter.h"
+#include <cstdio>
+
+TEST( WaveEncoder, Construction )
+{
+    WaveEncoder* encoder = new WaveEncoder( WaveEncoder::PCM_24, true );
+
+    EXPECT_EQ( WaveEncoder::PCM_24, encoder->getFormat() );
+    EXPECT_EQ( 3, encoder->getBytesPerSample() );
+    ASSERT_FALSE( encoder->getDither() ) << "expected dither to only apply to 16-bit output";
+
+    delete encoder;
+
+    encoder = new WaveEncoder( WaveEncoder::PCM_16, true );
+
+    EXPECT_EQ( 2, encoder->getBytesPerSample() );
+    ASSERT_TRUE( encoder->getDither() );
+
+    delete encoder;
+}
+
+TEST( WaveEncoder, Formats )
+{
+    std::string outputFile = "mwengine_waveencoder_test.wav";
+
+    int formats[ 3 ]      = { WaveEncoder::PCM_16, WaveEncoder::PCM_24, WaveEncoder::FLOAT_32 };
+    double tolerances[ 3 ] = { 1.0 / 32767, 1.0 / 8388607, 0.000001 };
+
+    int amountOfChannels = 2;
+    int bufferSize       = 512;
+    AudioBuffer* buffer  = fillAudioBuffer( new AudioBuffer( amountOfChannels, bufferSize ));
+
+    for ( int f = 0; f < 3; ++f )
+    {
+        size_t written = WaveWriter::bufferToWAV( outputFile, buffer, 48000, formats[ f ] );
+
+        EXPECT_EQ(( size_t ) bufferSize * amountOfChannels * ( f + 2 ), written )
+            << "expected the data size to match the sample size of the format";
+
+        waveFile WAV = WaveReader::fileToBuffer( outputFile );
+
+        ASSERT_FALSE( WAV.buffer == nullptr ) << "expected a valid WAV file to have been written";
+        EXPECT_EQ( 48000, ( int ) WAV.sampleRate );
+        EXPECT_EQ( amountOfChannels, WAV.buffer->amountOfChannels );
+        ASSERT_EQ( bufferSize, WAV.buffer->bufferSize );
+
+        for ( int c = 0; c < amountOfChannels; ++c )
+        {
+            SAMPLE_TYPE* expected = buffer->getBufferForChannel( c );
+            SAMPLE_TYPE* actual   = WAV.buffer->getBufferForChannel( c );
+
+            for ( int i = 0; i < bufferSize; ++i ) {
+                EXPECT_NEAR( expected[ i ], actual[ i ], tolerances[ f ] )
+                    << "expected sample to have been written at the resolution of format " << formats[ f ];
+            }
+        }
+        delete WAV.buffer;
+    }
+
+    delete buffer;
+    remove( outputFile.c_str() );
+}
+
+TEST( WaveEncoder, Dither )
+{
+    std::string outputFile = "mwengine_waveencoder_dither_test.wav";
+
+    // a signal below the 16-bit quantisation step is lost without dither
+
+    int bufferSize = 4096;
+    float input[ 4096 ];
+
+    for ( int i = 0; i < bufferSize; ++i )
+        input[ i ] = 0.25f / 32767.f;
+
+    WaveEncoder* encoder = new WaveEncoder( WaveEncoder::PCM_16, true );
+
+    ASSERT_TRUE( encoder->open( outputFile, 44100, 1 ));
+    encoder->encode( input, bufferSize );
+    encoder->close();
+
+    EXPECT_EQ(( size_t ) bufferSize * 2, encoder->getDataSize() );
+
+    waveFile WAV = WaveReader::fileToBuffer( outputFile );
+    ASSERT_FALSE( WAV.buffer == nullptr );
+
+    SAMPLE_TYPE* samples = WAV.buffer->getBufferForChannel( 0 );
+    SAMPLE_TYPE sum      = 0.0;
+    bool hasSignal       = false;
+
+    for ( int i = 0; i < bufferSize; ++i ) {
+        sum += samples[ i ];
+        hasSignal = hasSignal || samples[ i ] != 0.0;
+
+        EXPECT_LE( std::abs( samples[ i ] * 32767 ), 2.0 ) << "expected dither noise to not exceed 2 LSB";
+    }
+
+    ASSERT_TRUE( hasSignal ) << "expected dither to have preserved the low level signal";
+    EXPECT_NEAR( 0.25, sum / bufferSize * 32767, 0.1 ) << "expected the average to match the input signal";
+
+    delete WAV.buffer;
+    delete encoder;
+
+    remove( outputFile.c_str() );
+}
+
+TEST( WaveEncoder, AlignedWrites )
+{
+    std::string outputFile = "mwengine_waveencoder_aligned_test.wav";
+    WaveEncoder* encoder   = new WaveEncoder( WaveEncoder::PCM_16 );
+
+    ASSERT_TRUE( encoder->open( outputFile, 44100, 1 ));
+
+    // encode an amount of data that doesn't align with the block size
+    // (the remainder is kept pending until the next update)
+
+    int amountOfFrames = WaveEncoder::BLOCK_SIZE + 1000;
+    std::vector<float> buffer( amountOfFrames );
+
+    for ( int i = 0; i < amountOfFrames; ++i )
+        buffer[ i ] = ( float ) i / amountOfFrames;
+
+    encoder->encode( buffer.data(), amountOfFrames / 2 );
+    encoder->encode( buffer.data() + amountOfFrames / 2, amountOfFrames - amountOfFrames / 2 );
+
+    // an update writes all encoded data and describes it in the header
+
+    encoder->update();
+
+    waveFile WAV = WaveReader::fileToBuffer( outputFile );
+
+    ASSERT_FALSE( WAV.buffer == nullptr );
+    ASSERT_EQ( amountOfFrames, WAV.buffer->bufferSize ) << "expected all encoded frames to have been written on update";
+
+    for ( int i = 0; i < amountOfFrames; i += 1000 ) {
+        EXPECT_NEAR(( SAMPLE_TYPE ) i / amountOfFrames, WAV.buffer->getBufferForChannel( 0 )[ i ], 0.0001 )
+            << "expected frames to have been written in order";
+    }
+
+    delete WAV.buffer;
+    delete encoder;
+
+    remove( outputFile.c_str() );
+}
+
+TEST( WaveEncoder, Recover )
+{
+    std::string outputFile = "mwengine_waveencoder_recover_test.wav";
+
+    // simulate a recording that was interrupted before its header was updated,
+    // with the last frame only partially written
+
+    int amountOfFrames = 512;
+    std::ofstream stream = WaveWriter::createWAVStream( outputFile.c_str(), 0, 44100, 2 );
+
+    std::vector<INT16> frames( amountOfFrames * 2, 1000 );
+    stream.write(( const char* ) frames.data(), frames.size() * sizeof( INT16 ));
+    stream.write(( const char* ) frames.data(), 3 );
+    stream.close();
+
+    WaveEncoder* encoder = new WaveEncoder( WaveEncoder::PCM_16 );
+
+    ASSERT_TRUE( encoder->recover( outputFile ));
+
+    waveFile WAV = WaveReader::fileToBuffer( outputFile );
+
+    ASSERT_FALSE( WAV.buffer == nullptr ) << "expected recovered file to be readable";
+    EXPECT_EQ( amountOfFrames, WAV.buffer->bufferSize ) << "expected all whole frames to have been recovered";
+    EXPECT_NEAR( 1000.0 / 32767, WAV.buffer->getBufferForChannel( 1 )[ amountOfFrames - 1 ], 0.0001 );
+
+    ASSERT_FALSE( encoder->recover( "mwengine_nonexisting_file.wav" ));
+
+    delete WAV.buffer;
+    delete encoder;
+
+    remove( outputFile.c_str() );
+}
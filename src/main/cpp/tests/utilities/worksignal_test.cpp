@@ -0,0 +1,34 @@
+#include "../../utilities/worksignal.h"
+
+TEST( WorkSignal, Signal )
+{
+    WorkSignal* signal = new WorkSignal();
+
+    ASSERT_FALSE( signal->isPending() ) << "expected no work to be pending after construction";
+    EXPECT_FALSE( signal->wait( 1 )) << "expected wait to time out when not signalled";
+
+    // repeated signals are coalesced into a single wake up
+
+    signal->signal();
+    signal->signal();
+
+    ASSERT_TRUE( signal->isPending() ) << "expected work to be pending after signalling";
+    EXPECT_TRUE( signal->wait( 1 )) << "expected wait to return after signalling";
+    EXPECT_FALSE( signal->isPending() ) << "expected pending flag to have been lowered after waking";
+    EXPECT_FALSE( signal->wait( 1 )) << "expected repeated signals to have been coalesced";
+
+    // signalling from another thread should wake a blocked worker
+
+    std::atomic<bool> woken( false );
+
+    std::thread worker([ signal, &woken ]() {
+        signal->wait();
+        woken = true;
+    });
+    signal->signal();
+    worker.join();
+
+    EXPECT_TRUE( woken.load() ) << "expected the worker to have been woken";
+
+    delete signal;
+}
@@ -104,6 +104,26 @@ TEST( WaveTable, Accumulator )
     delete table;
 }
 
+TEST( WaveTable, Advance )
+{
+    int length       = randomInt( 2, 256 );
+    float frequency  = randomFloat( 20, 880 );
+    WaveTable* table = new WaveTable( length, frequency );
+    WaveTable* ref   = new WaveTable( length, frequency );
+    int amount       = randomInt( 1, 1024 );
+
+    for ( int i = 0; i < amount; ++i )
+        ref->peek();
+
+    table->advance( amount );
+
+    EXPECT_NEAR( ref->getAccumulator(), table->getAccumulator(), 0.001 )
+        << "expected WaveTable accumulator to equal the position after " << amount << " peeks";
+
+    delete table;
+    delete ref;
+}
+
 TEST( WaveTable, CloneTable )
 {
     int length1      = randomInt( 2, 256 );
@@ -0,0 +1,247 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "audiorenderer.h"
+#include "samplemanager.h"
+#include "audioengine.h"
+#include "sequencer.h"
+#include <definitions/notifications.h>
+#include <messaging/notifier.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace MWEngine {
+
+namespace AudioRendererState
+{
+    std::atomic<bool> _rendering( false );
+    std::atomic<bool> _threadActive( false ); // whether the (detached) worker thread has yet to return
+    AudioBuffer* _result = nullptr;
+}
+
+using namespace AudioRendererState;
+
+/* public methods */
+
+AudioBuffer* AudioRenderer::render( int rangeStart, int rangeEnd )
+{
+    std::vector<BaseInstrument*> instruments;
+
+    for ( size_t i = 0; i < Sequencer::instruments.size(); ++i )
+    {
+        BaseInstrument* instrument = Sequencer::instruments.at( i );
+
+        if ( !instrument->audioChannel->muted )
+            instruments.push_back( instrument );
+    }
+    return render( rangeStart, rangeEnd, instruments, true, true );
+}
+
+AudioBuffer* AudioRenderer::render( int rangeStart, int rangeEnd, std::vector<BaseInstrument*> instruments,
+                                    bool applyProcessing, bool applyMix )
+{
+    if ( rangeEnd < rangeStart )
+        return nullptr;
+
+    AudioBuffer* output = new AudioBuffer( AudioEngineProps::OUTPUT_CHANNELS, rangeEnd - rangeStart + 1 );
+
+    for ( size_t i = 0; i < instruments.size(); ++i )
+    {
+        BaseInstrument* instrument = instruments.at( i );
+        int amountOfProcessors     = applyProcessing ? ( int ) instrument->audioChannel->processingChain->getActiveProcessors().size() : 0;
+
+        renderInstrument( instrument, output, rangeStart, rangeEnd, amountOfProcessors, applyMix );
+    }
+    return output;
+}
+
+AudioBuffer* AudioRenderer::render( int rangeStart, int rangeEnd, BaseInstrument* instrument, int amountOfProcessors )
+{
+    if ( rangeEnd < rangeStart )
+        return nullptr;
+
+    AudioBuffer* output = new AudioBuffer( AudioEngineProps::OUTPUT_CHANNELS, rangeEnd - rangeStart + 1 );
+    renderInstrument( instrument, output, rangeStart, rangeEnd, amountOfProcessors, false );
+
+    return output;
+}
+
+bool AudioRenderer::renderToSample( std::string sampleKey, int rangeStart, int rangeEnd,
+                                    std::vector<BaseInstrument*> instruments, bool applyProcessing, bool applyMix )
+{
+    AudioBuffer* buffer = render( rangeStart, rangeEnd, instruments, applyProcessing, applyMix );
+
+    if ( buffer == nullptr )
+        return false;
+
+    SampleManager::setSample( sampleKey, buffer, ( unsigned int ) AudioEngineProps::SAMPLE_RATE );
+    return true;
+}
+
+bool AudioRenderer::renderAsync( int rangeStart, int rangeEnd, std::vector<BaseInstrument*> instruments,
+                                 bool applyProcessing, bool applyMix )
+{
+    if ( _rendering )
+        return false;
+
+    // the events and processors are shared with the engine, refuse rendering
+    // channels that are already being rendered outside of the engine (e.g. by the Freezer)
+
+    for ( size_t i = 0; i < instruments.size(); ++i ) {
+        if ( instruments.at( i )->audioChannel->isFreezing())
+            return false;
+    }
+
+    // await the worker of the previous render (which has completed, but might still be broadcasting)
+
+    while ( _threadActive )
+        std::this_thread::yield();
+
+    delete _result;
+    _result = nullptr;
+
+    _rendering    = true;
+    _threadActive = true;
+
+    // the worker is detached (rather than joined by getResult()) so no joinable thread
+    // remains when the result is never retrieved
+
+    std::thread([ rangeStart, rangeEnd, instruments, applyProcessing, applyMix ]()
+    {
+        // omit the channels from the engine while rendering (see AudioChannel::setFreezing())
+
+        for ( size_t i = 0; i < instruments.size(); ++i )
+            instruments.at( i )->audioChannel->setFreezing( true );
+
+        AudioBuffer* result = render( rangeStart, rangeEnd, instruments, applyProcessing, applyMix );
+
+        for ( size_t i = 0; i < instruments.size(); ++i )
+            instruments.at( i )->audioChannel->setFreezing( false );
+
+        _result    = result;
+        _rendering = false;
+
+        Notifier::broadcast( Notifications::RENDER_COMPLETE );
+
+        _threadActive = false;
+    }).detach();
+
+    return true;
+}
+
+bool AudioRenderer::isRendering()
+{
+    return _rendering;
+}
+
+AudioBuffer* AudioRenderer::getResult()
+{
+    if ( _rendering )
+        return nullptr;
+
+    AudioBuffer* result = _result;
+    _result = nullptr;
+
+    return result;
+}
+
+/* private methods */
+
+void AudioRenderer::renderInstrument( BaseInstrument* instrument, AudioBuffer* output, int rangeStart, int rangeEnd,
+                                      int amountOfProcessors, bool applyMix )
+{
+    AudioChannel* channel = instrument->audioChannel;
+    int bufferSize        = AudioEngineProps::BUFFER_SIZE;
+
+    // render in buffers of the engines size (as processors might expect these)
+
+    AudioBuffer* channelBuffer = new AudioBuffer( output->amountOfChannels, bufferSize );
+    std::vector<BaseAudioEvent*> events;
+
+    std::vector<BaseProcessor*> processors = channel->processingChain->getActiveProcessors();
+
+    if (( int ) processors.size() > amountOfProcessors )
+        processors.resize( std::max( 0, amountOfProcessors ));
+
+    bool useChannelRange  = channel->maxBufferPosition != 0; // channel has its own buffer range (i.e. drummachine)
+    int maxBufferPosition = useChannelRange ? channel->maxBufferPosition : rangeEnd;
+    float volume          = applyMix ? channel->getVolumeLogarithmic() : 1.f;
+
+    for ( int position = rangeStart; position <= rangeEnd; position += bufferSize )
+    {
+        channelBuffer->silenceBuffers();
+
+        int bufferPos = position;
+
+        // see AudioEngine::render(), channels with their own range loop by the measure
+
+        if ( useChannelRange ) {
+            while ( bufferPos > maxBufferPosition )
+                bufferPos -= AudioEngine::samples_per_bar;
+        }
+        int bufferEnd = bufferPos + bufferSize - 1;
+
+        // collect the events audible within this buffer (see Sequencer::collectSequencedEvents())
+
+        events.clear();
+        instrument->toggleReadLock( true );
+
+        std::vector<BaseAudioEvent*>* audioEvents = instrument->getEvents();
+
+        for ( size_t i = 0; i < audioEvents->size(); ++i )
+        {
+            BaseAudioEvent* audioEvent = audioEvents->at( i );
+
+            if ( !audioEvent->isEnabled() || audioEvent->isDeletable())
+                continue;
+
+            int eventStart = audioEvent->getEventStart();
+            int eventEnd   = audioEvent->getEventEnd();
+
+            if (( eventStart >= bufferPos && eventStart <= bufferEnd ) ||
+                ( eventStart <  bufferPos && eventEnd >= bufferPos ))
+                events.push_back( audioEvent );
+        }
+        instrument->toggleReadLock( false );
+
+        for ( size_t i = 0; i < events.size(); ++i )
+        {
+            events.at( i )->mixBuffer( channelBuffer, bufferPos, AudioEngine::min_buffer_position,
+                                       maxBufferPosition, false, 0, useChannelRange );
+        }
+
+        for ( size_t i = 0; i < processors.size(); ++i )
+            processors.at( i )->process( channelBuffer, channel->isMono );
+
+        // write the rendered buffer into the output (note the last buffer can exceed
+        // the range, in which case only the remainder of the range is written)
+
+        if ( applyMix )
+            channel->mixBuffer( channelBuffer, output, position - rangeStart, volume );
+        else
+            output->mergeBuffers( channelBuffer, 0, position - rangeStart, 1.f );
+    }
+    delete channelBuffer;
+}
+
+} // E.O namespace MWEngine
@@ -0,0 +1,100 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__AUDIORENDERER_H_INCLUDED__
+#define __MWENGINE__AUDIORENDERER_H_INCLUDED__
+
+#include "global.h"
+#include "audiobuffer.h"
+#include <instruments/baseinstrument.h>
+#include <string>
+#include <vector>
+
+namespace MWEngine {
+
+/**
+ * AudioRenderer renders a range of the sequencer directly into an AudioBuffer (rather than
+ * bouncing it onto storage and reading the file back). This can be used to "freeze" or
+ * resample a section within the application. The rendered buffer can be registered in
+ * the SampleManager directly (see renderToSample()).
+ *
+ * Rendering is performed separately from the engine (e.g. the sequencer position, the
+ * AudioChannel buffers and the master bus are left untouched) and as such can run while
+ * the engine is playing. However, as the events and processors of the rendered instruments
+ * are shared with the engine, rendered instruments should not be audible in the engine
+ * while rendering (e.g. mute their channel or stop the sequencer) or their playback will be disturbed.
+ *
+ * The rendered buffer has AudioEngineProps::OUTPUT_CHANNELS channels and holds the
+ * range from rangeStart up to and including rangeEnd (in samples). Rendered buffers
+ * are owned by the caller.
+ */
+class AudioRenderer
+{
+    public:
+
+        // render given range for all (unmuted) instruments registered in the sequencer,
+        // including their processing chains and mix (volume and panning)
+
+        static AudioBuffer* render( int rangeStart, int rangeEnd );
+
+        // render given range for given instruments. applyProcessing specifies whether to apply
+        // the processing chain of each instruments AudioChannel and applyMix whether to apply the
+        // channels volume and panning. Muted instruments are rendered when they're in the list.
+
+        static AudioBuffer* render( int rangeStart, int rangeEnd, std::vector<BaseInstrument*> instruments,
+                                    bool applyProcessing, bool applyMix );
+
+        // render given range for a single instrument (without its channel mix) applying only the
+        // first amountOfProcessors processors of its processing chain (e.g. see Freezer)
+
+        static AudioBuffer* render( int rangeStart, int rangeEnd, BaseInstrument* instrument, int amountOfProcessors );
+
+        // render given range for given instruments and register the result in the SampleManager
+        // under given identifier, returns false when nothing could be rendered
+
+        static bool renderToSample( std::string sampleKey, int rangeStart, int rangeEnd,
+                                    std::vector<BaseInstrument*> instruments, bool applyProcessing, bool applyMix );
+
+        /* asynchronous rendering */
+
+        // render on a worker thread, RENDER_COMPLETE is broadcast when the render has completed after which
+        // the result can be retrieved using getResult(). While rendering, the channels of given instruments are
+        // omitted from the engine output (see AudioChannel::setFreezing()). Returns false when a render is
+        // already in progress or when one of the channels is being rendered elsewhere (e.g. by the Freezer)
+
+        static bool renderAsync( int rangeStart, int rangeEnd, std::vector<BaseInstrument*> instruments,
+                                 bool applyProcessing, bool applyMix );
+
+        static bool isRendering();
+
+        // returns the result of the last asynchronous render (ownership is transferred to the caller)
+        // nullptr is returned while rendering or when the result has already been retrieved
+
+        static AudioBuffer* getResult();
+
+    private:
+        static void renderInstrument( BaseInstrument* instrument, AudioBuffer* output, int rangeStart, int rangeEnd,
+                                      int amountOfProcessors, bool applyMix );
+};
+} // E.O namespace MWEngine
+
+#endif
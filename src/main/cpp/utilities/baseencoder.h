@@ -0,0 +1,72 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__BASEENCODER_H_INCLUDED__
+#define __MWENGINE__BASEENCODER_H_INCLUDED__
+
+#include <string>
+
+namespace MWEngine {
+
+/**
+ * BaseEncoder describes the interface for writing (interleaved) audio into a file
+ * of a specific format. Encoders are used by RecordingStream / DiskWriter to encode
+ * audio while it is being recorded, which omits the need for a separate export pass.
+ * Encoders are invoked from the writer thread and are free to allocate and block.
+ *
+ * See WaveEncoder for the default implementation. Additional (e.g. compressed) formats
+ * can be provided by extending this class and registering a factory via DiskWriter::setEncoderFactory()
+ */
+class BaseEncoder
+{
+    public:
+        virtual ~BaseEncoder() {}
+
+        // create the output file for audio of given properties
+        virtual bool open( std::string outputFile, int sampleRate, int amountOfChannels ) = 0;
+
+        // encode given amount of interleaved frames into the output file
+        virtual void encode( const float* interleavedBuffer, int amountOfFrames ) = 0;
+
+        // invoked periodically during recording, allows the encoder to update the output file so
+        // it describes a valid file up to the encoded point (e.g. by updating its header). Encoders
+        // should commit the file to storage here so the recording survives termination of the application
+        virtual void update() {}
+
+        // complete the output file
+        virtual void close() = 0;
+
+        // the extension of the files written by this encoder (e.g. ".wav")
+        virtual std::string getFileExtension() = 0;
+
+        // repair a file this encoder was writing when the application was terminated (e.g. close()
+        // was never invoked) so it can be read. Returns true when the file is valid after recovery
+        virtual bool recover( std::string outputFile ) { return false; }
+};
+
+// function creating a new encoder instance for each recorded file
+
+typedef BaseEncoder* ( *EncoderFactory )();
+
+} // E.O namespace MWEngine
+
+#endif
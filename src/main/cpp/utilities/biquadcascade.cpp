@@ -0,0 +1,301 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "biquadcascade.h"
+#include <algorithm>
+
+namespace MWEngine {
+
+const int BiquadCascade::LANES;
+const int BiquadCascade::BLOCK_SIZE;
+
+/* constructor / destructor */
+
+BiquadCascade::BiquadCascade( int amountOfChannels, int amountOfSections )
+{
+    _amountOfChannels = amountOfChannels;
+    _amountOfSections = amountOfSections;
+    _amountOfLanes    = (( amountOfChannels + LANES - 1 ) / LANES ) * LANES;
+
+    _b0 = new SAMPLE_TYPE[ amountOfSections ];
+    _b1 = new SAMPLE_TYPE[ amountOfSections ];
+    _b2 = new SAMPLE_TYPE[ amountOfSections ];
+    _a1 = new SAMPLE_TYPE[ amountOfSections ];
+    _a2 = new SAMPLE_TYPE[ amountOfSections ];
+
+    _targets     = new SAMPLE_TYPE[ amountOfSections * 5 ];
+    _deltas      = new SAMPLE_TYPE[ amountOfSections * 5 ];
+    _rampLengths = new int[ amountOfSections ];
+
+    int stateSize = amountOfSections * _amountOfLanes;
+
+    _z1       = new SAMPLE_TYPE[ stateSize ];
+    _z2       = new SAMPLE_TYPE[ stateSize ];
+    _storedZ1 = new SAMPLE_TYPE[ stateSize ];
+    _storedZ2 = new SAMPLE_TYPE[ stateSize ];
+
+    // sections pass their input unchanged until coefficients are set
+
+    for ( int s = 0; s < amountOfSections; ++s )
+        setCoefficients( s, 1.0, 0.0, 0.0, 0.0, 0.0 );
+
+    reset();
+    store();
+}
+
+BiquadCascade::~BiquadCascade()
+{
+    delete[] _b0;
+    delete[] _b1;
+    delete[] _b2;
+    delete[] _a1;
+    delete[] _a2;
+    delete[] _targets;
+    delete[] _deltas;
+    delete[] _rampLengths;
+    delete[] _z1;
+    delete[] _z2;
+    delete[] _storedZ1;
+    delete[] _storedZ2;
+}
+
+/* public methods */
+
+int BiquadCascade::getAmountOfChannels()
+{
+    return _amountOfChannels;
+}
+
+int BiquadCascade::getAmountOfSections()
+{
+    return _amountOfSections;
+}
+
+void BiquadCascade::setCoefficients( int section, SAMPLE_TYPE b0, SAMPLE_TYPE b1, SAMPLE_TYPE b2, SAMPLE_TYPE a1, SAMPLE_TYPE a2 )
+{
+    _b0[ section ] = b0;
+    _b1[ section ] = b1;
+    _b2[ section ] = b2;
+    _a1[ section ] = a1;
+    _a2[ section ] = a2;
+
+    _rampLengths[ section ] = 0;
+}
+
+void BiquadCascade::rampCoefficients( int section, SAMPLE_TYPE b0, SAMPLE_TYPE b1, SAMPLE_TYPE b2,
+                                      SAMPLE_TYPE a1, SAMPLE_TYPE a2, int samples )
+{
+    if ( samples <= 0 ) {
+        setCoefficients( section, b0, b1, b2, a1, a2 );
+        return;
+    }
+    SAMPLE_TYPE* targets = &_targets[ section * 5 ];
+    SAMPLE_TYPE* deltas  = &_deltas [ section * 5 ];
+    SAMPLE_TYPE step     = 1.0 / ( SAMPLE_TYPE ) samples;
+
+    targets[ 0 ] = b0;
+    targets[ 1 ] = b1;
+    targets[ 2 ] = b2;
+    targets[ 3 ] = a1;
+    targets[ 4 ] = a2;
+
+    deltas[ 0 ] = ( b0 - _b0[ section ]) * step;
+    deltas[ 1 ] = ( b1 - _b1[ section ]) * step;
+    deltas[ 2 ] = ( b2 - _b2[ section ]) * step;
+    deltas[ 3 ] = ( a1 - _a1[ section ]) * step;
+    deltas[ 4 ] = ( a2 - _a2[ section ]) * step;
+
+    _rampLengths[ section ] = samples;
+}
+
+void BiquadCascade::process( AudioBuffer* sampleBuffer, bool isMonoSource )
+{
+    if ( sampleBuffer->amountOfChannels > _amountOfChannels )
+        isMonoSource = true;
+
+    process( sampleBuffer, isMonoSource ? 1 : sampleBuffer->amountOfChannels, 0, sampleBuffer->bufferSize );
+
+    // save CPU cycles when source is mono
+    if ( isMonoSource )
+        sampleBuffer->applyMonoSource();
+}
+
+void BiquadCascade::process( AudioBuffer* sampleBuffer, int amountOfChannels, int offset, int length )
+{
+    amountOfChannels = std::min( amountOfChannels, std::min( _amountOfChannels, sampleBuffer->amountOfChannels ));
+
+    // allocated on the stack as heap allocations aren't guaranteed to meet the vector alignment
+
+    Frame frames[ BLOCK_SIZE ];
+
+    for ( int i = 0; i < length; i += BLOCK_SIZE )
+    {
+        int blockSize = std::min( BLOCK_SIZE, length - i );
+
+        for ( int lane = 0; lane < amountOfChannels; lane += LANES )
+        {
+            int lanes = std::min( LANES, amountOfChannels - lane );
+
+            // interleave the channels into frames (unused lanes are silent)
+
+            for ( int l = 0; l < LANES; ++l )
+            {
+                if ( l < lanes ) {
+                    SAMPLE_TYPE* channelBuffer = sampleBuffer->getBufferForChannel( lane + l ) + offset + i;
+                    for ( int j = 0; j < blockSize; ++j )
+                        frames[ j ][ l ] = channelBuffer[ j ];
+                }
+                else {
+                    for ( int j = 0; j < blockSize; ++j )
+                        frames[ j ][ l ] = 0.0;
+                }
+            }
+
+            for ( int s = 0; s < _amountOfSections; ++s )
+                processSection( s, lane, frames, blockSize );
+
+            // write the filtered frames back into the channels
+
+            for ( int l = 0; l < lanes; ++l )
+            {
+                SAMPLE_TYPE* channelBuffer = sampleBuffer->getBufferForChannel( lane + l ) + offset + i;
+                for ( int j = 0; j < blockSize; ++j )
+                    channelBuffer[ j ] = frames[ j ][ l ];
+            }
+        }
+        // all lanes have been processed using the same coefficient ramp
+        advanceRamps( blockSize );
+    }
+}
+
+void BiquadCascade::reset()
+{
+    for ( int i = 0, l = _amountOfSections * _amountOfLanes; i < l; ++i )
+    {
+        _z1[ i ] = 0.0;
+        _z2[ i ] = 0.0;
+    }
+}
+
+void BiquadCascade::store()
+{
+    std::copy( _z1, _z1 + _amountOfSections * _amountOfLanes, _storedZ1 );
+    std::copy( _z2, _z2 + _amountOfSections * _amountOfLanes, _storedZ2 );
+}
+
+void BiquadCascade::restore()
+{
+    std::copy( _storedZ1, _storedZ1 + _amountOfSections * _amountOfLanes, _z1 );
+    std::copy( _storedZ2, _storedZ2 + _amountOfSections * _amountOfLanes, _z2 );
+}
+
+/* private methods */
+
+/**
+ * run a single section over length amount of frames
+ * for the lanes starting at given lane
+ */
+void BiquadCascade::processSection( int section, int lane, Frame* frames, int length )
+{
+    SAMPLE_TYPE b0 = _b0[ section ], b1 = _b1[ section ], b2 = _b2[ section ],
+                a1 = _a1[ section ], a2 = _a2[ section ];
+
+    SAMPLE_TYPE* z1 = &_z1[ section * _amountOfLanes + lane ];
+    SAMPLE_TYPE* z2 = &_z2[ section * _amountOfLanes + lane ];
+    Frame s1, s2;
+
+    for ( int l = 0; l < LANES; ++l ) {
+        s1[ l ] = z1[ l ];
+        s2[ l ] = z2[ l ];
+    }
+
+    SAMPLE_TYPE* deltas = &_deltas[ section * 5 ];
+    int rampLength      = std::min( _rampLengths[ section ], length );
+    int j = 0;
+
+    // coefficients are being interpolated
+
+    for ( ; j < rampLength; ++j )
+    {
+        Frame input  = frames[ j ];
+        Frame output = b0 * input + s1;
+        s1 = b1 * input - a1 * output + s2;
+        s2 = b2 * input - a2 * output;
+        frames[ j ] = output;
+
+        b0 += deltas[ 0 ];
+        b1 += deltas[ 1 ];
+        b2 += deltas[ 2 ];
+        a1 += deltas[ 3 ];
+        a2 += deltas[ 4 ];
+    }
+
+    // static coefficients
+
+    for ( ; j < length; ++j )
+    {
+        Frame input  = frames[ j ];
+        Frame output = b0 * input + s1;
+        s1 = b1 * input - a1 * output + s2;
+        s2 = b2 * input - a2 * output;
+        frames[ j ] = output;
+    }
+
+    for ( int l = 0; l < LANES; ++l ) {
+        z1[ l ] = s1[ l ];
+        z2[ l ] = s2[ l ];
+    }
+}
+
+void BiquadCascade::advanceRamps( int length )
+{
+    for ( int s = 0; s < _amountOfSections; ++s )
+    {
+        if ( _rampLengths[ s ] == 0 )
+            continue;
+
+        int amount = std::min( _rampLengths[ s ], length );
+        _rampLengths[ s ] -= amount;
+
+        SAMPLE_TYPE* targets = &_targets[ s * 5 ];
+        SAMPLE_TYPE* deltas  = &_deltas [ s * 5 ];
+
+        // ramp complete ? snap to the target values to prevent accumulated rounding errors
+
+        if ( _rampLengths[ s ] == 0 ) {
+            _b0[ s ] = targets[ 0 ];
+            _b1[ s ] = targets[ 1 ];
+            _b2[ s ] = targets[ 2 ];
+            _a1[ s ] = targets[ 3 ];
+            _a2[ s ] = targets[ 4 ];
+        }
+        else {
+            _b0[ s ] += deltas[ 0 ] * amount;
+            _b1[ s ] += deltas[ 1 ] * amount;
+            _b2[ s ] += deltas[ 2 ] * amount;
+            _a1[ s ] += deltas[ 3 ] * amount;
+            _a2[ s ] += deltas[ 4 ] * amount;
+        }
+    }
+}
+
+} // E.O namespace MWEngine
@@ -0,0 +1,141 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__BIQUADCASCADE_H_INCLUDED__
+#define __MWENGINE__BIQUADCASCADE_H_INCLUDED__
+
+#include "../global.h"
+#include "../audiobuffer.h"
+
+namespace MWEngine {
+
+/**
+ * BiquadCascade is the IIR core shared by the filter processors. It runs a series of
+ * second order sections (transposed direct form II) over all channels of an AudioBuffer
+ * in a single pass, where the channels are laid out side by side as the lanes of a frame
+ *
+ * a block of input is interleaved into frames of LANES samples, after which each section
+ * processes the entire block before the next section does. As the lanes share the section
+ * coefficients, a frame is processed using vector arithmetic (e.g. a stereo frame of
+ * doubles occupies a single SSE2 / NEON register)
+ *
+ * the state and coefficients are stored per section (structure-of-arrays), the transfer
+ * function of a section is normalized to a0 == 1:
+ *
+ *     H( z ) = ( b0 + b1 z^-1 + b2 z^-2 ) / ( 1 + a1 z^-1 + a2 z^-2 )
+ *
+ * first order filters are described by leaving b2 and a2 at 0
+ */
+class BiquadCascade
+{
+    public:
+        BiquadCascade( int amountOfChannels, int amountOfSections );
+        ~BiquadCascade();
+
+        static const int LANES      = 2;  // amount of channels processed side by side
+        static const int BLOCK_SIZE = 64; // amount of frames interleaved at a time
+
+        // a frame holds a sample for each lane, arithmetic on frames compiles to SIMD
+        // instructions (using the GCC / Clang vector extensions)
+
+        typedef SAMPLE_TYPE Frame __attribute__(( vector_size( sizeof( SAMPLE_TYPE ) * LANES )));
+
+        int getAmountOfChannels();
+        int getAmountOfSections();
+
+        // set the coefficients for given section, this takes effect immediately
+
+        void setCoefficients( int section, SAMPLE_TYPE b0, SAMPLE_TYPE b1, SAMPLE_TYPE b2, SAMPLE_TYPE a1, SAMPLE_TYPE a2 );
+
+        // linearly interpolate the coefficients for given section from their current
+        // values to the given values over the next amount of processed samples
+        // (e.g. for glitch free modulation at control rate)
+
+        void rampCoefficients( int section, SAMPLE_TYPE b0, SAMPLE_TYPE b1, SAMPLE_TYPE b2, SAMPLE_TYPE a1, SAMPLE_TYPE a2, int samples );
+
+        /**
+         * filter the contents of given buffer in place. When the buffer is a mono source (or
+         * has more channels than this cascade has been constructed for) only the first channel
+         * is processed, after which its contents are copied into the remaining channels
+         */
+        void process( AudioBuffer* sampleBuffer, bool isMonoSource );
+
+        // filter length amount of samples, starting at offset, for the first amount of channels
+
+        void process( AudioBuffer* sampleBuffer, int amountOfChannels, int offset, int length );
+
+        // filter a single sample for given channel (doesn't advance coefficient ramps)
+
+        inline SAMPLE_TYPE processSample( SAMPLE_TYPE sample, int channel )
+        {
+            for ( int s = 0, i = channel; s < _amountOfSections; ++s, i += _amountOfLanes )
+            {
+                SAMPLE_TYPE output = _b0[ s ] * sample + _z1[ i ];
+                _z1[ i ] = _b1[ s ] * sample - _a1[ s ] * output + _z2[ i ];
+                _z2[ i ] = _b2[ s ] * sample - _a2[ s ] * output;
+                sample   = output;
+            }
+            return sample;
+        }
+
+        // clear the filter history
+
+        void reset();
+
+        // store/restore the filter history, e.g. to process
+        // a signal multiple times starting from the same state
+
+        void store();
+        void restore();
+
+    private:
+        int _amountOfChannels;
+        int _amountOfSections;
+        int _amountOfLanes; // amount of channels rounded up to a multiple of LANES
+
+        // coefficients per section
+
+        SAMPLE_TYPE* _b0;
+        SAMPLE_TYPE* _b1;
+        SAMPLE_TYPE* _b2;
+        SAMPLE_TYPE* _a1;
+        SAMPLE_TYPE* _a2;
+
+        // per sample coefficient increments (and remaining length) for ramping sections
+
+        SAMPLE_TYPE* _targets; // five coefficients per section
+        SAMPLE_TYPE* _deltas;
+        int*         _rampLengths;
+
+        // filter history per section, per lane (index == section * _amountOfLanes + lane)
+
+        SAMPLE_TYPE* _z1;
+        SAMPLE_TYPE* _z2;
+        SAMPLE_TYPE* _storedZ1;
+        SAMPLE_TYPE* _storedZ2;
+
+        void processSection( int section, int lane, Frame* frames, int length );
+        void advanceRamps( int length );
+};
+} // E.O namespace MWEngine
+
+#endif
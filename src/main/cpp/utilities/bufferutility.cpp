@@ -72,6 +72,11 @@ int BufferUtility::getSamplesPerBar( int sampleRate, double tempo, int beatAmoun
     return samplesPerDoubleFourTime / beatUnit * beatAmount;
 }
 
+double BufferUtility::getSamplesPerTick( int sampleRate, double tempo )
+{
+    return (( double ) sampleRate * 60.0 ) / ( tempo * ( double ) TICKS_PER_BEAT );
+}
+
 int BufferUtility::calculateBufferLength( SAMPLE_TYPE aMinRate )
 {
     SAMPLE_TYPE phaseStep = aMinRate / AudioEngineProps::SAMPLE_RATE;
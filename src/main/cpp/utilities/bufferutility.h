@@ -92,6 +92,12 @@ class BufferUtility
          */
         static int getSamplesPerBar( int sampleRate, double tempo, int beatAmount, int beatUnit );
 
+        /**
+         * Calculates the (fractional) amount of samples a single tick (see TICKS_PER_BEAT)
+         * lasts for the given tempo at the given sampleRate.
+         */
+        static double getSamplesPerTick( int sampleRate, double tempo );
+
         /* beat calculation */
 
         /**
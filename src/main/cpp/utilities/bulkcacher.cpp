@@ -22,26 +22,43 @@
  */
 #include "bulkcacher.h"
 #include "utils.h"
+#include <audioengine.h>
+#include <definitions/notifications.h>
+#include <messaging/notifier.h>
 #include <algorithm>
 #include <vector>
 
 namespace MWEngine {
 
+const int BulkCacher::MAX_THREADS;
+
 /* constructor / destructor */
 
 /**
  * @param sequential when true, the BulkCacher queue
- *        will be processed one after another instead of all in one go
+ *        will be processed one after another instead of concurrently
  */
 BulkCacher::BulkCacher( bool sequential )
 {
-    _queue      = new std::vector<BaseCacheableAudioEvent*>();
-    _sequential = sequential;
+    _amountOfThreads = sequential ? 1 : std::max( 1, std::min( MAX_THREADS, ( int ) std::thread::hardware_concurrency() - 1 ));
+    _lastJobId       = 0;
+    _started         = false;
+    _running         = false;
 }
 
 BulkCacher::~BulkCacher()
 {
-    delete _queue;
+    {
+        std::unique_lock<std::mutex> guard( _lock );
+
+        _queue.clear();
+        _jobIds.clear();
+        _running = false;
+    }
+    _queueCondition.notify_all();
+
+    for ( size_t i = 0; i < _threads.size(); ++i )
+        _threads.at( i ).join();
 }
 
 /* public methods */
@@ -60,66 +77,184 @@ void BulkCacher::addToQueue( std::vector<BaseCacheableAudioEvent*>* aEvents )
 
 void BulkCacher::addToQueue( BaseCacheableAudioEvent* aEvent )
 {
-    // make sure we don't add the same event twice
-    if ( std::find( _queue->begin(), _queue->end(), aEvent ) == _queue->end())
+    if ( aEvent->isCached())
+        return;
+
     {
-        if ( !aEvent->isCached())
-            _queue->push_back( aEvent );
+        std::unique_lock<std::mutex> guard( _lock );
+
+        // make sure we don't add the same event twice
+        if ( _jobIds.find( aEvent ) != _jobIds.end())
+            return;
+
+        Job job = { aEvent, getPriority( aEvent ), ++_lastJobId };
+
+        _jobIds[ aEvent ] = job.id;
+        _queue.push_back( job );
+        std::push_heap( _queue.begin(), _queue.end(), compareJobs );
     }
+    _queueCondition.notify_one();
 }
 
 bool BulkCacher::removeFromQueue( BaseCacheableAudioEvent* aEvent )
 {
-    if ( std::find( _queue->begin(), _queue->end(), aEvent ) != _queue->end())
+    std::unique_lock<std::mutex> guard( _lock );
+
+    // the job remains in the heap, but is discarded as its id is no longer registered
+
+    bool wasQueued = _jobIds.erase( aEvent ) > 0;
+
+    // event is being cached ? wait for caching to complete (e.g. when the event is being deleted)
+
+    while ( _activeEvents.find( aEvent ) != _activeEvents.end())
+        _activeCondition.wait( guard );
+
+    return wasQueued;
+}
+
+bool BulkCacher::hasQueue()
+{
+    std::unique_lock<std::mutex> guard( _lock );
+    return !_jobIds.empty() || !_activeEvents.empty();
+}
+
+int BulkCacher::getQueueSize()
+{
+    std::unique_lock<std::mutex> guard( _lock );
+    return ( int ) _jobIds.size();
+}
+
+void BulkCacher::cacheQueue()
+{
     {
-        _queue->erase( std::find( _queue->begin(), _queue->end(), aEvent ));
-        return true;
+        std::unique_lock<std::mutex> guard( _lock );
+
+        // rebuild the heap using the priorities for the current playhead position
+        // (omitting the jobs of events that have been removed from the queue)
+
+        std::vector<Job> queue;
+        queue.reserve( _jobIds.size());
+
+        for ( size_t i = 0; i < _queue.size(); ++i )
+        {
+            Job job = _queue.at( i );
+            auto it = _jobIds.find( job.event );
+
+            if ( it != _jobIds.end() && it->second == job.id ) {
+                job.priority = getPriority( job.event );
+                queue.push_back( job );
+            }
+        }
+        std::make_heap( queue.begin(), queue.end(), compareJobs );
+        _queue.swap( queue );
+
+        if ( !_started )
+        {
+            _started = true;
+            _running = true;
+
+            for ( int i = 0; i < _amountOfThreads; ++i )
+                _threads.push_back( std::thread( &BulkCacher::handleWorkerThread, this ));
+        }
     }
-    return false;
+    _queueCondition.notify_all();
 }
 
-bool BulkCacher::hasQueue()
+void BulkCacher::clearQueue()
 {
-    return _queue->size() > 0;
+    std::unique_lock<std::mutex> guard( _lock );
+
+    _queue.clear();
+    _jobIds.clear();
+}
+
+/* private methods */
+
+bool BulkCacher::compareJobs( const Job& a, const Job& b )
+{
+    // std heap functions place the "largest" element first, as such the job with
+    // the lowest priority value is considered the largest (ties resolved by queue order)
+
+    if ( a.priority != b.priority )
+        return a.priority > b.priority;
+
+    return a.id > b.id;
 }
 
 /**
- * invokes the cache method on all queued audio events
- * (this will also remove them from the queue)
- *
- * in case the BulkCacher was constructed to work in
- * sequence, this method will cache the queue one event at a time
- * note that this method must be invoked after each cache-invocation
- * from the freshly cached event when it finishes its caching routine
+ * the priority of an event is the distance (in samples) between
+ * the playhead and its start, taking the sequencer loop into account
  */
-void BulkCacher::cacheQueue()
+int BulkCacher::getPriority( BaseCacheableAudioEvent* aEvent )
 {
-    int amount = _queue->size();
+    int playhead   = AudioEngine::bufferPosition;
+    int eventStart = aEvent->getEventStart();
+    int eventEnd   = aEvent->getEventEnd();
 
-    //Debug::log( "BulkCacher::caching %d events", amount );
+    if ( eventStart <= playhead && eventEnd >= playhead )
+        return 0; // currently playing
 
-    for ( int i = 0; i < amount; i++ )
+    int distance = eventStart - playhead;
+
+    // event lies behind the playhead ? it will play after the sequencer loops
+
+    if ( distance < 0 )
+        distance += std::max( 1, AudioEngine::max_buffer_position - AudioEngine::min_buffer_position + 1 );
+
+    return std::max( 0, distance );
+}
+
+void BulkCacher::handleWorkerThread()
+{
+    std::unique_lock<std::mutex> guard( _lock );
+
+    while ( _running )
     {
-        BaseCacheableAudioEvent* event = _queue->at( i );
+        if ( _queue.empty()) {
+            _queueCondition.wait( guard );
+            continue;
+        }
 
-        // (interesting detail must remove the event from the queue
-        // BEFORE invoking cache (isn't executed synchronously and
-        // would cause a recursive loop!)
+        std::pop_heap( _queue.begin(), _queue.end(), compareJobs );
+        Job job = _queue.back();
+        _queue.pop_back();
 
-        removeFromQueue( event );
-        event->cache( _sequential );
+        // job has been cancelled (or superseded by a newer job for the same event) ?
 
-        // just one when sequential
+        auto it = _jobIds.find( job.event );
 
-        if ( _sequential )
-            return;
+        if ( it == _jobIds.end() || it->second != job.id )
+            continue;
+
+        _jobIds.erase( it );
+        _activeEvents.insert( job.event );
+
+        // cache outside of the lock so other workers (and queue mutations) can proceed
+
+        guard.unlock();
+        job.event->cache( false );
+        guard.lock();
+
+        _activeEvents.erase( job.event );
+        _activeCondition.notify_all();
+
+        int remaining = ( int ) _jobIds.size();
+        bool complete = remaining == 0 && _activeEvents.empty();
+
+        // broadcast outside of the lock so observers can query the BulkCacher
+
+        guard.unlock();
+        broadcastProgress( remaining, complete );
+        guard.lock();
     }
-    clearQueue(); // superfluous actually
 }
 
-void BulkCacher::clearQueue()
+void BulkCacher::broadcastProgress( int remaining, bool complete )
 {
-    _queue->clear();
+    if ( complete )
+        Notifier::broadcast( Notifications::BULK_CACHE_COMPLETE );
+    else
+        Notifier::broadcast( Notifications::BULK_CACHE_PROGRESS, remaining );
 }
 
 } // E.O namespace MWEngine
@@ -24,26 +24,76 @@
 #define __MWENGINE__BULKCACHER_H_INCLUDED__
 
 #include <events/basecacheableaudioevent.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+/**
+ * BulkCacher caches the contents of BaseCacheableAudioEvents in the background. Queued
+ * events are cached by a pool of worker threads, prioritised by their distance from the
+ * sequencer playhead (e.g. events that are about to play are cached first).
+ *
+ * Queueing and removing events are constant time operations. Events that are removed from the
+ * queue (e.g. when they are deleted) are cancelled, when an event is being cached at the moment
+ * of removal, removeFromQueue() waits for its caching to complete. While caching, the remaining
+ * amount of queued events is broadcast (BULK_CACHE_PROGRESS) followed by BULK_CACHE_COMPLETE
+ * once the queue has been fully processed.
+ */
 namespace MWEngine {
 class BulkCacher
 {
     public:
+        // when sequential is true, events are cached one after another by a single worker
+        // thread, otherwise events are cached concurrently by up to MAX_THREADS workers
+
         BulkCacher( bool sequential );
         ~BulkCacher();
 
+        static const int MAX_THREADS = 4;
+
         void addToQueue     ( std::vector<BaseCacheableAudioEvent*>* aEvents );
         void addToQueue     ( BaseCacheableAudioEvent* aEvent );
         bool removeFromQueue( BaseCacheableAudioEvent* aEvent );
-        bool hasQueue();
+        bool hasQueue();    // whether events are queued or being cached
+        int getQueueSize(); // the amount of events awaiting caching
+
+        // start caching the queued events in the background (returns immediately). Once started,
+        // subsequently queued events are cached as they are added. The queue is re-prioritised
+        // against the current playhead position on each invocation.
+
         void cacheQueue();
         void clearQueue();
 
     private:
-        std::vector<BaseCacheableAudioEvent*>* _queue;
-        bool _sequential;
+        struct Job {
+            BaseCacheableAudioEvent* event;
+            int priority;      // lower values have higher priority
+            unsigned long id;  // identifies the job as the queued job for its event (see _jobIds)
+        };
+
+        static bool compareJobs( const Job& a, const Job& b );
+        static int getPriority( BaseCacheableAudioEvent* aEvent );
+
+        void handleWorkerThread();
+        void broadcastProgress( int remaining, bool complete );
+
+        std::vector<Job> _queue; // heap ordered by priority
+        std::unordered_map<BaseCacheableAudioEvent*, unsigned long> _jobIds; // the queued events and their job id
+        std::unordered_set<BaseCacheableAudioEvent*> _activeEvents;         // the events being cached
+        unsigned long _lastJobId;
+
+        int _amountOfThreads;
+        std::vector<std::thread> _threads;
+        std::mutex _lock;
+        std::condition_variable _queueCondition;
+        std::condition_variable _activeCondition;
+        bool _started;
+        bool _running;
 };
 } // E.O namespace MWEngine
 
-#endif
\ No newline at end of file
+#endif
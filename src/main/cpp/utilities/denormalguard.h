@@ -0,0 +1,87 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__DENORMALGUARD_H_INCLUDED__
+#define __MWENGINE__DENORMALGUARD_H_INCLUDED__
+
+#include <stdint.h>
+
+#if defined( __SSE__ ) || defined( __x86_64__ )
+#include <xmmintrin.h>
+#endif
+
+namespace MWEngine {
+
+/**
+ * DenormalGuard enables flush-to-zero (and denormals-are-zero on x86) on the
+ * current thread for the duration of its scope, restoring the previous floating
+ * point mode upon destruction. Recursive filters (e.g. reverbs) decaying towards
+ * silence otherwise produce denormal numbers that are very slow to compute, this
+ * replaces checking each sample for denormals. Usage:
+ *
+ * void process( AudioBuffer* buffer ) {
+ *     DenormalGuard guard;
+ *     ...
+ * }
+ */
+class DenormalGuard
+{
+    public:
+        inline DenormalGuard()
+        {
+#if defined( __SSE__ ) || defined( __x86_64__ )
+            _state = _mm_getcsr();
+            _mm_setcsr( _state | 0x8040 ); // FTZ (bit 15) and DAZ (bit 6)
+#elif defined( __aarch64__ )
+            uint64_t fpcr;
+            asm volatile( "mrs %0, fpcr" : "=r"( fpcr ));
+            _state = fpcr;
+            fpcr |= ( 1 << 24 ); // FZ
+            asm volatile( "msr fpcr, %0" : : "r"( fpcr ));
+#elif defined( __arm__ ) && defined( __ARM_FP )
+            uint32_t fpscr;
+            asm volatile( "vmrs %0, fpscr" : "=r"( fpscr ));
+            _state = fpscr;
+            fpscr |= ( 1 << 24 ); // FZ
+            asm volatile( "vmsr fpscr, %0" : : "r"( fpscr ));
+#endif
+        }
+
+        inline ~DenormalGuard()
+        {
+#if defined( __SSE__ ) || defined( __x86_64__ )
+            _mm_setcsr(( unsigned int ) _state );
+#elif defined( __aarch64__ )
+            uint64_t fpcr = _state;
+            asm volatile( "msr fpcr, %0" : : "r"( fpcr ));
+#elif defined( __arm__ ) && defined( __ARM_FP )
+            uint32_t fpscr = ( uint32_t ) _state;
+            asm volatile( "vmsr fpscr, %0" : : "r"( fpscr ));
+#endif
+        }
+
+    private:
+        uint64_t _state = 0;
+};
+} // E.O namespace MWEngine
+
+#endif
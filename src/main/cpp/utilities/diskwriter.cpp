@@ -22,282 +22,453 @@
  */
 #include "diskwriter.h"
 #include "audioengine.h"
-#include "wavewriter.h"
-#include "wavereader.h"
+#include "waveencoder.h"
 #include "utils.h"
-#include <stdio.h>
-#include <definitions/notifications.h>
+#include "worksignal.h"
 #include <messaging/notifier.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <dirent.h>
+#include <thread>
 
 namespace MWEngine {
 namespace DiskWriter
 {
-    std::string               outputFile;
-    std::string               tempDirectory;
-    std::vector<writtenFile>  outputFiles;
-    std::vector<AudioBuffer*> cachedBuffers{ nullptr, nullptr };
+    std::string      outputFile;
+    RecordingStream* recordingStream = nullptr;
+    std::vector<RecordingStream*> stemStreams;
+    std::vector<AudioChannel*>    stemChannels;
 
-    int recordingChunkSize     = 0;
-    int outputWriterIndex      = 0;
     int currentBufferIndex     = 0;
-    int savedSnippets          = 0;
     int recordingChannelAmount = AudioEngineProps::OUTPUT_CHANNELS;
+    int outputFormat           = WaveEncoder::PCM_16;
+    bool outputDither          = false;
 
-    bool prepared = false;
+    EncoderFactory encoderFactory = nullptr;
+
+    std::atomic<bool> prepared( false );
+    std::atomic<bool> stemsPrepared( false );
+
+    std::vector<std::thread> writerThreads;
+    std::atomic<bool> writing( false );
+    std::atomic<bool> closing( false );     // whether the writer threads close their streams once halted
+    std::atomic<int>  activeWriters( 0 );   // writer threads that have yet to complete (includes detached threads)
+    std::atomic<int>  completionNotification( -1 ); // broadcast by the last writer thread to complete (see finishAsync())
+
+    // maximum amount of writer threads (each thread writes a subset of all recorded files)
+
+    const int MAX_WRITER_THREADS = 4;
+
+    // the rendering thread signals the writer of a stream after appending to its queue
+
+    WorkSignal writerSignals[ MAX_WRITER_THREADS ];
+    std::atomic<int> writerThreadAmount( 0 );
+
+    // minimum duration (in milliseconds) of audio the queue can hold
+
+    const int MIN_QUEUE_DURATION = 1000;
 
     void prepare( std::string outputFilename, int chunkSize, int amountOfChannels )
     {
-        outputFile = outputFilename;
+        // join the writer threads of the previous recording (which might have been finished asynchronously)
+
+        finish();
 
-        std::string path   = std::string( outputFilename );
-        std::size_t dirPos = path.find_last_of( "/" );
-        tempDirectory      = path.substr( 0, dirPos ) + "/";
+        // the streams of the previous recording are disposed here rather than in finish() as
+        // the rendering thread might still have been appending to them when recording halted,
+        // await the completion of the current render cycle before disposing these
 
-        recordingChunkSize     = chunkSize;
+        AudioEngine::waitForRenderCycle();
+        disposeStreams();
+
+        outputFile             = outputFilename;
         recordingChannelAmount = amountOfChannels;
-        savedSnippets          = 0;
 
-        outputFiles.clear();
-        prepareSnippet();
+        int queueSize   = std::max( chunkSize, AudioEngineProps::SAMPLE_RATE / 1000 * MIN_QUEUE_DURATION );
+        recordingStream = new RecordingStream(
+            outputFile, amountOfChannels, AudioEngineProps::SAMPLE_RATE, queueSize, createEncoder()
+        );
+
+        if ( !recordingStream->open())
+            return;
 
         prepared = true;
+        startWriterThreads();
     }
 
-    void prepareSnippet()
+    void prepareStems( std::string outputDirectory, std::vector<AudioChannel*> channels, int chunkSize )
     {
-        // swap the currently active buffer
-        currentBufferIndex = ( currentBufferIndex == 0 ) ? 1 : 0;
-        generateOutputBuffer( currentBufferIndex, recordingChannelAmount );
-    }
+        if ( !prepared || stemsPrepared )
+            return;
 
-    bool finish()
-    {
-        if ( !prepared )
-            return false;
+        // halt the writers while the stem streams are being created
 
-        // flush all temporary buffers as recording has finished
-        // and snippets have been written onto disk
+        stopWriterThreads();
 
-        for ( int i = 0; i < 2; ++i )
-            flushOutput( i );
+        int queueSize = std::max( chunkSize, AudioEngineProps::SAMPLE_RATE / 1000 * MIN_QUEUE_DURATION );
 
-        if ( outputFiles.size() == 0 )
-            return false;
+        for ( size_t i = 0; i < channels.size(); ++i )
+        {
+            BaseEncoder* encoder = createEncoder();
+            std::string fileName = outputDirectory + "/channel_" + SSTR( i ) + encoder->getFileExtension();
 
-        // calculate total data size of concatenated wave files
+            RecordingStream* stream = new RecordingStream(
+                fileName, recordingChannelAmount, AudioEngineProps::SAMPLE_RATE, queueSize, encoder
+            );
 
-        size_t totalBufferSize = 0;
+            if ( !stream->open()) {
+                delete stream;
+                continue;
+            }
+            stemStreams.push_back( stream );
+            stemChannels.push_back( channels.at( i ));
+        }
+        stemsPrepared = stemStreams.size() > 0;
 
-        for ( std::size_t i = 0; i < outputFiles.size(); ++i )
-            totalBufferSize += outputFiles.at( i ).size;
+        startWriterThreads();
+    }
 
-        // create a stream for writing the output file to
+    bool hasStems()
+    {
+        return stemsPrepared;
+    }
 
-        std::ofstream waveStream = WaveWriter::createWAVStream(
-            outputFile.c_str(), totalBufferSize,
-            AudioEngineProps::SAMPLE_RATE, recordingChannelAmount
-        );
+    bool finish()
+    {
+        if ( !prepared.exchange( false )) {
+            stopWriterThreads(); // joins the writer threads of an asynchronously finished recording
+            return false;
+        }
+        stemsPrepared = false;
 
-        // concatenate the wave files into a single output file
+        // halt the writer threads, which write the remainder of the queues and complete the files
 
-        while ( outputFiles.size() > 0 )
-        {
-            writtenFile file = outputFiles.at( 0 );
+        closing = true;
+        stopWriterThreads();
 
-            // read WAV data from file
+        bool hasRecorded = recordingStream->getWrittenFrames() > 0;
 
-            AudioBuffer* tempBuffer = WaveReader::fileToBuffer( file.path ).buffer;
+        for ( size_t i = 0; i < stemStreams.size(); ++i )
+            hasRecorded = hasRecorded || stemStreams.at( i )->getWrittenFrames() > 0;
 
-            // delete the source WAV file so we immediately free storage space for
-            // writing the buffer contents into the single file output stream,
-            // note we assume that no errors have occurred with file writing
-            // as the original recording is now gone!! then again, if it has errors
-            // than the original recording isn't worth keeping anyways... ;)
+        return hasRecorded;
+    }
 
-            remove( file.path.c_str() );
+    void finishAsync( int notificationType )
+    {
+        if ( !prepared.exchange( false ))
+            return;
 
-            if ( tempBuffer != nullptr ) {
+        stemsPrepared = false;
 
-                // convert data to a temporary PCM buffer
-                // TODO: can we just extract the existing PCM data without this
-                // back-and-forth conversion?
-                INT16* outputBuffer = WaveWriter::bufferToPCM( tempBuffer );
+        // halt the writer threads without joining these, the last thread to
+        // complete its files broadcasts the notification. The threads are detached
+        // as they now own their streams (stopWriterThreads() awaits their completion)
 
-                delete tempBuffer; // free memory allocated to read WAV file
+        completionNotification = notificationType;
+        closing = true;
+        writing = false;
+        signalWriters();
 
-                // write PCM buffer into the output stream
+        for ( size_t i = 0; i < writerThreads.size(); ++i )
+            writerThreads.at( i ).detach();
 
-                WaveWriter::appendBufferToStream( waveStream, outputBuffer, file.size );
+        writerThreads.clear();
+    }
 
-                delete[] outputBuffer; // free memory allocated to the temporary PCM buffer
-            }
+    void setOutputFormat( int format, bool dither )
+    {
+        outputFormat = format;
+        outputDither = dither;
+    }
 
-            // remove from vector, iterate onto next
+    void setEncoderFactory( EncoderFactory factory )
+    {
+        encoderFactory = factory;
+    }
 
-            outputFiles.erase( outputFiles.begin() );
-        }
-        waveStream.close();
+    /**
+     * appends an AudioBuffer into the recording queue
+     */
+    void appendBuffer( AudioBuffer* aBuffer )
+    {
+        if ( !prepared )
+            return;
 
-        prepared = false;
+        // when bouncing, the engine isn't bound to real time and can wait for the writer to
+        // catch up, when rendering in real time the audio is dropped when the queue is full
 
-        return true;
+        appendBuffer( aBuffer, 0, aBuffer->bufferSize );
     }
 
     /**
-     * allocates a new buffer for writing the next snippet
+     * appends given range of an AudioBuffer into the recording queue
      */
-    AudioBuffer* generateOutputBuffer( int bufferIndex, int amountOfChannels )
+    void appendBuffer( AudioBuffer* aBuffer, int aReadOffset, int aBufferSize )
     {
-        flushOutput( bufferIndex ); // free previous contents when existing
-
-        if (( bufferIndex + 1 ) > cachedBuffers.size())
-            cachedBuffers.resize(( unsigned long )( bufferIndex + 1 ));
+        if ( !prepared )
+            return;
 
-        AudioBuffer* out = new AudioBuffer( amountOfChannels, recordingChunkSize );
+        waitForQueue( recordingStream, aBufferSize );
+        recordingStream->write( aBuffer, aReadOffset, aBufferSize, 1.f );
+        signalWriter( 0 );
+    }
 
-        cachedBuffers.at(( unsigned long ) bufferIndex ) = out;
-        outputWriterIndex = 0;
+    /**
+     * append the actual (interleaved) output buffer
+     * from the engine into the recording queue
+     */
+    void appendBuffer( float* aBuffer, int aBufferSize, int amountOfChannels )
+    {
+        if ( !prepared || amountOfChannels != recordingChannelAmount )
+            return;
 
-        return out;
+        waitForQueue( recordingStream, aBufferSize );
+        recordingStream->write( aBuffer, aBufferSize );
+        signalWriter( 0 );
     }
 
     /**
-     * appends an AudioBuffer into the current snippets output buffer
+     * append the output of an AudioChannel into its stems recording queue
      */
-    void appendBuffer( AudioBuffer* aBuffer )
+    void appendStem( AudioChannel* channel, AudioBuffer* aBuffer, int aBufferSize, float volume )
     {
-        if ( !prepared )
+        if ( !stemsPrepared )
             return;
 
-        int bufferSize    = aBuffer->bufferSize;
-        int channelAmount = aBuffer->amountOfChannels;
+        for ( size_t i = 0; i < stemChannels.size(); ++i )
+        {
+            if ( stemChannels[ i ] != channel )
+                continue;
 
-        AudioBuffer* cachedBuffer = getCachedBuffer( currentBufferIndex );
+            RecordingStream* stream = stemStreams[ i ];
 
-        if ( cachedBuffer == nullptr )
-            cachedBuffer = generateOutputBuffer( currentBufferIndex, channelAmount );
+            waitForQueue( stream, aBufferSize );
+            stream->write( aBuffer, aBufferSize, volume );
+            signalWriter(( int ) i + 1 );
 
-        cachedBuffer->mergeBuffers( aBuffer, 0, outputWriterIndex, 1.0f );
-        outputWriterIndex += bufferSize;
+            return;
+        }
     }
 
-    /**
-     * append the actual output buffer from the engine
-     * into the current snippets output buffer
-     */
-    void appendBuffer( float* aBuffer, int aBufferSize, int amountOfChannels )
+    std::string getFileExtension()
     {
-        if ( !prepared )
-            return;
+        BaseEncoder* encoder  = createEncoder();
+        std::string extension = encoder->getFileExtension();
+
+        delete encoder;
+
+        return extension;
+    }
 
-        AudioBuffer* cachedBuffer = getCachedBuffer( currentBufferIndex );
+    unsigned long getDroppedFrames()
+    {
+        unsigned long droppedFrames = ( recordingStream != nullptr ) ? recordingStream->getDroppedFrames() : 0;
 
-        if ( cachedBuffer == nullptr )
-            cachedBuffer = generateOutputBuffer( currentBufferIndex, amountOfChannels );
+        for ( size_t i = 0; i < stemStreams.size(); ++i )
+            droppedFrames += stemStreams.at( i )->getDroppedFrames();
 
-        int i, c, ci;
+        return droppedFrames;
+    }
+
+    std::vector<std::string> recoverRecordings( std::string directory )
+    {
+        std::vector<std::string> recoveredFiles;
+        DIR* dir = opendir( directory.c_str() );
+
+        if ( dir == nullptr )
+            return recoveredFiles;
+
+        std::vector<std::string> journalFiles;
+        struct dirent* entry;
+
+        while (( entry = readdir( dir )) != nullptr )
+        {
+            std::string fileName = entry->d_name;
 
-        // write samples into cache buffers
+            if ( RecordingStream::isJournalFile( fileName ))
+                journalFiles.push_back( directory + "/" + fileName );
+        }
+        closedir( dir );
 
-        for ( i = 0, c = 0; i < aBufferSize; ++i, ++outputWriterIndex, c += amountOfChannels )
+        for ( size_t i = 0; i < journalFiles.size(); ++i )
         {
-            if ( outputWriterIndex == recordingChunkSize )
-                return;
+            std::string outputFile = RecordingStream::getOutputFileForJournal( journalFiles.at( i ));
 
-            for ( ci = 0; ci < amountOfChannels; ++ci )
-                cachedBuffer->getBufferForChannel( ci )[ outputWriterIndex ] = aBuffer[ c + ci ];
+            if ( recoverRecording( outputFile ))
+                recoveredFiles.push_back( outputFile );
         }
+        return recoveredFiles;
+    }
+
+    bool recoverRecording( std::string outputFile )
+    {
+        // the files of the recording in progress are not to be touched
+
+        if ( prepared )
+        {
+            if ( recordingStream->getOutputFile() == outputFile )
+                return false;
+
+            for ( size_t i = 0; i < stemStreams.size(); ++i ) {
+                if ( stemStreams.at( i )->getOutputFile() == outputFile )
+                    return false;
+            }
+        }
+
+        BaseEncoder* encoder = createEncoder();
+        bool recovered       = encoder->recover( outputFile );
+        delete encoder;
+
+        // remove the journal (when the recording couldn't be recovered, there is nothing left to recover)
+
+        remove( RecordingStream::getJournalFile( outputFile ).c_str() );
+
+        return recovered;
+    }
+
+    /* deprecated methods */
+
+    void prepareSnippet()
+    {
+        // no longer required, recordings are streamed to storage
     }
 
-    /**
-     * checks whether the current write buffer is full
-     */
     bool bufferFull()
     {
-        return outputWriterIndex >= recordingChunkSize;
+        return false;
     }
 
-    /**
-     * write the contents of the write buffer into
-     * an output file, this will only write content
-     * up until the point if was written to in case
-     * the buffer wasn't full yet
-     */
     void writeBufferToFile( int bufferIndex, bool broadcastUpdate )
     {
-        if ( !prepared )
-            return;
+        // no longer required, recordings are streamed to storage
+    }
 
-        AudioBuffer* cachedBuffer = getCachedBuffer( bufferIndex );
+    /* internal methods */
 
-        if ( cachedBuffer == nullptr )
-            return;
+    BaseEncoder* createEncoder()
+    {
+        if ( encoderFactory != nullptr )
+            return encoderFactory();
 
-        int sampleRate = AudioEngineProps::SAMPLE_RATE;
+        return new WaveEncoder( outputFormat, outputDither );
+    }
 
-        // create output file name
-        std::string outputFile = std::string(
-            tempDirectory.c_str()
-        ).append( "rec_snippet_" + SSTR( savedSnippets ) + ".WAV" );
+    void disposeStreams()
+    {
+        delete recordingStream;
+        recordingStream = nullptr;
 
-        int bufferSize        = recordingChunkSize;
-        size_t writtenWAVSize = 0;
+        for ( size_t i = 0; i < stemStreams.size(); ++i )
+            delete stemStreams.at( i );
 
-        // recorded less than maximum available in buffer ? cut silence
-        // by writing recording into temporary buffers
+        stemStreams.clear();
+        stemChannels.clear();
+    }
 
-        if ( outputWriterIndex < bufferSize )
-        {
-            bufferSize = outputWriterIndex;
+    void startWriterThreads()
+    {
+        int streamAmount = 1 + ( int ) stemStreams.size();
+        int threadAmount = std::min( streamAmount, MAX_WRITER_THREADS );
 
-            AudioBuffer* tempBuffer = new AudioBuffer( recordingChannelAmount, bufferSize );
+        closing.store( false );
+        activeWriters.store( threadAmount );
+        writerThreadAmount.store( threadAmount );
+        writing.store( true );
 
-            for ( int i = 0; i < bufferSize; ++i )
-            {
-                for ( int c = 0; c < recordingChannelAmount; ++c )
-                    tempBuffer->getBufferForChannel( c )[ i ] = cachedBuffer->getBufferForChannel( c )[ i ];
-            }
-            writtenWAVSize = WaveWriter::bufferToWAV( outputFile, tempBuffer, sampleRate );
+        for ( int i = 0; i < threadAmount; ++i )
+            writerThreads.push_back( std::thread( handleWriterThread, i, threadAmount ));
+    }
 
-            // free memory allocated by temporary buffer
+    void stopWriterThreads()
+    {
+        writing.store( false );
+        signalWriters();
 
-            delete tempBuffer;
+        for ( size_t i = 0; i < writerThreads.size(); ++i ) {
+            if ( writerThreads.at( i ).joinable())
+                writerThreads.at( i ).join();
         }
-        else
+        writerThreads.clear();
+
+        // await the detached threads of an asynchronously finished recording
+
+        while ( activeWriters.load() > 0 )
+            std::this_thread::sleep_for( std::chrono::milliseconds( 1 ));
+    }
+
+    /**
+     * each writer thread drains the queues of every nth stream (where the
+     * master recording is the first stream, followed by the stems). When the
+     * recording finishes, each thread closes its streams once drained
+     */
+    void handleWriterThread( int threadIndex, int threadAmount )
+    {
+        int streamAmount = 1 + ( int ) stemStreams.size();
+
+        while ( true )
         {
-            writtenWAVSize = WaveWriter::bufferToWAV( outputFile, cachedBuffer, sampleRate );
+            // read flag before flushing, so the queues are drained in full after writing halts
+            bool isWriting = writing.load();
+
+            for ( int i = threadIndex; i < streamAmount; i += threadAmount )
+                ( i == 0 ? recordingStream : stemStreams.at( i - 1 ))->flush();
+
+            if ( !isWriting )
+                break;
+
+            writerSignals[ threadIndex ].wait();
         }
 
-        flushOutput( bufferIndex ); // free allocated buffer memory
+        // recording has finished ? complete the files (writes their headers and commits them to storage)
 
-        // store output file in vector
-        writtenFile file;
-        file.path = outputFile;
-        file.size = writtenWAVSize;
-        outputFiles.push_back( file );
+        bool isClosing = closing.load();
 
-        // broadcast update
-        if ( broadcastUpdate )
-            Notifier::broadcast( Notifications::RECORDED_SNIPPET_SAVED, savedSnippets );
+        if ( isClosing ) {
+            for ( int i = threadIndex; i < streamAmount; i += threadAmount )
+                ( i == 0 ? recordingStream : stemStreams.at( i - 1 ))->close();
+        }
 
-        ++savedSnippets;
-    }
+        if ( --activeWriters == 0 && isClosing )
+        {
+            int notificationType = completionNotification.exchange( -1 );
 
-    /* internal methods */
+            if ( notificationType >= 0 )
+                Notifier::broadcast( notificationType );
+        }
+    }
 
-    AudioBuffer* getCachedBuffer( int bufferIndex )
+    /**
+     * wakes the writer thread draining the stream at given index (where the master
+     * recording is the first stream, followed by the stems), see handleWriterThread()
+     */
+    void signalWriter( int streamIndex )
     {
-        return cachedBuffers.at(( unsigned long ) bufferIndex );
+        int threadAmount = writerThreadAmount.load();
+
+        if ( threadAmount > 0 )
+            writerSignals[ streamIndex % threadAmount ].signal();
     }
 
-    void flushOutput( int bufferIndex )
+    void signalWriters()
     {
-        AudioBuffer* cachedBuffer = getCachedBuffer( bufferIndex );
+        for ( int i = 0; i < MAX_WRITER_THREADS; ++i )
+            writerSignals[ i ].signal();
+    }
 
-        if ( cachedBuffer != nullptr )
-            delete cachedBuffer;
+    /**
+     * when bouncing, the engine isn't bound to real time and can wait for the writers to
+     * catch up, when rendering in real time the audio is dropped when the queue is full
+     */
+    void waitForQueue( RecordingStream* stream, int amountOfFrames )
+    {
+        if ( !AudioEngine::bouncing )
+            return;
 
-        cachedBuffers.at(( unsigned long ) bufferIndex ) = nullptr;
+        while ( stream->getWriteAvailable() < amountOfFrames && writing )
+            std::this_thread::sleep_for( std::chrono::milliseconds( 1 ));
     }
 }
 
@@ -24,18 +24,30 @@
 #define __MWENGINE__DISKWRITER_H_INCLUDED__
 
 #include "audiobuffer.h"
+#include "recordingstream.h"
+#include "baseencoder.h"
+#include "audiochannel.h"
 #include <string>
 #include <vector>
+#include <atomic>
 
 /**
- * DiskWriter is a utility that records audio for a given buffer length
- * (for instance to record a whole measure of live generated music) and
- * appends the AudioBuffer rendered by the engines until the buffer is full,
- * after which the contents can be written onto disk in PCM .WAV format
+ * DiskWriter is a utility that records the audio rendered by the engine
+ * into a single file on storage (by default a 16-bit PCM .WAV file)
  *
- * To overcome excessive memory consumption / CPU resources recordings are
- * written in snippets (with a length defined by chunkSize in the prepare()-method).
- * When a full snippet has been recorded, a
+ * The rendering thread appends its output into a lock free queue, which is
+ * drained by a dedicated writer thread that streams the recording directly into
+ * the output file. As such a recording of any length requires no more memory
+ * than the queue (sized by the chunkSize in the prepare()-method) and completing
+ * a recording only requires writing the remainder of the queue.
+ *
+ * Additionally, the output of individual AudioChannels can be recorded into separate
+ * files ("stems") during the same render pass (see prepareStems()). All files are
+ * written by a shared pool of writer threads.
+ *
+ * Recorded files are committed to storage once per second, when the application is terminated
+ * during a recording, the recorded audio (up until the last commit) can be recovered on the next
+ * start (see recoverRecordings())
  */
 namespace MWEngine {
 namespace DiskWriter
@@ -44,65 +56,116 @@ namespace DiskWriter
 
     //namespace
     //{
-        typedef struct
-        {
-            std::string path; // path to written WAV file
-            size_t size;      // total size of the WAV file's sample buffer
-
-        } writtenFile;
-
-        extern std::string               outputFile;         // the file name to write the output to when finished
-        extern std::string               tempDirectory;      // output directory to write temporary files to
-        extern std::vector<writtenFile>  outputFiles;
-        extern std::vector<AudioBuffer*> cachedBuffers;
-
-        extern int recordingChunkSize;
-        extern int outputWriterIndex;
-        extern int savedSnippets;      // amount of snippets within the current recording that have been saved
-        extern int recordingChannelAmount;
-
-        extern bool prepared;
-
-        extern AudioBuffer* getCachedBuffer( int bufferIndex );
-        extern void flushOutput( int bufferIndex );
-
-        extern AudioBuffer* generateOutputBuffer( int bufferIndex, int amountOfChannels );
+        extern std::string      outputFile;         // the file name to write the output to
+        extern RecordingStream* recordingStream;    // stream writing the current recording
+        extern std::vector<RecordingStream*> stemStreams; // streams writing the stems of the current recording
+        extern std::vector<AudioChannel*>    stemChannels;
+        extern int              recordingChannelAmount;
+        extern int              outputFormat;
+        extern bool             outputDither;
+        extern EncoderFactory   encoderFactory;
+
+        extern std::atomic<bool> prepared;
+
+        extern BaseEncoder* createEncoder();
+        extern void disposeStreams();
+        extern void startWriterThreads();
+        extern void stopWriterThreads();
+        extern void handleWriterThread( int threadIndex, int threadAmount );
+        extern void signalWriter( int streamIndex );
+        extern void signalWriters();
+        extern void waitForQueue( RecordingStream* stream, int amountOfFrames );
     //}
 
     /* public properties / methods */
 
-    extern int currentBufferIndex; // index of the cachedBuffer currently being written to
-
     /**
-     * Prepare for a new recording. The recording can consist
-     * of multiple iterations, each of given chunkSize in buffer size.
+     * Prepare for a new recording. chunkSize describes the amount of samples (per channel)
+     * the writing queue can hold. When the engine is rendering in real time and the writer
+     * thread cannot keep up with writing to storage, audio is dropped once the queue is full.
+     * When bouncing, the engine waits for the writer to catch up instead.
      */
     extern void prepare( std::string outputFilename, int chunkSize, int amountOfChannels );
 
     /**
-     * Invoked by the engine whenever a snippet has filled its buffer. This method will prepare the
-     * next snippet to continue recording audio into. We allow two snippets to exist at a time.
-     * When this is invoked, the engine will at the same time broadcast RECORDED_SNIPPET_READY
-     * which should be used to save the snippet contents onto storage so it can be unloaded from memory.
-     * This saving should happen in a separate thread to prevent buffer under runs from occurring while
-     * the engine continues to render audio while recording large fragments. Saving should however
-     * complete before the next snippet has filled its complete buffer to prevent data loss!
+     * Record the output of given AudioChannels into separate files during the current
+     * recording (must be invoked after prepare()). Each file is written into given
+     * outputDirectory and named "channel_" followed by the index of the channel within
+     * given list. The recorded output of each channel is taken after its processing chain
+     * has been applied, at the channels volume (but without panning).
      */
-    extern void prepareSnippet();
+    extern void prepareStems( std::string outputDirectory, std::vector<AudioChannel*> channels, int chunkSize );
+
+    // whether stems are recorded for the current recording
+    extern bool hasStems();
 
     /**
-     * Complete a recording. This will combine all written files
-     * into a single WAV file defined by outputFile.
-     *
-     * For best performance while keeping the engine rendering audio, execute
-     * this in a separate thread.
+     * Complete a recording. This writes the remainder of the queue(s) into the output file(s)
+     * and finalizes their headers (the remainder of the recording has already been written).
+     * Returns false when nothing was recorded.
      */
     extern bool finish();
 
+    /**
+     * Complete a recording without blocking the calling thread (e.g. the rendering thread when
+     * a bounce ends). The writer threads write the remainder of the queue(s) and finalize the
+     * file(s), after which given notification (see Notifications) is broadcast.
+     * The writer threads are detached and their completion is awaited by the next
+     * invocation of prepare() or finish().
+     */
+    extern void finishAsync( int notificationType );
+
+    /**
+     * Sets the format for subsequent recordings (see WaveEncoder::Format),
+     * dither is only applied to 16-bit recordings
+     */
+    extern void setOutputFormat( int format, bool dither );
+
+    /**
+     * Registers a factory creating the encoder for subsequent recordings, this
+     * allows recording directly into formats other than WAV. When set, the factory
+     * supersedes the output format. Pass nullptr to restore the default WAV output.
+     */
+    extern void setEncoderFactory( EncoderFactory factory );
+
     extern void appendBuffer( AudioBuffer* aBuffer );
+    extern void appendBuffer( AudioBuffer* aBuffer, int aReadOffset, int aBufferSize );
     extern void appendBuffer( float* aBuffer, int aBufferSize, int amountOfChannels );
+
+    // append the output of given AudioChannel to its stem (when recording stems for given channel)
+    extern void appendStem( AudioChannel* channel, AudioBuffer* aBuffer, int aBufferSize, float volume );
+
+    // returns the file extension of the files written by the current encoder (e.g. ".wav")
+    extern std::string getFileExtension();
+
+    /**
+     * Recovers the recordings in given directory that weren't completed as the application
+     * was terminated during recording. The recovered files are readable up until the moment
+     * they were last committed to storage. Returns the paths of the recovered files.
+     * The current encoder (see setEncoderFactory()) is used to repair the files.
+     */
+    extern std::vector<std::string> recoverRecordings( std::string directory );
+
+    // recover a single incomplete recording, returns true when given file is valid after recovery
+    extern bool recoverRecording( std::string outputFile );
+
+    // amount of samples (per channel) that have been dropped due to the writer
+    // threads not keeping up with the rendering thread (summed for all files)
+
+    extern unsigned long getDroppedFrames();
+
+    /* TO BE DEPRECATED */
+
+    // recordings are no longer written in snippets, the methods below remain
+    // for API compatibility only (bufferFull() always returns false and
+    // RECORDED_SNIPPET_READY is no longer broadcast)
+
+    extern int currentBufferIndex;
+    extern void prepareSnippet();
     extern bool bufferFull();
     extern void writeBufferToFile( int bufferIndex, bool broadcastUpdate );
+
+    /* E.O. DEPRECATION */
 }
 } // E.O namespace MWEngine
 
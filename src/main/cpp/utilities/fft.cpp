@@ -0,0 +1,255 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "fft.h"
+#include <algorithm>
+#include <cmath>
+
+namespace MWEngine {
+
+/* constructor / destructor */
+
+FFT::FFT( int size )
+{
+    _size        = size;
+    _complexSize = size / 2;
+
+    // bit reversal swap pairs for the complex transform
+
+    int bits = 0;
+    while (( 1 << bits ) < _complexSize )
+        ++bits;
+
+    for ( int i = 0; i < _complexSize; ++i )
+    {
+        int reversed = 0;
+        for ( int b = 0; b < bits; ++b ) {
+            if ( i & ( 1 << b ))
+                reversed |= 1 << ( bits - 1 - b );
+        }
+        if ( i < reversed ) {
+            _swaps.push_back( i );
+            _swaps.push_back( reversed );
+        }
+    }
+
+    // twiddle factors for each butterfly stage, stored contiguously per stage
+    // so the inner butterfly loop reads them sequentially
+
+    _twiddleReal.resize( std::max( 1, _complexSize - 1 ));
+    _twiddleImag.resize( std::max( 1, _complexSize - 1 ));
+
+    for ( int half = 1; half < _complexSize; half <<= 1 )
+    {
+        for ( int j = 0; j < half; ++j ) {
+            double angle = M_PI * ( double ) j / ( double ) half;
+            _twiddleReal[ half - 1 + j ] = ( float )  cos( angle );
+            _twiddleImag[ half - 1 + j ] = ( float ) -sin( angle );
+        }
+    }
+
+    // twiddle factors for splitting the complex spectrum into the real spectrum
+
+    int splitSize = _complexSize / 2 + 1;
+
+    _splitReal.resize( splitSize );
+    _splitImag.resize( splitSize );
+
+    for ( int k = 0; k < splitSize; ++k ) {
+        double angle = 2.0 * M_PI * ( double ) k / ( double ) _size;
+        _splitReal[ k ] = ( float )  cos( angle );
+        _splitImag[ k ] = ( float ) -sin( angle );
+    }
+
+    // (periodic) Hann window
+
+    _window.resize( _size );
+
+    for ( int i = 0; i < _size; ++i )
+        _window[ i ] = ( float )( 0.5 - 0.5 * cos( 2.0 * M_PI * ( double ) i / ( double ) _size ));
+}
+
+FFT::~FFT()
+{
+
+}
+
+/* public methods */
+
+int FFT::getSize()
+{
+    return _size;
+}
+
+void FFT::forward( float* data )
+{
+    // the real samples are already laid out as interleaved complex values
+    // (even samples as real, odd samples as imaginary parts)
+
+    transform( data, false );
+
+    const float* wr = _splitReal.data();
+    const float* wi = _splitImag.data();
+
+    float zr = data[ 0 ];
+    float zi = data[ 1 ];
+
+    data[ 0 ]         = zr + zi; // DC
+    data[ 1 ]         = 0.f;
+    data[ _size ]     = zr - zi; // Nyquist
+    data[ _size + 1 ] = 0.f;
+
+    // bins k and N / 2 - k are derived from the same pair of complex bins
+
+    for ( int k = 1, half = _complexSize / 2; k <= half; ++k )
+    {
+        int m = _complexSize - k;
+
+        float ar = data[ k << 1 ], ai = data[( k << 1 ) + 1 ];
+        float br = data[ m << 1 ], bi = data[( m << 1 ) + 1 ];
+
+        // spectrum of the even (e) and odd (o) samples
+
+        float er = 0.5f * ( ar + br );
+        float ei = 0.5f * ( ai - bi );
+        float or_ = 0.5f * ( ai + bi );
+        float oi  = 0.5f * ( br - ar );
+
+        float tr = wr[ k ] * or_ - wi[ k ] * oi;
+        float ti = wr[ k ] * oi  + wi[ k ] * or_;
+
+        data[ k << 1 ]         = er + tr;
+        data[( k << 1 ) + 1 ]  = ei + ti;
+        data[ m << 1 ]         = er - tr;
+        data[( m << 1 ) + 1 ]  = ti - ei;
+    }
+}
+
+void FFT::inverse( float* data )
+{
+    const float* wr = _splitReal.data();
+    const float* wi = _splitImag.data();
+
+    float dc      = data[ 0 ];
+    float nyquist = data[ _size ];
+
+    data[ 0 ] = dc + nyquist;
+    data[ 1 ] = dc - nyquist;
+
+    // recombine the real spectrum into the complex spectrum of the
+    // even (real part) and odd (imaginary part) samples
+
+    for ( int k = 1, half = _complexSize / 2; k <= half; ++k )
+    {
+        int m = _complexSize - k;
+
+        float ar = data[ k << 1 ], ai = data[( k << 1 ) + 1 ];
+        float br = data[ m << 1 ], bi = data[( m << 1 ) + 1 ];
+
+        float er = ar + br;
+        float ei = ai - bi;
+        float dr = ar - br;
+        float di = ai + bi;
+
+        float or_ = dr * wr[ k ] + di * wi[ k ];
+        float oi  = di * wr[ k ] - dr * wi[ k ];
+
+        data[ k << 1 ]        = er - oi;
+        data[( k << 1 ) + 1 ] = ei + or_;
+        data[ m << 1 ]        = er + oi;
+        data[( m << 1 ) + 1 ] = or_ - ei;
+    }
+
+    transform( data, true );
+}
+
+float* FFT::getWindow()
+{
+    return _window.data();
+}
+
+/* private methods */
+
+/**
+ * in place radix-2 complex transform of _complexSize interleaved values
+ */
+void FFT::transform( float* data, bool inverse )
+{
+    const int* swaps = _swaps.data();
+
+    for ( int i = 0, l = ( int ) _swaps.size(); i < l; i += 2 )
+    {
+        int a = swaps[ i ] << 1;
+        int b = swaps[ i + 1 ] << 1;
+
+        float tr = data[ a ], ti = data[ a + 1 ];
+        data[ a ]     = data[ b ];
+        data[ a + 1 ] = data[ b + 1 ];
+        data[ b ]     = tr;
+        data[ b + 1 ] = ti;
+    }
+
+    // first stage has a unity twiddle factor
+
+    for ( int i = 0, l = _complexSize << 1; i < l; i += 4 )
+    {
+        float ar = data[ i ],     ai = data[ i + 1 ];
+        float br = data[ i + 2 ], bi = data[ i + 3 ];
+
+        data[ i ]     = ar + br;
+        data[ i + 1 ] = ai + bi;
+        data[ i + 2 ] = ar - br;
+        data[ i + 3 ] = ai - bi;
+    }
+
+    // remaining stages, the inverse transform uses the conjugate twiddle factors
+
+    const float sign = inverse ? -1.f : 1.f;
+
+    for ( int half = 2; half < _complexSize; half <<= 1 )
+    {
+        const float* wr = _twiddleReal.data() + half - 1;
+        const float* wi = _twiddleImag.data() + half - 1;
+
+        for ( int block = 0; block < _complexSize; block += half << 1 )
+        {
+            float* p1 = data + ( block << 1 );
+            float* p2 = p1 + ( half << 1 );
+
+            for ( int j = 0; j < half; ++j )
+            {
+                float twr = wr[ j ];
+                float twi = wi[ j ] * sign;
+
+                float tr = p2[ j << 1 ] * twr - p2[( j << 1 ) + 1 ] * twi;
+                float ti = p2[ j << 1 ] * twi + p2[( j << 1 ) + 1 ] * twr;
+
+                p2[ j << 1 ]         = p1[ j << 1 ] - tr;
+                p2[( j << 1 ) + 1 ]  = p1[( j << 1 ) + 1 ] - ti;
+                p1[ j << 1 ]        += tr;
+                p1[( j << 1 ) + 1 ] += ti;
+            }
+        }
+    }
+}
+
+} // E.O namespace MWEngine
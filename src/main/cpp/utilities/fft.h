@@ -0,0 +1,90 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__FFT_H_INCLUDED__
+#define __MWENGINE__FFT_H_INCLUDED__
+
+#include <vector>
+
+namespace MWEngine {
+
+/**
+ * FFT provides a real-input fast Fourier transform for a fixed (power of two) size,
+ * to be used by spectral processors (e.g. PitchShifter)
+ *
+ * all bit reversal indices, twiddle factors and the analysis window are calculated
+ * once upon construction, as such instances should be created outside of the audio thread
+ * (but can then be used from any thread, as transforms don't modify the instance's state)
+ *
+ * a real signal of size N is transformed using a complex transform of size N / 2
+ * (the even and odd samples are treated as the real and imaginary parts of a complex
+ * signal), which is subsequently split into the N / 2 + 1 bins of the real signal's spectrum
+ */
+class FFT
+{
+    public:
+
+        // size describes the amount of real samples to transform and must be a power of two (>= 4)
+
+        FFT( int size );
+        ~FFT();
+
+        int getSize();
+
+        /**
+         * Transforms the size amount of real samples in data into size / 2 + 1 complex
+         * bins, stored in place as interleaved real and imaginary values (data must
+         * hold size + 2 values). The bins are unscaled, e.g. a sine of amplitude 1
+         * results in a bin magnitude of size / 2
+         */
+        void forward( float* data );
+
+        /**
+         * Transforms the size / 2 + 1 interleaved complex bins in data into size amount
+         * of real samples, stored in place (the imaginary parts of the DC and Nyquist bins
+         * are ignored). The result is unscaled, e.g. inverse( forward( x )) equals x * size
+         */
+        void inverse( float* data );
+
+        /**
+         * Returns the Hann window of size length, to be applied to
+         * the input prior to analysis (and the output after synthesis)
+         */
+        float* getWindow();
+
+    private:
+
+        int _size;
+        int _complexSize;
+
+        std::vector<int>   _swaps;       // pairs of indices to swap to bit reverse the complex input
+        std::vector<float> _twiddleReal; // twiddle factors per stage, stage with half length h starts at index h - 1
+        std::vector<float> _twiddleImag;
+        std::vector<float> _splitReal;   // twiddle factors to split the complex spectrum into the real spectrum
+        std::vector<float> _splitImag;
+        std::vector<float> _window;
+
+        void transform( float* data, bool inverse );
+};
+} // E.O namespace MWEngine
+
+#endif
@@ -0,0 +1,302 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "freezer.h"
+#include "audiorenderer.h"
+#include "audioengine.h"
+#include "sequencer.h"
+#include <utilities/worksignal.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MWEngine {
+
+struct FrozenInstrument
+{
+    BaseInstrument* instrument;
+    unsigned long long signature; // signature of the instrument at the time its frozen buffer was rendered
+    bool pending;                 // whether the frozen buffer is to be (re)rendered
+    bool rendering;               // whether the frozen buffer is being rendered (outside of the lock)
+    unsigned int generation;      // incremented on invalidation, discards the result of a render in progress
+};
+
+struct FreezeJob
+{
+    BaseInstrument* instrument;
+    unsigned long long signature;
+    unsigned int generation;
+};
+
+namespace FreezerState
+{
+    std::vector<FrozenInstrument> _instruments;
+    std::recursive_mutex _lock;
+    std::condition_variable_any _renderCondition; // signalled when a render has completed
+    std::thread _thread;
+    std::atomic<bool> _running( false );
+    WorkSignal _updateSignal; // wakes the worker thread
+}
+
+using namespace FreezerState;
+
+const int Freezer::POLL_INTERVAL;
+
+/* public methods */
+
+void Freezer::freeze( BaseInstrument* instrument )
+{
+    {
+        std::lock_guard<std::recursive_mutex> guard( _lock );
+
+        if ( isFrozen( instrument ))
+            return;
+
+        _instruments.push_back({ instrument, 0, true, false, 0 });
+    }
+    startThread();
+}
+
+void Freezer::unfreeze( BaseInstrument* instrument )
+{
+    bool hasInstruments;
+    {
+        std::unique_lock<std::recursive_mutex> guard( _lock );
+
+        // the instruments events and processors are in use while its frozen buffer is
+        // being rendered (e.g. when invoked from the instruments destructor), await completion
+
+        while ( findInstrument( instrument ) != nullptr && findInstrument( instrument )->rendering )
+            _renderCondition.wait( guard );
+
+        for ( size_t i = 0; i < _instruments.size(); ++i )
+        {
+            if ( _instruments.at( i ).instrument == instrument ) {
+                _instruments.erase( _instruments.begin() + i );
+                instrument->audioChannel->unfreeze();
+                break;
+            }
+        }
+        hasInstruments = !_instruments.empty();
+    }
+
+    if ( !hasInstruments )
+        stopThread();
+}
+
+bool Freezer::isFrozen( BaseInstrument* instrument )
+{
+    std::lock_guard<std::recursive_mutex> guard( _lock );
+
+    for ( size_t i = 0; i < _instruments.size(); ++i ) {
+        if ( _instruments.at( i ).instrument == instrument )
+            return true;
+    }
+    return false;
+}
+
+void Freezer::invalidate( BaseInstrument* instrument )
+{
+    std::lock_guard<std::recursive_mutex> guard( _lock );
+
+    for ( size_t i = 0; i < _instruments.size(); ++i )
+    {
+        FrozenInstrument& frozen = _instruments.at( i );
+
+        if ( frozen.instrument == instrument ) {
+            instrument->audioChannel->unfreeze();
+            frozen.pending = true;
+            ++frozen.generation;
+        }
+    }
+}
+
+void Freezer::requestUpdate()
+{
+    _updateSignal.signal();
+}
+
+bool Freezer::hasPendingFreezes()
+{
+    std::lock_guard<std::recursive_mutex> guard( _lock );
+
+    for ( size_t i = 0; i < _instruments.size(); ++i ) {
+        if ( _instruments.at( i ).pending )
+            return true;
+    }
+    return false;
+}
+
+void Freezer::update()
+{
+    // collect the instruments to render under the lock, the (lengthy) rendering itself
+    // happens outside of the lock so the public methods are not blocked while rendering
+
+    std::vector<FreezeJob> jobs;
+    {
+        std::lock_guard<std::recursive_mutex> guard( _lock );
+
+        for ( size_t i = 0; i < _instruments.size(); ++i )
+        {
+            FrozenInstrument& frozen = _instruments.at( i );
+
+            if ( frozen.rendering )
+                continue;
+
+            unsigned long long signature = getSignature( frozen.instrument );
+
+            // instrument has changed since freezing ? return to real time rendering
+
+            if ( signature != frozen.signature && !frozen.pending ) {
+                frozen.instrument->audioChannel->unfreeze();
+                frozen.pending = true;
+            }
+
+            // rendering shares the events and processors with the engine, as such we
+            // only render when the sequencer isn't playing (see AudioChannel::setFreezing())
+
+            if ( !frozen.pending || Sequencer::playing )
+                continue;
+
+            frozen.rendering = true;
+            jobs.push_back({ frozen.instrument, signature, frozen.generation });
+        }
+    }
+
+    for ( size_t i = 0; i < jobs.size(); ++i )
+    {
+        FreezeJob& job             = jobs.at( i );
+        BaseInstrument* instrument = job.instrument;
+        AudioChannel* channel      = instrument->audioChannel;
+
+        bool useChannelRange = channel->maxBufferPosition != 0;
+        int rangeStart       = useChannelRange ? 0 : AudioEngine::min_buffer_position;
+        int rangeEnd         = useChannelRange ? channel->maxBufferPosition : AudioEngine::max_buffer_position;
+
+        // freeze the processors preceding the first non-cacheable processor
+
+        std::vector<BaseProcessor*> processors = channel->processingChain->getActiveProcessors();
+        int amountOfProcessors = 0;
+
+        while ( amountOfProcessors < ( int ) processors.size() && processors.at( amountOfProcessors )->isCacheable())
+            ++amountOfProcessors;
+
+        channel->setFreezing( true );
+        AudioBuffer* buffer = AudioRenderer::render( rangeStart, rangeEnd, instrument, amountOfProcessors );
+        channel->setFreezing( false );
+
+        // publish the result, unless the instrument was invalidated or changed while rendering
+        // (in which case it remains pending and is rendered again on the next update)
+
+        std::lock_guard<std::recursive_mutex> guard( _lock );
+
+        FrozenInstrument* frozen = findInstrument( instrument );
+        frozen->rendering = false;
+        _renderCondition.notify_all();
+
+        if ( buffer != nullptr && frozen->generation == job.generation && getSignature( instrument ) == job.signature ) {
+            channel->freeze( buffer, rangeStart, rangeEnd, amountOfProcessors );
+
+            frozen->signature = job.signature;
+            frozen->pending   = false;
+        }
+        else {
+            delete buffer;
+        }
+    }
+}
+
+/* private methods */
+
+FrozenInstrument* Freezer::findInstrument( BaseInstrument* instrument )
+{
+    for ( size_t i = 0; i < _instruments.size(); ++i ) {
+        if ( _instruments.at( i ).instrument == instrument )
+            return &_instruments.at( i );
+    }
+    return nullptr;
+}
+
+/**
+ * creates a signature describing all properties that affect the frozen
+ * buffer of given instrument, used to detect when a frozen buffer is outdated.
+ * Changes to the events are detected using the instruments modification count
+ * (rather than by iterating the events, which requires locking the instrument)
+ */
+unsigned long long Freezer::getSignature( BaseInstrument* instrument )
+{
+    unsigned long long signature = 14695981039346656037ULL; // FNV-1a
+
+    auto add = [ &signature ]( unsigned long long value ) {
+        signature = ( signature ^ value ) * 1099511628211ULL;
+    };
+
+    AudioChannel* channel = instrument->audioChannel;
+
+    add( AudioEngine::min_buffer_position );
+    add( AudioEngine::max_buffer_position );
+    add( AudioEngine::samples_per_bar );
+    add( AudioEngine::tempoMapVersion );
+    add( channel->maxBufferPosition );
+
+    std::vector<BaseProcessor*> processors = channel->processingChain->getActiveProcessors();
+
+    for ( size_t i = 0; i < processors.size(); ++i )
+        add(( unsigned long long )( size_t ) processors.at( i ));
+
+    add(( unsigned long long )( size_t ) instrument->getEvents()); // e.g. switching drum patterns
+    add( instrument->getModificationCount());
+
+    return signature;
+}
+
+void Freezer::startThread()
+{
+    if ( _running )
+        return;
+
+    if ( _thread.joinable())
+        _thread.join();
+
+    _running = true;
+    _thread  = std::thread([]()
+    {
+        while ( _running )
+        {
+            update();
+            _updateSignal.wait( POLL_INTERVAL );
+        }
+    });
+}
+
+void Freezer::stopThread()
+{
+    _running = false;
+    _updateSignal.signal();
+
+    if ( _thread.joinable() && _thread.get_id() != std::this_thread::get_id())
+        _thread.join();
+}
+
+} // E.O namespace MWEngine
@@ -0,0 +1,99 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__FREEZER_H_INCLUDED__
+#define __MWENGINE__FREEZER_H_INCLUDED__
+
+#include "global.h"
+#include <instruments/baseinstrument.h>
+
+namespace MWEngine {
+
+struct FrozenInstrument;
+
+/**
+ * Freezer replaces the real time rendering of an instrument with a pre-rendered ("frozen")
+ * buffer of its sequenced events, so heavy instruments (e.g. synthesizers with many voices)
+ * cost next to nothing during playback. The frozen buffer spans the full loop range of the
+ * sequencer (or the range of the instruments AudioChannel, when it has its own range) and
+ * includes the processors of its processing chain up until the first non-cacheable processor.
+ * The remaining processors are still applied in real time.
+ *
+ * Frozen buffers are rendered on a worker thread. Changes to the events of a frozen instrument
+ * (see BaseInstrument::getModificationCount()) or to the sequencer range, tempo or processing
+ * chain are detected automatically (without locking the instrument), upon which
+ * the instrument returns to real time rendering until the frozen buffer has been rebuilt. Changes
+ * the Freezer can't detect (e.g. changing the properties of a synthesizer or processor) should
+ * be followed by invalidate().
+ *
+ * As frozen buffers are rendered using the instruments events and processors (which can't be
+ * shared with the engine while it renders the same instrument), frozen buffers are only (re)built
+ * while the sequencer is stopped. Instruments changed during playback are rendered in real time
+ * until the sequencer stops. Rendering happens outside of the Freezers lock, as such the public
+ * methods don't block while a frozen buffer is rendered, with the exception of unfreeze() (and
+ * thus the instruments destructor) for an instrument whose frozen buffer is being rendered.
+ *
+ * Note that live events of a frozen instrument are rendered in real time and only have the
+ * remaining (non-frozen) processors applied.
+ */
+class Freezer
+{
+    public:
+        // interval (in milliseconds) at which frozen instruments are validated in the absence of update requests
+        // (e.g. to pick up changes to an instruments processing chain, which do not request an update)
+
+        static const int POLL_INTERVAL = 500;
+
+        // freeze given instrument, the frozen buffer is rendered in the background
+        static void freeze( BaseInstrument* instrument );
+
+        // restore real time rendering for given instrument and discard its frozen buffer
+        static void unfreeze( BaseInstrument* instrument );
+
+        // whether freezing was requested for given instrument (the frozen buffer might not be available yet)
+        static bool isFrozen( BaseInstrument* instrument );
+
+        // discard the frozen buffer of given instrument and rebuild it in the background
+        static void invalidate( BaseInstrument* instrument );
+
+        // whether one or more frozen buffers are awaiting (re)rendering
+        static bool hasPendingFreezes();
+
+        // wake the worker thread to validate the frozen instruments, invoked when an instrument
+        // or the sequencer range/tempo has been altered. Does not block and is safe from any thread
+
+        static void requestUpdate();
+
+        // validates all frozen instruments and renders the pending frozen buffers
+        // (invoked by the worker thread, can be invoked directly to freeze synchronously)
+
+        static void update();
+
+    private:
+        static FrozenInstrument* findInstrument( BaseInstrument* instrument ); // invoke while holding the lock
+        static unsigned long long getSignature( BaseInstrument* instrument );
+        static void startThread();
+        static void stopThread();
+};
+} // E.O namespace MWEngine
+
+#endif
@@ -0,0 +1,175 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "inputcapture.h"
+#include "diskwriter.h"
+#include "audioengine.h"
+#include <drivers/adapter.h>
+#include <definitions/notifications.h>
+#include <messaging/notifier.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace MWEngine {
+
+// the calibration click is a short half sine burst
+
+static const int   CLICK_LENGTH    = 16;
+static const float CLICK_AMPLITUDE = 0.9f;
+
+enum calibrationState {
+    CALIBRATION_IDLE,
+    CALIBRATION_PENDING,   // click is written upon the next render cycle
+    CALIBRATION_LISTENING  // click has been written, awaiting its arrival at the input
+};
+
+namespace InputCaptureState
+{
+    std::atomic<int> _latency( -1 );
+    std::atomic<int> _calibrationState( CALIBRATION_IDLE );
+    float _calibrationThreshold = 0.1f;
+
+    long _renderedFrames = 0; // the amount of frames written to the output since calibration start
+    long _clickFrame     = 0; // the frame at which the calibration click was written
+
+    int _skipFrames      = 0;
+    int _startPosition   = 0;
+}
+
+using namespace InputCaptureState;
+
+/* public methods */
+
+int InputCapture::getLatency()
+{
+    int latency = _latency.load();
+    return ( latency >= 0 ) ? latency : DriverAdapter::getLatency();
+}
+
+void InputCapture::setLatency( int samples )
+{
+    _latency.store( samples );
+}
+
+void InputCapture::startCalibration()
+{
+    _renderedFrames = 0;
+    _calibrationState.store( CALIBRATION_PENDING );
+}
+
+bool InputCapture::isCalibrating()
+{
+    return _calibrationState.load() != CALIBRATION_IDLE;
+}
+
+void InputCapture::setCalibrationThreshold( float threshold )
+{
+    _calibrationThreshold = threshold;
+}
+
+void InputCapture::prepare()
+{
+    _skipFrames    = getLatency();
+    _startPosition = -1; // resolved when the first input is recorded
+}
+
+int InputCapture::getRecordingStartPosition()
+{
+    return _startPosition;
+}
+
+void InputCapture::processInput( AudioBuffer* inputBuffer, int amountOfSamples, bool recording )
+{
+    amountOfSamples = std::min( amountOfSamples, inputBuffer->bufferSize );
+
+    if ( _calibrationState.load() == CALIBRATION_LISTENING )
+    {
+        // note input is processed before the output of the same render cycle is
+        // written, as such _renderedFrames describes the frame of the first input sample
+
+        SAMPLE_TYPE* samples = inputBuffer->getBufferForChannel( 0 );
+
+        for ( int i = 0; i < amountOfSamples; ++i )
+        {
+            if ( std::abs( samples[ i ] ) >= _calibrationThreshold )
+            {
+                int latency = ( int )( _renderedFrames + i - _clickFrame );
+
+                _latency.store( latency );
+                _calibrationState.store( CALIBRATION_IDLE );
+
+                Notifier::broadcast( Notifications::LATENCY_CALIBRATED, latency );
+                break;
+            }
+        }
+
+        if ( _calibrationState.load() == CALIBRATION_LISTENING &&
+             ( _renderedFrames - _clickFrame ) > AudioEngineProps::SAMPLE_RATE / 1000 * CALIBRATION_TIMEOUT )
+        {
+            _calibrationState.store( CALIBRATION_IDLE );
+            Notifier::broadcast( Notifications::LATENCY_CALIBRATED, -1 );
+        }
+    }
+
+    if ( !recording )
+        return;
+
+    if ( _startPosition < 0 )
+        _startPosition = AudioEngine::bufferPosition;
+
+    // omit the input that arrived before the audio the performer
+    // heard at the start of the recording
+
+    int offset = std::min( _skipFrames, amountOfSamples );
+    _skipFrames -= offset;
+
+    if ( offset < amountOfSamples )
+        DiskWriter::appendBuffer( inputBuffer, offset, amountOfSamples - offset );
+}
+
+void InputCapture::processOutput( float* outputBuffer, int amountOfSamples, int amountOfChannels )
+{
+    if ( _calibrationState.load() == CALIBRATION_PENDING )
+    {
+        // the click is considered to be written at the first sample exceeding the
+        // detection threshold (as this is where it will be detected at the input)
+
+        int onset = 0;
+
+        for ( int i = 0, l = std::min( CLICK_LENGTH, amountOfSamples ); i < l; ++i )
+        {
+            float sample = CLICK_AMPLITUDE * ( float ) sin( PI * ( i + 0.5 ) / CLICK_LENGTH );
+
+            if ( onset == i && sample < _calibrationThreshold )
+                onset = i + 1;
+
+            for ( int c = 0; c < amountOfChannels; ++c )
+                outputBuffer[ i * amountOfChannels + c ] = sample;
+        }
+        _clickFrame = _renderedFrames + onset;
+        _calibrationState.store( CALIBRATION_LISTENING );
+    }
+    _renderedFrames += amountOfSamples;
+}
+
+} // E.O namespace MWEngine
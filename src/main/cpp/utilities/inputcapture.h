@@ -0,0 +1,88 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__INPUTCAPTURE_H_INCLUDED__
+#define __MWENGINE__INPUTCAPTURE_H_INCLUDED__
+
+#include "global.h"
+#include "audiobuffer.h"
+
+namespace MWEngine {
+
+/**
+ * InputCapture manages the recording of the device input with compensation for the
+ * round-trip latency of the audio hardware (e.g. the time between the engine writing
+ * output and the same audio arriving at the input). Without compensation, recorded
+ * takes land late relative to the sequenced material the performer was listening to.
+ *
+ * The latency is either estimated by the driver or measured by a loopback calibration
+ * (where the engine emits a click and measures when it is received at the input, requires
+ * the output to be audible to the input, e.g. through a loopback cable or speaker and microphone).
+ *
+ * When recording, the first <latency> frames of input are omitted so the recorded take
+ * starts at the sequencer position where the recording started (see getRecordingStartPosition()),
+ * allowing the take to be placed directly as a SampleEvent at that position.
+ *
+ * Methods marked as rendering thread don't allocate or block.
+ */
+class InputCapture
+{
+    public:
+
+        static const int CALIBRATION_TIMEOUT = 1000; // in milliseconds
+
+        // the round-trip latency (in samples) that is compensated for, when no latency
+        // has been set (or calibrated) this equals the estimated latency of the driver
+
+        static int getLatency();
+
+        // set the round-trip latency in samples, pass -1 to use the driver estimate
+        static void setLatency( int samples );
+
+        // start a loopback calibration, upon completion LATENCY_CALIBRATED is broadcast
+        // with the measured latency in samples as its value (or -1 when the click wasn't detected)
+
+        static void startCalibration();
+        static bool isCalibrating();
+
+        // the minimum absolute sample value the input must exceed for the calibration click to be detected
+        static void setCalibrationThreshold( float threshold );
+
+        // prepare for recording a new take (must be invoked before the recording starts)
+        static void prepare();
+
+        // the sequencer position (in samples) at which the first sample of the recorded take should be placed
+        static int getRecordingStartPosition();
+
+        /* rendering thread */
+
+        // processes given buffer of device input (for calibration), when recording is true,
+        // the latency compensated contents of the buffer are appended to the DiskWriter
+
+        static void processInput( AudioBuffer* inputBuffer, int amountOfSamples, bool recording );
+
+        // writes the calibration click into given (interleaved) output buffer when calibrating
+        static void processOutput( float* outputBuffer, int amountOfSamples, int amountOfChannels );
+};
+} // E.O namespace MWEngine
+
+#endif
@@ -0,0 +1,328 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "levelmeter.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+namespace MWEngine {
+
+// true-peak detection interpolates TRUE_PEAK_PHASES values in between each pair of
+// samples (e.g. 4x oversampling) using a windowed sinc kernel of TRUE_PEAK_TAPS taps
+
+static const int TRUE_PEAK_PHASES  = 3;
+static const int TRUE_PEAK_TAPS    = 12;
+static const int TRUE_PEAK_HISTORY = TRUE_PEAK_TAPS - 1;
+static const int TRUE_PEAK_BLOCK   = 128; // samples interpolated per pass, bounds the scratch buffer size
+
+typedef struct
+{
+    SAMPLE_TYPE peak[ 2 ];
+    SAMPLE_TYPE truePeak[ 2 ];
+    SAMPLE_TYPE sumOfSquares[ 2 ];
+    int frames;
+    int id;
+    SAMPLE_TYPE history[ 2 ][ TRUE_PEAK_HISTORY ]; // trailing samples of the previous cycle
+} meterState;
+
+// published levels are double buffered, the reader verifies the sequence
+// of the buffer it copied from to be unchanged (e.g. a sequence lock)
+
+typedef struct
+{
+    std::atomic<unsigned int> sequence;
+    int amountOfMeters;
+    float levels[ LevelMeter::MAX_METERS * LevelMeter::STRIDE ];
+} meterSnapshot;
+
+namespace LevelMeterState
+{
+    std::atomic<bool> _enabled( false );
+    std::atomic<bool> _truePeakEnabled( false );
+
+    meterState _meters[ LevelMeter::MAX_METERS ];
+    meterSnapshot _snapshots[ 2 ];
+    std::atomic<int>  _front( 0 );
+    std::atomic<bool> _resetRequested( true );
+
+    bool _measuring    = false; // whether a render cycle is being measured
+    bool _resetting    = true;  // whether the current render cycle starts a new measurement window
+    int  _windowFrames = 0;
+
+    SAMPLE_TYPE _scratch[ TRUE_PEAK_BLOCK + TRUE_PEAK_HISTORY ];
+}
+
+using namespace LevelMeterState;
+
+const int LevelMeter::MAX_METERS;
+const int LevelMeter::MAX_WINDOW_MS;
+const int LevelMeter::MASTER_ID;
+
+static std::vector<SAMPLE_TYPE> createTruePeakTable()
+{
+    std::vector<SAMPLE_TYPE> table( TRUE_PEAK_PHASES * TRUE_PEAK_TAPS );
+    const double halfWidth = TRUE_PEAK_TAPS / 2;
+
+    for ( int phase = 0; phase < TRUE_PEAK_PHASES; ++phase )
+    {
+        // tap j weighs the sample at offset ( j - TRUE_PEAK_HISTORY / 2 ) relative
+        // to the sample the interpolated position follows
+
+        double frac = ( double ) ( phase + 1 ) / ( TRUE_PEAK_PHASES + 1 );
+        double sum  = 0.0;
+        SAMPLE_TYPE* row = &table[ phase * TRUE_PEAK_TAPS ];
+
+        for ( int j = 0; j < TRUE_PEAK_TAPS; ++j )
+        {
+            double x      = frac - ( j - TRUE_PEAK_HISTORY / 2 );
+            double sinc   = ( x == 0.0 ) ? 1.0 : sin( PI * x ) / ( PI * x );
+            double window = 0.5 + 0.5 * cos( PI * x / halfWidth );
+            row[ j ] = sinc * window;
+            sum     += row[ j ];
+        }
+
+        // normalize for unity gain at DC
+        for ( int j = 0; j < TRUE_PEAK_TAPS; ++j )
+            row[ j ] /= sum;
+    }
+    return table;
+}
+
+static const SAMPLE_TYPE* getTruePeakTable()
+{
+    // static initialization is thread safe as of C++11, the table is created upon enabling
+    // true peak metering (see setTruePeakEnabled()) so it isn't computed on the rendering thread
+    static std::vector<SAMPLE_TYPE> table = createTruePeakTable();
+    return table.data();
+}
+
+/* public methods */
+
+void LevelMeter::setEnabled( bool value )
+{
+    if ( value && _truePeakEnabled )
+        getTruePeakTable();
+
+    _enabled = value;
+}
+
+bool LevelMeter::isEnabled()
+{
+    return _enabled;
+}
+
+void LevelMeter::setTruePeakEnabled( bool value )
+{
+    if ( value )
+        getTruePeakTable();
+
+    _truePeakEnabled = value;
+}
+
+bool LevelMeter::isTruePeakEnabled()
+{
+    return _truePeakEnabled;
+}
+
+void LevelMeter::measure( int slot, int id, AudioBuffer* buffer, int amountOfSamples, SAMPLE_TYPE gain )
+{
+    if ( slot < 0 || slot >= MAX_METERS )
+        return;
+
+    // first measurement of this render cycle ? start a new window when the previous levels have
+    // been read (or when the window exceeds its maximum duration as nobody seems to be reading)
+
+    if ( !_measuring )
+    {
+        _measuring = true;
+        _resetting = _resetRequested.exchange( false ) ||
+                     _windowFrames >= ( AudioEngineProps::SAMPLE_RATE / 1000 ) * MAX_WINDOW_MS;
+
+        if ( _resetting )
+            _windowFrames = 0;
+    }
+
+    meterState* meter = &_meters[ slot ];
+
+    if ( _resetting )
+    {
+        for ( int c = 0; c < 2; ++c ) {
+            meter->peak[ c ]         = 0.0;
+            meter->truePeak[ c ]     = 0.0;
+            meter->sumOfSquares[ c ] = 0.0;
+        }
+        meter->frames = 0;
+    }
+
+    // a different channel occupies this slot ? clear the interpolation history
+
+    if ( meter->id != id ) {
+        for ( int c = 0; c < 2; ++c ) {
+            for ( int i = 0; i < TRUE_PEAK_HISTORY; ++i )
+                meter->history[ c ][ i ] = 0.0;
+        }
+        meter->id = id;
+    }
+
+    amountOfSamples = std::min( amountOfSamples, buffer->bufferSize );
+
+    if ( amountOfSamples <= 0 )
+        return;
+
+    const SAMPLE_TYPE* table = getTruePeakTable();
+    bool truePeakEnabled     = _truePeakEnabled;
+
+    SAMPLE_TYPE absGain = std::abs( gain );
+
+    for ( int c = 0; c < 2; ++c )
+    {
+        // mono buffers are metered identically on both sides
+        SAMPLE_TYPE* samples = buffer->getBufferForChannel( std::min( c, buffer->amountOfChannels - 1 ));
+
+        // the loops below are kept free of branches so they can be vectorised by the compiler
+
+        SAMPLE_TYPE peak = 0.0;
+        SAMPLE_TYPE sum  = 0.0;
+
+        for ( int i = 0; i < amountOfSamples; ++i ) {
+            SAMPLE_TYPE sample = samples[ i ];
+            peak = std::max( peak, std::abs( sample ));
+            sum += sample * sample;
+        }
+
+        SAMPLE_TYPE truePeak = peak;
+
+        if ( truePeakEnabled )
+        {
+            // the samples are interpolated in blocks of up to TRUE_PEAK_BLOCK samples, each block
+            // is prepended with the trailing samples of the previous block (or cycle) so the
+            // interpolation continues seamlessly across blocks and cycles
+
+            SAMPLE_TYPE* history = meter->history[ c ];
+            SAMPLE_TYPE* input   = _scratch;
+
+            for ( int offset = 0; offset < amountOfSamples; offset += TRUE_PEAK_BLOCK )
+            {
+                int blockSize = std::min( TRUE_PEAK_BLOCK, amountOfSamples - offset );
+
+                for ( int i = 0; i < TRUE_PEAK_HISTORY; ++i )
+                    input[ i ] = history[ i ];
+
+                for ( int i = 0; i < blockSize; ++i )
+                    input[ i + TRUE_PEAK_HISTORY ] = samples[ offset + i ];
+
+                for ( int phase = 0; phase < TRUE_PEAK_PHASES; ++phase )
+                {
+                    const SAMPLE_TYPE* row = &table[ phase * TRUE_PEAK_TAPS ];
+
+                    for ( int i = 0; i < blockSize; ++i )
+                    {
+                        const SAMPLE_TYPE* window = &input[ i + 1 ];
+                        SAMPLE_TYPE value = 0.0;
+
+                        for ( int j = 0; j < TRUE_PEAK_TAPS; ++j )
+                            value += window[ j ] * row[ j ];
+
+                        truePeak = std::max( truePeak, std::abs( value ));
+                    }
+                }
+
+                for ( int i = 0; i < TRUE_PEAK_HISTORY; ++i )
+                    history[ i ] = input[ blockSize + i ];
+            }
+        }
+
+        meter->peak[ c ]          = std::max( meter->peak[ c ], peak * absGain );
+        meter->truePeak[ c ]      = std::max( meter->truePeak[ c ], truePeak * absGain );
+        meter->sumOfSquares[ c ] += sum * gain * gain;
+    }
+    meter->frames += amountOfSamples;
+}
+
+void LevelMeter::publish( int amountOfMeters, int amountOfSamples )
+{
+    amountOfMeters = std::min( amountOfMeters, ( int ) MAX_METERS );
+
+    int back = 1 - _front.load( std::memory_order_relaxed );
+    meterSnapshot* snapshot = &_snapshots[ back ];
+
+    // odd sequence indicates a write in progress
+
+    snapshot->sequence.fetch_add( 1, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release );
+
+    for ( int m = 0; m < amountOfMeters; ++m )
+    {
+        meterState* meter = &_meters[ m ];
+        float* levels     = &snapshot->levels[ m * STRIDE ];
+        SAMPLE_TYPE frames = ( SAMPLE_TYPE ) std::max( 1, meter->frames );
+
+        levels[ ID ]              = ( float ) meter->id;
+        levels[ PEAK_LEFT ]       = ( float ) meter->peak[ 0 ];
+        levels[ PEAK_RIGHT ]      = ( float ) meter->peak[ 1 ];
+        levels[ RMS_LEFT ]        = ( float ) sqrt( meter->sumOfSquares[ 0 ] / frames );
+        levels[ RMS_RIGHT ]       = ( float ) sqrt( meter->sumOfSquares[ 1 ] / frames );
+        levels[ TRUE_PEAK_LEFT ]  = ( float ) meter->truePeak[ 0 ];
+        levels[ TRUE_PEAK_RIGHT ] = ( float ) meter->truePeak[ 1 ];
+    }
+    snapshot->amountOfMeters = amountOfMeters;
+
+    snapshot->sequence.fetch_add( 1, std::memory_order_release );
+    _front.store( back, std::memory_order_release );
+
+    _windowFrames += amountOfSamples;
+    _measuring     = false;
+}
+
+int LevelMeter::read( float* target, int maxMeters )
+{
+    while ( true )
+    {
+        meterSnapshot* snapshot = &_snapshots[ _front.load( std::memory_order_acquire ) ];
+        unsigned int sequence   = snapshot->sequence.load( std::memory_order_acquire );
+
+        if ( sequence & 1 )
+            continue; // the writer wrapped around onto this snapshot, retry
+
+        int amount = std::min( snapshot->amountOfMeters, maxMeters );
+
+        for ( int i = 0, l = amount * STRIDE; i < l; ++i )
+            target[ i ] = snapshot->levels[ i ];
+
+        std::atomic_thread_fence( std::memory_order_acquire );
+
+        if ( snapshot->sequence.load( std::memory_order_relaxed ) == sequence )
+        {
+            _resetRequested.store( true );
+            return amount;
+        }
+    }
+}
+
+void LevelMeter::reset()
+{
+    _resetRequested.store( true );
+}
+
+} // E.O namespace MWEngine
@@ -0,0 +1,94 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__LEVELMETER_H_INCLUDED__
+#define __MWENGINE__LEVELMETER_H_INCLUDED__
+
+#include "global.h"
+#include "audiobuffer.h"
+
+namespace MWEngine {
+
+/**
+ * LevelMeter measures the peak, RMS and true-peak (4x oversampled, see ITU-R BS.1770)
+ * levels of the master bus and all AudioChannels in a single pass per render cycle
+ * (see AudioEngine::render()). Rather than querying the level of each channel individually
+ * (see LevelUtility), the results are published as a single flat array which
+ * can be read from any thread (e.g. the UI) without blocking the rendering thread.
+ *
+ * Levels are accumulated between reads: each read returns the maximum peak and the
+ * RMS value of the audio rendered since the previous read (up to MAX_WINDOW_MS), meaning
+ * no transients are missed when the reader polls at a lower rate than the render rate.
+ *
+ * Metering is opt-in: it is disabled by default and should be enabled (see setEnabled())
+ * when levels are displayed. True-peak detection is opt-in separately.
+ */
+class LevelMeter
+{
+    public:
+
+        static const int MAX_METERS    = 65;  // the master bus and up to 64 channels
+        static const int MAX_WINDOW_MS = 300; // maximum duration levels accumulate over when unread
+        static const int MASTER_ID     = -1;  // identifier of the master bus meter
+
+        // each meter occupies STRIDE values in the published array, in below order
+
+        enum Field {
+            ID, PEAK_LEFT, PEAK_RIGHT, RMS_LEFT, RMS_RIGHT, TRUE_PEAK_LEFT, TRUE_PEAK_RIGHT, STRIDE
+        };
+
+        static void setEnabled( bool value );
+        static bool isEnabled();
+
+        // true-peak detection is the most expensive measurement and is disabled by default
+        // (in which case the true-peak values equal the sample peak values)
+
+        static void setTruePeakEnabled( bool value );
+        static bool isTruePeakEnabled();
+
+        /* rendering thread */
+
+        // measure the first amountOfSamples of given buffer into the meter at given slot
+        // (where slot 0 is reserved for the master bus). id identifies the meter for the
+        // reader (e.g. the AudioChannel instanceId), gain is applied onto the measured levels
+        // (e.g. the channel volume)
+
+        static void measure( int slot, int id, AudioBuffer* buffer, int amountOfSamples, SAMPLE_TYPE gain );
+
+        // publish the levels of the first amountOfMeters slots to the reader
+        // amountOfSamples describes the amount of samples measured in the current render cycle
+
+        static void publish( int amountOfMeters, int amountOfSamples );
+
+        /* any thread */
+
+        // copies the last published levels into given target (which should hold
+        // at least maxMeters * STRIDE values), returns the amount of copied meters
+
+        static int read( float* target, int maxMeters );
+
+        // discards the accumulated levels, a new measurement window starts on the next render cycle
+        static void reset();
+};
+} // E.O namespace MWEngine
+
+#endif
@@ -0,0 +1,109 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "lockfreeringbuffer.h"
+#include <algorithm>
+#include <cstring>
+
+namespace MWEngine {
+
+/* constructor / destructor */
+
+LockFreeRingBuffer::LockFreeRingBuffer( size_t capacity )
+{
+    _capacity = 1;
+
+    while ( _capacity < capacity )
+        _capacity <<= 1;
+
+    _mask       = _capacity - 1;
+    _buffer     = new float[ _capacity ]();
+    _writeIndex = 0;
+    _readIndex  = 0;
+}
+
+LockFreeRingBuffer::~LockFreeRingBuffer()
+{
+    delete[] _buffer;
+}
+
+/* public methods */
+
+size_t LockFreeRingBuffer::getCapacity()
+{
+    return _capacity;
+}
+
+size_t LockFreeRingBuffer::write( const float* source, size_t amount )
+{
+    size_t writeIndex = _writeIndex.load( std::memory_order_relaxed );
+    size_t readIndex  = _readIndex.load( std::memory_order_acquire );
+
+    amount = std::min( amount, _capacity - ( writeIndex - readIndex ));
+
+    // copy in (at most) two parts when wrapping around the end of the buffer
+
+    size_t offset = writeIndex & _mask;
+    size_t first  = std::min( amount, _capacity - offset );
+
+    memcpy( _buffer + offset, source, first * sizeof( float ));
+    memcpy( _buffer, source + first, ( amount - first ) * sizeof( float ));
+
+    _writeIndex.store( writeIndex + amount, std::memory_order_release );
+
+    return amount;
+}
+
+size_t LockFreeRingBuffer::getWriteAvailable()
+{
+    return _capacity - ( _writeIndex.load( std::memory_order_relaxed ) - _readIndex.load( std::memory_order_acquire ));
+}
+
+size_t LockFreeRingBuffer::read( float* target, size_t amount )
+{
+    size_t readIndex  = _readIndex.load( std::memory_order_relaxed );
+    size_t writeIndex = _writeIndex.load( std::memory_order_acquire );
+
+    amount = std::min( amount, writeIndex - readIndex );
+
+    size_t offset = readIndex & _mask;
+    size_t first  = std::min( amount, _capacity - offset );
+
+    memcpy( target, _buffer + offset, first * sizeof( float ));
+    memcpy( target + first, _buffer, ( amount - first ) * sizeof( float ));
+
+    _readIndex.store( readIndex + amount, std::memory_order_release );
+
+    return amount;
+}
+
+size_t LockFreeRingBuffer::getReadAvailable()
+{
+    return _writeIndex.load( std::memory_order_acquire ) - _readIndex.load( std::memory_order_relaxed );
+}
+
+void LockFreeRingBuffer::clear()
+{
+    _readIndex.store( _writeIndex.load());
+}
+
+} // E.O namespace MWEngine
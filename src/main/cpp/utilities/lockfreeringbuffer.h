@@ -0,0 +1,77 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__LOCKFREERINGBUFFER_H_INCLUDED__
+#define __MWENGINE__LOCKFREERINGBUFFER_H_INCLUDED__
+
+#include <atomic>
+#include <cstddef>
+
+namespace MWEngine {
+
+/**
+ * LockFreeRingBuffer is a single producer, single consumer queue of
+ * floating point values. One thread (e.g. the rendering thread) writes while
+ * another thread (e.g. a disk writing thread) reads, without either thread
+ * ever blocking the other. The capacity is rounded up to the nearest power of two.
+ */
+class LockFreeRingBuffer
+{
+    public:
+        LockFreeRingBuffer( size_t capacity );
+        ~LockFreeRingBuffer();
+
+        size_t getCapacity();
+
+        /* producer thread */
+
+        // writes up to amount values from given source, returns
+        // the amount of values written (less than requested when full)
+
+        size_t write( const float* source, size_t amount );
+        size_t getWriteAvailable();
+
+        /* consumer thread */
+
+        // reads up to amount values into given target, returns
+        // the amount of values read (less than requested when empty)
+
+        size_t read( float* target, size_t amount );
+        size_t getReadAvailable();
+
+        // discards all contents, should only be invoked when no other thread is writing
+        void clear();
+
+    private:
+        float* _buffer;
+        size_t _capacity;
+        size_t _mask;
+
+        // both indices are incremented indefinitely (and only masked upon access)
+        // so their difference always equals the amount of stored values
+
+        std::atomic<size_t> _writeIndex;
+        std::atomic<size_t> _readIndex;
+};
+} // E.O namespace MWEngine
+
+#endif
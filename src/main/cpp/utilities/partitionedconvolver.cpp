@@ -0,0 +1,135 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "partitionedconvolver.h"
+#include <algorithm>
+
+namespace MWEngine {
+
+/* constructor / destructor */
+
+PartitionedConvolver::PartitionedConvolver( int blockSize, SAMPLE_TYPE* kernel, int kernelLength )
+{
+    _blockSize          = blockSize;
+    _spectrumSize       = blockSize * 2 + 2;
+    _amountOfPartitions = std::max( 1, ( kernelLength + blockSize - 1 ) / blockSize );
+    _delayLineIndex     = 0;
+
+    _fft = new FFT( blockSize * 2 );
+
+    _kernelSpectra.resize( _amountOfPartitions * _spectrumSize, 0.f );
+    _delayLine.resize    ( _amountOfPartitions * _spectrumSize, 0.f );
+    _accumulator.resize  ( _spectrumSize, 0.f );
+    _input.resize        ( _spectrumSize, 0.f );
+
+    // transform each partition of the kernel, zero padded to twice the block size. The scale
+    // of the inverse transform is applied to the kernel, saving a multiplication per block
+
+    float scale = 1.f / ( float ) ( blockSize * 2 );
+
+    for ( int p = 0; p < _amountOfPartitions; ++p )
+    {
+        float* spectrum = &_kernelSpectra[ p * _spectrumSize ];
+        int offset      = p * blockSize;
+
+        for ( int i = 0; i < blockSize && offset + i < kernelLength; ++i )
+            spectrum[ i ] = ( float ) kernel[ offset + i ] * scale;
+
+        _fft->forward( spectrum );
+    }
+}
+
+PartitionedConvolver::~PartitionedConvolver()
+{
+    delete _fft;
+}
+
+/* public methods */
+
+int PartitionedConvolver::getBlockSize()
+{
+    return _blockSize;
+}
+
+int PartitionedConvolver::getAmountOfPartitions()
+{
+    return _amountOfPartitions;
+}
+
+void PartitionedConvolver::process( SAMPLE_TYPE* input, SAMPLE_TYPE* output )
+{
+    // append the block to the previous one and transform both into the delay line
+
+    float* inputBuffer = &_input[ 0 ];
+
+    std::copy( inputBuffer + _blockSize, inputBuffer + _blockSize * 2, inputBuffer );
+
+    for ( int i = 0; i < _blockSize; ++i )
+        inputBuffer[ _blockSize + i ] = ( float ) input[ i ];
+
+    if ( --_delayLineIndex < 0 )
+        _delayLineIndex = _amountOfPartitions - 1;
+
+    float* spectrum = &_delayLine[ _delayLineIndex * _spectrumSize ];
+
+    std::copy( inputBuffer, inputBuffer + _blockSize * 2, spectrum );
+    _fft->forward( spectrum );
+
+    // multiply-accumulate the spectrum of each block with the partition of the kernel
+    // by which it is delayed (the most recent block with the first partition, etc.)
+
+    float* accumulator = &_accumulator[ 0 ];
+    std::fill( _accumulator.begin(), _accumulator.end(), 0.f );
+
+    for ( int p = 0; p < _amountOfPartitions; ++p )
+    {
+        int index = _delayLineIndex + p;
+        if ( index >= _amountOfPartitions )
+            index -= _amountOfPartitions;
+
+        float* x = &_delayLine[ index * _spectrumSize ];
+        float* h = &_kernelSpectra[ p * _spectrumSize ];
+
+        for ( int i = 0; i < _spectrumSize; i += 2 )
+        {
+            accumulator[ i ]     += x[ i ] * h[ i ]     - x[ i + 1 ] * h[ i + 1 ];
+            accumulator[ i + 1 ] += x[ i ] * h[ i + 1 ] + x[ i + 1 ] * h[ i ];
+        }
+    }
+
+    // the first half of the result is aliased by the circular convolution, the second half
+    // holds the output for the current block
+
+    _fft->inverse( accumulator );
+
+    for ( int i = 0; i < _blockSize; ++i )
+        output[ i ] = ( SAMPLE_TYPE ) accumulator[ _blockSize + i ];
+}
+
+void PartitionedConvolver::reset()
+{
+    std::fill( _delayLine.begin(), _delayLine.end(), 0.f );
+    std::fill( _input.begin(), _input.end(), 0.f );
+    _delayLineIndex = 0;
+}
+
+} // E.O namespace MWEngine
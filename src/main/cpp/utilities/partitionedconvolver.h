@@ -0,0 +1,82 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__PARTITIONEDCONVOLVER_H_INCLUDED__
+#define __MWENGINE__PARTITIONEDCONVOLVER_H_INCLUDED__
+
+#include "../global.h"
+#include "fft.h"
+#include <vector>
+
+namespace MWEngine {
+
+/**
+ * PartitionedConvolver convolves a (mono) signal with a kernel of arbitrary length
+ * (e.g. an impulse response) using uniformly partitioned overlap-save FFT convolution
+ *
+ * the kernel is split into partitions of blockSize samples, which are transformed once
+ * upon construction. The spectra of the most recent input blocks are kept in a frequency
+ * domain delay line, convolving a block of input thus requires a single forward and inverse
+ * transform (of twice the block size) regardless of the kernel length, in addition to a
+ * complex multiply-accumulate per partition
+ *
+ * the output of a block is available once the block of input has been received, as such the
+ * latency equals blockSize. Instances should be created outside of the audio thread
+ */
+class PartitionedConvolver
+{
+    public:
+
+        // blockSize must be a power of two, kernel is copied
+
+        PartitionedConvolver( int blockSize, SAMPLE_TYPE* kernel, int kernelLength );
+        ~PartitionedConvolver();
+
+        int getBlockSize();
+        int getAmountOfPartitions();
+
+        // convolve blockSize samples of input, writing blockSize samples into
+        // output (input and output can point to the same memory)
+
+        void process( SAMPLE_TYPE* input, SAMPLE_TYPE* output );
+
+        // clear the history of the input (e.g. when the stream is interrupted)
+
+        void reset();
+
+    private:
+
+        FFT* _fft;
+
+        int _blockSize;
+        int _spectrumSize;    // amount of values in a spectrum (blockSize + 1 interleaved complex bins)
+        int _amountOfPartitions;
+        int _delayLineIndex;  // partition in the delay line holding the spectrum of the most recent block
+
+        std::vector<float> _kernelSpectra; // per partition, scaled for the unscaled inverse transform
+        std::vector<float> _delayLine;     // the input spectra of the last amountOfPartitions blocks
+        std::vector<float> _accumulator;
+        std::vector<float> _input;         // the previous and current block of input
+};
+} // E.O namespace MWEngine
+
+#endif
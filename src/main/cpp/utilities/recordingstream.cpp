@@ -0,0 +1,251 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "recordingstream.h"
+#include "waveencoder.h"
+#include "debug.h"
+#include "utils.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+namespace MWEngine {
+
+// amount of frames that are converted and written in a single iteration
+
+static const int WRITE_CHUNK_FRAMES = 2048;
+
+static const std::string JOURNAL_EXTENSION = ".journal";
+
+/* constructor / destructor */
+
+RecordingStream::RecordingStream( std::string outputFile, int amountOfChannels, int sampleRate, int bufferedFrames ) :
+    RecordingStream( outputFile, amountOfChannels, sampleRate, bufferedFrames, new WaveEncoder( WaveEncoder::PCM_16 ))
+{
+
+}
+
+RecordingStream::RecordingStream( std::string outputFile, int amountOfChannels, int sampleRate, int bufferedFrames,
+                                  BaseEncoder* encoder )
+{
+    _outputFile       = outputFile;
+    _amountOfChannels = amountOfChannels;
+    _sampleRate       = sampleRate;
+    _open             = false;
+    _ringBuffer       = new LockFreeRingBuffer(( size_t ) bufferedFrames * amountOfChannels );
+    _encoder          = encoder;
+    _writtenFrames    = 0;
+    _updatedFrames    = 0;
+    _droppedFrames    = 0;
+
+    _readBuffer.resize( WRITE_CHUNK_FRAMES * amountOfChannels );
+}
+
+RecordingStream::~RecordingStream()
+{
+    close();
+    delete _encoder;
+    delete _ringBuffer;
+}
+
+/* public methods */
+
+std::string RecordingStream::getOutputFile()
+{
+    return _outputFile;
+}
+
+int RecordingStream::getAmountOfChannels()
+{
+    return _amountOfChannels;
+}
+
+BaseEncoder* RecordingStream::getEncoder()
+{
+    return _encoder;
+}
+
+int RecordingStream::write( float* interleavedBuffer, int amountOfFrames )
+{
+    if ( getWriteAvailable() < amountOfFrames ) {
+        _droppedFrames += amountOfFrames;
+        return 0;
+    }
+    _ringBuffer->write( interleavedBuffer, ( size_t ) amountOfFrames * _amountOfChannels );
+
+    return amountOfFrames;
+}
+
+int RecordingStream::write( AudioBuffer* buffer, int amountOfFrames )
+{
+    return write( buffer, amountOfFrames, 1.f );
+}
+
+int RecordingStream::write( AudioBuffer* buffer, int amountOfFrames, float gain )
+{
+    return write( buffer, 0, amountOfFrames, gain );
+}
+
+int RecordingStream::write( AudioBuffer* buffer, int readOffset, int amountOfFrames, float gain )
+{
+    amountOfFrames = std::min( amountOfFrames, buffer->bufferSize - readOffset );
+
+    if ( getWriteAvailable() < amountOfFrames ) {
+        _droppedFrames += amountOfFrames;
+        return 0;
+    }
+
+    // interleave the buffer contents in small chunks to omit allocation
+
+    const int CHUNK_SIZE = 256;
+    float chunk[ CHUNK_SIZE ];
+    int framesPerChunk = CHUNK_SIZE / _amountOfChannels;
+
+    for ( int i = 0; i < amountOfFrames; i += framesPerChunk )
+    {
+        int frames = std::min( framesPerChunk, amountOfFrames - i );
+
+        for ( int c = 0; c < _amountOfChannels; ++c )
+        {
+            // buffers with less channels than the recording have their last channel duplicated
+            SAMPLE_TYPE* channelBuffer = buffer->getBufferForChannel( std::min( c, buffer->amountOfChannels - 1 )) + readOffset;
+
+            for ( int j = 0; j < frames; ++j )
+                chunk[ j * _amountOfChannels + c ] = ( float ) channelBuffer[ i + j ] * gain;
+        }
+        _ringBuffer->write( chunk, ( size_t ) frames * _amountOfChannels );
+    }
+    return amountOfFrames;
+}
+
+int RecordingStream::getWriteAvailable()
+{
+    return ( int ) ( _ringBuffer->getWriteAvailable() / _amountOfChannels );
+}
+
+bool RecordingStream::open()
+{
+    if ( _open )
+        return true;
+
+    _open = _encoder->open( _outputFile, _sampleRate, _amountOfChannels );
+
+    if ( !_open ) {
+        Debug::log( "RecordingStream::Error could not open file '%s'", _outputFile.c_str() );
+        return false;
+    }
+
+    // write the journal describing the recording in progress
+
+    std::string journalFile = getJournalFile( _outputFile );
+    std::ofstream journal( journalFile.c_str() );
+    journal << _outputFile;
+    journal.close();
+
+    syncFile( journalFile );
+
+    return true;
+}
+
+bool RecordingStream::isOpen()
+{
+    return _open;
+}
+
+int RecordingStream::flush()
+{
+    if ( !_open )
+        return 0;
+
+    int written = 0;
+    size_t read;
+
+    // the producer only queues whole frames and the read buffer holds
+    // a multiple of the channel amount, as such we always read whole frames
+
+    while (( read = _ringBuffer->read( _readBuffer.data(), _readBuffer.size())) > 0 )
+    {
+        int frames = ( int ) read / _amountOfChannels;
+        _encoder->encode( _readBuffer.data(), frames );
+
+        written += frames;
+    }
+    _writtenFrames += written;
+
+    // periodically update the output file to describe the written data
+
+    if ( _writtenFrames - _updatedFrames >= ( unsigned long ) _sampleRate * UPDATE_INTERVAL / 1000 )
+    {
+        _encoder->update();
+        _updatedFrames = _writtenFrames;
+    }
+    return written;
+}
+
+void RecordingStream::close()
+{
+    if ( !_open )
+        return;
+
+    flush();
+
+    _encoder->close();
+    _open = false;
+
+    // the output file is complete, the journal is no longer required
+    remove( getJournalFile( _outputFile ).c_str() );
+
+    if ( _droppedFrames > 0 )
+        Debug::log( "RecordingStream::Warning dropped %d frames while recording '%s'",
+                    ( int ) _droppedFrames, _outputFile.c_str() );
+}
+
+unsigned long RecordingStream::getWrittenFrames()
+{
+    return _writtenFrames;
+}
+
+unsigned long RecordingStream::getDroppedFrames()
+{
+    return _droppedFrames;
+}
+
+std::string RecordingStream::getJournalFile( std::string outputFile )
+{
+    return outputFile + JOURNAL_EXTENSION;
+}
+
+std::string RecordingStream::getOutputFileForJournal( std::string journalFile )
+{
+    if ( !isJournalFile( journalFile ))
+        return journalFile;
+
+    return journalFile.substr( 0, journalFile.size() - JOURNAL_EXTENSION.size() );
+}
+
+bool RecordingStream::isJournalFile( std::string fileName )
+{
+    return fileName.size() > JOURNAL_EXTENSION.size() &&
+           fileName.compare( fileName.size() - JOURNAL_EXTENSION.size(), JOURNAL_EXTENSION.size(), JOURNAL_EXTENSION ) == 0;
+}
+
+} // E.O namespace MWEngine
@@ -0,0 +1,115 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__RECORDINGSTREAM_H_INCLUDED__
+#define __MWENGINE__RECORDINGSTREAM_H_INCLUDED__
+
+#include "global.h"
+#include "audiobuffer.h"
+#include "lockfreeringbuffer.h"
+#include "baseencoder.h"
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace MWEngine {
+
+/**
+ * RecordingStream writes audio into a single file as it is being rendered.
+ * The rendering thread queues interleaved frames into a lock free ring buffer, while
+ * a writer thread (see DiskWriter) drains the queue and encodes its contents straight
+ * into the output file. The encoder is updated periodically (e.g. for WAV files the header
+ * is rewritten), so the file on storage is valid at all times during the recording.
+ *
+ * While the stream is open, a journal file is kept alongside the output file. When the
+ * application is terminated during recording, the journal remains and allows the incomplete
+ * recording to be recovered on the next start (see DiskWriter::recoverRecordings()).
+ */
+class RecordingStream
+{
+    public:
+        // bufferedFrames describes the amount of frames the ring buffer can hold, this should
+        // be large enough to cover the worst case latency of writing to storage
+        // encoder describes the output format (16-bit WAV when omitted), the stream takes ownership
+
+        RecordingStream( std::string outputFile, int amountOfChannels, int sampleRate, int bufferedFrames );
+        RecordingStream( std::string outputFile, int amountOfChannels, int sampleRate, int bufferedFrames,
+                         BaseEncoder* encoder );
+        ~RecordingStream();
+
+        static const int UPDATE_INTERVAL = 1000; // interval of encoder updates, in milliseconds
+
+        std::string getOutputFile();
+        int getAmountOfChannels();
+        BaseEncoder* getEncoder();
+
+        /* rendering thread */
+
+        // queue given amount of frames for writing. Frames are queued as a whole (e.g. nothing
+        // is queued when there is insufficient space, in which case the frames are counted as dropped)
+        // returns the amount of queued frames
+
+        int write( float* interleavedBuffer, int amountOfFrames );
+        int write( AudioBuffer* buffer, int amountOfFrames );
+        int write( AudioBuffer* buffer, int amountOfFrames, float gain );
+        int write( AudioBuffer* buffer, int readOffset, int amountOfFrames, float gain );
+
+        int getWriteAvailable(); // in frames
+
+        /* writer thread */
+
+        bool open();
+        bool isOpen();
+
+        // write all queued frames into the output file, returns the amount of written frames
+        int flush();
+
+        // flush remaining frames and complete the output file
+        void close();
+
+        unsigned long getWrittenFrames();
+        unsigned long getDroppedFrames();
+
+        // the journal file for given output file, and for a given journal file its output file
+
+        static std::string getJournalFile( std::string outputFile );
+        static std::string getOutputFileForJournal( std::string journalFile );
+        static bool isJournalFile( std::string fileName );
+
+    private:
+        std::string _outputFile;
+        int _amountOfChannels;
+        int _sampleRate;
+        bool _open;
+
+        LockFreeRingBuffer* _ringBuffer;
+        BaseEncoder* _encoder;
+
+        std::vector<float> _readBuffer;
+
+        unsigned long _writtenFrames;
+        unsigned long _updatedFrames; // amount of frames written at the last encoder update
+        std::atomic<unsigned long> _droppedFrames;
+};
+} // E.O namespace MWEngine
+
+#endif
@@ -0,0 +1,275 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "resampler.h"
+#include <algorithm>
+
+namespace MWEngine {
+
+// windowed-sinc kernel properties
+
+static const int    SINC_HALF_TAPS = Resampler::SINC_TAPS / 2;
+static const double SINC_CUTOFF    = 0.9; // relative to Nyquist, leaves room for the Kaiser window transition band
+static const double KAISER_BETA    = 8.0; // ~80 dB stopband attenuation
+
+/* internal methods */
+
+// zeroth order modified Bessel function of the first kind (used by the Kaiser window)
+
+static double besselI0( double x )
+{
+    double sum  = 1.0;
+    double term = 1.0;
+    double half = x * 0.5;
+
+    for ( int k = 1; k < 32; ++k ) {
+        term *= ( half / k ) * ( half / k );
+        sum  += term;
+
+        if ( term < sum * 1e-12 )
+            break;
+    }
+    return sum;
+}
+
+// the (not normalized) windowed-sinc kernel at given offset x (in source samples)
+
+static double kernel( double x )
+{
+    if ( fabs( x ) >= SINC_HALF_TAPS )
+        return 0.0;
+
+    double s = SINC_CUTOFF;
+
+    if ( x != 0.0 ) {
+        double px = M_PI * SINC_CUTOFF * x;
+        s = SINC_CUTOFF * sin( px ) / px;
+    }
+    double w = x / SINC_HALF_TAPS;
+
+    return s * besselI0( KAISER_BETA * sqrt( 1.0 - w * w )) / besselI0( KAISER_BETA );
+}
+
+// fixed length dot product written with independent accumulators
+// so the compiler can vectorize it (NEON / SSE) at the -O3 level
+
+static inline SAMPLE_TYPE dotProduct( const SAMPLE_TYPE* a, const SAMPLE_TYPE* b )
+{
+    SAMPLE_TYPE s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+
+    for ( int j = 0; j < Resampler::SINC_TAPS; j += 4 ) {
+        s0 += a[ j ]     * b[ j ];
+        s1 += a[ j + 1 ] * b[ j + 1 ];
+        s2 += a[ j + 2 ] * b[ j + 2 ];
+        s3 += a[ j + 3 ] * b[ j + 3 ];
+    }
+    return ( s0 + s1 ) + ( s2 + s3 );
+}
+
+// interpolates a sample at given position using the polyphase table (for increments <= 1)
+// the contributions of the two nearest table phases are linearly interpolated
+
+static inline SAMPLE_TYPE polyphase( const SAMPLE_TYPE* table, SAMPLE_TYPE* source, int sourceLength, double position )
+{
+    int t          = ( int ) floor( position );
+    double phase   = ( position - t ) * Resampler::SINC_PHASES;
+    int phaseIndex = ( int ) phase;
+    SAMPLE_TYPE phaseFrac = phase - phaseIndex;
+
+    const SAMPLE_TYPE* row1 = table + phaseIndex * Resampler::SINC_TAPS;
+    const SAMPLE_TYPE* row2 = row1 + Resampler::SINC_TAPS;
+
+    int first = t - SINC_HALF_TAPS + 1;
+    const SAMPLE_TYPE* window;
+    SAMPLE_TYPE paddedWindow[ Resampler::SINC_TAPS ];
+
+    if ( first >= 0 && first + Resampler::SINC_TAPS <= sourceLength ) {
+        window = source + first;
+    }
+    else {
+        // kernel exceeds the source boundaries, read with zero padding
+        for ( int j = 0; j < Resampler::SINC_TAPS; ++j ) {
+            int index = first + j;
+            paddedWindow[ j ] = ( index >= 0 && index < sourceLength ) ? source[ index ] : 0.0;
+        }
+        window = paddedWindow;
+    }
+    SAMPLE_TYPE s1 = dotProduct( window, row1 );
+    SAMPLE_TYPE s2 = dotProduct( window, row2 );
+
+    return s1 + ( s2 - s1 ) * phaseFrac;
+}
+
+/* public methods */
+
+double Resampler::mix( int quality, SAMPLE_TYPE* source, int sourceLength, SAMPLE_TYPE* target,
+                       int amount, double readPosition, double increment, SAMPLE_TYPE volume )
+{
+    int i;
+
+    switch ( quality )
+    {
+        default:
+        case LINEAR:
+            for ( i = 0; i < amount; ++i )
+                target[ i ] += linear( source, sourceLength, readPosition + i * increment ) * volume;
+            break;
+
+        case HERMITE:
+            for ( i = 0; i < amount; ++i )
+                target[ i ] += hermite( source, sourceLength, readPosition + i * increment ) * volume;
+            break;
+
+        case SINC:
+            if ( increment <= 1.0 ) {
+                const SAMPLE_TYPE* table = getPolyphaseTable();
+
+                for ( i = 0; i < amount; ++i )
+                    target[ i ] += polyphase( table, source, sourceLength, readPosition + i * increment ) * volume;
+            }
+            else {
+                for ( i = 0; i < amount; ++i )
+                    target[ i ] += sinc( source, sourceLength, readPosition + i * increment, increment ) * volume;
+            }
+            break;
+    }
+    return readPosition + amount * increment;
+}
+
+SAMPLE_TYPE Resampler::sinc( SAMPLE_TYPE* source, int sourceLength, double position, double increment )
+{
+    if ( increment <= 1.0 )
+        return polyphase( getPolyphaseTable(), source, sourceLength, position );
+
+    // reading at increments above 1 lowers the Nyquist frequency relative to the source,
+    // stretch the kernel (lowering its cutoff) by the increment to prevent aliasing
+
+    const SAMPLE_TYPE* wing = getWingTable();
+
+    double scale     = 1.0 / std::min( increment, ( double ) MAX_DECIMATION );
+    double halfWidth = SINC_HALF_TAPS / scale;
+    double step      = scale * SINC_PHASES;
+    int wingSize     = SINC_HALF_TAPS * SINC_PHASES;
+
+    int first = ( int ) ceil ( position - halfWidth );
+    int last  = ( int ) floor( position + halfWidth );
+
+    SAMPLE_TYPE sum     = 0.0;
+    SAMPLE_TYPE weights = 0.0;
+
+    for ( int k = first; k <= last; ++k )
+    {
+        double x  = fabs( k - position ) * step;
+        int index = ( int ) x;
+
+        if ( index >= wingSize )
+            continue;
+
+        SAMPLE_TYPE weight = wing[ index ] + ( wing[ index + 1 ] - wing[ index ]) * ( x - index );
+        weights += weight;
+
+        if ( k >= 0 && k < sourceLength )
+            sum += source[ k ] * weight;
+    }
+    return ( weights > 0.0 ) ? sum / weights : 0.0;
+}
+
+AudioBuffer* Resampler::resampleBuffer( AudioBuffer* buffer, unsigned int inputSampleRate,
+                                       unsigned int outputSampleRate, int quality )
+{
+    double increment = ( double ) inputSampleRate / ( double ) outputSampleRate;
+    int outputLength = ( int ) ceil( buffer->bufferSize / increment );
+
+    AudioBuffer* output = new AudioBuffer( buffer->amountOfChannels, outputLength );
+
+    for ( int c = 0; c < buffer->amountOfChannels; ++c ) {
+        mix( quality, buffer->getBufferForChannel( c ), buffer->bufferSize,
+             output->getBufferForChannel( c ), outputLength, 0.0, increment, 1.0 );
+    }
+    output->loopeable = buffer->loopeable;
+
+    return output;
+}
+
+void Resampler::prepare( int quality )
+{
+    if ( quality == SINC ) {
+        getPolyphaseTable();
+        getWingTable();
+    }
+}
+
+/* private methods */
+
+const SAMPLE_TYPE* Resampler::getPolyphaseTable()
+{
+    // static initialization is thread safe as of C++11
+    static std::vector<SAMPLE_TYPE> table = createPolyphaseTable();
+    return table.data();
+}
+
+const SAMPLE_TYPE* Resampler::getWingTable()
+{
+    static std::vector<SAMPLE_TYPE> table = createWingTable();
+    return table.data();
+}
+
+std::vector<SAMPLE_TYPE> Resampler::createPolyphaseTable()
+{
+    // SINC_PHASES + 1 rows of SINC_TAPS coefficients, the last row
+    // allows interpolating between the phases without wrapping
+
+    std::vector<SAMPLE_TYPE> table(( SINC_PHASES + 1 ) * SINC_TAPS );
+
+    for ( int phase = 0; phase <= SINC_PHASES; ++phase )
+    {
+        double frac = ( double ) phase / SINC_PHASES;
+        double sum  = 0.0;
+        SAMPLE_TYPE* row = &table[ phase * SINC_TAPS ];
+
+        for ( int j = 0; j < SINC_TAPS; ++j ) {
+            row[ j ] = kernel(( j - SINC_HALF_TAPS + 1 ) - frac );
+            sum += row[ j ];
+        }
+
+        // normalize each phase for unity gain at DC
+        for ( int j = 0; j < SINC_TAPS; ++j )
+            row[ j ] /= sum;
+    }
+    return table;
+}
+
+std::vector<SAMPLE_TYPE> Resampler::createWingTable()
+{
+    // a single (right hand) wing of the kernel at SINC_PHASES resolution
+    // including a trailing zero for interpolation at the kernel edge
+
+    int size = SINC_HALF_TAPS * SINC_PHASES;
+    std::vector<SAMPLE_TYPE> table( size + 2, 0.0 );
+
+    for ( int i = 0; i <= size; ++i )
+        table[ i ] = kernel(( double ) i / SINC_PHASES );
+
+    return table;
+}
+
+} // E.O namespace MWEngine
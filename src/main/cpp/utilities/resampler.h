@@ -0,0 +1,158 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__RESAMPLER_H_INCLUDED__
+#define __MWENGINE__RESAMPLER_H_INCLUDED__
+
+#include "global.h"
+#include "audiobuffer.h"
+#include <cmath>
+#include <vector>
+
+namespace MWEngine {
+
+/**
+ * Resampler provides the interpolation kernels used to read audio at
+ * fractional positions, e.g. when playing back a sample at a custom playback rate
+ * or when the sample rate of a sample differs from the engine's sample rate
+ *
+ * LINEAR is the cheapest, HERMITE provides a good quality/performance trade-off while
+ * SINC uses a polyphase Kaiser windowed-sinc kernel that is band limited (and thus
+ * prevents aliasing when reading at increments above 1, e.g. when pitching up)
+ */
+class Resampler
+{
+    public:
+
+        enum Quality {
+            LINEAR,
+            HERMITE,
+            SINC
+        };
+
+        static const int SINC_TAPS       = 32;  // kernel length (in source samples) at increments <= 1
+        static const int SINC_PHASES     = 256; // amount of fractional positions in the polyphase table
+        static const int MAX_DECIMATION  = 4;   // the kernel is stretched up to this increment (beyond, aliasing is accepted)
+
+        /**
+         * Mixes amount of samples read from source (holding sourceLength samples) into target
+         * starting at given (fractional) readPosition, advancing by increment for each written sample
+         * (e.g. 2.0 reads at double speed, 0.5 at half speed). Samples are multiplied by volume.
+         * Positions outside of the source range are treated as silence.
+         * Returns the read position following the last mixed sample.
+         */
+        static double mix( int quality, SAMPLE_TYPE* source, int sourceLength, SAMPLE_TYPE* target,
+                           int amount, double readPosition, double increment, SAMPLE_TYPE volume );
+
+        /**
+         * Returns a single interpolated sample at given (fractional) position within source,
+         * increment describes the rate at which source is read (used by SINC to determine cutoff)
+         */
+        static inline SAMPLE_TYPE interpolate( int quality, SAMPLE_TYPE* source, int sourceLength,
+                                               double position, double increment )
+        {
+            switch ( quality ) {
+                default:
+                case LINEAR:
+                    return linear( source, sourceLength, position );
+                case HERMITE:
+                    return hermite( source, sourceLength, position );
+                case SINC:
+                    return sinc( source, sourceLength, position, increment );
+            }
+        }
+
+        /**
+         * Creates a new AudioBuffer containing the contents of given buffer (recorded
+         * at inputSampleRate) converted to outputSampleRate using given quality.
+         * This is intended for offline use (e.g. converting samples upon loading)
+         */
+        static AudioBuffer* resampleBuffer( AudioBuffer* buffer, unsigned int inputSampleRate,
+                                            unsigned int outputSampleRate, int quality );
+
+        /**
+         * The lookup tables required by the SINC quality are lazily created on first use,
+         * this method can be invoked to create them upfront (e.g. outside of the audio thread)
+         */
+        static void prepare( int quality );
+
+        /* kernels */
+
+        static inline SAMPLE_TYPE linear( SAMPLE_TYPE* source, int sourceLength, double position )
+        {
+            int t = ( int ) position;
+
+            if ( t < 0 || t >= sourceLength )
+                return 0.0;
+
+            SAMPLE_TYPE frac = position - t;
+            SAMPLE_TYPE s1   = source[ t ];
+            SAMPLE_TYPE s2   = ( t + 1 < sourceLength ) ? source[ t + 1 ] : 0.0;
+
+            return s1 + ( s2 - s1 ) * frac;
+        }
+
+        static inline SAMPLE_TYPE hermite( SAMPLE_TYPE* source, int sourceLength, double position )
+        {
+            int t = ( int ) floor( position );
+            SAMPLE_TYPE x = position - t;
+            SAMPLE_TYPE ym1, y0, y1, y2;
+
+            if ( t >= 1 && t + 2 < sourceLength ) {
+                ym1 = source[ t - 1 ];
+                y0  = source[ t ];
+                y1  = source[ t + 1 ];
+                y2  = source[ t + 2 ];
+            }
+            else {
+                ym1 = sampleAt( source, sourceLength, t - 1 );
+                y0  = sampleAt( source, sourceLength, t );
+                y1  = sampleAt( source, sourceLength, t + 1 );
+                y2  = sampleAt( source, sourceLength, t + 2 );
+            }
+
+            // 4-point, 3rd-order Hermite (x-form)
+
+            SAMPLE_TYPE c1 = 0.5 * ( y1 - ym1 );
+            SAMPLE_TYPE c2 = ym1 - 2.5 * y0 + 2.0 * y1 - 0.5 * y2;
+            SAMPLE_TYPE c3 = 0.5 * ( y2 - ym1 ) + 1.5 * ( y0 - y1 );
+
+            return (( c3 * x + c2 ) * x + c1 ) * x + y0;
+        }
+
+        static SAMPLE_TYPE sinc( SAMPLE_TYPE* source, int sourceLength, double position, double increment );
+
+    private:
+
+        static inline SAMPLE_TYPE sampleAt( SAMPLE_TYPE* source, int sourceLength, int index )
+        {
+            return ( index >= 0 && index < sourceLength ) ? source[ index ] : 0.0;
+        }
+
+        static const SAMPLE_TYPE* getPolyphaseTable();
+        static const SAMPLE_TYPE* getWingTable();
+        static std::vector<SAMPLE_TYPE> createPolyphaseTable();
+        static std::vector<SAMPLE_TYPE> createWingTable();
+};
+} // E.O namespace MWEngine
+
+#endif
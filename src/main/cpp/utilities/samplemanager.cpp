@@ -21,36 +21,156 @@
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #include "samplemanager.h"
+#include "wavereader.h"
+#include "resampler.h"
+#include "utils.h"
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
 
 namespace MWEngine {
 namespace SampleManagerSamples
 {
     std::map<std::string, cachedSample> _sampleMap;
+    std::unordered_map<AudioBuffer*, std::map<std::string, cachedSample>::iterator> _bufferIndex;
+    std::unordered_map<AudioBuffer*, int> _orphanedBuffers;
+    unsigned long _memoryBudget = 0;
+    unsigned long _memoryUsage  = 0;
+    unsigned long _accessCount  = 0;
+    std::recursive_mutex _mutex;
+
+    bool _convertSampleRate = false;
+    int _conversionQuality  = Resampler::SINC;
+    std::string _conversionCacheDirectory;
+    std::deque<std::string> _conversionQueue;
+    bool _converting        = false;
+    int _activeConversions  = 0;
+
+    int _preRollDuration    = 100;
+    int _streamCount        = 0;
+    bool _streaming         = false;
 }
 
+// header of files in the sample rate conversion cache
+
+static const int CONVERSION_CACHE_ID = 0x4D575352; // "MWSR"
+
+typedef struct
+{
+    int id;
+    int sampleSize;
+    int amountOfChannels;
+    int bufferSize;
+    unsigned int sampleRate;
+} conversionCacheHeader;
+
 /* public methods */
 
 void SampleManager::setSample( std::string aIdentifier, AudioBuffer* aBuffer, unsigned int sampleRate )
 {
-    cachedSample sample = { aBuffer->bufferSize, sampleRate, aBuffer };
+    setSample( aIdentifier, aBuffer, sampleRate, "" );
+}
+
+void SampleManager::setSample( std::string aIdentifier, AudioBuffer* aBuffer, unsigned int sampleRate, std::string sourcePath )
+{
+    std::lock_guard<std::recursive_mutex> guard( SampleManagerSamples::_mutex );
+
+    cachedSample sample = {
+        aBuffer->bufferSize, sampleRate, aBuffer, sourcePath, 0, ++SampleManagerSamples::_accessCount, nullptr
+    };
 
     // Assignment using member function insert() and STL pair
+    std::pair<std::map<std::string, cachedSample>::iterator, bool> result =
+        SampleManagerSamples::_sampleMap.insert( std::pair<std::string, cachedSample>( aIdentifier, sample ));
+
+    if ( result.second )
+    {
+        SampleManagerSamples::_bufferIndex[ aBuffer ] = result.first;
+        SampleManagerSamples::_memoryUsage += getBufferSizeInBytes( aBuffer );
+        enforceBudget();
+
+        if ( SampleManagerSamples::_convertSampleRate && sampleRate != ( unsigned int ) AudioEngineProps::SAMPLE_RATE )
+            queueConversion( aIdentifier );
+    }
+}
+
+void SampleManager::setStreamedSample( std::string aIdentifier, AudioBuffer* aBuffer, unsigned int sampleRate, std::string sourcePath )
+{
+    std::lock_guard<std::recursive_mutex> guard( SampleManagerSamples::_mutex );
+
+    if ( hasSample( aIdentifier ))
+        return;
+
+    // copy the pre-roll from the start of the sample
+
+    int preRollLength    = std::min( aBuffer->bufferSize, std::max( 1,
+                               ( int ) (( long ) SampleManagerSamples::_preRollDuration * sampleRate / 1000 )));
+    AudioBuffer* preRoll = new AudioBuffer( aBuffer->amountOfChannels, preRollLength );
+    preRoll->mergeBuffers( aBuffer, 0, 0, 1.0 );
+
+    SampleStream* stream = new SampleStream( sourcePath, preRoll, aBuffer->bufferSize, sampleRate );
+    stream->setBody( aBuffer );
+
+    cachedSample sample = {
+        aBuffer->bufferSize, sampleRate, nullptr, sourcePath, 0, ++SampleManagerSamples::_accessCount, stream
+    };
     SampleManagerSamples::_sampleMap.insert( std::pair<std::string, cachedSample>( aIdentifier, sample ));
+    SampleManagerSamples::_memoryUsage += getStreamSizeInBytes( stream );
+    ++SampleManagerSamples::_streamCount;
+
+    enforceBudget();
+
+    // start the loader thread, it runs for as long as streamed samples are registered
+
+    if ( !SampleManagerSamples::_streaming ) {
+        SampleManagerSamples::_streaming = true;
+        std::thread( &SampleManager::processStreamRequests ).detach();
+    }
 }
 
-AudioBuffer* SampleManager::getSample( std::string aIdentifier )
+SampleStream* SampleManager::getStream( std::string aIdentifier )
 {
-    if ( !hasSample( aIdentifier ))
-        return nullptr;
+    std::lock_guard<std::recursive_mutex> guard( SampleManagerSamples::_mutex );
 
     std::map<std::string, cachedSample>::iterator it = SampleManagerSamples::_sampleMap.find( aIdentifier );
 
-    // key stored in first, value stored in second
-    return it->second.sampleBuffer;
+    if ( it == SampleManagerSamples::_sampleMap.end() || it->second.stream == nullptr )
+        return nullptr;
+
+    it->second.lastAccess = ++SampleManagerSamples::_accessCount;
+    it->second.stream->retain();
+
+    return it->second.stream;
+}
+
+void SampleManager::setPreRollDuration( int milliseconds )
+{
+    SampleManagerSamples::_preRollDuration = milliseconds;
+}
+
+int SampleManager::getPreRollDuration()
+{
+    return SampleManagerSamples::_preRollDuration;
+}
+
+AudioBuffer* SampleManager::getSample( std::string aIdentifier )
+{
+    return loadSample( aIdentifier, false );
+}
+
+AudioBuffer* SampleManager::retainSample( std::string aIdentifier )
+{
+    return loadSample( aIdentifier, true );
 }
 
 int SampleManager::getSampleLength( std::string aIdentifier )
 {
+    std::lock_guard<std::recursive_mutex> guard( SampleManagerSamples::_mutex );
+
     if ( !hasSample( aIdentifier ))
         return 0;
 
@@ -62,6 +182,8 @@ int SampleManager::getSampleLength( std::string aIdentifier )
 
 int SampleManager::getSampleRateForSample( std::string aIdentifier )
 {
+    std::lock_guard<std::recursive_mutex> guard( SampleManagerSamples::_mutex );
+
     if ( !hasSample( aIdentifier ))
         return AudioEngineProps::SAMPLE_RATE;
 
@@ -73,35 +195,654 @@ int SampleManager::getSampleRateForSample( std::string aIdentifier )
 
 bool SampleManager::hasSample( std::string aIdentifier )
 {
+    std::lock_guard<std::recursive_mutex> guard( SampleManagerSamples::_mutex );
+
     std::map<std::string, cachedSample>::iterator it = SampleManagerSamples::_sampleMap.find( aIdentifier );
     return ( it != SampleManagerSamples::_sampleMap.end());
 }
 
+bool SampleManager::isSampleLoaded( std::string aIdentifier )
+{
+    std::lock_guard<std::recursive_mutex> guard( SampleManagerSamples::_mutex );
+
+    std::map<std::string, cachedSample>::iterator it = SampleManagerSamples::_sampleMap.find( aIdentifier );
+
+    if ( it == SampleManagerSamples::_sampleMap.end())
+        return false;
+
+    if ( it->second.stream != nullptr )
+        return it->second.stream->isResident();
+
+    return it->second.sampleBuffer != nullptr;
+}
+
 void SampleManager::removeSample( std::string aIdentifier, bool free )
 {
+    std::lock_guard<std::recursive_mutex> guard( SampleManagerSamples::_mutex );
+
     if ( hasSample( aIdentifier ))
     {
         std::map<std::string, cachedSample>::iterator it = SampleManagerSamples::_sampleMap.find( aIdentifier );
+        cachedSample& sample = it->second;
 
-        if ( free )
-            delete it->second.sampleBuffer;
+        // streamed samples own their buffers, the stream is deleted once the
+        // last SampleEvent referencing it has released it
 
-        SampleManagerSamples::_sampleMap.erase( SampleManagerSamples::_sampleMap.find( aIdentifier ));
+        if ( sample.stream != nullptr )
+        {
+            SampleManagerSamples::_memoryUsage -= getStreamSizeInBytes( sample.stream );
+            --SampleManagerSamples::_streamCount;
+            sample.stream->release();
+
+            // wake the loader thread so it stops once the last stream has been removed
+            SampleStream::getFetchSignal()->signal();
+        }
+        else if ( sample.sampleBuffer != nullptr )
+        {
+            SampleManagerSamples::_bufferIndex.erase( sample.sampleBuffer );
+            SampleManagerSamples::_memoryUsage -= getBufferSizeInBytes( sample.sampleBuffer );
+
+            if ( free )
+            {
+                // buffer is still being played back by SampleEvents, defer its deletion
+                // until the last of these events releases it
+
+                if ( sample.references > 0 )
+                    SampleManagerSamples::_orphanedBuffers[ sample.sampleBuffer ] = sample.references;
+                else
+                    delete sample.sampleBuffer;
+            }
+        }
+        SampleManagerSamples::_sampleMap.erase( it );
     }
 }
 
 void SampleManager::flushSamples()
 {
-    // invoke destructors on all AudioBuffers
+    std::lock_guard<std::recursive_mutex> guard( SampleManagerSamples::_mutex );
+
+    // invoke destructors on all AudioBuffers (deferring deletion of those still in use)
 
     std::map<std::string, cachedSample>::iterator it;
 
     for ( it  = SampleManagerSamples::_sampleMap.begin();
           it != SampleManagerSamples::_sampleMap.end(); ++it )
     {
-        delete it->second.sampleBuffer;
+        if ( it->second.stream != nullptr )
+            it->second.stream->release();
+        else if ( it->second.references > 0 && it->second.sampleBuffer != nullptr )
+            SampleManagerSamples::_orphanedBuffers[ it->second.sampleBuffer ] = it->second.references;
+        else
+            delete it->second.sampleBuffer;
     }
     SampleManagerSamples::_sampleMap.clear();
+    SampleManagerSamples::_bufferIndex.clear();
+    SampleManagerSamples::_memoryUsage = 0;
+    SampleManagerSamples::_streamCount = 0;
+
+    SampleStream::getFetchSignal()->signal(); // stops the loader thread
+}
+
+void SampleManager::retainBuffer( AudioBuffer* aBuffer )
+{
+    if ( aBuffer == nullptr )
+        return;
+
+    std::lock_guard<std::recursive_mutex> guard( SampleManagerSamples::_mutex );
+
+    auto indexed = SampleManagerSamples::_bufferIndex.find( aBuffer );
+
+    if ( indexed == SampleManagerSamples::_bufferIndex.end())
+        return;
+
+    cachedSample& sample = indexed->second->second;
+
+    ++sample.references;
+    sample.lastAccess = ++SampleManagerSamples::_accessCount;
+}
+
+void SampleManager::releaseBuffer( AudioBuffer* aBuffer )
+{
+    if ( aBuffer == nullptr )
+        return;
+
+    std::lock_guard<std::recursive_mutex> guard( SampleManagerSamples::_mutex );
+
+    // buffer was removed from the SampleManager while in use, delete it upon its last release
+
+    auto orphan = SampleManagerSamples::_orphanedBuffers.find( aBuffer );
+
+    if ( orphan != SampleManagerSamples::_orphanedBuffers.end())
+    {
+        if ( --orphan->second <= 0 )
+        {
+            delete orphan->first;
+            SampleManagerSamples::_orphanedBuffers.erase( orphan );
+        }
+        return;
+    }
+
+    auto indexed = SampleManagerSamples::_bufferIndex.find( aBuffer );
+
+    if ( indexed == SampleManagerSamples::_bufferIndex.end())
+        return;
+
+    cachedSample& sample = indexed->second->second;
+
+    if ( sample.references > 0 && --sample.references == 0 )
+        enforceBudget(); // sample has become eligible for eviction
+}
+
+int SampleManager::getReferenceCount( std::string aIdentifier )
+{
+    std::lock_guard<std::recursive_mutex> guard( SampleManagerSamples::_mutex );
+
+    std::map<std::string, cachedSample>::iterator it = SampleManagerSamples::_sampleMap.find( aIdentifier );
+
+    if ( it == SampleManagerSamples::_sampleMap.end())
+        return 0;
+
+    return it->second.references;
+}
+
+void SampleManager::setMemoryBudget( unsigned long bytes )
+{
+    std::lock_guard<std::recursive_mutex> guard( SampleManagerSamples::_mutex );
+
+    SampleManagerSamples::_memoryBudget = bytes;
+    enforceBudget();
+}
+
+unsigned long SampleManager::getMemoryBudget()
+{
+    std::lock_guard<std::recursive_mutex> guard( SampleManagerSamples::_mutex );
+
+    return SampleManagerSamples::_memoryBudget;
+}
+
+unsigned long SampleManager::getMemoryUsage()
+{
+    std::lock_guard<std::recursive_mutex> guard( SampleManagerSamples::_mutex );
+
+    return SampleManagerSamples::_memoryUsage;
+}
+
+void SampleManager::setSampleRateConversion( bool enabled, int quality )
+{
+    std::lock_guard<std::recursive_mutex> guard( SampleManagerSamples::_mutex );
+
+    SampleManagerSamples::_convertSampleRate = enabled;
+    SampleManagerSamples::_conversionQuality = quality;
+
+    if ( !enabled )
+        return;
+
+    // convert all currently registered samples that don't match the engine sample rate
+
+    std::map<std::string, cachedSample>::iterator it;
+
+    for ( it  = SampleManagerSamples::_sampleMap.begin();
+          it != SampleManagerSamples::_sampleMap.end(); ++it )
+    {
+        if ( it->second.sampleBuffer != nullptr && it->second.sampleRate != ( unsigned int ) AudioEngineProps::SAMPLE_RATE )
+            queueConversion( it->first );
+    }
+}
+
+bool SampleManager::getSampleRateConversion()
+{
+    return SampleManagerSamples::_convertSampleRate;
+}
+
+void SampleManager::setConversionCacheDirectory( std::string directory )
+{
+    std::lock_guard<std::recursive_mutex> guard( SampleManagerSamples::_mutex );
+
+    SampleManagerSamples::_conversionCacheDirectory = directory;
+}
+
+bool SampleManager::convertSample( std::string aIdentifier )
+{
+    AudioBuffer* source;
+    unsigned int sampleRate;
+    unsigned int engineRate = ( unsigned int ) AudioEngineProps::SAMPLE_RATE;
+    std::string cachePath;
+    int quality;
+
+    {
+        std::lock_guard<std::recursive_mutex> guard( SampleManagerSamples::_mutex );
+
+        std::map<std::string, cachedSample>::iterator it = SampleManagerSamples::_sampleMap.find( aIdentifier );
+
+        if ( it == SampleManagerSamples::_sampleMap.end() || it->second.sampleBuffer == nullptr ||
+             it->second.sampleRate == engineRate )
+            return false;
+
+        source     = it->second.sampleBuffer;
+        sampleRate = it->second.sampleRate;
+        cachePath  = getConversionCachePath( it->second.sourcePath, engineRate );
+        quality    = SampleManagerSamples::_conversionQuality;
+
+        // retain the source so it isn't freed while converting outside of the lock
+        retainBuffer( source );
+        ++SampleManagerSamples::_activeConversions;
+    }
+
+    AudioBuffer* converted = readConversionCache( cachePath );
+
+    if ( converted == nullptr ) {
+        converted = Resampler::resampleBuffer( source, sampleRate, engineRate, quality );
+        writeConversionCache( cachePath, converted );
+    }
+
+    std::lock_guard<std::recursive_mutex> guard( SampleManagerSamples::_mutex );
+
+    std::map<std::string, cachedSample>::iterator it = SampleManagerSamples::_sampleMap.find( aIdentifier );
+    bool swapped = ( it != SampleManagerSamples::_sampleMap.end() && it->second.sampleBuffer == source );
+
+    if ( swapped )
+    {
+        cachedSample& sample = it->second;
+
+        // SampleEvents referencing the original buffer keep doing so until they release it
+        // (which includes the retain made above, the original is deleted upon its last release)
+
+        SampleManagerSamples::_orphanedBuffers[ source ] = sample.references;
+        SampleManagerSamples::_bufferIndex.erase( source );
+        SampleManagerSamples::_bufferIndex[ converted ] = it;
+        SampleManagerSamples::_memoryUsage -= getBufferSizeInBytes( source );
+        SampleManagerSamples::_memoryUsage += getBufferSizeInBytes( converted );
+
+        sample.sampleBuffer = converted;
+        sample.sampleLength = converted->bufferSize;
+        sample.sampleRate   = engineRate;
+        sample.references   = 0;
+    }
+    else {
+        // sample was removed or replaced during conversion
+        delete converted;
+    }
+    releaseBuffer( source );
+    --SampleManagerSamples::_activeConversions;
+
+    if ( swapped )
+        enforceBudget();
+
+    return swapped;
+}
+
+int SampleManager::getPendingConversions()
+{
+    std::lock_guard<std::recursive_mutex> guard( SampleManagerSamples::_mutex );
+
+    return ( int ) SampleManagerSamples::_conversionQueue.size() + SampleManagerSamples::_activeConversions;
+}
+
+/* protected methods */
+
+unsigned long SampleManager::getBufferSizeInBytes( AudioBuffer* aBuffer )
+{
+    if ( aBuffer == nullptr )
+        return 0;
+
+    return ( unsigned long ) aBuffer->amountOfChannels * aBuffer->bufferSize * sizeof( SAMPLE_TYPE );
+}
+
+/**
+ * retrieves the buffer of given sample, reloading it when it has been evicted. The source file is read
+ * outside of the lock (as is the body of a streamed sample), after which the sample is looked up again
+ * as it could have been removed, replaced or reloaded in the meantime. The returned sample is never
+ * evicted by the budget enforcement of this call, when retain is true its reference count is increased
+ */
+AudioBuffer* SampleManager::loadSample( std::string aIdentifier, bool retain )
+{
+    std::unique_lock<std::recursive_mutex> guard( SampleManagerSamples::_mutex );
+
+    std::map<std::string, cachedSample>::iterator it = SampleManagerSamples::_sampleMap.find( aIdentifier );
+
+    if ( it == SampleManagerSamples::_sampleMap.end())
+        return nullptr;
+
+    // key stored in first, value stored in second
+    it->second.lastAccess = ++SampleManagerSamples::_accessCount;
+
+    // streamed sample, ensure its contents are resident (these are retained through getStream())
+
+    SampleStream* stream = it->second.stream;
+
+    if ( stream != nullptr )
+    {
+        if ( retain )
+            return nullptr;
+
+        if ( !stream->isResident())
+        {
+            // retain the stream so it isn't deleted when removed while fetching outside of the lock
+
+            stream->retain();
+            guard.unlock();
+
+            unsigned long size = stream->fetch();
+
+            guard.lock();
+            it = SampleManagerSamples::_sampleMap.find( aIdentifier );
+            stream->release();
+
+            if ( it == SampleManagerSamples::_sampleMap.end() || it->second.stream != stream )
+                return nullptr;
+
+            if ( size > 0 ) {
+                SampleManagerSamples::_memoryUsage += size;
+                enforceBudget( &it->second );
+            }
+        }
+        AudioBuffer* body = stream->beginRead();
+        stream->endRead();
+
+        return body;
+    }
+
+    // sample has been evicted from memory, reload it from its source file
+
+    if ( it->second.sampleBuffer == nullptr && !it->second.sourcePath.empty())
+    {
+        std::string sourcePath  = it->second.sourcePath;
+        unsigned int engineRate = ( unsigned int ) AudioEngineProps::SAMPLE_RATE;
+        std::string cachePath   = SampleManagerSamples::_convertSampleRate ? getConversionCachePath( sourcePath, engineRate ) : "";
+        waveFile WAV            = { engineRate, nullptr };
+
+        guard.unlock();
+
+        // when converting sample rates, try the conversion cache first
+
+        if ( !cachePath.empty())
+            WAV.buffer = readConversionCache( cachePath );
+
+        if ( WAV.buffer == nullptr )
+            WAV = WaveReader::fileToBuffer( sourcePath );
+
+        guard.lock();
+        it = SampleManagerSamples::_sampleMap.find( aIdentifier );
+
+        // sample was removed or replaced while reading
+
+        if ( it == SampleManagerSamples::_sampleMap.end() || it->second.stream != nullptr || it->second.sourcePath != sourcePath ) {
+            delete WAV.buffer;
+            return nullptr;
+        }
+        cachedSample& sample = it->second;
+
+        if ( sample.sampleBuffer != nullptr ) {
+            delete WAV.buffer; // reloaded by another thread in the meantime
+        }
+        else if ( WAV.buffer != nullptr )
+        {
+            sample.sampleBuffer = WAV.buffer;
+            sample.sampleLength = WAV.buffer->bufferSize;
+            sample.sampleRate   = WAV.sampleRate;
+
+            SampleManagerSamples::_bufferIndex[ WAV.buffer ] = it;
+            SampleManagerSamples::_memoryUsage += getBufferSizeInBytes( WAV.buffer );
+            enforceBudget( &sample );
+
+            if ( SampleManagerSamples::_convertSampleRate && WAV.sampleRate != engineRate )
+                queueConversion( aIdentifier );
+        }
+    }
+
+    cachedSample& sample = it->second;
+
+    if ( retain && sample.sampleBuffer != nullptr )
+        ++sample.references;
+
+    return sample.sampleBuffer;
+}
+
+void SampleManager::enforceBudget()
+{
+    enforceBudget( nullptr );
+}
+
+void SampleManager::enforceBudget( cachedSample* keep )
+{
+    if ( SampleManagerSamples::_memoryBudget == 0 )
+        return;
+
+    // evict the least recently used samples until memory usage is within budget
+    // only unreferenced samples that can be reloaded from their source file are eligible
+    // for streamed samples, the contents are evicted when not being read (the pre-roll remains)
+
+    while ( SampleManagerSamples::_memoryUsage > SampleManagerSamples::_memoryBudget )
+    {
+        cachedSample* candidate = nullptr;
+        std::map<std::string, cachedSample>::iterator it;
+
+        for ( it  = SampleManagerSamples::_sampleMap.begin();
+              it != SampleManagerSamples::_sampleMap.end(); ++it )
+        {
+            cachedSample& sample = it->second;
+
+            if ( &sample == keep )
+                continue;
+
+            // streams being played back are pinned (as a voice only reads the body during
+            // each render cycle, isReading() alone does not suffice to tell whether it's in use)
+
+            if ( sample.stream != nullptr ) {
+                if ( !sample.stream->isResident() || sample.stream->isReading() || sample.stream->isInUse())
+                    continue;
+            }
+            else if ( sample.sampleBuffer == nullptr || sample.references > 0 || sample.sourcePath.empty())
+                continue;
+
+            if ( candidate == nullptr || sample.lastAccess < candidate->lastAccess )
+                candidate = &sample;
+        }
+
+        if ( candidate == nullptr )
+            return; // nothing left to evict
+
+        if ( candidate->stream != nullptr ) {
+            SampleManagerSamples::_memoryUsage -= candidate->stream->evict();
+        }
+        else {
+            SampleManagerSamples::_memoryUsage -= getBufferSizeInBytes( candidate->sampleBuffer );
+            SampleManagerSamples::_bufferIndex.erase( candidate->sampleBuffer );
+
+            delete candidate->sampleBuffer;
+            candidate->sampleBuffer = nullptr;
+        }
+    }
+}
+
+void SampleManager::queueConversion( std::string aIdentifier )
+{
+    SampleManagerSamples::_conversionQueue.push_back( aIdentifier );
+
+    // the background thread runs until the queue has been processed
+
+    if ( !SampleManagerSamples::_converting ) {
+        SampleManagerSamples::_converting = true;
+        std::thread( &SampleManager::processConversionQueue ).detach();
+    }
+}
+
+void SampleManager::processConversionQueue()
+{
+    while ( true )
+    {
+        std::string identifier;
+        {
+            std::lock_guard<std::recursive_mutex> guard( SampleManagerSamples::_mutex );
+
+            if ( SampleManagerSamples::_conversionQueue.empty()) {
+                SampleManagerSamples::_converting = false;
+                return;
+            }
+            identifier = SampleManagerSamples::_conversionQueue.front();
+            SampleManagerSamples::_conversionQueue.pop_front();
+        }
+        convertSample( identifier );
+    }
+}
+
+std::string SampleManager::getConversionCachePath( std::string sourcePath, unsigned int sampleRate )
+{
+    if ( sourcePath.empty() || SampleManagerSamples::_conversionCacheDirectory.empty())
+        return "";
+
+    // the source file's size and modification time are part of the key
+    // so the cache is invalidated when the source file changes
+
+    struct stat fileInfo;
+
+    if ( stat( sourcePath.c_str(), &fileInfo ) != 0 )
+        return "";
+
+    std::string key = sourcePath + "_" + SSTR( fileInfo.st_size ) + "_" + SSTR( fileInfo.st_mtime ) +
+                      "_" + SSTR( SampleManagerSamples::_conversionQuality );
+
+    return SampleManagerSamples::_conversionCacheDirectory + "/" +
+           SSTR( std::hash<std::string>()( key )) + "_" + SSTR( sampleRate ) + ".mwsr";
+}
+
+AudioBuffer* SampleManager::readConversionCache( std::string cachePath )
+{
+    if ( cachePath.empty())
+        return nullptr;
+
+    std::ifstream file( cachePath.c_str(), std::ios::in | std::ios::binary );
+
+    if ( !file.is_open())
+        return nullptr;
+
+    conversionCacheHeader header;
+    file.read(( char* ) &header, sizeof( conversionCacheHeader ));
+
+    if ( !file || header.id != CONVERSION_CACHE_ID || header.sampleSize != sizeof( SAMPLE_TYPE ) ||
+         header.amountOfChannels <= 0 || header.bufferSize <= 0 )
+        return nullptr;
+
+    AudioBuffer* buffer = new AudioBuffer( header.amountOfChannels, header.bufferSize );
+
+    for ( int c = 0; c < header.amountOfChannels; ++c )
+        file.read(( char* ) buffer->getBufferForChannel( c ), header.bufferSize * sizeof( SAMPLE_TYPE ));
+
+    // truncated file
+
+    if ( !file ) {
+        delete buffer;
+        return nullptr;
+    }
+    return buffer;
+}
+
+void SampleManager::writeConversionCache( std::string cachePath, AudioBuffer* aBuffer )
+{
+    if ( cachePath.empty())
+        return;
+
+    // write to a temporary file first so an interrupted write can't result in a corrupt cache entry
+
+    std::string tempPath = cachePath + ".tmp";
+    std::ofstream file( tempPath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+
+    if ( !file.is_open())
+        return;
+
+    conversionCacheHeader header = {
+        CONVERSION_CACHE_ID, sizeof( SAMPLE_TYPE ), aBuffer->amountOfChannels,
+        aBuffer->bufferSize, ( unsigned int ) AudioEngineProps::SAMPLE_RATE
+    };
+    file.write(( char* ) &header, sizeof( conversionCacheHeader ));
+
+    for ( int c = 0; c < aBuffer->amountOfChannels; ++c )
+        file.write(( char* ) aBuffer->getBufferForChannel( c ), aBuffer->bufferSize * sizeof( SAMPLE_TYPE ));
+
+    file.close();
+
+    if ( file )
+        rename( tempPath.c_str(), cachePath.c_str());
+    else
+        remove( tempPath.c_str());
+}
+
+unsigned long SampleManager::getStreamSizeInBytes( SampleStream* aStream )
+{
+    unsigned long size = getBufferSizeInBytes( aStream->getPreRoll());
+
+    if ( aStream->isResident())
+        size += ( unsigned long ) aStream->getPreRoll()->amountOfChannels * aStream->getSampleLength() * sizeof( SAMPLE_TYPE );
+
+    return size;
+}
+
+void SampleManager::processStreamRequests()
+{
+    std::vector<SampleStream*> requests;
+
+    while ( true )
+    {
+        {
+            std::lock_guard<std::recursive_mutex> guard( SampleManagerSamples::_mutex );
+
+            if ( SampleManagerSamples::_streamCount <= 0 ) {
+                SampleManagerSamples::_streaming = false;
+                return;
+            }
+
+            // collect the streams whose contents have been requested by the rendering thread
+            // (retaining them so they can be fetched outside of the lock)
+
+            std::map<std::string, cachedSample>::iterator it;
+
+            for ( it  = SampleManagerSamples::_sampleMap.begin();
+                  it != SampleManagerSamples::_sampleMap.end(); ++it )
+            {
+                SampleStream* stream = it->second.stream;
+
+                if ( stream != nullptr && stream->isFetchRequested()) {
+                    it->second.lastAccess = ++SampleManagerSamples::_accessCount;
+                    stream->retain();
+                    requests.push_back( stream );
+                }
+            }
+        }
+
+        for ( size_t i = 0; i < requests.size(); ++i )
+        {
+            SampleStream* stream = requests[ i ];
+            unsigned long size   = stream->fetch();
+
+            if ( size > 0 )
+            {
+                std::lock_guard<std::recursive_mutex> guard( SampleManagerSamples::_mutex );
+
+                // only account for streams that are still registered
+                // (removed streams are deleted upon the release below)
+
+                std::map<std::string, cachedSample>::iterator it;
+
+                for ( it  = SampleManagerSamples::_sampleMap.begin();
+                      it != SampleManagerSamples::_sampleMap.end(); ++it )
+                {
+                    if ( it->second.stream == stream ) {
+                        SampleManagerSamples::_memoryUsage += size;
+                        enforceBudget();
+                        break;
+                    }
+                }
+            }
+            stream->release();
+        }
+
+        // await the next fetch request (made by the rendering thread without locking)
+
+        if ( requests.empty())
+            SampleStream::getFetchSignal()->wait();
+
+        requests.clear();
+    }
 }
 
 } // E.O namespace MWEngine
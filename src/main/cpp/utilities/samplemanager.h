@@ -24,8 +24,12 @@
 #define __MWENGINE__SAMPLEMANAGER_H_INCLUDED__
 
 #include "audiobuffer.h"
+#include "samplestream.h"
 #include <string>
 #include <map>
+#include <unordered_map>
+#include <deque>
+#include <mutex>
 #include <utility>
 
 namespace MWEngine {
@@ -34,7 +38,11 @@ typedef struct
 {
    int sampleLength;
    unsigned int sampleRate;
-   AudioBuffer* sampleBuffer;
+   AudioBuffer* sampleBuffer; // can be nullptr when the sample has been evicted from memory
+   std::string sourcePath;    // path of the WAV file the sample was read from (empty when unknown)
+   int references;            // the amount of SampleEvents currently playing back sampleBuffer
+   unsigned long lastAccess;  // used to determine the least recently used sample for eviction
+   SampleStream* stream;      // when streamed, holds the resident pre-roll and the (evictable) sample contents
 } cachedSample;
 
 /**
@@ -42,6 +50,24 @@ typedef struct
  * used to pool samples (AudioBuffers) that are to be used repeatedly or simultaneously, etc...
  * SampleManager will also manage the memory, when samples can be removed you can do
  * so via SampleManager which will in turn release the memory allocated by the AudioBuffers
+ *
+ * AudioBuffers are shared between all SampleEvents referencing the same sample. These
+ * events retain/release the buffer so the SampleManager knows which samples are in use.
+ * When a memory budget is set, the least recently used samples that are not referenced
+ * and that can be reloaded from their source file are evicted from memory once the budget
+ * is exceeded. Evicted samples are transparently reloaded when requested through getSample()
+ * or retainSample() (reading the source file outside of the SampleManagers lock)
+ *
+ * Optionally, samples registered at a sample rate that differs from the engine's
+ * can be converted to the engine sample rate on a background thread, allowing them to be
+ * played back without resampling. The converted buffer replaces the original (SampleEvents
+ * created prior to conversion keep referencing the original buffer until they release it)
+ *
+ * Samples can also be registered as streamed: only a short pre-roll (the first milliseconds)
+ * of the sample is guaranteed to remain in memory (allowing instant playback), while the
+ * remainder is evicted when exceeding the memory budget (unless it is being played back) and
+ * fetched on demand by a loader thread once a SampleEvent (see SampleEvent::setSample( std::string ))
+ * is about to play
  */
 class SampleManager
 {
@@ -50,10 +76,35 @@ class SampleManager
         // store given AudioBuffer under given identifier name in this SampleManager
         static void setSample( std::string aIdentifier, AudioBuffer* aBuffer, unsigned int sampleRate );
 
+        // store given AudioBuffer under given identifier name, providing the path of the
+        // WAV file it was read from allows the sample to be evicted and reloaded on demand
+        static void setSample( std::string aIdentifier, AudioBuffer* aBuffer, unsigned int sampleRate, std::string sourcePath );
+
+        // store given AudioBuffer (read from the WAV file at sourcePath) under given identifier
+        // as a streamed sample. Only the pre-roll is guaranteed to remain resident in memory,
+        // the SampleManager takes ownership of aBuffer
+        static void setStreamedSample( std::string aIdentifier, AudioBuffer* aBuffer, unsigned int sampleRate, std::string sourcePath );
+
         // retrieve AudioBuffer registered under given identifier from this SampleManager
-        // returns 0 if no associated AudioBuffer is found
+        // returns 0 if no associated AudioBuffer is found (or if an evicted sample could not be reloaded)
+        // NOTE : for streamed samples this returns the full contents (which can be evicted when unused),
+        // use getStream() instead
         static AudioBuffer* getSample( std::string aIdentifier );
 
+        // retrieve the AudioBuffer registered under given identifier, retained so it cannot be evicted
+        // or freed until the caller releases it through releaseBuffer(). Use this over getSample()
+        // when the buffer is used beyond the call (e.g. when assigned to a SampleEvent).
+        // Returns nullptr when no AudioBuffer is available (and for streamed samples, see getStream())
+        static AudioBuffer* retainSample( std::string aIdentifier );
+
+        // retrieve the SampleStream for the streamed sample registered under given identifier (or
+        // nullptr if the sample isn't streamed). The stream is retained and must be released by the caller
+        static SampleStream* getStream( std::string aIdentifier );
+
+        // the duration (in milliseconds) of the resident pre-roll of streamed samples
+        static void setPreRollDuration( int milliseconds );
+        static int getPreRollDuration();
+
         // retrieve the length (in samples) of the AudioBuffer registered under given
         // identifier, returns 0 if no associated AudioBuffer is found
         static int getSampleLength( std::string aIdentifier );
@@ -63,16 +114,85 @@ class SampleManager
         static int getSampleRateForSample( std::string aIdentifier );
 
         // queries whether the SampleManager has an AudioBuffer registered under given identifier
+        // note an evicted sample is still registered (see isSampleLoaded())
         static bool hasSample( std::string aIdentifier );
 
+        // queries whether the AudioBuffer registered under given identifier currently resides in memory
+        static bool isSampleLoaded( std::string aIdentifier );
+
         // remove the sample from the SampleManager, if free is true, the sample will also be deleted
+        // (when the sample is still referenced by SampleEvents, deletion is deferred until its last release)
         static void removeSample( std::string aIdentifier, bool free );
         static void flushSamples();
+
+        // reference counting of shared sample buffers, invoked by the SampleEvents
+        // using the buffer. Buffers that aren't managed by the SampleManager are ignored
+
+        static void retainBuffer( AudioBuffer* aBuffer );
+        static void releaseBuffer( AudioBuffer* aBuffer );
+        static int getReferenceCount( std::string aIdentifier );
+
+        // the memory budget (in bytes) for all samples held in memory, 0 equals no limit
+
+        static void setMemoryBudget( unsigned long bytes );
+        static unsigned long getMemoryBudget();
+        static unsigned long getMemoryUsage();
+
+        // sample rate conversion at load time, when enabled, samples are converted to the engine
+        // sample rate using given quality (see Resampler::Quality). When a cache directory is
+        // set, converted samples are stored on disk (per engine sample rate) to be reused
+        // on subsequent loads of the same source file
+
+        static void setSampleRateConversion( bool enabled, int quality );
+        static bool getSampleRateConversion();
+        static void setConversionCacheDirectory( std::string directory );
+
+        // converts the sample registered under given identifier to the engine sample rate
+        // synchronously (blocking the calling thread), returns true when the sample was converted
+        static bool convertSample( std::string aIdentifier );
+
+        // the amount of samples queued for conversion on the background thread
+        static int getPendingConversions();
+
+    protected:
+
+        static unsigned long getBufferSizeInBytes( AudioBuffer* aBuffer );
+        static AudioBuffer* loadSample( std::string aIdentifier, bool retain );
+        static void enforceBudget();
+        static void enforceBudget( cachedSample* keep ); // evicts all but given sample
+
+        static void queueConversion( std::string aIdentifier );
+        static void processConversionQueue();
+        static std::string getConversionCachePath( std::string sourcePath, unsigned int sampleRate );
+        static AudioBuffer* readConversionCache( std::string cachePath );
+        static void writeConversionCache( std::string cachePath, AudioBuffer* aBuffer );
+
+        static unsigned long getStreamSizeInBytes( SampleStream* aStream );
+        static void processStreamRequests();
 };
 
 namespace SampleManagerSamples
 {
     extern std::map<std::string, cachedSample> _sampleMap;
+    extern std::unordered_map<AudioBuffer*, std::map<std::string, cachedSample>::iterator> _bufferIndex; // resident buffers to their sample
+    extern std::unordered_map<AudioBuffer*, int> _orphanedBuffers; // removed samples awaiting their last release
+    extern unsigned long _memoryBudget;
+    extern unsigned long _memoryUsage;
+    extern unsigned long _accessCount;
+    extern std::recursive_mutex _mutex;
+
+    // sample rate conversion
+    extern bool _convertSampleRate;
+    extern int _conversionQuality;
+    extern std::string _conversionCacheDirectory;
+    extern std::deque<std::string> _conversionQueue;
+    extern bool _converting;       // whether the background conversion thread is running
+    extern int _activeConversions; // the amount of conversions currently in progress
+
+    // streamed samples
+    extern int _preRollDuration;
+    extern int _streamCount;
+    extern bool _streaming; // whether the stream loader thread is running
 }
 
 } // E.O namespace MWEngine
@@ -0,0 +1,223 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "samplestream.h"
+#include "wavereader.h"
+#include <chrono>
+#include <thread>
+
+namespace MWEngine {
+
+// allocated during static initialization (never on the rendering thread) and never freed
+// so the (detached) loader thread can safely outlive static destruction
+
+static WorkSignal* FETCH_SIGNAL = new WorkSignal();
+
+const int SampleStream::IN_USE_DURATION;
+
+static long long getTime()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+}
+
+/* constructor / destructor */
+
+SampleStream::SampleStream( std::string sourcePath, AudioBuffer* preRoll, int sampleLength, unsigned int sampleRate )
+{
+    _sourcePath     = sourcePath;
+    _preRoll        = preRoll;
+    _sampleLength   = sampleLength;
+    _sampleRate     = sampleRate;
+    _body           = nullptr;
+    _readers        = 0;
+    _references     = 1; // creator holds the first reference
+    _fetchRequested = false;
+    _lastUse        = 0;
+}
+
+SampleStream::~SampleStream()
+{
+    delete _body.exchange( nullptr );
+    delete _preRoll;
+}
+
+/* public methods */
+
+std::string SampleStream::getSourcePath()
+{
+    return _sourcePath;
+}
+
+AudioBuffer* SampleStream::getPreRoll()
+{
+    return _preRoll;
+}
+
+int SampleStream::getSampleLength()
+{
+    return _sampleLength;
+}
+
+unsigned int SampleStream::getSampleRate()
+{
+    return _sampleRate;
+}
+
+void SampleStream::retain()
+{
+    ++_references;
+}
+
+void SampleStream::release()
+{
+    if ( --_references == 0 )
+        delete this;
+}
+
+AudioBuffer* SampleStream::beginRead()
+{
+    // register as reader prior to reading the body pointer so evict()
+    // can't delete the body while it is being read
+
+    ++_readers;
+    markInUse();
+
+    AudioBuffer* body = _body.load();
+
+    if ( body == nullptr )
+        setFetchRequested();
+
+    return body;
+}
+
+void SampleStream::endRead()
+{
+    --_readers;
+}
+
+void SampleStream::requestFetch()
+{
+    markInUse();
+
+    if ( _body.load() == nullptr )
+        setFetchRequested();
+}
+
+bool SampleStream::isResident()
+{
+    return _body.load() != nullptr;
+}
+
+bool SampleStream::isFetchRequested()
+{
+    return _fetchRequested;
+}
+
+bool SampleStream::isReading()
+{
+    return _readers > 0;
+}
+
+bool SampleStream::isInUse()
+{
+    return getTime() - _lastUse.load() < IN_USE_DURATION;
+}
+
+WorkSignal* SampleStream::getFetchSignal()
+{
+    return FETCH_SIGNAL;
+}
+
+unsigned long SampleStream::fetch()
+{
+    if ( isResident() ) {
+        _fetchRequested = false;
+        return 0;
+    }
+    waveFile WAV = WaveReader::fileToBuffer( _sourcePath );
+
+    _fetchRequested = false;
+
+    if ( WAV.buffer == nullptr )
+        return 0;
+
+    // another thread might have fetched the contents in the meantime
+
+    AudioBuffer* expected = nullptr;
+
+    if ( !_body.compare_exchange_strong( expected, WAV.buffer )) {
+        delete WAV.buffer;
+        return 0;
+    }
+    markInUse(); // the body was requested for playback, don't evict it before it's read
+    return ( unsigned long ) WAV.buffer->amountOfChannels * WAV.buffer->bufferSize * sizeof( SAMPLE_TYPE );
+}
+
+void SampleStream::setBody( AudioBuffer* body )
+{
+    AudioBuffer* previous = _body.exchange( body );
+
+    if ( previous != nullptr && previous != body ) {
+        while ( _readers > 0 )
+            std::this_thread::yield();
+
+        delete previous;
+    }
+}
+
+unsigned long SampleStream::evict()
+{
+    AudioBuffer* body = _body.exchange( nullptr );
+
+    if ( body == nullptr )
+        return 0;
+
+    // rendering thread might have obtained the body prior to the exchange
+    // wait until it has finished reading before deleting it
+
+    while ( _readers > 0 )
+        std::this_thread::yield();
+
+    unsigned long size = ( unsigned long ) body->amountOfChannels * body->bufferSize * sizeof( SAMPLE_TYPE );
+    delete body;
+
+    return size;
+}
+
+/* private methods */
+
+void SampleStream::markInUse()
+{
+    _lastUse.store( getTime(), std::memory_order_relaxed );
+}
+
+void SampleStream::setFetchRequested()
+{
+    // only signal the loader thread when the request is new
+
+    if ( !_fetchRequested.exchange( true ))
+        FETCH_SIGNAL->signal();
+}
+
+} // E.O namespace MWEngine
@@ -0,0 +1,113 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__SAMPLESTREAM_H_INCLUDED__
+#define __MWENGINE__SAMPLESTREAM_H_INCLUDED__
+
+#include "audiobuffer.h"
+#include "worksignal.h"
+#include <atomic>
+#include <string>
+
+namespace MWEngine {
+
+/**
+ * SampleStream describes a sample that is streamed from storage: a short "pre-roll"
+ * (the attack of the sample) remains resident in memory at all times, while the
+ * full sample contents (the "body") are only held in memory when needed. This allows
+ * instant playback of the first hit of a sample without keeping all samples resident.
+ *
+ * The rendering thread requests the body through beginRead() / endRead() which are
+ * lock free. Fetching and evicting the body is done outside of the rendering thread
+ * (see SampleManager), which is woken through the fetch signal. While the body is being
+ * played back (or its playback is imminent) the stream is in use and its body is not evicted.
+ * SampleStreams are reference counted and delete themselves upon their last release.
+ */
+class SampleStream
+{
+    public:
+        SampleStream( std::string sourcePath, AudioBuffer* preRoll, int sampleLength, unsigned int sampleRate );
+        ~SampleStream();
+
+        std::string getSourcePath();
+        AudioBuffer* getPreRoll();
+        int getSampleLength();         // the length of the full sample
+        unsigned int getSampleRate();
+
+        void retain();
+        void release();
+
+        /* rendering thread */
+
+        // returns the full sample contents when resident or nullptr when not (in which
+        // case a fetch is requested), each invocation must be followed by endRead()
+
+        AudioBuffer* beginRead();
+        void endRead();
+
+        // request the full sample contents to be loaded (e.g. when playback is imminent)
+        void requestFetch();
+
+        /* loader thread */
+
+        bool isResident();
+        bool isFetchRequested();
+        bool isReading();
+
+        // whether the body was read or requested within the last IN_USE_DURATION milliseconds
+        // (e.g. a voice is playing it back in between reads), in which case it mustn't be evicted
+
+        bool isInUse();
+        static const int IN_USE_DURATION = 500;
+
+        // signalled whenever a fetch is requested by any stream, awaited by the loader thread
+        static WorkSignal* getFetchSignal();
+
+        // loads the full sample contents from the source file, returns the amount of bytes
+        // that were loaded (0 when the contents were already resident or couldn't be read)
+        unsigned long fetch();
+
+        // sets given buffer (holding the full sample contents) as the body, the stream takes ownership
+        void setBody( AudioBuffer* body );
+
+        // removes the full sample contents from memory, waiting for the rendering thread
+        // to finish reading them, returns the amount of freed bytes
+        unsigned long evict();
+
+    private:
+        std::string  _sourcePath;
+        AudioBuffer* _preRoll;
+        int          _sampleLength;
+        unsigned int _sampleRate;
+
+        std::atomic<AudioBuffer*> _body;
+        std::atomic<int>          _readers;
+        std::atomic<int>          _references;
+        std::atomic<bool>         _fetchRequested;
+        std::atomic<long long>    _lastUse; // time (in milliseconds) the body was last read or requested
+
+        void markInUse();
+        void setFetchRequested();
+};
+} // E.O namespace MWEngine
+
+#endif
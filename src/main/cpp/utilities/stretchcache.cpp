@@ -0,0 +1,404 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "stretchcache.h"
+#include "timestretcher.h"
+#include "samplemanager.h"
+#include "worksignal.h"
+#include <events/sampleevent.h>
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MWEngine {
+namespace StretchCacheEntries
+{
+    // requests handed over by the rendering thread, either the release of an entry or the
+    // stretch update of an event. These are queued in a bounded multiple producer (as events are
+    // also mixed by the Freezer), single consumer queue (consumed only while holding the mutex)
+
+    struct Request {
+        StretchCache::Entry* entry;
+        SampleEvent* event;
+    };
+
+    const size_t QUEUE_SIZE = 1024;
+
+    struct Slot {
+        std::atomic<size_t> sequence;
+        Request request;
+    };
+
+    // the state is never freed so the background thread can safely outlive static destruction
+
+    struct State {
+        std::vector<StretchCache::Entry*> entries;
+        std::deque<StretchCache::Entry*> renderQueue;
+        std::vector<StretchCache::Entry*> disposals;
+        std::vector<SampleEvent*> updates;
+        StretchCache::Entry* rendering = nullptr;
+        SampleEvent* updating = nullptr;
+        bool started    = false;
+        bool processing = false;
+        std::mutex mutex;
+        WorkSignal workSignal; // wakes the background thread, signalled by the rendering thread as well
+        std::condition_variable renderCondition;
+
+        Slot queue[ QUEUE_SIZE ];
+        std::atomic<size_t> enqueuePosition;
+        size_t dequeuePosition = 0;
+
+        State() {
+            for ( size_t i = 0; i < QUEUE_SIZE; ++i )
+                queue[ i ].sequence.store( i );
+
+            enqueuePosition.store( 0 );
+        }
+    };
+    State* _state = new State();
+
+    // lock-free, returns false when the queue is full
+
+    bool enqueue( Request request )
+    {
+        size_t position = _state->enqueuePosition.load( std::memory_order_relaxed );
+        Slot* slot;
+
+        while ( true )
+        {
+            slot = &_state->queue[ position & ( QUEUE_SIZE - 1 )];
+            size_t sequence = slot->sequence.load( std::memory_order_acquire );
+            long difference = ( long ) sequence - ( long ) position;
+
+            if ( difference == 0 ) {
+                if ( _state->enqueuePosition.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ))
+                    break;
+            }
+            else if ( difference < 0 ) {
+                return false;
+            }
+            else {
+                position = _state->enqueuePosition.load( std::memory_order_relaxed );
+            }
+        }
+        slot->request = request;
+        slot->sequence.store( position + 1, std::memory_order_release );
+
+        return true;
+    }
+
+    // to be invoked while holding the mutex
+
+    bool dequeue( Request& request )
+    {
+        size_t position = _state->dequeuePosition;
+        Slot* slot      = &_state->queue[ position & ( QUEUE_SIZE - 1 )];
+
+        if ( slot->sequence.load( std::memory_order_acquire ) != position + 1 )
+            return false;
+
+        request = slot->request;
+        slot->sequence.store( position + QUEUE_SIZE, std::memory_order_release );
+        _state->dequeuePosition = position + 1;
+
+        return true;
+    }
+}
+
+using namespace StretchCacheEntries;
+
+/* public methods */
+
+StretchCache::Entry* StretchCache::retain( AudioBuffer* source, float ratio )
+{
+    start();
+
+    std::lock_guard<std::mutex> guard( _state->mutex );
+
+    int key = getRatioKey( ratio );
+
+    for ( size_t i = 0; i < _state->entries.size(); ++i )
+    {
+        Entry* entry = _state->entries.at( i );
+
+        if ( entry->source == source && getRatioKey( entry->ratio ) == key ) {
+            ++entry->references;
+            return entry;
+        }
+    }
+
+    Entry* entry      = new Entry();
+    entry->source     = source;
+    entry->buffer     = nullptr;
+    entry->ratio      = ( float ) key / ( float ) RATIO_RESOLUTION;
+    entry->references = 1;
+    entry->ready.store( false );
+    entry->cancelled.store( false );
+
+    // retain the source so it isn't freed while rendering (when managed by the SampleManager)
+    SampleManager::retainBuffer( source );
+
+    _state->entries.push_back( entry );
+    queueRender( entry );
+
+    return entry;
+}
+
+void StretchCache::release( Entry* entry )
+{
+    if ( entry == nullptr )
+        return;
+
+    std::lock_guard<std::mutex> guard( _state->mutex );
+    releaseEntry( entry );
+}
+
+void StretchCache::releaseDeferred( Entry* entry )
+{
+    if ( entry == nullptr )
+        return;
+
+    Request request = { entry, nullptr };
+
+    // queue full (highly unlikely) ? release synchronously rather than leaking the entry
+
+    if ( !enqueue( request ))
+        release( entry );
+    else
+        _state->workSignal.signal();
+}
+
+void StretchCache::requestUpdate( SampleEvent* event )
+{
+    // only a single update can be pending per event
+
+    if ( event->_stretchUpdateRequested.exchange( true ))
+        return;
+
+    Request request = { nullptr, event };
+
+    if ( !enqueue( request ))
+        event->_stretchUpdateRequested.store( false ); // retried upon the next timing update
+    else
+        _state->workSignal.signal();
+}
+
+void StretchCache::cancelUpdate( SampleEvent* event )
+{
+    std::unique_lock<std::mutex> guard( _state->mutex );
+
+    drainRequests();
+
+    auto it = std::find( _state->updates.begin(), _state->updates.end(), event );
+
+    if ( it != _state->updates.end())
+        _state->updates.erase( it );
+
+    while ( _state->updating == event )
+        _state->renderCondition.wait( guard );
+}
+
+void StretchCache::start()
+{
+    std::lock_guard<std::mutex> guard( _state->mutex );
+
+    if ( _state->started )
+        return;
+
+    _state->started = true;
+    std::thread( &StretchCache::handleWorkerThread ).detach();
+}
+
+void StretchCache::waitForRenders( AudioBuffer* source )
+{
+    std::unique_lock<std::mutex> guard( _state->mutex );
+
+    while ( _state->rendering != nullptr && _state->rendering->source == source )
+        _state->renderCondition.wait( guard );
+}
+
+int StretchCache::getPendingRenders()
+{
+    std::lock_guard<std::mutex> guard( _state->mutex );
+
+    return ( int ) _state->renderQueue.size() + ( _state->rendering != nullptr ? 1 : 0 );
+}
+
+bool StretchCache::isProcessing()
+{
+    std::lock_guard<std::mutex> guard( _state->mutex );
+
+    Slot* next = &_state->queue[ _state->dequeuePosition & ( QUEUE_SIZE - 1 )];
+    bool hasRequests = next->sequence.load() == _state->dequeuePosition + 1;
+
+    return _state->processing || hasRequests || !_state->renderQueue.empty() ||
+           !_state->updates.empty() || !_state->disposals.empty();
+}
+
+int StretchCache::getCacheSize()
+{
+    std::lock_guard<std::mutex> guard( _state->mutex );
+
+    return ( int ) _state->entries.size();
+}
+
+int StretchCache::getRatioKey( float ratio )
+{
+    return ( int ) round( ratio * RATIO_RESOLUTION );
+}
+
+/* private methods */
+
+// the methods below are invoked while holding the mutex
+
+void StretchCache::queueRender( Entry* entry )
+{
+    _state->renderQueue.push_back( entry );
+    _state->workSignal.signal();
+}
+
+void StretchCache::releaseEntry( Entry* entry )
+{
+    if ( --entry->references > 0 )
+        return;
+
+    _state->entries.erase( std::find( _state->entries.begin(), _state->entries.end(), entry ));
+
+    // entry is being rendered ? it is disposed once the render has been cancelled
+    // otherwise dispose it on the background thread
+
+    if ( entry == _state->rendering ) {
+        entry->cancelled.store( true );
+        return;
+    }
+
+    auto queued = std::find( _state->renderQueue.begin(), _state->renderQueue.end(), entry );
+
+    if ( queued != _state->renderQueue.end())
+        _state->renderQueue.erase( queued );
+
+    _state->disposals.push_back( entry );
+    _state->workSignal.signal();
+}
+
+void StretchCache::drainRequests()
+{
+    Request request;
+
+    while ( dequeue( request ))
+    {
+        if ( request.entry != nullptr )
+            releaseEntry( request.entry );
+
+        if ( request.event != nullptr )
+            _state->updates.push_back( request.event );
+    }
+}
+
+void StretchCache::handleWorkerThread()
+{
+    std::unique_lock<std::mutex> guard( _state->mutex );
+
+    while ( true )
+    {
+        drainRequests();
+
+        // await the next request (the signal is raised without holding the mutex, as such
+        // work queued after the check above but before waiting still wakes the thread)
+
+        if ( _state->renderQueue.empty() && _state->disposals.empty() && _state->updates.empty()) {
+            _state->processing = false;
+
+            guard.unlock();
+            _state->workSignal.wait();
+            guard.lock();
+            continue;
+        }
+        _state->processing = true;
+
+        if ( !_state->disposals.empty())
+        {
+            std::vector<Entry*> disposals;
+            disposals.swap( _state->disposals );
+
+            guard.unlock();
+            for ( size_t i = 0; i < disposals.size(); ++i )
+                dispose( disposals.at( i ));
+            guard.lock();
+        }
+
+        if ( !_state->updates.empty())
+        {
+            // the update retains (and releases) entries, as such it is performed without holding the mutex
+
+            SampleEvent* event = _state->updates.front();
+            _state->updates.erase( _state->updates.begin());
+            _state->updating = event;
+
+            guard.unlock();
+            event->_stretchUpdateRequested.store( false );
+            event->updateStretch();
+            guard.lock();
+
+            _state->updating = nullptr;
+            _state->renderCondition.notify_all();
+            continue;
+        }
+
+        if ( _state->renderQueue.empty())
+            continue;
+
+        Entry* entry      = _state->renderQueue.front();
+        _state->rendering = entry;
+        _state->renderQueue.pop_front();
+
+        guard.unlock();
+        AudioBuffer* buffer = TimeStretcher::stretch( entry->source, entry->ratio, &entry->cancelled );
+        guard.lock();
+
+        _state->rendering = nullptr;
+
+        if ( entry->cancelled.load()) {
+            delete buffer;
+            _state->disposals.push_back( entry );
+        }
+        else {
+            buffer->loopeable = entry->source->loopeable;
+            entry->buffer     = buffer;
+            entry->ready.store( true );
+        }
+        _state->renderCondition.notify_all();
+    }
+}
+
+void StretchCache::dispose( Entry* entry )
+{
+    delete entry->buffer;
+    SampleManager::releaseBuffer( entry->source );
+    delete entry;
+}
+
+} // E.O namespace MWEngine
@@ -0,0 +1,113 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__STRETCHCACHE_H_INCLUDED__
+#define __MWENGINE__STRETCHCACHE_H_INCLUDED__
+
+#include "audiobuffer.h"
+#include <atomic>
+
+namespace MWEngine {
+
+class SampleEvent; // forward declaration, see <events/sampleevent.h>
+
+/**
+ * StretchCache renders time stretched versions of samples (see TimeStretcher) on
+ * a long-lived background thread. Renders are shared by all users requesting the same sample
+ * at the same (rounded) ratio and remain cached for as long as these reference them
+ *
+ * the rendering thread must not invoke retain() or release() (these lock and allocate), it
+ * hands its requests to the background thread through a lock-free queue instead (see
+ * releaseDeferred() and requestUpdate())
+ */
+class StretchCache
+{
+    public:
+
+        static const int RATIO_RESOLUTION = 1000; // ratios are rounded to 1 / RATIO_RESOLUTION
+
+        class Entry
+        {
+            public:
+                AudioBuffer* source;
+                AudioBuffer* buffer;          // the stretched contents, available once ready
+                float ratio;
+                int references;
+                std::atomic<bool> ready;      // can be queried from the rendering thread
+                std::atomic<bool> cancelled;  // set when released during rendering
+        };
+
+        /**
+         * retrieves the Entry for given source and stretch ratio, when it is not
+         * cached yet its rendering is queued. Each retain must be balanced by a release
+         */
+        static Entry* retain( AudioBuffer* source, float ratio );
+
+        // release a retained Entry, unreferenced entries are freed (on the background thread)
+
+        static void release( Entry* entry );
+
+        // lock-free variants to be invoked from the rendering thread, the release (or the
+        // event's stretch update, see SampleEvent::updateStretch()) is performed on the background thread
+
+        static void releaseDeferred( Entry* entry );
+        static void requestUpdate( SampleEvent* event );
+
+        // cancels a requested update for given event (e.g. when it is being deleted), upon
+        // return the background thread no longer references given event
+
+        static void cancelUpdate( SampleEvent* event );
+
+        // starts the background thread (when not running yet), invoked from outside the rendering thread
+
+        static void start();
+
+        // blocks until the render of given source (if in progress) has completed, to be
+        // invoked before deleting a source buffer that isn't managed by the SampleManager
+
+        static void waitForRenders( AudioBuffer* source );
+
+        // the amount of renders that are queued or in progress
+
+        static int getPendingRenders();
+
+        // whether the background thread is busy (i.e. has requests, is rendering or disposing entries)
+
+        static bool isProcessing();
+
+        // the amount of cached entries
+
+        static int getCacheSize();
+
+        static int getRatioKey( float ratio );
+
+    private:
+
+        static void queueRender( Entry* entry );
+        static void releaseEntry( Entry* entry );
+        static void drainRequests();
+        static void handleWorkerThread();
+        static void dispose( Entry* entry );
+};
+} // E.O namespace MWEngine
+
+#endif
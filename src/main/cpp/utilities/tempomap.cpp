@@ -0,0 +1,307 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "tempomap.h"
+#include <algorithm>
+#include <cmath>
+
+namespace MWEngine {
+
+unsigned int TempoMap::VERSION_COUNT = 0;
+
+/* constructor / destructor */
+
+TempoMap::TempoMap( float tempo, int beatAmount, int beatUnit )
+{
+    _tempo      = tempo;
+    _beatAmount = beatAmount;
+    _beatUnit   = beatUnit;
+
+    calculateSegments();
+}
+
+TempoMap::~TempoMap()
+{
+    // nowt...
+}
+
+/* public methods */
+
+void TempoMap::addTempoChange( double position, float tempo, bool ramp )
+{
+    TempoChange change = { std::max( 0.0, position ), tempo, ramp };
+
+    // keep changes sorted by position (changes at an equal position are applied in order of addition)
+
+    auto it = std::upper_bound( _tempoChanges.begin(), _tempoChanges.end(), change,
+        []( const TempoChange& a, const TempoChange& b ) { return a.position < b.position; });
+
+    _tempoChanges.insert( it, change );
+    calculateSegments();
+}
+
+void TempoMap::addTimeSignatureChange( double position, int beatAmount, int beatUnit )
+{
+    TimeSignatureChange change = { std::max( 0.0, position ), beatAmount, beatUnit };
+
+    auto it = std::upper_bound( _timeSignatureChanges.begin(), _timeSignatureChanges.end(), change,
+        []( const TimeSignatureChange& a, const TimeSignatureChange& b ) { return a.position < b.position; });
+
+    _timeSignatureChanges.insert( it, change );
+    calculateSegments();
+}
+
+void TempoMap::clear()
+{
+    _tempoChanges.clear();
+    _timeSignatureChanges.clear();
+
+    calculateSegments();
+}
+
+int TempoMap::getTempoChangeAmount()
+{
+    return ( int ) _tempoChanges.size();
+}
+
+int TempoMap::getTimeSignatureChangeAmount()
+{
+    return ( int ) _timeSignatureChanges.size();
+}
+
+float TempoMap::getTempo( double position )
+{
+    TempoSegment* segment = getTempoSegment( position );
+    return ( float ) getTempoInSegment( segment, std::max( 0.0, position - segment->start ));
+}
+
+int TempoMap::getBeatAmount( double position )
+{
+    return getMeterSegment( position )->beatAmount;
+}
+
+int TempoMap::getBeatUnit( double position )
+{
+    return getMeterSegment( position )->beatUnit;
+}
+
+double TempoMap::getSamplePosition( double position )
+{
+    position = std::max( 0.0, position );
+
+    TempoSegment* segment = getTempoSegment( position );
+    double time = segment->startTime + getTimeInSegment( segment, position - segment->start );
+
+    return time * getSamplesPerMinute();
+}
+
+double TempoMap::getTickPosition( double samplePosition )
+{
+    double time = std::max( 0.0, samplePosition ) / getSamplesPerMinute();
+
+    TempoSegment* segment = getTempoSegmentForTime( time );
+    double elapsed        = time - segment->startTime;
+    double length         = segment->end - segment->start;
+
+    // invert getTimeInSegment() (see below)
+
+    if ( segment->end < 0 || segment->startTempo == segment->endTempo )
+        return segment->start + elapsed * TICKS_PER_BEAT * segment->startTempo;
+
+    double delta = segment->endTempo - segment->startTempo;
+    double tempo = segment->startTempo * exp( elapsed * TICKS_PER_BEAT * delta / length );
+
+    return segment->start + ( tempo - segment->startTempo ) * length / delta;
+}
+
+double TempoMap::getStepPosition( double position, int stepsPerBar )
+{
+    MeterSegment* meter = getMeterSegment( position );
+    return ( meter->startBar + ( position - meter->start ) / meter->ticksPerBar ) * stepsPerBar;
+}
+
+double TempoMap::getTickPositionForStep( double step, int stepsPerBar )
+{
+    double bar = step / stepsPerBar;
+
+    // find the last time signature starting at or before given measure
+
+    auto it = std::upper_bound( _meterSegments.begin(), _meterSegments.end(), bar,
+        []( double value, const MeterSegment& segment ) { return value < segment.startBar; });
+
+    MeterSegment* meter = &*( it == _meterSegments.begin() ? it : it - 1 );
+    double position     = meter->start + ( bar - meter->startBar ) * meter->ticksPerBar;
+
+    // a time signature change cuts the preceding measure short
+
+    if ( it != _meterSegments.end())
+        position = std::min( position, it->start );
+
+    return position;
+}
+
+int TempoMap::getNextChange( int samplePosition )
+{
+    double position = getTickPosition( samplePosition );
+    double next     = -1;
+
+    TempoSegment* segment = getTempoSegment( position );
+
+    if ( segment->end >= 0 )
+        next = segment->end;
+
+    auto it = std::upper_bound( _meterSegments.begin(), _meterSegments.end(), position,
+        []( double value, const MeterSegment& meter ) { return value < meter.start; });
+
+    if ( it != _meterSegments.end() && ( next < 0 || it->start < next ))
+        next = it->start;
+
+    if ( next < 0 )
+        return -1;
+
+    // changes take effect at the first sample at or after their position
+
+    int nextSample = ( int ) ceil( getSamplePosition( next ));
+    return nextSample > samplePosition ? nextSample : samplePosition + 1;
+}
+
+unsigned int TempoMap::getVersion()
+{
+    return _version;
+}
+
+/* protected methods */
+
+void TempoMap::calculateSegments()
+{
+    _tempoSegments.clear();
+    _meterSegments.clear();
+
+    // tempo segments
+
+    double position = 0.0;
+    double tempo    = _tempo;
+    double time     = 0.0;
+
+    for ( size_t i = 0; i < _tempoChanges.size(); ++i )
+    {
+        TempoChange& change = _tempoChanges.at( i );
+
+        if ( change.position > position )
+        {
+            TempoSegment segment = { position, change.position, time, tempo, change.ramp ? change.tempo : tempo };
+            time += getTimeInSegment( &segment, segment.end - segment.start );
+
+            _tempoSegments.push_back( segment );
+            position = change.position;
+        }
+        tempo = change.tempo;
+    }
+    TempoSegment last = { position, -1, time, tempo, tempo };
+    _tempoSegments.push_back( last );
+
+    // time signature segments
+
+    MeterSegment meter = { 0.0, 0.0, getTicksPerBar( _beatAmount, _beatUnit ), _beatAmount, _beatUnit };
+
+    for ( size_t i = 0; i < _timeSignatureChanges.size(); ++i )
+    {
+        TimeSignatureChange& change = _timeSignatureChanges.at( i );
+
+        if ( change.position > meter.start )
+        {
+            _meterSegments.push_back( meter );
+
+            // a change occurring within a measure cuts that measure short
+
+            meter.startBar += ceil(( change.position - meter.start ) / meter.ticksPerBar - 1e-9 );
+            meter.start     = change.position;
+        }
+        meter.beatAmount  = change.beatAmount;
+        meter.beatUnit    = change.beatUnit;
+        meter.ticksPerBar = getTicksPerBar( change.beatAmount, change.beatUnit );
+    }
+    _meterSegments.push_back( meter );
+
+    _version = ++VERSION_COUNT;
+}
+
+TempoMap::TempoSegment* TempoMap::getTempoSegment( double position )
+{
+    auto it = std::upper_bound( _tempoSegments.begin(), _tempoSegments.end(), position,
+        []( double value, const TempoSegment& segment ) { return value < segment.start; });
+
+    return &*( it == _tempoSegments.begin() ? it : it - 1 );
+}
+
+TempoMap::TempoSegment* TempoMap::getTempoSegmentForTime( double time )
+{
+    auto it = std::upper_bound( _tempoSegments.begin(), _tempoSegments.end(), time,
+        []( double value, const TempoSegment& segment ) { return value < segment.startTime; });
+
+    return &*( it == _tempoSegments.begin() ? it : it - 1 );
+}
+
+TempoMap::MeterSegment* TempoMap::getMeterSegment( double position )
+{
+    auto it = std::upper_bound( _meterSegments.begin(), _meterSegments.end(), position,
+        []( double value, const MeterSegment& segment ) { return value < segment.start; });
+
+    return &*( it == _meterSegments.begin() ? it : it - 1 );
+}
+
+double TempoMap::getTempoInSegment( TempoSegment* segment, double offset )
+{
+    if ( segment->end < 0 || segment->startTempo == segment->endTempo )
+        return segment->startTempo;
+
+    double length = segment->end - segment->start;
+    return segment->startTempo + ( segment->endTempo - segment->startTempo ) * std::min( 1.0, offset / length );
+}
+
+/**
+ * the time (in minutes) elapsed after given offset (in ticks) within given segment, where
+ * a tick lasts 1 / ( tempo * TICKS_PER_BEAT ) minutes. For a ramp (where the tempo moves linearly
+ * between the start and end tempo) this is the integral of above over the elapsed ticks
+ */
+double TempoMap::getTimeInSegment( TempoSegment* segment, double offset )
+{
+    if ( segment->end < 0 || segment->startTempo == segment->endTempo )
+        return offset / ( TICKS_PER_BEAT * segment->startTempo );
+
+    double length = segment->end - segment->start;
+    double delta  = segment->endTempo - segment->startTempo;
+
+    return length / ( TICKS_PER_BEAT * delta ) * log( getTempoInSegment( segment, offset ) / segment->startTempo );
+}
+
+double TempoMap::getTicksPerBar( int beatAmount, int beatUnit )
+{
+    return ( double ) TICKS_PER_BEAT * 4.0 * beatAmount / beatUnit;
+}
+
+double TempoMap::getSamplesPerMinute()
+{
+    return ( double ) AudioEngineProps::SAMPLE_RATE * 60.0;
+}
+
+} // E.O namespace MWEngine
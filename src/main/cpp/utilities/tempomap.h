@@ -0,0 +1,149 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__TEMPOMAP_H_INCLUDED__
+#define __MWENGINE__TEMPOMAP_H_INCLUDED__
+
+#include "global.h"
+#include <vector>
+
+namespace MWEngine {
+
+/**
+ * A TempoMap describes the tempo and time signature changes along a sequence. Changes are
+ * positioned in musical time, using ticks as a unit (see TICKS_PER_BEAT, where a beat is a quarter note)
+ * and tempo changes can be instant or ramp (e.g. accelerando / ritardando) towards their position.
+ *
+ * The map precomputes the cumulative time for each of its segments, meaning the translation
+ * of a musical position into a buffer sample position (and vice versa) is a binary search,
+ * e.g. O(log n) for n changes, without accumulating rounding errors over the length of the sequence.
+ *
+ * Apply the map using SequencerController::setTempoMap(), the caller retains ownership of the map.
+ * A TempoMap should not be altered while it is applied, apply it anew after altering its contents
+ * (the engine compares the map version to detect the alteration).
+ */
+class TempoMap
+{
+    public:
+        TempoMap( float tempo, int beatAmount, int beatUnit );
+        ~TempoMap();
+
+        // add a change in tempo at given position (in ticks), when ramp is true, the tempo
+        // moves linearly from the tempo of the previous change, reaching given tempo at given position
+        void addTempoChange( double position, float tempo, bool ramp );
+
+        // add a change in time signature at given position (in ticks), which starts a new measure
+        void addTimeSignatureChange( double position, int beatAmount, int beatUnit );
+
+        // removes all changes (the initial tempo and time signature remain)
+        void clear();
+
+        int getTempoChangeAmount();
+        int getTimeSignatureChangeAmount();
+
+        // tempo and time signature at given position (in ticks)
+
+        float getTempo( double position );
+        int getBeatAmount( double position );
+        int getBeatUnit( double position );
+
+        // translate positions in ticks to (fractional) buffer samples and vice versa
+
+        double getSamplePosition( double position );
+        double getTickPosition( double samplePosition );
+
+        // translate positions in ticks to (fractional) sequencer steps, where each measure
+        // is subdivided into given stepsPerBar, and vice versa
+
+        double getStepPosition( double position, int stepsPerBar );
+        double getTickPositionForStep( double step, int stepsPerBar );
+
+        // the buffer sample position of the first change following given
+        // buffer sample position, or -1 when no change follows
+        int getNextChange( int samplePosition );
+
+        // unique identifier for the current contents of this map, changes on each alteration
+        unsigned int getVersion();
+
+    protected:
+
+        typedef struct
+        {
+            double position;
+            float tempo;
+            bool ramp;
+        } TempoChange;
+
+        typedef struct
+        {
+            double position;
+            int beatAmount;
+            int beatUnit;
+        } TimeSignatureChange;
+
+        // a segment spans the range between two successive tempo changes, where startTime is the
+        // cumulative time (in minutes) at the start of the segment (independent of the sample rate)
+
+        typedef struct
+        {
+            double start;
+            double end; // -1 for the last segment
+            double startTime;
+            double startTempo;
+            double endTempo;
+        } TempoSegment;
+
+        typedef struct
+        {
+            double start;
+            double startBar; // the amount of measures preceding this time signature
+            double ticksPerBar;
+            int beatAmount;
+            int beatUnit;
+        } MeterSegment;
+
+        float _tempo;
+        int _beatAmount;
+        int _beatUnit;
+        unsigned int _version;
+
+        std::vector<TempoChange> _tempoChanges;
+        std::vector<TimeSignatureChange> _timeSignatureChanges;
+        std::vector<TempoSegment> _tempoSegments;
+        std::vector<MeterSegment> _meterSegments;
+
+        static unsigned int VERSION_COUNT;
+
+        void calculateSegments();
+
+        TempoSegment* getTempoSegment( double position );
+        TempoSegment* getTempoSegmentForTime( double time );
+        MeterSegment* getMeterSegment( double position );
+
+        double getTempoInSegment( TempoSegment* segment, double offset );
+        double getTimeInSegment ( TempoSegment* segment, double offset );
+        double getTicksPerBar( int beatAmount, int beatUnit );
+        double getSamplesPerMinute();
+};
+} // E.O namespace MWEngine
+
+#endif
@@ -0,0 +1,164 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "timestretcher.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace MWEngine {
+
+constexpr double TimeStretcher::FRAME_DURATION;
+
+/* public methods */
+
+AudioBuffer* TimeStretcher::stretch( AudioBuffer* source, double ratio )
+{
+    return stretch( source, ratio, nullptr );
+}
+
+AudioBuffer* TimeStretcher::stretch( AudioBuffer* source, double ratio, std::atomic<bool>* cancel )
+{
+    int inputLength      = source->bufferSize;
+    int outputLength     = std::max( 1, ( int ) round( inputLength * ratio ));
+    int amountOfChannels = source->amountOfChannels;
+
+    AudioBuffer* output = new AudioBuffer( amountOfChannels, outputLength );
+
+    // frames overlap by half their length, as such the Hann windows sum to unity
+
+    int frameSize      = std::max( 64, ( int )( AudioEngineProps::SAMPLE_RATE * FRAME_DURATION ) & ~1 );
+    int synthesisHop   = frameSize / 2;
+    double analysisHop = synthesisHop / ratio;
+    int tolerance      = frameSize / 4; // max deviation of a frame from its nominal position
+
+    std::vector<SAMPLE_TYPE> window( frameSize );
+
+    for ( int i = 0; i < frameSize; ++i ) {
+        SAMPLE_TYPE s = sin( M_PI * ( SAMPLE_TYPE ) i / ( SAMPLE_TYPE ) frameSize );
+        window[ i ]   = s * s;
+    }
+
+    // the waveform similarity is determined on the sum of all channels (padded
+    // with silence so frames can be compared beyond the end of the source)
+
+    std::vector<SAMPLE_TYPE> mix( inputLength + frameSize * 2, 0.0 );
+
+    for ( int c = 0; c < amountOfChannels; ++c )
+    {
+        SAMPLE_TYPE* channelBuffer = source->getBufferForChannel( c );
+
+        for ( int i = 0; i < inputLength; ++i )
+            mix[ i ] += channelBuffer[ i ];
+    }
+
+    int position = 0;
+
+    for ( int frame = 0, outputPosition = 0; outputPosition < outputLength; ++frame, outputPosition += synthesisHop )
+    {
+        if ( cancel != nullptr && cancel->load()) {
+            delete output;
+            return nullptr;
+        }
+
+        // each subsequent frame is read from the position closest to its nominal position
+        // that resembles the natural continuation of the previous frame
+
+        if ( frame > 0 ) {
+            int nominal = std::min( inputLength, ( int ) round( frame * analysisHop ));
+            position    = findFramePosition( mix, nominal, position + synthesisHop, tolerance, frameSize );
+        }
+
+        int amount = std::min( frameSize, outputLength - outputPosition );
+        int readable = std::max( 0, std::min( amount, inputLength - position ));
+
+        for ( int c = 0; c < amountOfChannels; ++c )
+        {
+            SAMPLE_TYPE* sourceBuffer = source->getBufferForChannel( c ) + position;
+            SAMPLE_TYPE* targetBuffer = output->getBufferForChannel( c ) + outputPosition;
+
+            // the first frame isn't faded in (as no frame precedes it)
+
+            for ( int i = 0; i < readable; ++i )
+                targetBuffer[ i ] += sourceBuffer[ i ] * (( frame == 0 && i < synthesisHop ) ? 1.0 : window[ i ]);
+        }
+    }
+    return output;
+}
+
+/* private methods */
+
+int TimeStretcher::findFramePosition( std::vector<SAMPLE_TYPE>& mix, int nominal, int natural,
+                                      int tolerance, int frameSize )
+{
+    int maxPosition = ( int ) mix.size() - frameSize * 2;
+    int first       = std::max( 0, nominal - tolerance );
+    int last        = std::max( first, std::min( maxPosition, nominal + tolerance ));
+    natural         = std::min( natural, maxPosition );
+
+    // coarse search at a reduced resolution, followed by a fine search around the best match
+
+    int best = std::min( nominal, last );
+    SAMPLE_TYPE bestSimilarity = getSimilarity( mix, best, natural, frameSize, 4 );
+
+    for ( int position = first; position <= last; position += 4 )
+    {
+        SAMPLE_TYPE similarity = getSimilarity( mix, position, natural, frameSize, 4 );
+
+        if ( similarity > bestSimilarity ) {
+            bestSimilarity = similarity;
+            best           = position;
+        }
+    }
+
+    int coarse = best;
+    bestSimilarity = getSimilarity( mix, best, natural, frameSize, 1 );
+
+    for ( int position = std::max( first, coarse - 3 ), end = std::min( last, coarse + 3 ); position <= end; ++position )
+    {
+        SAMPLE_TYPE similarity = getSimilarity( mix, position, natural, frameSize, 1 );
+
+        if ( similarity > bestSimilarity ) {
+            bestSimilarity = similarity;
+            best           = position;
+        }
+    }
+    return best;
+}
+
+SAMPLE_TYPE TimeStretcher::getSimilarity( std::vector<SAMPLE_TYPE>& mix, int position, int natural,
+                                          int frameSize, int stride )
+{
+    // cross correlation normalized by the energy of the candidate
+
+    SAMPLE_TYPE correlation = 0.0, energy = 0.0;
+    SAMPLE_TYPE* candidate  = mix.data() + position;
+    SAMPLE_TYPE* reference  = mix.data() + natural;
+
+    for ( int i = 0; i < frameSize; i += stride ) {
+        correlation += candidate[ i ] * reference[ i ];
+        energy      += candidate[ i ] * candidate[ i ];
+    }
+    return correlation / sqrt( energy + 1e-9 );
+}
+
+} // E.O namespace MWEngine
@@ -0,0 +1,69 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__TIMESTRETCHER_H_INCLUDED__
+#define __MWENGINE__TIMESTRETCHER_H_INCLUDED__
+
+#include "global.h"
+#include "audiobuffer.h"
+#include <atomic>
+#include <vector>
+
+namespace MWEngine {
+
+/**
+ * TimeStretcher changes the duration of audio without affecting its pitch using WSOLA
+ * (waveform similarity overlap-add). The source is cut into overlapping frames which are
+ * output at a fixed hop size, while each frame is read from the position (around its nominal
+ * stretched position) that best continues the waveform of the previously output frame
+ *
+ * this is intended for offline use (see StretchCache for rendering in the background)
+ */
+class TimeStretcher
+{
+    public:
+
+        static constexpr double FRAME_DURATION = 0.04; // duration (in seconds) of a single frame
+
+        /**
+         * Creates a new AudioBuffer containing the contents of given source stretched by given
+         * ratio (e.g. 2.0 doubles the duration, 0.5 halves it), the output length equals
+         * the source length multiplied by the ratio. All channels share the same frame
+         * positions so their phase relation is retained
+         */
+        static AudioBuffer* stretch( AudioBuffer* source, double ratio );
+
+        // as above, but returns nullptr when cancel is set while stretching (e.g. from another thread)
+
+        static AudioBuffer* stretch( AudioBuffer* source, double ratio, std::atomic<bool>* cancel );
+
+    private:
+
+        static int findFramePosition( std::vector<SAMPLE_TYPE>& mix, int nominal, int natural,
+                                      int tolerance, int frameSize );
+
+        static SAMPLE_TYPE getSimilarity( std::vector<SAMPLE_TYPE>& mix, int position, int natural,
+                                          int frameSize, int stride );
+};
+} // E.O namespace MWEngine
+
+#endif
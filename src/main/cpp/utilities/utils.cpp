@@ -26,6 +26,8 @@
 #include <ctime>
 #include <string.h>
 #include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 namespace MWEngine {
 
@@ -117,4 +119,22 @@ unsigned long sliceLong( std::vector<char> inputBuffer, int startOffset, bool li
            inputBuffer[ startOffset + 0 ];
 }
 
+/**
+ * ensures the contents of the file at given path have been committed to storage
+ * (e.g. survive termination of the process or the device losing power). Note the
+ * file's pending writes must have been flushed (e.g. std::ofstream::flush()) beforehand
+ */
+bool syncFile( std::string path )
+{
+    int fd = open( path.c_str(), O_RDONLY );
+
+    if ( fd < 0 )
+        return false;
+
+    bool synced = fsync( fd ) == 0;
+    close( fd );
+
+    return synced;
+}
+
 } // E.O namespace MWEngine
@@ -24,6 +24,7 @@
 #define __MWENGINE__UTILS_H_INCLUDED__
 
 #include <math.h>
+#include <string>
 #include <vector>
 #include <algorithm>
 #include "global.h"
@@ -55,6 +56,7 @@ float randomFloat();
 unsigned long long now_ms();
 char* sliceString( std::vector<char> inputBuffer, char* outputBuffer, int startOffset, int length );
 unsigned long sliceLong( std::vector<char> inputBuffer, int startOffset, bool littleEndian );
+bool syncFile( std::string path );
 
 // numbers to string
 #define SSTR( x ) std::to_string( x )
@@ -0,0 +1,270 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "waveencoder.h"
+#include "wavewriter.h"
+#include "debug.h"
+#include "utils.h"
+#include <cmath>
+#include <cstring>
+
+namespace MWEngine {
+
+/* constructors / destructor */
+
+WaveEncoder::WaveEncoder( int format )
+{
+    _format           = format;
+    _dither           = false;
+    _amountOfChannels = 0;
+    _seed             = 22222;
+    _dataSize         = 0;
+    _writtenSize      = 0;
+}
+
+WaveEncoder::WaveEncoder( int format, bool dither ) : WaveEncoder( format )
+{
+    // dithering is only of use when reducing to 16-bit
+    _dither = dither && format == PCM_16;
+}
+
+WaveEncoder::~WaveEncoder()
+{
+    close();
+}
+
+/* public methods */
+
+int WaveEncoder::getFormat()
+{
+    return _format;
+}
+
+bool WaveEncoder::getDither()
+{
+    return _dither;
+}
+
+int WaveEncoder::getBytesPerSample()
+{
+    switch ( _format ) {
+        default:
+        case PCM_16:
+            return 2;
+        case PCM_24:
+            return 3;
+        case FLOAT_32:
+            return 4;
+    }
+}
+
+size_t WaveEncoder::getDataSize()
+{
+    return _dataSize;
+}
+
+bool WaveEncoder::open( std::string outputFile, int sampleRate, int amountOfChannels )
+{
+    _amountOfChannels = amountOfChannels;
+    _dataSize         = 0;
+    _writtenSize      = 0;
+    _outputFile       = outputFile;
+
+    // the header describes an empty file until the first update
+
+    _stream = WaveWriter::createWAVStream(
+        outputFile.c_str(), 0, sampleRate, amountOfChannels,
+        getBytesPerSample() * 8, _format == FLOAT_32 ? WaveWriter::FORMAT_IEEE_FLOAT : WaveWriter::FORMAT_PCM
+    );
+
+    if ( !_stream.is_open()) {
+        Debug::log( "WaveEncoder::Error could not open file '%s'", outputFile.c_str() );
+        return false;
+    }
+    return true;
+}
+
+void WaveEncoder::encode( const float* interleavedBuffer, int amountOfFrames )
+{
+    if ( !_stream.is_open())
+        return;
+
+    int amountOfSamples = amountOfFrames * _amountOfChannels;
+    size_t outputSize   = ( size_t ) amountOfSamples * getBytesPerSample();
+    size_t pendingSize  = _dataSize - _writtenSize;
+
+    // encoded output is appended to the bytes pending from the previous write
+
+    if ( _outputBuffer.size() < pendingSize + outputSize )
+        _outputBuffer.resize( pendingSize + outputSize );
+
+    char* output = _outputBuffer.data() + pendingSize;
+
+    switch ( _format )
+    {
+        default:
+        case PCM_16:
+        {
+            const float MAX_VALUE = 32767.f;
+            INT16 value;
+
+            for ( int i = 0; i < amountOfSamples; ++i )
+            {
+                float sample = interleavedBuffer[ i ] * MAX_VALUE;
+
+                if ( _dither )
+                    sample += getDitherNoise();
+
+                // sanity check to keep converted samples within range
+
+                if ( sample > +MAX_VALUE )
+                    sample = +MAX_VALUE;
+
+                else if ( sample < -MAX_VALUE )
+                    sample = -MAX_VALUE;
+
+                value = ( INT16 ) lrintf( sample );
+                memcpy( output + i * 2, &value, 2 );
+            }
+            break;
+        }
+
+        case PCM_24:
+        {
+            const float MAX_VALUE = 8388607.f;
+
+            for ( int i = 0; i < amountOfSamples; ++i )
+            {
+                float sample = interleavedBuffer[ i ] * MAX_VALUE;
+
+                if ( sample > +MAX_VALUE )
+                    sample = +MAX_VALUE;
+
+                else if ( sample < -MAX_VALUE )
+                    sample = -MAX_VALUE;
+
+                // note that RIFF files are little endian
+
+                int value = ( int ) lrintf( sample );
+                char* out = output + i * 3;
+
+                out[ 0 ] = ( char )( value & 0xff );
+                out[ 1 ] = ( char )(( value >> 8 ) & 0xff );
+                out[ 2 ] = ( char )(( value >> 16 ) & 0xff );
+            }
+            break;
+        }
+
+        case FLOAT_32:
+            // floating point output is written as-is (e.g. without clipping)
+            memcpy( output, interleavedBuffer, outputSize );
+            break;
+    }
+
+    _dataSize += outputSize;
+
+    writeOutput( true );
+}
+
+void WaveEncoder::update()
+{
+    if ( !_stream.is_open())
+        return;
+
+    writeOutput( false );
+
+    WaveWriter::updateWAVHeader( _stream, _dataSize );
+    _stream.flush();
+
+    syncFile( _outputFile );
+}
+
+void WaveEncoder::close()
+{
+    if ( !_stream.is_open())
+        return;
+
+    writeOutput( false );
+
+    WaveWriter::updateWAVHeader( _stream, _dataSize );
+    _stream.close();
+
+    syncFile( _outputFile );
+}
+
+std::string WaveEncoder::getFileExtension()
+{
+    return ".wav";
+}
+
+bool WaveEncoder::recover( std::string outputFile )
+{
+    return WaveWriter::repairWAVFile( outputFile );
+}
+
+/* protected methods */
+
+void WaveEncoder::writeOutput( bool aligned )
+{
+    size_t pendingSize = _dataSize - _writtenSize;
+    size_t writeSize   = pendingSize;
+
+    if ( aligned )
+    {
+        // write up until the last block boundary of the file (which includes the header)
+
+        size_t filePosition = WaveWriter::HEADER_SIZE + _writtenSize;
+        size_t blockEnd     = ( filePosition + pendingSize ) / BLOCK_SIZE * BLOCK_SIZE;
+
+        writeSize = blockEnd > filePosition ? blockEnd - filePosition : 0;
+    }
+
+    if ( writeSize == 0 )
+        return;
+
+    WaveWriter::appendBufferToStream( _stream, _outputBuffer.data(), writeSize );
+    _writtenSize += writeSize;
+
+    // move the remainder to the front of the buffer
+
+    if ( writeSize < pendingSize )
+        memmove( _outputBuffer.data(), _outputBuffer.data() + writeSize, pendingSize - writeSize );
+}
+
+/**
+ * triangular probability density function noise (in the range of -1 to +1 LSB)
+ * generated by subtracting two uniformly distributed random values
+ */
+float WaveEncoder::getDitherNoise()
+{
+    const float SCALE = 1.f / 16777216.f;
+
+    _seed = _seed * 1664525 + 1013904223;
+    float value1 = ( float )( _seed >> 8 ) * SCALE;
+
+    _seed = _seed * 1664525 + 1013904223;
+    float value2 = ( float )( _seed >> 8 ) * SCALE;
+
+    return value1 - value2;
+}
+
+} // E.O namespace MWEngine
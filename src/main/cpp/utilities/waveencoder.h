@@ -0,0 +1,91 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__WAVEENCODER_H_INCLUDED__
+#define __MWENGINE__WAVEENCODER_H_INCLUDED__
+
+#include "baseencoder.h"
+#include <fstream>
+#include <vector>
+
+namespace MWEngine {
+
+/**
+ * WaveEncoder writes audio into a .WAV file in 16-bit or 24-bit PCM
+ * or 32-bit floating point format. 16-bit output can optionally be
+ * dithered using triangular (TPDF) noise to decorrelate the quantisation error
+ *
+ * Encoded data is written in blocks aligned to the storage page size and the header
+ * is updated (and the file synced to storage) on each update(), as such an interrupted
+ * recording can be recovered up to the last update (see recover())
+ */
+class WaveEncoder : public BaseEncoder
+{
+    public:
+        enum Format {
+            PCM_16,
+            PCM_24,
+            FLOAT_32
+        };
+
+        WaveEncoder( int format );
+        WaveEncoder( int format, bool dither );
+        ~WaveEncoder();
+
+        int getFormat();
+        bool getDither();
+        int getBytesPerSample();
+
+        // the amount of bytes of audio data that have been written
+        size_t getDataSize();
+
+        bool open( std::string outputFile, int sampleRate, int amountOfChannels );
+        void encode( const float* interleavedBuffer, int amountOfFrames );
+        void update();
+        void close();
+        std::string getFileExtension();
+        bool recover( std::string outputFile );
+
+        static const int BLOCK_SIZE = 16384; // size (in bytes) that writes to storage are aligned to
+
+    protected:
+        int  _format;
+        bool _dither;
+        int  _amountOfChannels;
+        unsigned int _seed;  // state of the dither noise generator
+        size_t _dataSize;     // the amount of encoded bytes
+        size_t _writtenSize;  // the amount of encoded bytes written into the stream
+        std::string _outputFile;
+
+        std::ofstream _stream;
+        std::vector<char> _outputBuffer; // holds the encoded bytes that have yet to be written
+
+        inline float getDitherNoise();
+
+        // write the pending encoded bytes, when aligned is true only the bytes up until
+        // the last block boundary are written (the remainder is kept for the next write)
+
+        void writeOutput( bool aligned );
+};
+} // E.O namespace MWEngine
+
+#endif
@@ -20,6 +20,9 @@
  * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
+#ifndef __MWENGINE__WAVEREADER_H_INCLUDED__
+#define __MWENGINE__WAVEREADER_H_INCLUDED__
+
 #include "../audiobuffer.h"
 #include "../wavetable.h"
 #include <string>
@@ -53,3 +56,5 @@ class WaveReader
         static waveFile byteArrayToBuffer( std::vector<char> byteArray );
 };
 } // E.O namespace MWEngine
+
+#endif
@@ -21,12 +21,18 @@
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #include "wavewriter.h"
+#include "waveencoder.h"
 #include "global.h"
 #include "utils.h"
+#include <algorithm>
 #include <fstream>
+#include <cstring>
+#include <unistd.h>
 
 namespace MWEngine {
 
+const int WaveWriter::HEADER_SIZE;
+
 /* public methods */
 
 size_t WaveWriter::bufferToWAV( std::string outputFile, AudioBuffer* buffer, int sampleRate )
@@ -57,6 +63,39 @@ size_t WaveWriter::bufferToWAV( std::string outputFile, AudioBuffer* buffer, int
     return outputBufferSize; // return size of written WAV buffer data
 }
 
+size_t WaveWriter::bufferToWAV( std::string outputFile, AudioBuffer* buffer, int sampleRate, int format )
+{
+    int bufferSize       = buffer->bufferSize;
+    int amountOfChannels = buffer->amountOfChannels;
+
+    WaveEncoder encoder( format );
+
+    if ( !encoder.open( outputFile, sampleRate, amountOfChannels ))
+        return 0;
+
+    // interleave and encode the buffer contents in chunks
+
+    const int CHUNK_FRAMES = 1024;
+    std::vector<float> interleaved( CHUNK_FRAMES * amountOfChannels );
+
+    for ( int i = 0; i < bufferSize; i += CHUNK_FRAMES )
+    {
+        int frames = std::min( CHUNK_FRAMES, bufferSize - i );
+
+        for ( int c = 0; c < amountOfChannels; ++c )
+        {
+            SAMPLE_TYPE* channelBuffer = buffer->getBufferForChannel( c );
+
+            for ( int j = 0; j < frames; ++j )
+                interleaved[ j * amountOfChannels + c ] = ( float ) channelBuffer[ i + j ];
+        }
+        encoder.encode( interleaved.data(), frames );
+    }
+    encoder.close();
+
+    return encoder.getDataSize(); // return size of written WAV buffer data
+}
+
 INT16* WaveWriter::bufferToPCM( AudioBuffer* buffer )
 {
     int writeIndex       = 0;
@@ -90,4 +129,58 @@ INT16* WaveWriter::bufferToPCM( AudioBuffer* buffer )
     return outputBuffer;
 }
 
+void WaveWriter::updateWAVHeader( std::ofstream& stream, size_t totalBufSizeWritten )
+{
+    std::streampos position = stream.tellp();
+
+    stream.seekp( 4 );
+    t_streamwrite<UINT32>( stream, 36 + totalBufSizeWritten ); // file size
+    stream.seekp( 40 );
+    t_streamwrite<UINT32>( stream, totalBufSizeWritten );      // data size
+
+    stream.seekp( position );
+}
+
+bool WaveWriter::repairWAVFile( std::string inputFile )
+{
+    std::fstream stream( inputFile.c_str(), std::ios::binary | std::ios::in | std::ios::out );
+
+    if ( !stream.is_open())
+        return false;
+
+    char riff[ 4 ], wave[ 4 ], data[ 4 ];
+    INT16 frameSize = 0;
+
+    stream.read( riff, 4 );
+    stream.seekg( 8 );
+    stream.read( wave, 4 );
+    stream.seekg( 32 );
+    stream.read(( char* ) &frameSize, 2 );
+    stream.seekg( 36 );
+    stream.read( data, 4 );
+
+    stream.seekg( 0, std::ios::end );
+    std::streamoff fileSize = stream.tellg();
+
+    if ( !stream.good() || fileSize < HEADER_SIZE || frameSize <= 0 ||
+         strncmp( riff, "RIFF", 4 ) != 0 || strncmp( wave, "WAVE", 4 ) != 0 || strncmp( data, "data", 4 ) != 0 )
+        return false;
+
+    // omit a partially written frame at the end of the file
+
+    UINT32 dataSize = ( UINT32 )(( fileSize - HEADER_SIZE ) / frameSize * frameSize );
+    UINT32 riffSize = 36 + dataSize;
+
+    stream.seekp( 4 );
+    stream.write(( const char* ) &riffSize, sizeof( UINT32 ));
+    stream.seekp( 40 );
+    stream.write(( const char* ) &dataSize, sizeof( UINT32 ));
+    stream.close();
+
+    if ( HEADER_SIZE + dataSize < fileSize )
+        truncate( inputFile.c_str(), HEADER_SIZE + dataSize );
+
+    return true;
+}
+
 } // E.O namespace MWEngine
@@ -34,11 +34,21 @@ namespace MWEngine {
 class WaveWriter
 {
     public:
+        // audio format identifiers as described in the WAV header
+
+        static const int FORMAT_PCM        = 1;
+        static const int FORMAT_IEEE_FLOAT = 3;
+
+        // size (in bytes) of the header written by createWAVStream()
+        static const int HEADER_SIZE = 44;
+
         /**
          * Writes the contents of given AudioBuffer into a WAV file
          * Returns the size of the written WAV files buffer content
+         * format describes the WaveEncoder::Format to write the file in (16-bit PCM when omitted)
          */
         static size_t bufferToWAV( std::string outputFile, AudioBuffer* buffer, int sampleRate );
+        static size_t bufferToWAV( std::string outputFile, AudioBuffer* buffer, int sampleRate, int format );
 
         /**
          * Create an output stream for writing a WAV file to
@@ -48,27 +58,49 @@ class WaveWriter
          */
         static std::ofstream createWAVStream( const char* outFile, size_t totalBufSizeToWrite,
                                               int sampleRate, int channels )
+        {
+            return createWAVStream( outFile, totalBufSizeToWrite, sampleRate, channels, 8 * sizeof( INT16 ), FORMAT_PCM );
+        }
+
+        static std::ofstream createWAVStream( const char* outFile, size_t totalBufSizeToWrite,
+                                              int sampleRate, int channels, int bitsPerSample, int audioFormat )
         {
             std::ofstream stream( outFile, std::ios::binary );
+            int bytesPerSample = bitsPerSample / 8;
 
             // write the header data
             stream.write( "RIFF", 4 );
-            t_streamwrite<UINT32>( stream, 36 + totalBufSizeToWrite );               // file size
+            t_streamwrite<UINT32>( stream, 36 + totalBufSizeToWrite );              // file size
             stream.write( "WAVE", 4 );
             stream.write( "fmt ", 4 );
-            t_streamwrite<UINT32>  ( stream, 16 );                                   // format length
-            t_streamwrite<INT16>( stream, 1 );                                       // Format (1 = PCM)
-            t_streamwrite<INT16>( stream, ( INT16 ) channels );                      // Channels
-            t_streamwrite<UINT32>( stream, sampleRate );                             // Sample rate
-            t_streamwrite<UINT32>( stream, sampleRate * channels * sizeof( INT16 )); // Byte rate
-            t_streamwrite<INT16>( stream, channels * sizeof( INT16 ));               // Frame size
-            t_streamwrite<INT16>( stream, 8 * sizeof( INT16 ));                      // Bits per sample
+            t_streamwrite<UINT32>  ( stream, 16 );                                  // format length
+            t_streamwrite<INT16>( stream, ( INT16 ) audioFormat );                  // Format (1 = PCM, 3 = IEEE float)
+            t_streamwrite<INT16>( stream, ( INT16 ) channels );                     // Channels
+            t_streamwrite<UINT32>( stream, sampleRate );                            // Sample rate
+            t_streamwrite<UINT32>( stream, sampleRate * channels * bytesPerSample ); // Byte rate
+            t_streamwrite<INT16>( stream, ( INT16 )( channels * bytesPerSample ));   // Frame size
+            t_streamwrite<INT16>( stream, ( INT16 ) bitsPerSample );                // Bits per sample
             stream.write( "data", 4 );
             stream.write(( const char* )&totalBufSizeToWrite, 4 );
 
             return stream;
         }
 
+        /**
+         * Updates the size fields of the header of a WAV stream created by createWAVStream()
+         * to describe given size of WAV data, this allows a stream that is continuously appended
+         * to to describe a valid WAV file at all times. The write position is restored afterwards.
+         */
+        static void updateWAVHeader( std::ofstream& stream, size_t totalBufSizeWritten );
+
+        /**
+         * Repairs a WAV file created by createWAVStream() that was not completed (e.g. the
+         * application was terminated while writing), by updating its header to describe all
+         * whole frames of WAV data present in the file. Returns false when given file is not a
+         * WAV file (or could not be opened), returns true when the file is valid after repairing
+         */
+        static bool repairWAVFile( std::string inputFile );
+
         /**
          * Appends the contents of given buffer to given stream
          */
@@ -0,0 +1,88 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "worksignal.h"
+#include <cerrno>
+#include <ctime>
+
+namespace MWEngine {
+
+/* constructor / destructor */
+
+WorkSignal::WorkSignal()
+{
+    _pending = false;
+    sem_init( &_semaphore, 0, 0 );
+}
+
+WorkSignal::~WorkSignal()
+{
+    sem_destroy( &_semaphore );
+}
+
+/* public methods */
+
+void WorkSignal::signal()
+{
+    if ( !_pending.exchange( true ))
+        sem_post( &_semaphore );
+}
+
+void WorkSignal::wait()
+{
+    while ( sem_wait( &_semaphore ) != 0 && errno == EINTR )
+        continue;
+
+    _pending = false;
+}
+
+bool WorkSignal::wait( int milliseconds )
+{
+    timespec deadline;
+    clock_gettime( CLOCK_REALTIME, &deadline );
+
+    deadline.tv_sec  += milliseconds / 1000;
+    deadline.tv_nsec += ( long )( milliseconds % 1000 ) * 1000000L;
+
+    if ( deadline.tv_nsec >= 1000000000L ) {
+        deadline.tv_nsec -= 1000000000L;
+        ++deadline.tv_sec;
+    }
+
+    int result;
+
+    while (( result = sem_timedwait( &_semaphore, &deadline )) != 0 && errno == EINTR )
+        continue;
+
+    if ( result != 0 )
+        return false;
+
+    _pending = false;
+    return true;
+}
+
+bool WorkSignal::isPending()
+{
+    return _pending;
+}
+
+} // E.O namespace MWEngine
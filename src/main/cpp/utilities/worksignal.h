@@ -0,0 +1,62 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MWENGINE__WORKSIGNAL_H_INCLUDED__
+#define __MWENGINE__WORKSIGNAL_H_INCLUDED__
+
+#include <atomic>
+#include <semaphore.h>
+
+namespace MWEngine {
+
+/**
+ * WorkSignal wakes a worker thread when work is pending, without the worker having to poll.
+ * signal() never locks and can as such be invoked from the rendering thread: it raises an atomic
+ * pending flag and only posts the underlying semaphore when the flag wasn't raised yet (repeated
+ * signals are coalesced until the worker wakes up). The worker blocks in wait(), which lowers the
+ * flag upon return so work signalled while the worker processes wakes it again.
+ *
+ * A WorkSignal is awaited by a single worker thread.
+ */
+class WorkSignal
+{
+    public:
+        WorkSignal();
+        ~WorkSignal();
+
+        void signal();
+
+        // blocks until signalled, the timed variant returns false when it timed out
+        // (e.g. for workers that also validate state that isn't signalled)
+
+        void wait();
+        bool wait( int milliseconds );
+
+        bool isPending();
+
+    private:
+        std::atomic<bool> _pending;
+        sem_t _semaphore;
+};
+} // E.O namespace MWEngine
+
+#endif
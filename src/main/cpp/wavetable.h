@@ -67,6 +67,16 @@ class WaveTable
             return _buffer[ readOffset ];
         }
 
+        /**
+         * increment the accumulator by given amount of samples
+         * without reading from the wave table (e.g. when only
+         * sampling the table at control rate)
+         */
+        inline void advance( int amount )
+        {
+            _accumulator = fmod( _accumulator + ( SAMPLE_TYPE ) _frequency * amount, ( SAMPLE_TYPE ) AudioEngineProps::SAMPLE_RATE );
+        }
+
         void cloneTable( WaveTable* waveTable );
         WaveTable* clone();
 
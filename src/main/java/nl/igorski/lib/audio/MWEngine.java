@@ -62,10 +62,14 @@ public final class MWEngine extends Thread
          * SEQUENCER_POSITION_UPDATED fired when Sequencer has advanced a step, payload describes
          *                            the precise buffer offset of the Sequencer when the notification fired
          *                            (as a value in the range of 0 - BUFFER_SIZE)
-         * RECORDED_SNIPPET_READY     fired when a recording snippet of the requested size is ready for
-         *                            writing onto storage, payload describes snippets buffer index (see DiskWriter)
-         * RECORDED_SNIPPET_SAVED     fired when snippet has been saved onto storage, payload describes snippets number
+         * RECORDING_COMPLETED        fired when a recording has been written in full into its output file
          * BOUNCE_COMPLETE            fired when the offline bouncing of the Sequencer range has completed
+         * LATENCY_CALIBRATED         fired when InputCapture has measured the input latency, payload describes
+         *                            the latency in samples (or -1 when the calibration failed)
+         * RENDER_COMPLETE            fired when AudioRenderer has completed an asynchronous render into memory
+         * BULK_CACHE_PROGRESS        fired when the BulkCacher has cached an event, payload describes the
+         *                            amount of events remaining in its queue
+         * BULK_CACHE_COMPLETE        fired when the BulkCacher has cached all events in its queue
          */
         void handleNotification( int aNotificationId, int aNotificationValue );
     }
@@ -197,6 +201,56 @@ public final class MWEngine extends Thread
         _sequencerController.setBounceState( value, calculateRecordingSnippetBufferSize(), outputFile, rangeStart, rangeEnd );
     }
 
+    /**
+     * Bounces the output of each instrument into a separate file (a "stem") in a single pass,
+     * alongside the combined output. Files are written into given outputDirectory.
+     */
+    public void setStemBouncing( boolean value, String outputDirectory )
+    {
+        setStemBouncing( value, outputDirectory, 0, AudioEngine.getAmount_of_bars() * AudioEngine.getSamples_per_bar());
+    }
+
+    public void setStemBouncing( boolean value, String outputDirectory, int rangeStart, int rangeEnd )
+    {
+        _sequencerController.setStemBounceState( value, calculateRecordingSnippetBufferSize(), outputDirectory, rangeStart, rangeEnd );
+    }
+
+    /**
+     * Records the output of each instrument into a separate file (a "stem") alongside
+     * the combined output. Files are written into given outputDirectory.
+     *
+     * @param recordingActive {boolean} toggle the recording state on/off
+     * @param outputDirectory {String} name of the directory to write the recordings into
+     */
+    public void setStemRecordingState( boolean recordingActive, String outputDirectory )
+    {
+        _sequencerController.setStemRecordingState( recordingActive, calculateRecordingSnippetBufferSize(), outputDirectory );
+    }
+
+    /**
+     * Sets the file format of all subsequent recordings and bounces
+     *
+     * @param format {WaveEncoder.Format} e.g. 16-bit PCM, 24-bit PCM or 32-bit floating point WAV
+     * @param dither {boolean} whether to apply dither when recording in 16-bit PCM
+     */
+    public void setRecordingFormat( WaveEncoder.Format format, boolean dither )
+    {
+        _sequencerController.setRecordingFormat( format.ordinal(), dither );
+    }
+
+    /**
+     * Recovers the recordings that were interrupted by the application being terminated
+     * (these are valid up until the last second before termination). Should be invoked on
+     * application start before starting new recordings into the same directory.
+     *
+     * @param outputDirectory {String} the directory recordings are written into
+     * @return {int} the amount of recovered recordings
+     */
+    public int recoverRecordings( String outputDirectory )
+    {
+        return _sequencerController.recoverRecordings( outputDirectory );
+    }
+
     /**
      * Records the audio coming in from the Android device input.
      * Requires RECORD_DEVICE_INPUT to be enabled in global.h as well as the
@@ -261,9 +315,8 @@ public final class MWEngine extends Thread
     }
 
     /**
-     * Invoke when RECORDED_SNIPPET_READY fires. This will write an in-memory audio recording
-     * snippet onto device storage. Execute as soon as notification as fired for continuous recording,
-     * invoke from a different thread than the audio rendering thread to prevent buffer under runs.
+     * @deprecated recordings are streamed directly onto device storage (see DiskWriter)
+     *             and RECORDED_SNIPPET_READY is no longer fired, this method is a no-op
      *
      * @param snippetBufferIndex {int}
      */
@@ -409,8 +462,9 @@ public final class MWEngine extends Thread
 
     private int calculateRecordingSnippetBufferSize()
     {
-        // we divide a recording into 15 second snippets (these are combined when recording finishes)
-        final double amountOfMinutes = .25;
+        // recordings are queued in memory while being written onto storage, the queue
+        // (allocated per recorded file) can hold 2 seconds of audio
+        final double amountOfMinutes = 2. / 60;
 
         // convert milliseconds to sample buffer size
         return ( int ) (( amountOfMinutes * 60000 ) * ( SAMPLE_RATE / 1000 ));